@@ -453,6 +453,11 @@
 #define DEFAULT_THREADED_DATA_RUNLOOP_ENABLE false
 #endif
 
+/* Number of threads running tasks when threaded tasks are enabled.
+ * With more than one, save states and screenshots get a worker
+ * of their own and can no longer queue behind a database scan. */
+#define DEFAULT_THREADED_DATA_RUNLOOP_WORKERS 1
+
 /* Set to true if HW render cores should get their private context. */
 #define DEFAULT_VIDEO_SHARED_CONTEXT false
 
@@ -1279,6 +1284,10 @@
 #define DEFAULT_REWIND_GRANULARITY 1
 #endif
 
+/* Compress rewind states on a background thread
+ * instead of during the frame they were captured in. */
+#define DEFAULT_REWIND_THREADED false
+
 /* Pause gameplay when window loses focus. */
 #if defined(EMSCRIPTEN)
 #define DEFAULT_PAUSE_NONACTIVE false
@@ -1429,6 +1438,22 @@
 /* Hide warning messages when using the Run Ahead feature. */
 #define DEFAULT_RUN_AHEAD_HIDE_WARNINGS false
 
+/* When using single instance Run Ahead, roll back by restoring
+ * the core's own memory pages instead of loading a savestate.
+ * Experimental, Linux only. */
+#define DEFAULT_RUN_AHEAD_SNAPSHOT false
+
+/* When using second instance Run Ahead, run the secondary
+ * instance's next frame on its own thread while the primary
+ * instance runs. */
+#define DEFAULT_RUN_AHEAD_SECONDARY_THREAD false
+
+/* Largest analog change, in percent of the axis range, that
+ * Preemptive Frames may absorb without replaying. The actual
+ * threshold adapts to the measured jitter of each port up to
+ * this limit. 0 replays on every change. */
+#define DEFAULT_PREEMPT_ANALOG_THRESHOLD 0
+
 /* Enable stdin/network command interface. */
 #define DEFAULT_NETWORK_CMD_ENABLE false
 #define DEFAULT_NETWORK_CMD_PORT 55355
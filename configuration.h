@@ -228,6 +228,7 @@ typedef struct settings
       unsigned rewind_granularity;
       unsigned rewind_buffer_size_step;
       unsigned autosave_interval;
+      unsigned threaded_data_runloop_workers;
       unsigned replay_checkpoint_interval;
       unsigned replay_max_keep;
       unsigned savestate_max_keep;
@@ -341,6 +342,7 @@ typedef struct settings
 #endif
 
       unsigned run_ahead_frames;
+      unsigned preemptive_frames_analog_threshold;
 
       unsigned midi_volume;
       unsigned streaming_mode;
@@ -982,6 +984,7 @@ typedef struct settings
       bool history_list_enable;
       bool playlist_entry_rename;
       bool rewind_enable;
+      bool rewind_threaded;
       bool fastforward_frameskip;
       bool vrr_runloop_enable;
       bool menu_throttle_framerate;
@@ -990,6 +993,8 @@ typedef struct settings
       bool run_ahead_enabled;
       bool run_ahead_secondary_instance;
       bool run_ahead_hide_warnings;
+      bool run_ahead_snapshot;
+      bool run_ahead_secondary_thread;
       bool preemptive_frames_enable;
       bool pause_nonactive;
       bool pause_on_disconnect;
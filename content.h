@@ -69,6 +69,15 @@ size_t content_get_serialized_size_rewind(void);
 /* Serializes the current state for rewinding. buffer must be at least content_get_serialized_size bytes */
 bool content_serialize_state_rewind(void* buffer, size_t buffer_size);
 
+/* Gets the location of the core data within a rewind state. Fails if
+ * anything else in the state may change from frame to frame, in which
+ * case the whole state has to be rewritten with content_serialize_state_rewind. */
+bool content_get_serialized_core_block_rewind(size_t *offset, size_t *size);
+
+/* Whether rewind states still consist of nothing but the core data block.
+ * Achievements loaded later add a block of their own. */
+bool content_serialized_core_block_rewind_is_current(void);
+
 /* Deserializes the current state. */
 bool content_deserialize_state(const void* serialized_data, size_t serialized_size);
 
@@ -47,7 +47,7 @@
 /* Core Info Cache START */
 /*************************/
 
-#define CORE_INFO_CACHE_VERSION "1.2"
+#define CORE_INFO_CACHE_VERSION "1.3"
 #define CORE_INFO_CACHE_DEFAULT_CAPACITY 8
 
 /* TODO/FIXME: Apparently rzip compression is an issue on UWP */
@@ -199,6 +199,8 @@ static bool CCJSONObjectMemberHandler(void *context,
                         pCtx->current_string_val      = &pCtx->core_info->required_hw_api;
                         pCtx->current_string_list_val = &pCtx->core_info->required_hw_api_list;
                      }
+                     else if (string_is_equal(pValue, "runahead_snapshot"))
+                        pCtx->current_entry_bool_val  = &pCtx->core_info->runahead_snapshot;
                      break;
                   case 's':
                      if (string_is_equal(pValue, "system_manufacturer"))
@@ -492,6 +494,7 @@ static void core_info_copy(core_info_t *src, core_info_t *dst)
    dst->single_purpose                = src->single_purpose;
    dst->database_match_archive_member = src->database_match_archive_member;
    dst->is_experimental               = src->is_experimental;
+   dst->runahead_snapshot             = src->runahead_snapshot;
    dst->is_locked                     = src->is_locked;
    dst->is_standalone_exempt          = src->is_standalone_exempt;
    dst->is_installed                  = src->is_installed;
@@ -589,6 +592,7 @@ static void core_info_transfer(core_info_t *src, core_info_t *dst)
    dst->single_purpose                = src->single_purpose;
    dst->database_match_archive_member = src->database_match_archive_member;
    dst->is_experimental               = src->is_experimental;
+   dst->runahead_snapshot             = src->runahead_snapshot;
    dst->is_locked                     = src->is_locked;
    dst->is_standalone_exempt          = src->is_standalone_exempt;
    dst->is_installed                  = src->is_installed;
@@ -1175,6 +1179,17 @@ static bool core_info_cache_write(core_info_cache_list_t *list, const char *info
          bool value = info->is_experimental;
          rjsonwriter_raw(writer, (value ? "true" : "false"), (value ? 4 : 5));
       }
+      rjsonwriter_raw(writer, ",", 1);
+      rjsonwriter_raw(writer, "\n", 1);
+
+      rjsonwriter_add_spaces(writer, 6);
+      rjsonwriter_add_string(writer, "runahead_snapshot");
+      rjsonwriter_raw(writer, ":", 1);
+      rjsonwriter_raw(writer, " ", 1);
+      {
+         bool value = info->runahead_snapshot;
+         rjsonwriter_raw(writer, (value ? "true" : "false"), (value ? 4 : 5));
+      }
       rjsonwriter_raw(writer, "\n", 1);
 
       rjsonwriter_add_spaces(writer, 4);
@@ -1854,6 +1869,10 @@ static void core_info_parse_config_file(
             &tmp_bool))
       info->is_experimental = tmp_bool;
 
+   if (config_get_bool(conf, "runahead_snapshot",
+            &tmp_bool))
+      info->runahead_snapshot = tmp_bool;
+
 
    /* Savestate support level is slightly more complex,
     * since it is a value derived from two configuration
@@ -2301,6 +2320,7 @@ bool core_info_init_current_core(void)
    current->single_purpose                = false;
    current->database_match_archive_member = false;
    current->is_experimental               = false;
+   current->runahead_snapshot             = false;
    current->is_locked                     = false;
    current->is_standalone_exempt          = false;
    current->is_installed                  = false;
@@ -2886,6 +2906,21 @@ bool core_info_current_supports_runahead(void)
          CORE_INFO_SAVESTATE_DETERMINISTIC;
 }
 
+/* Snapshot rollback only restores the core's own
+ * writable segments, so it is limited to cores whose
+ * info file states that their whole emulation state
+ * lives there and that they do not allocate heap
+ * memory while running */
+bool core_info_current_supports_runahead_snapshot(void)
+{
+   core_info_state_t *p_coreinfo = &core_info_st;
+
+   if (!p_coreinfo->current)
+      return false;
+
+   return p_coreinfo->current->runahead_snapshot;
+}
+
 static bool core_info_update_core_aux_file(const char *path, bool create)
 {
    bool aux_file_exists = false;
@@ -107,6 +107,7 @@ typedef struct
    bool single_purpose;
    bool database_match_archive_member;
    bool is_experimental;
+   bool runahead_snapshot;
    bool is_locked;
    bool is_standalone_exempt;
    bool is_installed;
@@ -211,6 +212,7 @@ bool core_info_current_supports_savestate(void);
 bool core_info_current_supports_rewind(void);
 bool core_info_current_supports_netplay(void);
 bool core_info_current_supports_runahead(void);
+bool core_info_current_supports_runahead_snapshot(void);
 
 /* Sets 'locked' status of specified core
  * > Returns true if successful
@@ -16,10 +16,13 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <compat/strl.h>
 #include <retro_endianness.h>
+#include <retro_inline.h>
+#include <retro_miscellaneous.h>
 #include <file/file_path.h>
 #include <lists/string_list.h>
 #include <lists/dir_list.h>
@@ -466,19 +469,15 @@ char *bin_to_hex_alloc(const uint8_t *data, size_t len)
    return ret;
 }
 
-static int database_cursor_iterate(libretrodb_cursor_t *cur,
+static int database_info_parse_item(struct rmsgpack_dom_value *item,
       database_info_t *db_info)
 {
    unsigned i;
-   struct rmsgpack_dom_value item;
    const char* str                = NULL;
 
-   if (libretrodb_cursor_read_item(cur, &item) != 0)
-      return -1;
-
-   if (item.type != RDT_MAP)
+   if (item->type != RDT_MAP)
    {
-      rmsgpack_dom_value_free(&item);
+      rmsgpack_dom_value_free(item);
       return 1;
    }
 
@@ -486,10 +485,10 @@ static int database_cursor_iterate(libretrodb_cursor_t *cur,
    db_info->rumble_supported       = -1;
    db_info->coop_supported         = -1;
 
-   for (i = 0; i < item.val.map.len; i++)
+   for (i = 0; i < item->val.map.len; i++)
    {
-      struct rmsgpack_dom_value *key = &item.val.map.items[i].key;
-      struct rmsgpack_dom_value *val = &item.val.map.items[i].value;
+      struct rmsgpack_dom_value *key = &item->val.map.items[i].key;
+      struct rmsgpack_dom_value *val = &item->val.map.items[i].value;
       const char *val_string         = NULL;
 
       if (!key || !val)
@@ -709,11 +708,22 @@ static int database_cursor_iterate(libretrodb_cursor_t *cur,
                (uint8_t*)val->val.binary.buff, val->val.binary.len);
    }
 
-   rmsgpack_dom_value_free(&item);
+   rmsgpack_dom_value_free(item);
 
    return 0;
 }
 
+static int database_cursor_iterate(libretrodb_cursor_t *cur,
+      database_info_t *db_info)
+{
+   struct rmsgpack_dom_value item;
+
+   if (libretrodb_cursor_read_item(cur, &item) != 0)
+      return -1;
+
+   return database_info_parse_item(&item, db_info);
+}
+
 static int database_cursor_open(libretrodb_t *db,
       libretrodb_cursor_t *cur, const char *path, const char *query)
 {
@@ -832,6 +842,193 @@ void database_info_free(database_info_handle_t *db)
       string_list_free(db->list);
 }
 
+/* Record keys read by database_info_parse_item(), with the
+ * database_info_t member each one is stored in */
+typedef struct
+{
+   const char *key;
+   size_t offset;
+} database_info_column_field_t;
+
+static const database_info_column_field_t database_info_string_fields[] = {
+   { "name",           offsetof(database_info_t, name)                 },
+   { "serial",         offsetof(database_info_t, serial)               },
+   { "description",    offsetof(database_info_t, description)          },
+   { "genre",          offsetof(database_info_t, genre)                },
+   { "category",       offsetof(database_info_t, category)             },
+   { "language",       offsetof(database_info_t, language)             },
+   { "region",         offsetof(database_info_t, region)               },
+   { "score",          offsetof(database_info_t, score)                },
+   { "media",          offsetof(database_info_t, media)                },
+   { "controls",       offsetof(database_info_t, controls)             },
+   { "artstyle",       offsetof(database_info_t, artstyle)             },
+   { "gameplay",       offsetof(database_info_t, gameplay)             },
+   { "narrative",      offsetof(database_info_t, narrative)            },
+   { "pacing",         offsetof(database_info_t, pacing)               },
+   { "perspective",    offsetof(database_info_t, perspective)          },
+   { "setting",        offsetof(database_info_t, setting)              },
+   { "visual",         offsetof(database_info_t, visual)               },
+   { "vehicular",      offsetof(database_info_t, vehicular)            },
+   { "publisher",      offsetof(database_info_t, publisher)            },
+   { "origin",         offsetof(database_info_t, origin)               },
+   { "franchise",      offsetof(database_info_t, franchise)            },
+   { "edge_review",    offsetof(database_info_t, edge_magazine_review) },
+   { "bbfc_rating",    offsetof(database_info_t, bbfc_rating)          },
+   { "elspa_rating",   offsetof(database_info_t, elspa_rating)         },
+   { "esrb_rating",    offsetof(database_info_t, esrb_rating)          },
+   { "pegi_rating",    offsetof(database_info_t, pegi_rating)          },
+   { "cero_rating",    offsetof(database_info_t, cero_rating)          },
+   { "enhancement_hw", offsetof(database_info_t, enhancement_hw)       },
+};
+
+static const database_info_column_field_t database_info_uint_fields[] = {
+   { "edge_rating",    offsetof(database_info_t, edge_magazine_rating)    },
+   { "famitsu_rating", offsetof(database_info_t, famitsu_magazine_rating) },
+   { "tgdb_rating",    offsetof(database_info_t, tgdb_rating)             },
+   { "edge_issue",     offsetof(database_info_t, edge_magazine_issue)     },
+   { "users",          offsetof(database_info_t, max_users)               },
+   { "releasemonth",   offsetof(database_info_t, releasemonth)            },
+   { "releaseyear",    offsetof(database_info_t, releaseyear)             },
+   { "size",           offsetof(database_info_t, size)                    },
+};
+
+static const database_info_column_field_t database_info_int_fields[] = {
+   { "rumble",             offsetof(database_info_t, rumble_supported)   },
+   { "achievements",       offsetof(database_info_t, achievements)       },
+   { "console_exclusive",  offsetof(database_info_t, console_exclusive)  },
+   { "platform_exclusive", offsetof(database_info_t, platform_exclusive) },
+   { "coop",               offsetof(database_info_t, coop_supported)     },
+   { "analog",             offsetof(database_info_t, analog_supported)   },
+};
+
+/* Reads every record of the database from its columnar
+ * companion, which spares decoding each record into a DOM.
+ * Returns NULL if there is no companion compiled from the
+ * database as it is now; the caller scans the database then. */
+static database_info_list_t *database_info_list_new_columns(
+      const char *rdb_path)
+{
+   size_t i;
+   uint32_t row, rows;
+   int developer_col, crc_col, sha1_col, md5_col;
+   int string_cols[ARRAY_SIZE(database_info_string_fields)];
+   int uint_cols[ARRAY_SIZE(database_info_uint_fields)];
+   int int_cols[ARRAY_SIZE(database_info_int_fields)];
+   char columns_path[PATH_MAX_LENGTH];
+   database_info_list_t *database_info_list = NULL;
+   libretrodb_columns_t *cols               = NULL;
+
+   fill_pathname(columns_path, rdb_path,
+         LIBRETRODB_COLUMNS_EXTENSION, sizeof(columns_path));
+
+   if (!(cols = libretrodb_columns_open(columns_path)))
+      return NULL;
+
+   if (!libretrodb_columns_is_current(cols, rdb_path))
+      goto end;
+
+   if (!(database_info_list = (database_info_list_t*)
+            malloc(sizeof(*database_info_list))))
+      goto end;
+
+   rows                       = libretrodb_columns_rows(cols);
+   database_info_list->count  = 0;
+   database_info_list->list   = NULL;
+
+   if (rows && !(database_info_list->list = (database_info_t*)
+            calloc(rows, sizeof(database_info_t))))
+   {
+      free(database_info_list);
+      database_info_list = NULL;
+      goto end;
+   }
+
+   for (i = 0; i < ARRAY_SIZE(database_info_string_fields); i++)
+      string_cols[i] = libretrodb_columns_find(cols,
+            database_info_string_fields[i].key, LIBRETRODB_COLUMN_STRING);
+   for (i = 0; i < ARRAY_SIZE(database_info_uint_fields); i++)
+      uint_cols[i]   = libretrodb_columns_find(cols,
+            database_info_uint_fields[i].key, LIBRETRODB_COLUMN_INT);
+   for (i = 0; i < ARRAY_SIZE(database_info_int_fields); i++)
+      int_cols[i]    = libretrodb_columns_find(cols,
+            database_info_int_fields[i].key, LIBRETRODB_COLUMN_INT);
+   developer_col     = libretrodb_columns_find(cols, "developer",
+         LIBRETRODB_COLUMN_STRING);
+   crc_col           = libretrodb_columns_find(cols, "crc",
+         LIBRETRODB_COLUMN_BINARY);
+   sha1_col          = libretrodb_columns_find(cols, "sha1",
+         LIBRETRODB_COLUMN_BINARY);
+   md5_col           = libretrodb_columns_find(cols, "md5",
+         LIBRETRODB_COLUMN_BINARY);
+
+   for (row = 0; row < rows; row++)
+   {
+      int64_t value;
+      uint32_t len;
+      const char *str;
+      const uint8_t *bin;
+      database_info_t *db_info = &database_info_list->list[row];
+      uint8_t *base            = (uint8_t*)db_info;
+
+      db_info->analog_supported = -1;
+      db_info->rumble_supported = -1;
+      db_info->coop_supported   = -1;
+
+      for (i = 0; i < ARRAY_SIZE(database_info_string_fields); i++)
+         if (!string_is_empty(str = libretrodb_columns_get_string(
+                     cols, string_cols[i], row)))
+            *(char**)(base + database_info_string_fields[i].offset) =
+               strdup(str);
+
+      for (i = 0; i < ARRAY_SIZE(database_info_uint_fields); i++)
+         if (libretrodb_columns_get_int(cols, uint_cols[i], row, &value))
+            *(unsigned*)(base + database_info_uint_fields[i].offset) =
+               (unsigned)value;
+
+      for (i = 0; i < ARRAY_SIZE(database_info_int_fields); i++)
+         if (libretrodb_columns_get_int(cols, int_cols[i], row, &value))
+            *(int*)(base + database_info_int_fields[i].offset) =
+               (int)value;
+
+      if (!string_is_empty(str = libretrodb_columns_get_string(
+                  cols, developer_col, row)))
+         db_info->developer = string_split(str, "|");
+
+      if ((bin = libretrodb_columns_get_binary(cols, crc_col, row, &len)))
+      {
+         /* Big-endian, as in database_info_parse_item() */
+         switch (len)
+         {
+            case 1:
+               db_info->crc32 = bin[0];
+               break;
+            case 2:
+               db_info->crc32 = ((uint32_t)bin[0] << 8) | bin[1];
+               break;
+            case 4:
+               db_info->crc32 = ((uint32_t)bin[0] << 24)
+                              | ((uint32_t)bin[1] << 16)
+                              | ((uint32_t)bin[2] << 8)
+                              |  (uint32_t)bin[3];
+               break;
+            default:
+               break;
+         }
+      }
+
+      if ((bin = libretrodb_columns_get_binary(cols, sha1_col, row, &len)))
+         db_info->sha1 = bin_to_hex_alloc(bin, len);
+      if ((bin = libretrodb_columns_get_binary(cols, md5_col, row, &len)))
+         db_info->md5  = bin_to_hex_alloc(bin, len);
+   }
+
+   database_info_list->count = rows;
+
+end:
+   libretrodb_columns_free(cols);
+   return database_info_list;
+}
+
 database_info_list_t *database_info_list_new(
       const char *rdb_path, const char *query)
 {
@@ -839,8 +1036,17 @@ database_info_list_t *database_info_list_new(
    unsigned k                               = 0;
    database_info_t *database_info           = NULL;
    database_info_list_t *database_info_list = NULL;
-   libretrodb_t *db                         = libretrodb_new();
-   libretrodb_cursor_t *cur                 = libretrodb_cursor_new();
+   libretrodb_t *db                         = NULL;
+   libretrodb_cursor_t *cur                 = NULL;
+
+   /* Reading the whole database is answered from the
+    * columnar companion when there is one */
+   if (!query && (database_info_list =
+            database_info_list_new_columns(rdb_path)))
+      return database_info_list;
+
+   db                                       = libretrodb_new();
+   cur                                      = libretrodb_cursor_new();
 
    if (!db || !cur)
       goto end;
@@ -1083,3 +1289,411 @@ void database_info_list_free(database_info_list_t *database_info_list)
 
    free(database_info_list->list);
 }
+
+/* Scan-session index.
+ *
+ * Maps the crc32 and serial columns of every database onto the
+ * file offsets of their records, so that identifying a piece of
+ * content costs a hash probe per database instead of a full
+ * cursor scan. Databases are indexed lazily, the first time they
+ * are consulted, which spreads the loading cost over the scan and
+ * skips databases that no installed core can use. */
+
+#define DATABASE_INDEX_MIN_SLOTS 4096
+
+enum database_index_db_state
+{
+   DATABASE_INDEX_DB_PENDING = 0,
+   DATABASE_INDEX_DB_READY,
+   DATABASE_INDEX_DB_FAILED
+};
+
+typedef struct
+{
+   uint32_t key;    /* 0 marks an empty slot */
+   uint32_t offset; /* record offset inside the database */
+   uint32_t db;
+} database_index_slot_t;
+
+typedef struct
+{
+   database_index_slot_t *slots;
+   size_t count;
+   size_t mask;
+} database_index_table_t;
+
+struct database_info_index
+{
+   database_index_table_t crc;
+   database_index_table_t serial;
+   uint8_t *state;
+   size_t dbs;
+};
+
+static INLINE size_t database_index_bucket(uint32_t key, size_t mask)
+{
+   key ^= key >> 16;
+   key *= 0x7FEB352DU;
+   key ^= key >> 15;
+   return key & mask;
+}
+
+static uint32_t database_index_hash_serial(const char *s, size_t len)
+{
+   /* FNV-1a; collisions are harmless since every hit is
+    * compared against the record's own serial afterwards. */
+   size_t i;
+   uint32_t hash = 0x811C9DC5U;
+
+   for (i = 0; i < len; i++)
+   {
+      hash ^= (uint8_t)s[i];
+      hash *= 0x01000193U;
+   }
+
+   return hash ? hash : 1;
+}
+
+static bool database_index_table_grow(database_index_table_t *table)
+{
+   size_t i;
+   size_t old_size             = table->slots ? table->mask + 1 : 0;
+   size_t new_size             = old_size
+      ? old_size << 1 : DATABASE_INDEX_MIN_SLOTS;
+   database_index_slot_t *old  = table->slots;
+   database_index_slot_t *slots= (database_index_slot_t*)
+      calloc(new_size, sizeof(*slots));
+
+   if (!slots)
+      return false;
+
+   table->slots = slots;
+   table->mask  = new_size - 1;
+
+   for (i = 0; i < old_size; i++)
+   {
+      size_t j;
+
+      if (!old[i].key)
+         continue;
+
+      j = database_index_bucket(old[i].key, table->mask);
+      while (slots[j].key)
+         j = (j + 1) & table->mask;
+      slots[j] = old[i];
+   }
+
+   free(old);
+   return true;
+}
+
+static bool database_index_table_insert(database_index_table_t *table,
+      uint32_t key, uint32_t db, uint32_t offset)
+{
+   size_t i;
+
+   /* Keep the load factor at or below one half */
+   if (!table->slots || (table->count + 1) * 2 > table->mask + 1)
+      if (!database_index_table_grow(table))
+         return false;
+
+   i = database_index_bucket(key, table->mask);
+   while (table->slots[i].key)
+      i = (i + 1) & table->mask;
+
+   table->slots[i].key    = key;
+   table->slots[i].offset = offset;
+   table->slots[i].db     = db;
+   table->count++;
+   return true;
+}
+
+static size_t database_index_table_find(const database_index_table_t *table,
+      uint32_t key, uint32_t db, uint32_t *offsets, size_t count, size_t len)
+{
+   size_t i;
+
+   if (!table->slots || !key)
+      return count;
+
+   /* The same key may appear in several records and databases,
+    * so walk the whole probe run rather than stopping at the
+    * first hit. */
+   for (i = database_index_bucket(key, table->mask);
+         table->slots[i].key; i = (i + 1) & table->mask)
+   {
+      const database_index_slot_t *slot = &table->slots[i];
+
+      if (slot->key != key || slot->db != db)
+         continue;
+      if (count < len)
+         offsets[count] = slot->offset;
+      count++;
+   }
+
+   return count;
+}
+
+static bool database_info_index_load(database_info_index_t *index,
+      size_t db_id, const char *rdb_path)
+{
+   bool ret                 = false;
+   libretrodb_t *db         = libretrodb_new();
+   libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+   if (!db || !cur)
+      goto end;
+
+   if (database_cursor_open(db, cur, rdb_path, NULL) != 0)
+      goto end;
+
+   for (;;)
+   {
+      unsigned i;
+      struct rmsgpack_dom_value item;
+      int64_t offset = libretrodb_cursor_tell(cur);
+
+      if (libretrodb_cursor_read_item(cur, &item) != 0)
+         break;
+
+      if (offset < 0 || (uint64_t)offset > 0xFFFFFFFFU)
+      {
+         rmsgpack_dom_value_free(&item);
+         goto end;
+      }
+
+      if (item.type == RDT_MAP)
+      {
+         for (i = 0; i < item.val.map.len; i++)
+         {
+            uint32_t key                   = 0;
+            database_index_table_t *table  = NULL;
+            struct rmsgpack_dom_value *k   = &item.val.map.items[i].key;
+            struct rmsgpack_dom_value *val = &item.val.map.items[i].value;
+
+            if (k->type != RDT_STRING)
+               continue;
+
+            if (     val->type == RDT_BINARY
+                  && string_is_equal(k->val.string.buff, "crc"))
+            {
+               const uint8_t *crc = (const uint8_t*)val->val.binary.buff;
+
+               /* Matches the big-endian decoding in
+                * database_info_parse_item() */
+               switch (val->val.binary.len)
+               {
+                  case 1:
+                     key = crc[0];
+                     break;
+                  case 2:
+                     key = ((uint32_t)crc[0] << 8) | crc[1];
+                     break;
+                  case 4:
+                     key = ((uint32_t)crc[0] << 24)
+                         | ((uint32_t)crc[1] << 16)
+                         | ((uint32_t)crc[2] << 8)
+                         |  (uint32_t)crc[3];
+                     break;
+                  default:
+                     break;
+               }
+               table = &index->crc;
+            }
+            else if ((val->type == RDT_BINARY || val->type == RDT_STRING)
+                  && val->val.string.len
+                  && string_is_equal(k->val.string.buff, "serial"))
+            {
+               key   = database_index_hash_serial(val->val.string.buff,
+                     val->val.string.len);
+               table = &index->serial;
+            }
+
+            if (table && key && !database_index_table_insert(table,
+                     key, (uint32_t)db_id, (uint32_t)offset))
+            {
+               rmsgpack_dom_value_free(&item);
+               goto end;
+            }
+         }
+      }
+
+      rmsgpack_dom_value_free(&item);
+   }
+
+   ret = true;
+
+end:
+   if (db)
+   {
+      libretrodb_cursor_close(cur);
+      libretrodb_close(db);
+      libretrodb_free(db);
+   }
+   if (cur)
+      libretrodb_cursor_free(cur);
+
+   index->state[db_id] = ret
+      ? DATABASE_INDEX_DB_READY : DATABASE_INDEX_DB_FAILED;
+   return ret;
+}
+
+static database_info_list_t *database_info_index_list_new(
+      database_info_index_t *index, const database_index_table_t *table,
+      size_t db_id, const char *rdb_path,
+      const uint32_t *keys, size_t num_keys)
+{
+   size_t i, count;
+   uint32_t stack_offsets[16];
+   uint32_t *offsets                        = stack_offsets;
+   database_info_list_t *database_info_list = NULL;
+   libretrodb_t *db                         = NULL;
+
+   if (!index || db_id >= index->dbs)
+      return NULL;
+
+   if (index->state[db_id] == DATABASE_INDEX_DB_PENDING)
+      database_info_index_load(index, db_id, rdb_path);
+   if (index->state[db_id] != DATABASE_INDEX_DB_READY)
+      return NULL;
+
+   count = 0;
+   for (i = 0; i < num_keys; i++)
+      count = database_index_table_find(table, keys[i], (uint32_t)db_id,
+            offsets, count, ARRAY_SIZE(stack_offsets));
+
+   if (count > ARRAY_SIZE(stack_offsets))
+   {
+      size_t len = count;
+
+      if (!(offsets = (uint32_t*)malloc(len * sizeof(*offsets))))
+         return NULL;
+
+      count = 0;
+      for (i = 0; i < num_keys; i++)
+         count = database_index_table_find(table, keys[i],
+               (uint32_t)db_id, offsets, count, len);
+   }
+
+   if (!(database_info_list = (database_info_list_t*)
+         malloc(sizeof(*database_info_list))))
+      goto end;
+
+   database_info_list->count = 0;
+   database_info_list->list  = NULL;
+
+   if (count == 0)
+      goto end;
+
+   /* Hand matches back in file order, as a cursor scan would */
+   for (i = 1; i < count; i++)
+   {
+      size_t j;
+      uint32_t offset = offsets[i];
+
+      for (j = i; j > 0 && offsets[j - 1] > offset; j--)
+         offsets[j] = offsets[j - 1];
+      offsets[j] = offset;
+   }
+
+   if (!(database_info_list->list = (database_info_t*)
+         calloc(count, sizeof(database_info_t))))
+      goto error;
+
+   if (!(db = libretrodb_new()))
+      goto error;
+
+   if (libretrodb_open(rdb_path, db, false) != 0)
+      goto error;
+
+   for (i = 0; i < count; i++)
+   {
+      struct rmsgpack_dom_value item;
+
+      if (i > 0 && offsets[i] == offsets[i - 1])
+         continue;
+      if (libretrodb_read_item_at(db, offsets[i], &item) != 0)
+         continue;
+      if (database_info_parse_item(&item,
+               &database_info_list->list[database_info_list->count]) == 0)
+         database_info_list->count++;
+   }
+
+   goto end;
+
+error:
+   database_info_list_free(database_info_list);
+   free(database_info_list);
+   database_info_list = NULL;
+
+end:
+   if (db)
+   {
+      libretrodb_close(db);
+      libretrodb_free(db);
+   }
+   if (offsets != stack_offsets)
+      free(offsets);
+
+   return database_info_list;
+}
+
+database_info_index_t *database_info_index_new(size_t dbs)
+{
+   database_info_index_t *index = (database_info_index_t*)
+      calloc(1, sizeof(*index));
+
+   if (!index)
+      return NULL;
+
+   if (dbs && !(index->state = (uint8_t*)calloc(dbs, sizeof(uint8_t))))
+   {
+      free(index);
+      return NULL;
+   }
+
+   index->dbs = dbs;
+   return index;
+}
+
+void database_info_index_free(database_info_index_t *index)
+{
+   if (!index)
+      return;
+
+   free(index->crc.slots);
+   free(index->serial.slots);
+   free(index->state);
+   free(index);
+}
+
+database_info_list_t *database_info_index_find_crc(
+      database_info_index_t *index, size_t db_id, const char *rdb_path,
+      uint32_t crc, uint32_t archive_crc)
+{
+   uint32_t keys[2];
+
+   if (!index)
+      return NULL;
+
+   keys[0] = crc;
+   keys[1] = archive_crc;
+
+   return database_info_index_list_new(index, &index->crc, db_id,
+         rdb_path, keys, (crc == archive_crc) ? 1 : 2);
+}
+
+database_info_list_t *database_info_index_find_serial(
+      database_info_index_t *index, size_t db_id, const char *rdb_path,
+      const char *serial)
+{
+   uint32_t key;
+
+   if (!index || string_is_empty(serial))
+      return NULL;
+
+   key = database_index_hash_serial(serial, strlen(serial));
+
+   return database_info_index_list_new(index, &index->serial, db_id,
+         rdb_path, &key, 1);
+}
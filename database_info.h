@@ -141,6 +141,51 @@ database_info_list_t *database_info_list_new(const char *rdb_path,
 
 void database_info_list_free(database_info_list_t *list);
 
+typedef struct database_info_index database_info_index_t;
+
+/**
+ * database_info_index_new:
+ * @dbs                 : Number of databases taking part in the scan.
+ *
+ * Creates an in-memory crc32/serial index over a set of databases,
+ * identified by their position (0 .. @dbs - 1). Each database is
+ * loaded into the index the first time it is searched.
+ *
+ * Returns: new index, or NULL on allocation failure.
+ **/
+database_info_index_t *database_info_index_new(size_t dbs);
+
+void database_info_index_free(database_info_index_t *index);
+
+/**
+ * database_info_index_find_crc:
+ * @index               : Scan-session index.
+ * @db_id               : Position of the database in the index.
+ * @rdb_path            : Path of the database.
+ * @crc                 : CRC32 of the content.
+ * @archive_crc         : CRC32 of the containing archive, or 0.
+ *
+ * Equivalent to database_info_list_new() with a
+ * {crc:or(@crc,@archive_crc)} query, without scanning the database.
+ *
+ * Returns: list of matching entries (possibly empty), or NULL if
+ * the database could not be indexed and must be queried instead.
+ **/
+database_info_list_t *database_info_index_find_crc(
+      database_info_index_t *index, size_t db_id, const char *rdb_path,
+      uint32_t crc, uint32_t archive_crc);
+
+/**
+ * database_info_index_find_serial:
+ *
+ * Serial counterpart of database_info_index_find_crc().
+ * Matching is by hash, so callers must still compare the
+ * serial of each returned entry.
+ **/
+database_info_list_t *database_info_index_find_serial(
+      database_info_index_t *index, size_t db_id, const char *rdb_path,
+      const char *serial);
+
 database_info_handle_t *database_info_dir_init(const char *dir,
       enum database_type type, retro_task_t *task,
       bool show_hidden_files);
@@ -29,6 +29,10 @@
 #include "../config.h"
 #endif
 
+#ifdef HAVE_THREADS
+#include <rthreads/band_pool.h>
+#endif
+
 #include "../frontend/frontend_driver.h"
 #include "../dynamic.h"
 #include "../performance_counters.h"
@@ -61,48 +65,20 @@ struct rarch_softfilter
    unsigned threads;
 
 #ifdef HAVE_THREADS
-   struct filter_thread_data *thread_data;
+   band_pool_t *pool;
 #endif
 };
 
 #ifdef HAVE_THREADS
-#include <rthreads/rthreads.h>
-
-struct filter_thread_data
+/* Runs the packets of one band of the pool */
+static void softfilter_thread_band(void *data,
+      unsigned first, unsigned last)
 {
-   sthread_t *thread;
-   const struct softfilter_work_packet *packet;
-   scond_t *cond;
-   slock_t *lock;
-   void *userdata;
-   bool die;
-   bool done;
-};
-
-static void filter_thread_loop(void *data)
-{
-   struct filter_thread_data *thr = (struct filter_thread_data*)data;
-
-   for (;;)
-   {
-      bool die;
-      slock_lock(thr->lock);
-      while (thr->done && !thr->die)
-         scond_wait(thr->cond, thr->lock);
-      die = thr->die;
-      slock_unlock(thr->lock);
-
-      if (die)
-         break;
-
-      if (thr->packet && thr->packet->work)
-         thr->packet->work(thr->userdata, thr->packet->thread_data);
+   rarch_softfilter_t *filt = (rarch_softfilter_t*)data;
 
-      slock_lock(thr->lock);
-      thr->done = true;
-      scond_signal(thr->cond);
-      slock_unlock(thr->lock);
-   }
+   for (; first < last; first++)
+      filt->packets[first].work(filt->impl_data,
+            filt->packets[first].thread_data);
 }
 #endif
 
@@ -234,30 +210,10 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    }
 
 #ifdef HAVE_THREADS
+   /* The calling thread runs packets too */
    if (filt->threads > 1)
-   {
-      unsigned i;
-      if (!(filt->thread_data = (struct filter_thread_data*)
-         calloc(threads, sizeof(*filt->thread_data))))
+      if (!(filt->pool = band_pool_new(filt->threads - 1)))
          return false;
-
-      for (i = 0; i < threads; i++)
-      {
-         filt->thread_data[i].userdata = filt->impl_data;
-         filt->thread_data[i].done     = true;
-
-         filt->thread_data[i].lock     = slock_new();
-         if (!filt->thread_data[i].lock)
-            return false;
-         filt->thread_data[i].cond     = scond_new();
-         if (!filt->thread_data[i].cond)
-            return false;
-         filt->thread_data[i].thread   = sthread_create(
-               filter_thread_loop, &filt->thread_data[i]);
-         if (!filt->thread_data[i].thread)
-            return false;
-      }
-   }
 #endif
 
    return true;
@@ -483,6 +439,10 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
    if (!filt)
       return;
 
+#ifdef HAVE_THREADS
+   band_pool_free(filt->pool);
+#endif
+
    free(filt->packets);
    if (filt->impl && filt->impl_data)
       filt->impl->destroy(filt->impl_data);
@@ -496,25 +456,6 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
    free(filt->plugs);
 #endif
 
-#ifdef HAVE_THREADS
-   if (filt->threads > 1)
-   {
-      for (i = 0; i < filt->threads; i++)
-      {
-         if (!filt->thread_data[i].thread)
-            continue;
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].die = true;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-         sthread_join(filt->thread_data[i].thread);
-         slock_free(filt->thread_data[i].lock);
-         scond_free(filt->thread_data[i].cond);
-      }
-      free(filt->thread_data);
-   }
-#endif
-
    if (filt->conf)
       config_file_free(filt->conf);
 
@@ -558,32 +499,10 @@ void rarch_softfilter_process(rarch_softfilter_t *filt,
             output, output_stride, input, width, height, input_stride);
 
 #ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   if (filt->pool)
    {
-      /* Fire off workers */
-      for (i = 0; i < filt->threads; i++)
-      {
-#if 0
-         RARCH_LOG("Firing off filter thread %u ...\n", i);
-#endif
-         filt->thread_data[i].packet = &filt->packets[i];
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].done = false;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-      }
-
-      /* Wait for workers */
-      for (i = 0; i < filt->threads; i++)
-      {
-#if 0
-         RARCH_LOG("Waiting for filter thread %u ...\n", i);
-#endif
-         slock_lock(filt->thread_data[i].lock);
-         while (!filt->thread_data[i].done)
-            scond_wait(filt->thread_data[i].cond, filt->thread_data[i].lock);
-         slock_unlock(filt->thread_data[i].lock);
-      }
+      band_pool_run(filt->pool, filt->threads,
+            softfilter_thread_band, filt);
       return;
    }
 #endif
@@ -34,6 +34,7 @@
 */
 
 #include "softfilter.h"
+#include "softfilter_simd.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -58,6 +59,10 @@ struct softfilter_thread_data
    unsigned height;
    int first;
    int last;
+   /* YUV values of the row being filtered, padded by two pixels
+    * on either side, so that the RGB565 vector kernels do not
+    * have to look them up pixel by pixel */
+   uint16_t *yuv;
 };
 
 struct filter_data
@@ -65,6 +70,8 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   unsigned max_width;
+   softfilter_simd_mask_t simd;
    uint16_t RGBtoYUV[65536];
    uint16_t tbl_5_to_8[32];
    uint16_t tbl_6_to_8[64];
@@ -225,22 +232,32 @@ static void *twoxbr_generic_create(const struct softfilter_config *config,
       unsigned max_width, unsigned max_height,
       unsigned threads, softfilter_simd_mask_t simd, void *userdata)
 {
+   unsigned i;
    struct filter_data *filt = (struct filter_data*)calloc(1, sizeof(*filt));
-   (void)simd;
    (void)config;
    (void)userdata;
    if (!filt)
       return NULL;
    filt->workers = (struct softfilter_thread_data*)
       calloc(threads, sizeof(struct softfilter_thread_data));
-   filt->threads = 1;
-   filt->in_fmt  = in_fmt;
+   filt->threads   = threads;
+   filt->in_fmt    = in_fmt;
+   filt->max_width = max_width;
+   filt->simd      = simd;
    if (!filt->workers)
    {
       free(filt);
       return NULL;
    }
 
+   if (in_fmt == SOFTFILTER_FMT_RGB565)
+   {
+      /* The vector kernels are skipped without it */
+      for (i = 0; i < threads; i++)
+         filt->workers[i].yuv = (uint16_t*)malloc(
+               (max_width + 4) * sizeof(uint16_t));
+   }
+
    SetupFormat(filt);
 
    return filt;
@@ -256,11 +273,14 @@ static void twoxbr_generic_output(void *data,
 
 static void twoxbr_generic_destroy(void *data)
 {
+   unsigned i;
    struct filter_data *filt = (struct filter_data*)data;
 
    if (!filt)
       return;
 
+   for (i = 0; i < filt->threads; i++)
+      free(filt->workers[i].yuv);
    free(filt->workers);
    free(filt);
 }
@@ -535,39 +555,193 @@ int eq8(uint32_t A, uint32_t B,
          out += 2
 #endif
 
+/* Vector version of FILTRO_RGB565, for 16-bit lanes. The YUV
+ * value of every pixel X is in yX, so df() is a plain absolute
+ * difference; e and i wrap like the 16-bit scalar variables.
+ * (ke<<1)<=ki and ke>=(ki<<1) are tested as ke<=ki>>1 and
+ * ki<=ke>>1, which is the same for integers. */
+#define twoxbr_vdf(V, A, B) V##_absdiff(y##A, y##B)
+
+#define twoxbr_veq(V, A, B) V##_le(twoxbr_vdf(V, A, B), eq_limit)
+
+/* Per channel, the blends work out to
+ * dst + floor(k * (src - dst) / 256) */
+#define twoxbr_vblend_channel(V, dst, src, k) \
+   V##_add(dst, V##_sra(V##_mullo(V##_sub(src, dst), k), 8))
+
+#define twoxbr_vblend(V, dst, src, k) \
+   V##_or(V##_or( \
+      V##_sll(twoxbr_vblend_channel(V, V##_srl(dst, 11), \
+            V##_srl(src, 11), k), 11), \
+      V##_sll(twoxbr_vblend_channel(V, V##_and(V##_srl(dst, 5), mask6), \
+            V##_and(V##_srl(src, 5), mask6), k), 5)), \
+      twoxbr_vblend_channel(V, V##_and(dst, mask5), V##_and(src, mask5), k))
+
+#define twoxbr_vblend_128(V, dst, src) \
+   V##_add(V##_srl(V##_and(src, pg_lbmask), 1), \
+         V##_srl(V##_and(dst, pg_lbmask), 1))
+
+#define twoxbr_vfiltro(V, PE, _PI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, N0, N1, N2, N3) \
+     ex    = V##_and(V##_ne(PE, PH), V##_ne(PE, PF)); \
+     if (V##_any(ex)) \
+     { \
+        e     = V##_add(V##_add(V##_add(V##_add(twoxbr_vdf(V, PE, PC), \
+                    twoxbr_vdf(V, PE, PG)), twoxbr_vdf(V, _PI, H5)), \
+                 twoxbr_vdf(V, _PI, F4)), V##_sll(twoxbr_vdf(V, PH, PF), 2)); \
+        i     = V##_add(V##_add(V##_add(V##_add(twoxbr_vdf(V, PH, PD), \
+                    twoxbr_vdf(V, PH, I5)), twoxbr_vdf(V, PF, I4)), \
+                 twoxbr_vdf(V, PF, PB)), V##_sll(twoxbr_vdf(V, PE, _PI), 2)); \
+        lt    = V##_bic(ex, V##_le(i, e)); \
+        lte   = V##_and(ex, V##_le(e, i)); \
+        t1    = V##_and(V##_or(twoxbr_veq(V, PF, PB), twoxbr_veq(V, PF, PC)), \
+                 V##_or(twoxbr_veq(V, PH, PD), twoxbr_veq(V, PH, PG))); \
+        t2    = V##_and(V##_or(twoxbr_veq(V, PF, F4), twoxbr_veq(V, PF, I4)), \
+                 V##_or(twoxbr_veq(V, PH, H5), twoxbr_veq(V, PH, I5))); \
+        cond  = V##_or(V##_bic(lt, t1), V##_and(lt, V##_or(V##_or( \
+                    V##_bic(twoxbr_veq(V, PE, _PI), t2), \
+                    twoxbr_veq(V, PE, PG)), twoxbr_veq(V, PE, PC)))); \
+        ke    = twoxbr_vdf(V, PF, PG); \
+        ki    = twoxbr_vdf(V, PH, PC); \
+        ex2   = V##_and(V##_ne(PE, PC), V##_ne(PB, PC)); \
+        ex3   = V##_and(V##_ne(PE, PG), V##_ne(PD, PG)); \
+        px    = V##_sel(V##_le(twoxbr_vdf(V, PE, PF), twoxbr_vdf(V, PE, PH)), PF, PH); \
+        left  = V##_and(V##_and(cond, V##_le(ke, V##_srl(ki, 1))), ex3); \
+        up    = V##_and(V##_and(cond, V##_le(ki, V##_srl(ke, 1))), ex2); \
+        lu    = V##_and(left, up); \
+        if (V##_any(V##_or(cond, lte))) \
+        { \
+           b64   = twoxbr_vblend(V, E##N2, px, k64); \
+           E##N3 = V##_sel(lu, twoxbr_vblend(V, E##N3, px, k224), \
+                    V##_sel(V##_or(left, up), twoxbr_vblend(V, E##N3, px, k192), \
+                       V##_sel(V##_or(cond, lte), twoxbr_vblend_128(V, E##N3, px), E##N3))); \
+           E##N1 = V##_sel(lu, b64, V##_sel(V##_bic(up, left), \
+                    twoxbr_vblend(V, E##N1, px, k64), E##N1)); \
+           E##N2 = V##_sel(left, b64, E##N2); \
+        } \
+     }
+
+#define twoxbr_vload(V, P, col) \
+     P    = V##_load(in + x + (col)); \
+     y##P = V##_load(yuv + x + (col))
+
+/* The outer pixels are only ever compared through df() */
+#define twoxbr_vload_yuv(V, P, col) \
+     y##P = V##_load(yuv + x + (col))
+
+typedef unsigned (*twoxbr_span_t)(const uint16_t *in,
+      const uint16_t *yuv, uint16_t *out, unsigned dst_stride,
+      unsigned count);
+
+/* Filters the first 'count' pixels of a row, rounded down to
+ * whole vectors, and returns how many it did. 'yuv' holds the
+ * YUV values of the row. The neighbours above and below are
+ * read from the row itself, like the scalar path does. */
+#define twoxbr_span(name, target, V) \
+static target unsigned name(const uint16_t *in, \
+      const uint16_t *yuv, uint16_t *out, unsigned dst_stride, \
+      unsigned count) \
+{ \
+   unsigned x; \
+   V##_t eq_limit  = V##_set1(154); \
+   V##_t mask5     = V##_set1(0x1F); \
+   V##_t mask6     = V##_set1(0x3F); \
+   V##_t pg_lbmask = V##_set1(PG_LBMASK565); \
+   V##_t k64       = V##_set1(64); \
+   V##_t k192      = V##_set1(192); \
+   V##_t k224      = V##_set1(224); \
+   \
+   for (x = 0; x + V##_LANES <= count; x += V##_LANES) \
+   { \
+      V##_t PA, PB, PC, PD, PE, PF, PG, PH, _PI; \
+      V##_t yA1, yB1, yC1, yA0, yPA, yPB, yPC, yC4, yD0, yPD, yPE, yPF, yF4; \
+      V##_t yG0, yPG, yPH, y_PI, yI4, yG5, yH5, yI5; \
+      V##_t E0, E1, E2, E3; \
+      V##_t ex, e, i, lt, lte, t1, t2, cond, ke, ki, ex2, ex3, px; \
+      V##_t left, up, lu, b64; \
+      \
+      twoxbr_vload_yuv(V, A1, -1); \
+      twoxbr_vload_yuv(V, B1,  0); \
+      twoxbr_vload_yuv(V, C1,  1); \
+      twoxbr_vload_yuv(V, A0, -2); \
+      twoxbr_vload(V, PA, -1); \
+      twoxbr_vload(V, PB,  0); \
+      twoxbr_vload(V, PC,  1); \
+      twoxbr_vload_yuv(V, C4,  2); \
+      twoxbr_vload_yuv(V, D0, -2); \
+      twoxbr_vload(V, PD, -1); \
+      twoxbr_vload(V, PE,  0); \
+      twoxbr_vload(V, PF,  1); \
+      twoxbr_vload_yuv(V, F4,  2); \
+      twoxbr_vload_yuv(V, G0, -2); \
+      twoxbr_vload(V, PG, -1); \
+      twoxbr_vload(V, PH,  0); \
+      twoxbr_vload(V, _PI, 1); \
+      twoxbr_vload_yuv(V, I4,  2); \
+      twoxbr_vload_yuv(V, G5, -1); \
+      twoxbr_vload_yuv(V, H5,  0); \
+      twoxbr_vload_yuv(V, I5,  1); \
+      \
+      E0 = E1 = E2 = E3 = PE; \
+      twoxbr_vfiltro(V, PE, _PI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, 0, 1, 2, 3); \
+      twoxbr_vfiltro(V, PE, PC, PF, PB, _PI, PA, PH, PD, PG, I4, A1, I5, H5, A0, D0, B1, C1, F4, C4, G5, G0, 2, 0, 3, 1); \
+      twoxbr_vfiltro(V, PE, PA, PB, PD, PC, PG, PF, PH, _PI, C1, G0, C4, F4, G5, H5, D0, A0, B1, A1, I4, I5, 3, 2, 1, 0); \
+      twoxbr_vfiltro(V, PE, PG, PD, PH, PA, _PI, PB, PF, PC, A0, I5, A1, B1, I4, F4, H5, G5, D0, G0, C1, C4, 1, 3, 0, 2); \
+      \
+      V##_store2(out + 2 * x, E0, E1); \
+      V##_store2(out + 2 * x + dst_stride, E2, E3); \
+   } \
+   \
+   return x; \
+}
+
+#ifdef SOFTFILTER_HAVE_SSE2
+twoxbr_span(twoxbr_span_rgb565_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_16)
+#endif
+#ifdef SOFTFILTER_HAVE_AVX2
+twoxbr_span(twoxbr_span_rgb565_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_16)
+#endif
+#ifdef SOFTFILTER_HAVE_NEON
+twoxbr_span(twoxbr_span_rgb565_neon, SOFTFILTER_NEON_TARGET, sf_neon_16)
+#endif
+
 static void twoxbr_generic_xrgb8888(void *data, unsigned width, unsigned height,
       int first, int last, uint32_t *src,
       unsigned src_stride, uint32_t *dst, unsigned dst_stride)
 {
-   unsigned nextline, finish;
+   unsigned finish;
    uint32_t pg_red_mask      = RED_MASK8888;
    uint32_t pg_green_mask    = GREEN_MASK8888;
    uint32_t pg_blue_mask     = BLUE_MASK8888;
    uint32_t pg_lbmask        = PG_LBMASK8888;
    uint32_t pg_alpha_mask    = ALPHA_MASK8888;
    struct filter_data *filt = (struct filter_data*)data;
+   /* 2xBR ran as one band flagged 'last', so it never read the
+    * rows above or below. Keeping the offsets at zero keeps
+    * that output, and bands share no rows. */
+   const unsigned prevline   = 0;
+   const unsigned prevline2  = 0;
+   const unsigned nextline   = 0;
+   const unsigned nextline2  = 0;
 
    (void)filt;
 
-   nextline = (last) ? 0 : src_stride;
-
    for (; height; height--)
    {
-      uint32_t *in  = (uint32_t*)src;
-      uint32_t *out = (uint32_t*)dst;
+      uint32_t *in       = (uint32_t*)src;
+      uint32_t *out      = (uint32_t*)dst;
 
       for (finish = width; finish; finish -= 1)
       {
          uint32_t E[4];
          uint32_t ex, e, i, ke, ki, ex2, ex3, px;
-         uint32_t A1 = *(in - nextline - nextline - 1);
-         uint32_t B1 = *(in - nextline - nextline);
-         uint32_t C1 = *(in - nextline - nextline + 1);
-         uint32_t A0 = *(in - nextline - 2);
-         uint32_t PA = *(in - nextline - 1);
-         uint32_t PB = *(in - nextline);
-         uint32_t PC = *(in - nextline + 1);
-         uint32_t C4 = *(in - nextline + 2);
+         uint32_t A1 = *(in - prevline2 - 1);
+         uint32_t B1 = *(in - prevline2);
+         uint32_t C1 = *(in - prevline2 + 1);
+         uint32_t A0 = *(in - prevline - 2);
+         uint32_t PA = *(in - prevline - 1);
+         uint32_t PB = *(in - prevline);
+         uint32_t PC = *(in - prevline + 1);
+         uint32_t C4 = *(in - prevline + 2);
          uint32_t D0 = *(in - 2);
          uint32_t PD = *(in - 1);
          uint32_t PE = *(in);
@@ -578,9 +752,9 @@ static void twoxbr_generic_xrgb8888(void *data, unsigned width, unsigned height,
          uint32_t PH = *(in + nextline);
          uint32_t _PI = *(in + nextline + 1);
          uint32_t I4 = *(in + nextline + 2);
-         uint32_t G5 = *(in + nextline + nextline - 1);
-         uint32_t H5 = *(in + nextline + nextline);
-         uint32_t I5 = *(in + nextline + nextline + 1);
+         uint32_t G5 = *(in + nextline2 - 1);
+         uint32_t H5 = *(in + nextline2);
+         uint32_t I5 = *(in + nextline2 + 1);
 
          /*
           * Map of the pixels:          A1 B1 C1
@@ -598,35 +772,55 @@ static void twoxbr_generic_xrgb8888(void *data, unsigned width, unsigned height,
    }
 }
 
-static void twoxbr_generic_rgb565(void *data, unsigned width, unsigned height,
+static void twoxbr_generic_rgb565(void *data, twoxbr_span_t span,
+      uint16_t *yuv, unsigned width, unsigned height,
       int first, int last, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    unsigned finish;
+   int x;
    struct filter_data *filt = (struct filter_data*)data;
    uint16_t pg_red_mask     = RED_MASK565;
    uint16_t pg_green_mask   = GREEN_MASK565;
    uint16_t pg_blue_mask    = BLUE_MASK565;
    uint16_t pg_lbmask       = PG_LBMASK565;
-   unsigned nextline        = (last) ? 0 : src_stride;
+   const unsigned prevline  = 0;
+   const unsigned prevline2 = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint16_t *in  = (uint16_t*)src;
-      uint16_t *out = (uint16_t*)dst;
+      uint16_t *in       = (uint16_t*)src;
+      uint16_t *out      = (uint16_t*)dst;
 
-      for (finish = width; finish; finish -= 1)
+      finish             = width;
+
+      if (span)
+      {
+         unsigned done;
+
+         for (x = -2; x < (int)width + 2; x++)
+            yuv[x + 2]   = filt->RGBtoYUV[in[x]];
+
+         done            = span(in, yuv + 2, out, dst_stride, width);
+         in             += done;
+         out            += 2 * done;
+         finish         -= done;
+      }
+
+      for (; finish; finish -= 1)
       {
          uint16_t E[4];
          uint16_t ex, e, i, ke, ki, ex2, ex3, px;
-         uint16_t A1 = *(in - nextline - nextline - 1);
-         uint16_t B1 = *(in - nextline - nextline);
-         uint16_t C1 = *(in - nextline - nextline + 1);
-         uint16_t A0 = *(in - nextline - 2);
-         uint16_t PA = *(in - nextline - 1);
-         uint16_t PB = *(in - nextline);
-         uint16_t PC = *(in - nextline + 1);
-         uint16_t C4 = *(in - nextline + 2);
+         uint16_t A1 = *(in - prevline2 - 1);
+         uint16_t B1 = *(in - prevline2);
+         uint16_t C1 = *(in - prevline2 + 1);
+         uint16_t A0 = *(in - prevline - 2);
+         uint16_t PA = *(in - prevline - 1);
+         uint16_t PB = *(in - prevline);
+         uint16_t PC = *(in - prevline + 1);
+         uint16_t C4 = *(in - prevline + 2);
          uint16_t D0 = *(in - 2);
          uint16_t PD = *(in - 1);
          uint16_t PE = *(in);
@@ -637,9 +831,9 @@ static void twoxbr_generic_rgb565(void *data, unsigned width, unsigned height,
          uint16_t PH = *(in + nextline);
          uint16_t _PI = *(in + nextline + 1);
          uint16_t I4 = *(in + nextline + 2);
-         uint16_t G5 = *(in + nextline + nextline - 1);
-         uint16_t H5 = *(in + nextline + nextline);
-         uint16_t I5 = *(in + nextline + nextline + 1);
+         uint16_t G5 = *(in + nextline2 - 1);
+         uint16_t H5 = *(in + nextline2);
+         uint16_t I5 = *(in + nextline2 + 1);
 
          /*
           * Map of the pixels:          A1 B1 C1
@@ -659,14 +853,19 @@ static void twoxbr_generic_rgb565(void *data, unsigned width, unsigned height,
 
 static void twoxbr_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint16_t *input = (uint16_t*)thr->in_data;
    uint16_t *output = (uint16_t*)thr->out_data;
    unsigned width = thr->width;
    unsigned height = thr->height;
+   twoxbr_span_t span = NULL;
+
+   if (thr->yuv && width <= filt->max_width)
+      SOFTFILTER_SIMD_PICK(filt->simd, span, twoxbr_span_rgb565);
 
-   twoxbr_generic_rgb565(data, width, height,
+   twoxbr_generic_rgb565(data, span, thr->yuv, width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
@@ -702,9 +901,9 @@ static void twoxbr_generic_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
 
-      unsigned y_start = (height * i) / filt->threads;
-      unsigned y_end = (height * (i + 1)) / filt->threads;
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
       thr->out_data = (uint8_t*)output + y_start *
          TWOXBR_SCALE * output_stride;
@@ -714,11 +913,6 @@ static void twoxbr_generic_packets(void *data,
       thr->width = width;
       thr->height = y_end - y_start;
 
-      /* Workers need to know if they can access
-       * pixels outside their given buffer. */
-      thr->first = y_start;
-      thr->last = y_end == height;
-
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work = twoxbr_work_cb_rgb565;
 #if 0
@@ -15,6 +15,7 @@
  */
 
 #include "softfilter.h"
+#include "softfilter_simd.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -44,6 +45,7 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   softfilter_simd_mask_t simd;
 };
 
 static unsigned twoxsai_generic_input_fmts(void)
@@ -76,10 +78,9 @@ static void *twoxsai_generic_create(const struct softfilter_config *config,
       free(filt);
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
+   filt->simd    = simd;
    return filt;
 }
 
@@ -115,12 +116,12 @@ static void twoxsai_generic_destroy(void *data)
 
 #define twoxsai_result(A, B, C, D) (((A) != (C) || (A) != (D)) - ((B) != (C) || (B) != (D)));
 
-#define twoxsai_declare_variables(typename_t, in, nextline) \
+#define twoxsai_declare_variables(typename_t, in, prevline, nextline, nextline2) \
          typename_t product, product1, product2; \
-         typename_t colorI = *(in - nextline - 1); \
-         typename_t colorE = *(in - nextline + 0); \
-         typename_t colorF = *(in - nextline + 1); \
-         typename_t colorJ = *(in - nextline + 2); \
+         typename_t colorI = *(in - prevline - 1); \
+         typename_t colorE = *(in - prevline + 0); \
+         typename_t colorF = *(in - prevline + 1); \
+         typename_t colorJ = *(in - prevline + 2); \
          typename_t colorG = *(in - 1); \
          typename_t colorA = *(in + 0); \
          typename_t colorB = *(in + 1); \
@@ -129,9 +130,9 @@ static void twoxsai_generic_destroy(void *data)
          typename_t colorC = *(in + nextline + 0); \
          typename_t colorD = *(in + nextline + 1); \
          typename_t colorL = *(in + nextline + 2); \
-         typename_t colorM = *(in + nextline + nextline - 1); \
-         typename_t colorN = *(in + nextline + nextline + 0); \
-         typename_t colorO = *(in + nextline + nextline + 1);
+         typename_t colorM = *(in + nextline2 - 1); \
+         typename_t colorN = *(in + nextline2 + 0); \
+         typename_t colorO = *(in + nextline2 + 1);
 
 #ifndef twoxsai_function
 #define twoxsai_function(result_cb, interpolate_cb, interpolate2_cb) \
@@ -207,21 +208,162 @@ static void twoxsai_generic_destroy(void *data)
          out += 2
 #endif
 
-static void twoxsai_generic_xrgb8888(unsigned width, unsigned height,
+/* Vector versions of the interpolation and result macros,
+ * lane for lane the same arithmetic */
+#define twoxsai_vinterpolate(V, A, B, cmask, lmask) \
+   V##_add(V##_add(V##_srl(V##_and(A, cmask), 1), \
+            V##_srl(V##_and(B, cmask), 1)), \
+         V##_and(V##_and(A, B), lmask))
+
+#define twoxsai_vinterpolate2(V, A, B, C, D, qcmask, qlmask) \
+   V##_add(V##_add(V##_add(V##_add( \
+                  V##_srl(V##_and(A, qcmask), 2), \
+                  V##_srl(V##_and(B, qcmask), 2)), \
+               V##_srl(V##_and(C, qcmask), 2)), \
+            V##_srl(V##_and(D, qcmask), 2)), \
+         V##_and(V##_srl(V##_add(V##_add(V##_add( \
+                        V##_and(A, qlmask), V##_and(B, qlmask)), \
+                     V##_and(C, qlmask)), V##_and(D, qlmask)), 2), qlmask))
+
+/* Lanes are all ones for true, so the difference of the
+ * two masks is the scalar result */
+#define twoxsai_vresult(V, A, B, C, D) \
+   V##_sub(V##_or(V##_ne(B, C), V##_ne(B, D)), \
+         V##_or(V##_ne(A, C), V##_ne(A, D)))
+
+/* Expands the first 'count' pixels of a row, rounded down to
+ * whole vectors, and returns how many it did. Every branch of
+ * twoxsai_function() is computed and the products are picked
+ * with lane masks. The neighbours above and below are read
+ * from the row itself, like the scalar path does. */
+#define twoxsai_span(name, target, V, typename_t, cmask, lmask, qcmask, qlmask) \
+static target unsigned name(const typename_t *in, typename_t *out, \
+      unsigned dst_stride, unsigned count) \
+{ \
+   unsigned x; \
+   V##_t colorMask     = V##_set1(cmask); \
+   V##_t lowPixelMask  = V##_set1(lmask); \
+   V##_t qcolorMask    = V##_set1(qcmask); \
+   V##_t qlowpixelMask = V##_set1(qlmask); \
+   \
+   for (x = 0; x + V##_LANES <= count; x += V##_LANES) \
+   { \
+      const typename_t *p = in + x; \
+      V##_t colorI   = V##_load(p - 1); \
+      V##_t colorE   = V##_load(p + 0); \
+      V##_t colorF   = V##_load(p + 1); \
+      V##_t colorJ   = V##_load(p + 2); \
+      V##_t colorG   = V##_load(p - 1); \
+      V##_t colorA   = V##_load(p + 0); \
+      V##_t colorB   = V##_load(p + 1); \
+      V##_t colorK   = V##_load(p + 2); \
+      V##_t colorH   = V##_load(p - 1); \
+      V##_t colorC   = V##_load(p + 0); \
+      V##_t colorD   = V##_load(p + 1); \
+      V##_t colorL   = V##_load(p + 2); \
+      V##_t colorM   = V##_load(p - 1); \
+      V##_t colorN   = V##_load(p + 0); \
+      V##_t colorO   = V##_load(p + 1); \
+      V##_t a_eq_d   = V##_eq(colorA, colorD); \
+      V##_t b_eq_c   = V##_eq(colorB, colorC); \
+      /* The four branches */ \
+      V##_t case1    = V##_bic(a_eq_d, b_eq_c); \
+      V##_t case2    = V##_bic(b_eq_c, a_eq_d); \
+      V##_t case3    = V##_and(a_eq_d, b_eq_c); \
+      V##_t case4    = V##_bic(V##_ne(colorB, colorC), a_eq_d); \
+      V##_t p1       = V##_and(V##_and(V##_eq(colorA, colorC), V##_eq(colorA, colorF)), \
+            V##_bic(V##_eq(colorB, colorJ), V##_eq(colorB, colorE))); \
+      V##_t p2       = V##_and(V##_and(V##_eq(colorB, colorE), V##_eq(colorB, colorD)), \
+            V##_bic(V##_eq(colorA, colorI), V##_eq(colorA, colorF))); \
+      V##_t q1       = V##_and(V##_and(V##_eq(colorA, colorB), V##_eq(colorA, colorH)), \
+            V##_bic(V##_eq(colorC, colorM), V##_eq(colorG, colorC))); \
+      V##_t q2       = V##_and(V##_and(V##_eq(colorC, colorG), V##_eq(colorC, colorD)), \
+            V##_bic(V##_eq(colorA, colorI), V##_eq(colorA, colorH))); \
+      V##_t r        = twoxsai_vresult(V, colorA, colorB, colorG, colorE); \
+      V##_t pick_a, pick_b, product, product1, product2; \
+      \
+      r        = V##_add(r, twoxsai_vresult(V, colorB, colorA, colorK, colorF)); \
+      r        = V##_add(r, twoxsai_vresult(V, colorB, colorA, colorH, colorN)); \
+      r        = V##_add(r, twoxsai_vresult(V, colorA, colorB, colorL, colorO)); \
+      \
+      pick_a   = V##_or(V##_and(case1, V##_or(V##_and(V##_eq(colorA, colorE), \
+                     V##_eq(colorB, colorL)), p1)), V##_and(case4, p1)); \
+      pick_b   = V##_or(V##_and(case2, V##_or(V##_and(V##_eq(colorB, colorF), \
+                     V##_eq(colorA, colorH)), p2)), V##_and(case4, V##_bic(p2, p1))); \
+      product  = V##_sel(pick_a, colorA, V##_sel(pick_b, colorB, \
+               twoxsai_vinterpolate(V, colorA, colorB, colorMask, lowPixelMask))); \
+      \
+      pick_a   = V##_or(V##_and(case1, V##_or(V##_and(V##_eq(colorA, colorG), \
+                     V##_eq(colorC, colorO)), q1)), V##_and(case4, q1)); \
+      pick_b   = V##_or(V##_and(case2, V##_or(V##_and(V##_eq(colorC, colorH), \
+                     V##_eq(colorA, colorF)), q2)), V##_and(case4, V##_bic(q2, q1))); \
+      product1 = V##_sel(pick_a, colorA, V##_sel(pick_b, colorC, \
+               twoxsai_vinterpolate(V, colorA, colorC, colorMask, lowPixelMask))); \
+      \
+      pick_a   = V##_or(case1, V##_and(case3, V##_gtz(r))); \
+      pick_b   = V##_or(case2, V##_and(case3, V##_ltz(r))); \
+      product2 = V##_sel(pick_a, colorA, V##_sel(pick_b, colorB, \
+               twoxsai_vinterpolate2(V, colorA, colorB, colorC, colorD, \
+                  qcolorMask, qlowpixelMask))); \
+      \
+      V##_store2(out + 2 * x, colorA, product); \
+      V##_store2(out + 2 * x + dst_stride, product1, product2); \
+   } \
+   \
+   return x; \
+}
+
+typedef unsigned (*twoxsai_span_xrgb8888_t)(const uint32_t *in,
+      uint32_t *out, unsigned dst_stride, unsigned count);
+typedef unsigned (*twoxsai_span_rgb565_t)(const uint16_t *in,
+      uint16_t *out, unsigned dst_stride, unsigned count);
+
+#ifdef SOFTFILTER_HAVE_SSE2
+twoxsai_span(twoxsai_span_xrgb8888_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+twoxsai_span(twoxsai_span_rgb565_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+#ifdef SOFTFILTER_HAVE_AVX2
+twoxsai_span(twoxsai_span_xrgb8888_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+twoxsai_span(twoxsai_span_rgb565_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+#ifdef SOFTFILTER_HAVE_NEON
+twoxsai_span(twoxsai_span_xrgb8888_neon, SOFTFILTER_NEON_TARGET, sf_neon_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+twoxsai_span(twoxsai_span_rgb565_neon, SOFTFILTER_NEON_TARGET, sf_neon_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+
+static void twoxsai_generic_xrgb8888(twoxsai_span_xrgb8888_t span,
+      unsigned width, unsigned height,
       int first, int last, uint32_t *src,
       unsigned src_stride, uint32_t *dst, unsigned dst_stride)
 {
    unsigned finish;
-   unsigned nextline = (last) ? 0 : src_stride;
+
+   /* Rows are filtered on their own. This filter used to run as
+    * a single band flagged as the last one, which zeroed the
+    * offsets to the rows around it; keep that output. Bands
+    * then need no rows from each other. */
+   const unsigned prevline  = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint32_t *in  = (uint32_t*)src;
-      uint32_t *out = (uint32_t*)dst;
+      uint32_t *in       = (uint32_t*)src;
+      uint32_t *out      = (uint32_t*)dst;
+      unsigned done      = span ? span(in, out, dst_stride, width) : 0;
 
-      for (finish = width; finish; finish -= 1)
+      in                += done;
+      out               += 2 * done;
+
+      for (finish = width - done; finish; finish -= 1)
       {
-         twoxsai_declare_variables(uint32_t, in, nextline);
+         twoxsai_declare_variables(uint32_t, in, prevline, nextline, nextline2);
 
          /*
           * Map of the pixels:           I|E F|J
@@ -239,21 +381,28 @@ static void twoxsai_generic_xrgb8888(unsigned width, unsigned height,
    }
 }
 
-static void twoxsai_generic_rgb565(unsigned width, unsigned height,
+static void twoxsai_generic_rgb565(twoxsai_span_rgb565_t span,
+      unsigned width, unsigned height,
       int first, int last, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    unsigned finish;
-   unsigned nextline = (last) ? 0 : src_stride;
+   const unsigned prevline  = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint16_t *in  = (uint16_t*)src;
-      uint16_t *out = (uint16_t*)dst;
+      uint16_t *in       = (uint16_t*)src;
+      uint16_t *out      = (uint16_t*)dst;
+      unsigned done      = span ? span(in, out, dst_stride, width) : 0;
+
+      in                += done;
+      out               += 2 * done;
 
-      for (finish = width; finish; finish -= 1)
+      for (finish = width - done; finish; finish -= 1)
       {
-         twoxsai_declare_variables(uint16_t, in, nextline);
+         twoxsai_declare_variables(uint16_t, in, prevline, nextline, nextline2);
 
          /*
           * Map of the pixels:           I|E F|J
@@ -273,13 +422,18 @@ static void twoxsai_generic_rgb565(unsigned width, unsigned height,
 
 static void twoxsai_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint16_t *input                    = (uint16_t*)thr->in_data;
    uint16_t *output                   = (uint16_t*)thr->out_data;
    unsigned width                     = thr->width;
    unsigned height                    = thr->height;
-   twoxsai_generic_rgb565(width, height,
+   twoxsai_span_rgb565_t span         = NULL;
+
+   SOFTFILTER_SIMD_PICK(filt->simd, span, twoxsai_span_rgb565);
+
+   twoxsai_generic_rgb565(span, width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
@@ -288,13 +442,18 @@ static void twoxsai_work_cb_rgb565(void *data, void *thread_data)
 
 static void twoxsai_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint32_t *input                    = (uint32_t*)thr->in_data;
    uint32_t *output                   = (uint32_t*)thr->out_data;
    unsigned width                     = thr->width;
    unsigned height                    = thr->height;
-   twoxsai_generic_xrgb8888(width, height,
+   twoxsai_span_xrgb8888_t span       = NULL;
+
+   SOFTFILTER_SIMD_PICK(filt->simd, span, twoxsai_span_xrgb8888);
+
+   twoxsai_generic_xrgb8888(span, width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
          output,
@@ -314,9 +473,9 @@ static void twoxsai_generic_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
 
-      unsigned y_start       = (height * i) / filt->threads;
-      unsigned y_end         = (height * (i + 1)) / filt->threads;
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
       thr->out_data          = (uint8_t*)output + y_start *
          TWOXSAI_SCALE * output_stride;
@@ -326,12 +485,6 @@ static void twoxsai_generic_packets(void *data,
       thr->width             = width;
       thr->height            = y_end - y_start;
 
-      /* Workers need to know if they can access pixels
-       * outside their given buffer.
-       */
-      thr->first             = y_start;
-      thr->last              = y_end == height;
-
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work     = twoxsai_work_cb_rgb565;
 #if 0
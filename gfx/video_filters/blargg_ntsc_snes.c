@@ -42,6 +42,7 @@ struct softfilter_thread_data
    unsigned height;
    int first;
    int last;
+   int burst;
 };
 
 struct filter_data
@@ -170,9 +171,7 @@ static void *blargg_ntsc_snes_generic_create(const struct softfilter_config *con
       free(filt);
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
 
    blargg_ntsc_snes_initialize(filt, config, userdata);
@@ -203,26 +202,24 @@ static void blargg_ntsc_snes_generic_destroy(void *data)
 }
 
 static void blargg_ntsc_snes_render_rgb565(void *data, int width, int height,
-      int first, int last,
+      int first, int last, int burst,
       uint16_t *input, int pitch, uint16_t *output, int outpitch)
 {
    struct filter_data *filt = (struct filter_data*)data;
    if (width <= 256 || !hires_blit)
-      retroarch_snes_ntsc_blit(filt->ntsc, input, pitch, filt->burst,
+      retroarch_snes_ntsc_blit(filt->ntsc, input, pitch, burst,
             width, height, output, outpitch * 2, first, last);
    else
-      retroarch_snes_ntsc_blit_hires(filt->ntsc, input, pitch, filt->burst,
+      retroarch_snes_ntsc_blit_hires(filt->ntsc, input, pitch, burst,
             width, height, output, outpitch * 2, first, last);
-
-   filt->burst ^= filt->burst_toggle;
 }
 
 static void blargg_ntsc_snes_rgb565(void *data, unsigned width, unsigned height,
-      int first, int last, uint16_t *src,
+      int first, int last, int burst, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    blargg_ntsc_snes_render_rgb565(data, width, height,
-         first, last,
+         first, last, burst,
          src, src_stride,
          dst, dst_stride);
 }
@@ -236,7 +233,7 @@ static void blargg_ntsc_snes_work_cb_rgb565(void *data, void *thread_data)
    unsigned width                     = thr->width;
    unsigned height                    = thr->height;
    blargg_ntsc_snes_rgb565(data, width, height,
-         thr->first, thr->last, input,
+         thr->first, thr->last, thr->burst, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
          (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565));
@@ -253,9 +250,10 @@ static void blargg_ntsc_snes_generic_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
-      unsigned y_start                   = (height * i) / filt->threads;
-      unsigned y_end                     = (height * (i + 1)) / filt->threads;
       thr->out_data                      = (uint8_t*)output + y_start * output_stride;
       thr->in_data                       = (const uint8_t*)input + y_start * input_stride;
       thr->out_pitch                     = output_stride;
@@ -263,16 +261,22 @@ static void blargg_ntsc_snes_generic_packets(void *data,
       thr->width                         = width;
       thr->height                        = y_end - y_start;
 
-      /* Workers need to know if they can
-       * access pixels outside their given buffer. */
+      /* Number of rows above and below the band,
+       * which workers may read as halo. */
       thr->first                         = y_start;
-      thr->last                          = y_end == height;
+      thr->last                          = height - y_end;
+
+      /* The burst phase advances by one every row */
+      thr->burst                         = (filt->burst + y_start)
+         % snes_ntsc_burst_count;
 
       /* TODO/FIXME - no XRGB8888 codepath? */
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work                 = blargg_ntsc_snes_work_cb_rgb565;
       packets[i].thread_data             = thr;
    }
+
+   filt->burst ^= filt->burst_toggle;
 }
 
 static const struct softfilter_implementation blargg_ntsc_snes_generic = {
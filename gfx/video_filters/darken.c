@@ -139,8 +139,9 @@ static void darken_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
-      unsigned y_start                   = (height * i) / filt->threads;
-      unsigned y_end                     = (height * (i + 1)) / filt->threads;
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
       thr->out_data                      = (uint8_t*)output + y_start * output_stride;
       thr->in_data                       = (const uint8_t*)input + y_start * input_stride;
@@ -15,6 +15,7 @@
  */
 
 #include "softfilter.h"
+#include "softfilter_simd.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -41,13 +42,58 @@ struct softfilter_thread_data
    int last;
 };
 
+/* Expands 'count' pixels from the middle of a row, which all
+ * have both horizontal neighbours, and returns how many it did.
+ * The scalar code takes care of the rest of the row. */
+typedef unsigned (*epx_span_t)(const uint16_t *src,
+      const uint16_t *up, const uint16_t *down,
+      uint16_t *out0, uint16_t *out1, unsigned count);
+
 struct filter_data
 {
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   epx_span_t span;
 };
 
+#define epx_span(name, target, V) \
+static target unsigned name(const uint16_t *src, \
+      const uint16_t *up, const uint16_t *down, \
+      uint16_t *out0, uint16_t *out1, unsigned count) \
+{ \
+   unsigned x; \
+   \
+   for (x = 0; x + V##_LANES <= count; x += V##_LANES) \
+   { \
+      V##_t colorA = V##_load(src + x - 1); \
+      V##_t colorX = V##_load(src + x); \
+      V##_t colorC = V##_load(src + x + 1); \
+      V##_t colorB = V##_load(down + x); \
+      V##_t colorD = V##_load(up + x); \
+      V##_t cond   = V##_and(V##_ne(colorA, colorC), V##_ne(colorB, colorD)); \
+      \
+      V##_store2(out0 + 2 * x, \
+            V##_sel(V##_and(cond, V##_eq(colorD, colorA)), colorD, colorX), \
+            V##_sel(V##_and(cond, V##_eq(colorC, colorD)), colorC, colorX)); \
+      V##_store2(out1 + 2 * x, \
+            V##_sel(V##_and(cond, V##_eq(colorA, colorB)), colorA, colorX), \
+            V##_sel(V##_and(cond, V##_eq(colorB, colorC)), colorB, colorX)); \
+   } \
+   \
+   return x; \
+}
+
+#ifdef SOFTFILTER_HAVE_SSE2
+epx_span(epx_span_rgb565_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_16)
+#endif
+#ifdef SOFTFILTER_HAVE_AVX2
+epx_span(epx_span_rgb565_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_16)
+#endif
+#ifdef SOFTFILTER_HAVE_NEON
+epx_span(epx_span_rgb565_neon, SOFTFILTER_NEON_TARGET, sf_neon_16)
+#endif
+
 static unsigned epx_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_RGB565;
@@ -79,8 +125,10 @@ static void *epx_generic_create(const struct softfilter_config *config,
       free(filt);
       return NULL;
    }
-   filt->threads            = 1;
+   filt->threads            = threads;
    filt->in_fmt             = in_fmt;
+   filt->span               = NULL;
+   SOFTFILTER_SIMD_PICK(simd, filt->span, epx_span_rgb565);
    return filt;
 }
 
@@ -103,18 +151,23 @@ static void epx_generic_destroy(void *data)
    free(filt);
 }
 
-static void epx_generic_rgb565 (unsigned width, unsigned height,
-      int first, int lsat, uint16_t *src,
+static void epx_generic_rgb565(epx_span_t span,
+      unsigned width, unsigned height,
+      int first, int last, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    uint16_t colorA;
    int w;
+   unsigned above = first;
 
-   for (; height; height--)
+   for (; height; height--, above++)
    {
+      /* Neighbouring rows, clamped to the edges of the frame.
+       * Rows outside the band are its halo. */
+      unsigned below  = last + height - 1;
       uint16_t *sP    = (uint16_t *) src;
-      uint16_t *uP    = (uint16_t *) (src - src_stride);
-      uint16_t *lP    = (uint16_t *) (src + src_stride);
+      uint16_t *uP    = (uint16_t *) (above ? src - src_stride : src);
+      uint16_t *lP    = (uint16_t *) (below ? src + src_stride : src);
       uint32_t *dP1   = (uint32_t *) dst;
       uint32_t *dP2   = (uint32_t *) (dst + dst_stride);
 
@@ -123,6 +176,7 @@ static void epx_generic_rgb565 (unsigned width, unsigned height,
       uint16_t colorC = *++sP;
       uint16_t colorB = *lP++;
       uint16_t colorD = *uP++;
+      unsigned done;
 
       if ((colorX != colorC) && (colorB != colorD))
       {
@@ -140,7 +194,18 @@ static void epx_generic_rgb565 (unsigned width, unsigned height,
       dP1++;
       dP2++;
 
-      for (w = width - 2; w; w--)
+      /* Vectorized middle of the row */
+      done    = span ? span(sP, uP, lP,
+            (uint16_t*)dP1, (uint16_t*)dP2, width - 2) : 0;
+      sP     += done;
+      uP     += done;
+      lP     += done;
+      dP1    += done;
+      dP2    += done;
+      colorX  = sP[-1];
+      colorC  = *sP;
+
+      for (w = width - 2 - done; w; w--)
       {
          colorA = colorX;
          colorX = colorC;
@@ -193,12 +258,13 @@ static void epx_work_cb_rgb565(void *data, void *thread_data)
 {
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
-   uint16_t *input  = (uint16_t*)thr->in_data;
-   uint16_t *output = (uint16_t*)thr->out_data;
-   unsigned width   = thr->width;
-   unsigned height  = thr->height;
+   struct filter_data *filt = (struct filter_data*)data;
+   uint16_t *input          = (uint16_t*)thr->in_data;
+   uint16_t *output         = (uint16_t*)thr->out_data;
+   unsigned width           = thr->width;
+   unsigned height          = thr->height;
 
-   epx_generic_rgb565(width, height,
+   epx_generic_rgb565(filt->span, width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
@@ -217,9 +283,10 @@ static void epx_generic_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
-      unsigned y_start   = (height * i) / filt->threads;
-      unsigned y_end     = (height * (i + 1)) / filt->threads;
       thr->out_data      = (uint8_t*)output + y_start * EPX_SCALE * output_stride;
       thr->in_data       = (const uint8_t*)input + y_start * input_stride;
       thr->out_pitch     = output_stride;
@@ -227,10 +294,10 @@ static void epx_generic_packets(void *data,
       thr->width         = width;
       thr->height        = y_end - y_start;
 
-      /* Workers need to know if they can
-       * access pixels outside their given buffer. */
+      /* Number of rows above and below the band,
+       * which workers may read as halo. */
       thr->first         = y_start;
-      thr->last          = y_end == height;
+      thr->last          = height - y_end;
 
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work = epx_work_cb_rgb565;
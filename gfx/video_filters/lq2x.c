@@ -75,9 +75,7 @@ static void *lq2x_generic_create(const struct softfilter_config *config,
       free(filt);
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
    return filt;
 }
@@ -111,8 +109,12 @@ static void lq2x_generic_rgb565(unsigned width, unsigned height,
 
    for (y = 0; y < height; y++)
    {
-      int prevline = (y == 0 ? 0 : src_stride);
-      int nextline = (y == height - 1 || last) ? 0 : src_stride;
+      /* The row above comes from the frame, so bands may read
+       * the last row of the band before them. The row below was
+       * never used: the filter ran as a single band flagged as
+       * the last one. */
+      int prevline = (first + y == 0) ? 0 : src_stride;
+      int nextline = 0;
 
       for (x = 0; x < width; x++)
       {
@@ -155,8 +157,8 @@ static void lq2x_generic_xrgb8888(unsigned width, unsigned height,
 
    for (y = 0; y < height; y++)
    {
-      int prevline = (y == 0 ? 0 : src_stride);
-      int nextline = (y == height - 1 || last) ? 0 : src_stride;
+      int prevline = (first + y == 0) ? 0 : src_stride;
+      int nextline = 0;
 
       for (x = 0; x < width; x++)
       {
@@ -231,9 +233,10 @@ static void lq2x_generic_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
-      unsigned y_start       = (height * i) / filt->threads;
-      unsigned y_end         = (height * (i + 1)) / filt->threads;
       thr->out_data          = (uint8_t*)output + y_start * LQ2X_SCALE * output_stride;
       thr->in_data           = (const uint8_t*)input + y_start * input_stride;
       thr->out_pitch         = output_stride;
@@ -241,10 +244,8 @@ static void lq2x_generic_packets(void *data,
       thr->width             = width;
       thr->height            = y_end - y_start;
 
-      /* Workers need to know if they can access pixels
-       * outside their given buffer. */
+      /* Row of the frame the band starts at */
       thr->first             = y_start;
-      thr->last              = y_end == height;
 
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work     = lq2x_work_cb_rgb565;
@@ -242,9 +242,7 @@ static void *phosphor2x_generic_create(const struct softfilter_config *config,
       free(filt);
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->threads        = 1;
+   filt->threads        = threads;
    filt->in_fmt         = in_fmt;
 
    filt->phosphor_bleed = 0.78;
@@ -429,9 +427,10 @@ static void phosphor2x_generic_packets(void *data,
    {
       struct softfilter_thread_data *thr =
          (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
-      unsigned y_start       = (height * i) / filt->threads;
-      unsigned y_end         = (height * (i + 1)) / filt->threads;
       thr->out_data          = (uint8_t*)output + y_start * PHOSPHOR2X_SCALE * output_stride;
       thr->in_data           = (const uint8_t*)input + y_start * input_stride;
       thr->out_pitch         = output_stride;
@@ -439,10 +438,10 @@ static void phosphor2x_generic_packets(void *data,
       thr->width             = width;
       thr->height            = y_end - y_start;
 
-      /* Workers need to know if they can access pixels
-       * outside their given buffer. */
+      /* Number of rows above and below the band,
+       * which workers may read as halo. */
       thr->first             = y_start;
-      thr->last              = y_end == height;
+      thr->last              = height - y_end;
 
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work     = phosphor2x_work_cb_rgb565;
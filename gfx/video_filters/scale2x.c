@@ -17,6 +17,7 @@
 /* Compile: gcc -o scale2x.so -shared scale2x.c -std=c99 -O3 -Wall -pedantic -fPIC */
 
 #include "softfilter.h"
+#include "softfilter_simd.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -44,6 +45,7 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   softfilter_simd_mask_t simd;
 };
 
 static unsigned scale2x_generic_input_fmts(void)
@@ -79,6 +81,8 @@ static void *scale2x_generic_create(const struct softfilter_config *config,
     * so force single threaded operation... */
    filt->threads = 1;
    filt->in_fmt  = in_fmt;
+   filt->simd    = simd;
+
    return filt;
 }
 
@@ -99,6 +103,32 @@ static void scale2x_generic_destroy(void *data)
    free(filt);
 }
 
+/* Expands the pixel at 'input' into two pixels on
+ * each of 'output0' and 'output1', and advances all three */
+#define scale2x_function(typename_t) \
+         /* Get sample points */ \
+         typename_t A = *(input - line_prev); \
+         typename_t B = (x > 0) ? *(input - 1) : *input; \
+         typename_t C = *input; \
+         typename_t D = (x < thr->width - 1) ? *(input + 1) : *input; \
+         typename_t E = *(input++ + line_next); \
+         \
+         /* Apply pixel expansion algorithm */ \
+         if (A != E && B != D) \
+         { \
+            *output0++ = (A == B ? A : C); \
+            *output0++ = (A == D ? A : C); \
+            *output1++ = (E == B ? E : C); \
+            *output1++ = (E == D ? E : C); \
+         } \
+         else \
+         { \
+            *output0++ = C; \
+            *output0++ = C; \
+            *output1++ = C; \
+            *output1++ = C; \
+         }
+
 static void scale2x_work_cb_xrgb8888(void *data, void *thread_data)
 {
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
@@ -117,28 +147,7 @@ static void scale2x_work_cb_xrgb8888(void *data, void *thread_data)
 
       for (x = 0; x < thr->width; x++)
       {
-         /* Get sample points */
-         uint32_t A = *(input - line_prev);
-         uint32_t B = (x > 0) ? *(input - 1) : *input;
-         uint32_t C = *input;
-         uint32_t D = (x < thr->width - 1) ? *(input + 1) : *input;
-         uint32_t E = *(input++ + line_next);
-
-         /* Apply pixel expansion algorithm */
-         if (A != E && B != D)
-         {
-            *output0++ = (A == B ? A : C);
-            *output0++ = (A == D ? A : C);
-            *output1++ = (E == B ? E : C);
-            *output1++ = (E == D ? E : C);
-         }
-         else
-         {
-            *output0++ = C;
-            *output0++ = C;
-            *output1++ = C;
-            *output1++ = C;
-         }
+         scale2x_function(uint32_t);
       }
 
       input   += in_stride - thr->width;
@@ -165,28 +174,7 @@ static void scale2x_work_cb_rgb565(void *data, void *thread_data)
 
       for (x = 0; x < thr->width; x++)
       {
-         /* Get sample points */
-         uint16_t A = *(input - line_prev);
-         uint16_t B = (x > 0) ? *(input - 1) : *input;
-         uint16_t C = *input;
-         uint16_t D = (x < thr->width - 1) ? *(input + 1) : *input;
-         uint16_t E = *(input++ + line_next);
-
-         /* Apply pixel expansion algorithm */
-         if (A != E && B != D)
-         {
-            *output0++ = (A == B ? A : C);
-            *output0++ = (A == D ? A : C);
-            *output1++ = (E == B ? E : C);
-            *output1++ = (E == D ? E : C);
-         }
-         else
-         {
-            *output0++ = C;
-            *output0++ = C;
-            *output1++ = C;
-            *output1++ = C;
-         }
+         scale2x_function(uint16_t);
       }
 
       input   += in_stride - thr->width;
@@ -195,6 +183,74 @@ static void scale2x_work_cb_rgb565(void *data, void *thread_data)
    }
 }
 
+/* Vector version of scale2x_function(), for every pixel
+ * that has both horizontal neighbours; the first and last
+ * pixel of each row use the scalar code. Produces the same
+ * output as the scalar callbacks. */
+#define scale2x_simd_work_cb(name, target, V, typename_t, bpp_shift) \
+static target void name(void *data, void *thread_data) \
+{ \
+   struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data; \
+   uint32_t in_stride                 = (uint32_t)(thr->in_pitch >> bpp_shift); \
+   uint32_t out_stride                = (uint32_t)(thr->out_pitch >> bpp_shift); \
+   unsigned x, y; \
+   \
+   for (y = 0; y < thr->height; y++) \
+   { \
+      const typename_t *input = (const typename_t*)thr->in_data + y * in_stride; \
+      typename_t *output0     = (typename_t*)thr->out_data + (y << 1) * out_stride; \
+      typename_t *output1     = output0 + out_stride; \
+      uint32_t line_prev      = (y == 0)               ? 0 : in_stride; \
+      uint32_t line_next      = (y == thr->height - 1) ? 0 : in_stride; \
+      \
+      for (x = 0; x < 1 && x < thr->width; x++) \
+      { \
+         scale2x_function(typename_t); \
+      } \
+      \
+      for (; x + V##_LANES < thr->width; x += V##_LANES) \
+      { \
+         V##_t A    = V##_load(input - line_prev); \
+         V##_t B    = V##_load(input - 1); \
+         V##_t C    = V##_load(input); \
+         V##_t D    = V##_load(input + 1); \
+         V##_t E    = V##_load(input + line_next); \
+         V##_t cond = V##_and(V##_ne(A, E), V##_ne(B, D)); \
+         \
+         V##_store2(output0, \
+               V##_sel(V##_and(cond, V##_eq(A, B)), A, C), \
+               V##_sel(V##_and(cond, V##_eq(A, D)), A, C)); \
+         V##_store2(output1, \
+               V##_sel(V##_and(cond, V##_eq(E, B)), E, C), \
+               V##_sel(V##_and(cond, V##_eq(E, D)), E, C)); \
+         \
+         input   += V##_LANES; \
+         output0 += V##_LANES << 1; \
+         output1 += V##_LANES << 1; \
+      } \
+      \
+      for (; x < thr->width; x++) \
+      { \
+         scale2x_function(typename_t); \
+      } \
+   } \
+}
+
+#ifdef SOFTFILTER_HAVE_SSE2
+scale2x_simd_work_cb(scale2x_work_cb_xrgb8888_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_32, uint32_t, 2)
+scale2x_simd_work_cb(scale2x_work_cb_rgb565_sse2,   SOFTFILTER_SSE2_TARGET, sf_sse2_16, uint16_t, 1)
+#endif
+
+#ifdef SOFTFILTER_HAVE_AVX2
+scale2x_simd_work_cb(scale2x_work_cb_xrgb8888_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_32, uint32_t, 2)
+scale2x_simd_work_cb(scale2x_work_cb_rgb565_avx2,   SOFTFILTER_AVX2_TARGET, sf_avx2_16, uint16_t, 1)
+#endif
+
+#ifdef SOFTFILTER_HAVE_NEON
+scale2x_simd_work_cb(scale2x_work_cb_xrgb8888_neon, SOFTFILTER_NEON_TARGET, sf_neon_32, uint32_t, 2)
+scale2x_simd_work_cb(scale2x_work_cb_rgb565_neon,   SOFTFILTER_NEON_TARGET, sf_neon_16, uint16_t, 1)
+#endif
+
 static void scale2x_generic_packets(void *data,
       struct softfilter_work_packet *packets,
       void *output, size_t output_stride,
@@ -216,9 +272,15 @@ static void scale2x_generic_packets(void *data,
    thr->height                        = height;
 
    if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888)
+   {
       packets[0].work                 = scale2x_work_cb_xrgb8888;
+      SOFTFILTER_SIMD_PICK(filt->simd, packets[0].work, scale2x_work_cb_xrgb8888);
+   }
    else if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
+   {
       packets[0].work                 = scale2x_work_cb_rgb565;
+      SOFTFILTER_SIMD_PICK(filt->simd, packets[0].work, scale2x_work_cb_rgb565);
+   }
    packets[0].thread_data             = thr;
 }
 
@@ -20,6 +20,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <retro_inline.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -99,6 +101,17 @@ const struct softfilter_implementation *softfilter_get_implementation(
 
 #define SOFTFILTER_API_VERSION  2
 
+/* Returns the rows [*y_start, *y_end) of a frame 'height' rows
+ * tall that work packet 'index' out of 'threads' handles. This
+ * is the split the frontend's band pool uses for its own bands. */
+static INLINE void softfilter_get_band(unsigned height,
+      unsigned index, unsigned threads,
+      unsigned *y_start, unsigned *y_end)
+{
+   *y_start = height * index       / threads;
+   *y_end   = height * (index + 1) / threads;
+}
+
 /* Required base color formats */
 
 #define SOFTFILTER_FMT_NONE     0
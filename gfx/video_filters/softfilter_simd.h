@@ -0,0 +1,552 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SOFTFILTER_SIMD_H__
+#define SOFTFILTER_SIMD_H__
+
+/* Integer vector operations shared by the SIMD filter kernels.
+ *
+ * Every operation set is named after the instruction set and
+ * the lane size, so that a kernel can be written once as a macro
+ * taking the set as its argument, e.g. sf_sse2_16 (8 lanes of
+ * RGB565) or sf_avx2_32 (8 lanes of XRGB8888):
+ *
+ *    V##_t             vector type
+ *    V##_LANES         pixels per vector
+ *    V##_load(p)       unaligned load
+ *    V##_store(p, a)   unaligned store
+ *    V##_store2(p, a, b)
+ *                      stores a and b interleaved, a first
+ *    V##_set1(x)       broadcast
+ *    V##_eq, V##_ne    comparisons, giving all-ones lanes when true
+ *    V##_gtz, V##_ltz  signed comparison against zero
+ *    V##_and, V##_or, V##_xor
+ *    V##_bic(a, b)     a & ~b
+ *    V##_sel(m, a, b)  m ? a : b, for every lane
+ *    V##_add, V##_sub  wrapping arithmetic
+ *    V##_srl(a, n)     logical shift right by a constant
+ *    V##_any(m)        whether any lane of a comparison result is set
+ *
+ * The 16-bit sets add
+ *
+ *    V##_absdiff(a, b) |a - b|, unsigned
+ *    V##_le(a, b)      a <= b, unsigned
+ *    V##_sll(a, n), V##_sra(a, n)
+ *    V##_mullo(a, b)   low half of the product
+ *
+ * AVX2 kernels are built with a per-function target attribute and
+ * only selected when the frontend reports SOFTFILTER_SIMD_AVX2, so
+ * the filters do not need to be compiled with -mavx2. */
+
+#include <stdint.h>
+#include <retro_inline.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTFILTER_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SOFTFILTER_HAVE_SSE2)
+#if defined(__AVX2__)
+#define SOFTFILTER_HAVE_AVX2
+#define SOFTFILTER_AVX2_TARGET
+#elif defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define SOFTFILTER_HAVE_AVX2
+#define SOFTFILTER_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1700
+#define SOFTFILTER_HAVE_AVX2
+#define SOFTFILTER_AVX2_TARGET
+#endif
+#endif
+
+#ifdef SOFTFILTER_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(HAVE_NEON)
+#define SOFTFILTER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+/* Function attributes of the kernels, by instruction set */
+#define SOFTFILTER_SSE2_TARGET
+#define SOFTFILTER_NEON_TARGET
+
+/* Replaces 'fn' with the fastest of name##_avx2, name##_sse2
+ * and name##_neon that is built in and that the host supports,
+ * according to the SIMD mask passed to the filter. */
+#if defined(SOFTFILTER_HAVE_AVX2)
+#define SOFTFILTER_SIMD_PICK(simd, fn, name) \
+   do { \
+      if ((simd) & SOFTFILTER_SIMD_AVX2) \
+         fn = name##_avx2; \
+      else if ((simd) & SOFTFILTER_SIMD_SSE2) \
+         fn = name##_sse2; \
+   } while (0)
+#elif defined(SOFTFILTER_HAVE_SSE2)
+#define SOFTFILTER_SIMD_PICK(simd, fn, name) \
+   do { \
+      if ((simd) & SOFTFILTER_SIMD_SSE2) \
+         fn = name##_sse2; \
+   } while (0)
+#elif defined(SOFTFILTER_HAVE_NEON)
+#define SOFTFILTER_SIMD_PICK(simd, fn, name) \
+   do { \
+      if ((simd) & SOFTFILTER_SIMD_NEON) \
+         fn = name##_neon; \
+   } while (0)
+#else
+#define SOFTFILTER_SIMD_PICK(simd, fn, name) do { } while (0)
+#endif
+
+#ifdef SOFTFILTER_HAVE_SSE2
+typedef __m128i sf_sse2_16_t;
+typedef __m128i sf_sse2_32_t;
+
+#define sf_sse2_16_LANES 8
+#define sf_sse2_32_LANES 4
+
+#define sf_sse2_16_srl(a, n) _mm_srli_epi16(a, n)
+#define sf_sse2_32_srl(a, n) _mm_srli_epi32(a, n)
+#define sf_sse2_16_sll(a, n) _mm_slli_epi16(a, n)
+#define sf_sse2_16_sra(a, n) _mm_srai_epi16(a, n)
+
+static INLINE __m128i sf_sse2_16_load(const uint16_t *p)
+{
+   return _mm_loadu_si128((const __m128i*)p);
+}
+
+static INLINE __m128i sf_sse2_32_load(const uint32_t *p)
+{
+   return _mm_loadu_si128((const __m128i*)p);
+}
+
+static INLINE void sf_sse2_16_store(uint16_t *p, __m128i a)
+{
+   _mm_storeu_si128((__m128i*)p, a);
+}
+
+static INLINE void sf_sse2_32_store(uint32_t *p, __m128i a)
+{
+   _mm_storeu_si128((__m128i*)p, a);
+}
+
+static INLINE void sf_sse2_16_store2(uint16_t *p, __m128i a, __m128i b)
+{
+   _mm_storeu_si128((__m128i*)p,     _mm_unpacklo_epi16(a, b));
+   _mm_storeu_si128((__m128i*)p + 1, _mm_unpackhi_epi16(a, b));
+}
+
+static INLINE void sf_sse2_32_store2(uint32_t *p, __m128i a, __m128i b)
+{
+   _mm_storeu_si128((__m128i*)p,     _mm_unpacklo_epi32(a, b));
+   _mm_storeu_si128((__m128i*)p + 1, _mm_unpackhi_epi32(a, b));
+}
+
+static INLINE __m128i sf_sse2_16_set1(uint16_t x)
+{
+   return _mm_set1_epi16((short)x);
+}
+
+static INLINE __m128i sf_sse2_32_set1(uint32_t x)
+{
+   return _mm_set1_epi32((int)x);
+}
+
+static INLINE __m128i sf_sse2_16_eq(__m128i a, __m128i b)
+{
+   return _mm_cmpeq_epi16(a, b);
+}
+
+static INLINE __m128i sf_sse2_32_eq(__m128i a, __m128i b)
+{
+   return _mm_cmpeq_epi32(a, b);
+}
+
+static INLINE __m128i sf_sse2_16_ne(__m128i a, __m128i b)
+{
+   return _mm_xor_si128(_mm_cmpeq_epi16(a, b), _mm_set1_epi32(-1));
+}
+
+static INLINE __m128i sf_sse2_32_ne(__m128i a, __m128i b)
+{
+   return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1));
+}
+
+static INLINE __m128i sf_sse2_16_gtz(__m128i a)
+{
+   return _mm_cmpgt_epi16(a, _mm_setzero_si128());
+}
+
+static INLINE __m128i sf_sse2_32_gtz(__m128i a)
+{
+   return _mm_cmpgt_epi32(a, _mm_setzero_si128());
+}
+
+static INLINE __m128i sf_sse2_16_ltz(__m128i a)
+{
+   return _mm_cmpgt_epi16(_mm_setzero_si128(), a);
+}
+
+static INLINE __m128i sf_sse2_32_ltz(__m128i a)
+{
+   return _mm_cmpgt_epi32(_mm_setzero_si128(), a);
+}
+
+#define sf_sse2_16_and _mm_and_si128
+#define sf_sse2_32_and _mm_and_si128
+#define sf_sse2_16_or  _mm_or_si128
+#define sf_sse2_32_or  _mm_or_si128
+#define sf_sse2_16_xor _mm_xor_si128
+#define sf_sse2_32_xor _mm_xor_si128
+#define sf_sse2_16_add _mm_add_epi16
+#define sf_sse2_32_add _mm_add_epi32
+#define sf_sse2_16_sub _mm_sub_epi16
+#define sf_sse2_32_sub _mm_sub_epi32
+#define sf_sse2_16_mullo _mm_mullo_epi16
+
+static INLINE __m128i sf_sse2_bic(__m128i a, __m128i b)
+{
+   return _mm_andnot_si128(b, a);
+}
+
+static INLINE __m128i sf_sse2_sel(__m128i m, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+#define sf_sse2_16_bic sf_sse2_bic
+#define sf_sse2_32_bic sf_sse2_bic
+#define sf_sse2_16_sel sf_sse2_sel
+#define sf_sse2_32_sel sf_sse2_sel
+
+static INLINE int sf_sse2_any(__m128i m)
+{
+   return _mm_movemask_epi8(m) != 0;
+}
+
+#define sf_sse2_16_any sf_sse2_any
+#define sf_sse2_32_any sf_sse2_any
+
+static INLINE __m128i sf_sse2_16_absdiff(__m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+}
+
+static INLINE __m128i sf_sse2_16_le(__m128i a, __m128i b)
+{
+   return _mm_cmpeq_epi16(_mm_subs_epu16(a, b), _mm_setzero_si128());
+}
+#endif
+
+#ifdef SOFTFILTER_HAVE_AVX2
+typedef __m256i sf_avx2_16_t;
+typedef __m256i sf_avx2_32_t;
+
+#define sf_avx2_16_LANES 16
+#define sf_avx2_32_LANES 8
+
+#define sf_avx2_16_srl(a, n) _mm256_srli_epi16(a, n)
+#define sf_avx2_32_srl(a, n) _mm256_srli_epi32(a, n)
+#define sf_avx2_16_sll(a, n) _mm256_slli_epi16(a, n)
+#define sf_avx2_16_sra(a, n) _mm256_srai_epi16(a, n)
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_load(
+      const uint16_t *p)
+{
+   return _mm256_loadu_si256((const __m256i*)p);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_load(
+      const uint32_t *p)
+{
+   return _mm256_loadu_si256((const __m256i*)p);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET void sf_avx2_16_store(
+      uint16_t *p, __m256i a)
+{
+   _mm256_storeu_si256((__m256i*)p, a);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET void sf_avx2_32_store(
+      uint32_t *p, __m256i a)
+{
+   _mm256_storeu_si256((__m256i*)p, a);
+}
+
+/* The unpack instructions work within 128-bit halves */
+static INLINE SOFTFILTER_AVX2_TARGET void sf_avx2_16_store2(
+      uint16_t *p, __m256i a, __m256i b)
+{
+   __m256i lo = _mm256_unpacklo_epi16(a, b);
+   __m256i hi = _mm256_unpackhi_epi16(a, b);
+   _mm256_storeu_si256((__m256i*)p,     _mm256_permute2x128_si256(lo, hi, 0x20));
+   _mm256_storeu_si256((__m256i*)p + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET void sf_avx2_32_store2(
+      uint32_t *p, __m256i a, __m256i b)
+{
+   __m256i lo = _mm256_unpacklo_epi32(a, b);
+   __m256i hi = _mm256_unpackhi_epi32(a, b);
+   _mm256_storeu_si256((__m256i*)p,     _mm256_permute2x128_si256(lo, hi, 0x20));
+   _mm256_storeu_si256((__m256i*)p + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_set1(uint16_t x)
+{
+   return _mm256_set1_epi16((short)x);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_set1(uint32_t x)
+{
+   return _mm256_set1_epi32((int)x);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_eq(
+      __m256i a, __m256i b)
+{
+   return _mm256_cmpeq_epi16(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_eq(
+      __m256i a, __m256i b)
+{
+   return _mm256_cmpeq_epi32(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_ne(
+      __m256i a, __m256i b)
+{
+   return _mm256_xor_si256(_mm256_cmpeq_epi16(a, b), _mm256_set1_epi32(-1));
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_ne(
+      __m256i a, __m256i b)
+{
+   return _mm256_xor_si256(_mm256_cmpeq_epi32(a, b), _mm256_set1_epi32(-1));
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_gtz(__m256i a)
+{
+   return _mm256_cmpgt_epi16(a, _mm256_setzero_si256());
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_gtz(__m256i a)
+{
+   return _mm256_cmpgt_epi32(a, _mm256_setzero_si256());
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_ltz(__m256i a)
+{
+   return _mm256_cmpgt_epi16(_mm256_setzero_si256(), a);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_ltz(__m256i a)
+{
+   return _mm256_cmpgt_epi32(_mm256_setzero_si256(), a);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_and(
+      __m256i a, __m256i b)
+{
+   return _mm256_and_si256(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_or(
+      __m256i a, __m256i b)
+{
+   return _mm256_or_si256(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_xor(
+      __m256i a, __m256i b)
+{
+   return _mm256_xor_si256(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_bic(
+      __m256i a, __m256i b)
+{
+   return _mm256_andnot_si256(b, a);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_sel(
+      __m256i m, __m256i a, __m256i b)
+{
+   return _mm256_blendv_epi8(b, a, m);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_add(
+      __m256i a, __m256i b)
+{
+   return _mm256_add_epi16(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_add(
+      __m256i a, __m256i b)
+{
+   return _mm256_add_epi32(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_sub(
+      __m256i a, __m256i b)
+{
+   return _mm256_sub_epi16(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_32_sub(
+      __m256i a, __m256i b)
+{
+   return _mm256_sub_epi32(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_mullo(
+      __m256i a, __m256i b)
+{
+   return _mm256_mullo_epi16(a, b);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_absdiff(
+      __m256i a, __m256i b)
+{
+   return _mm256_sub_epi16(_mm256_max_epu16(a, b), _mm256_min_epu16(a, b));
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET __m256i sf_avx2_16_le(
+      __m256i a, __m256i b)
+{
+   return _mm256_cmpeq_epi16(_mm256_min_epu16(a, b), a);
+}
+
+static INLINE SOFTFILTER_AVX2_TARGET int sf_avx2_any(__m256i m)
+{
+   return !_mm256_testz_si256(m, m);
+}
+
+#define sf_avx2_16_any sf_avx2_any
+#define sf_avx2_32_any sf_avx2_any
+#define sf_avx2_16_and sf_avx2_and
+#define sf_avx2_32_and sf_avx2_and
+#define sf_avx2_16_or  sf_avx2_or
+#define sf_avx2_32_or  sf_avx2_or
+#define sf_avx2_16_xor sf_avx2_xor
+#define sf_avx2_32_xor sf_avx2_xor
+#define sf_avx2_16_bic sf_avx2_bic
+#define sf_avx2_32_bic sf_avx2_bic
+#define sf_avx2_16_sel sf_avx2_sel
+#define sf_avx2_32_sel sf_avx2_sel
+#endif
+
+#ifdef SOFTFILTER_HAVE_NEON
+typedef uint16x8_t sf_neon_16_t;
+typedef uint32x4_t sf_neon_32_t;
+
+#define sf_neon_16_LANES 8
+#define sf_neon_32_LANES 4
+
+#define sf_neon_16_srl(a, n) vshrq_n_u16(a, n)
+#define sf_neon_32_srl(a, n) vshrq_n_u32(a, n)
+#define sf_neon_16_sll(a, n) vshlq_n_u16(a, n)
+#define sf_neon_16_sra(a, n) vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(a), n))
+
+#define sf_neon_16_load  vld1q_u16
+#define sf_neon_32_load  vld1q_u32
+#define sf_neon_16_store vst1q_u16
+#define sf_neon_32_store vst1q_u32
+#define sf_neon_16_set1  vdupq_n_u16
+#define sf_neon_32_set1  vdupq_n_u32
+#define sf_neon_16_eq    vceqq_u16
+#define sf_neon_32_eq    vceqq_u32
+#define sf_neon_16_and   vandq_u16
+#define sf_neon_32_and   vandq_u32
+#define sf_neon_16_or    vorrq_u16
+#define sf_neon_32_or    vorrq_u32
+#define sf_neon_16_xor   veorq_u16
+#define sf_neon_32_xor   veorq_u32
+#define sf_neon_16_bic   vbicq_u16
+#define sf_neon_32_bic   vbicq_u32
+#define sf_neon_16_sel   vbslq_u16
+#define sf_neon_32_sel   vbslq_u32
+#define sf_neon_16_add   vaddq_u16
+#define sf_neon_32_add   vaddq_u32
+#define sf_neon_16_sub   vsubq_u16
+#define sf_neon_32_sub   vsubq_u32
+#define sf_neon_16_mullo vmulq_u16
+#define sf_neon_16_absdiff vabdq_u16
+#define sf_neon_16_le    vcleq_u16
+
+static INLINE void sf_neon_16_store2(uint16_t *p,
+      uint16x8_t a, uint16x8_t b)
+{
+   uint16x8x2_t v;
+   v.val[0] = a;
+   v.val[1] = b;
+   vst2q_u16(p, v);
+}
+
+static INLINE void sf_neon_32_store2(uint32_t *p,
+      uint32x4_t a, uint32x4_t b)
+{
+   uint32x4x2_t v;
+   v.val[0] = a;
+   v.val[1] = b;
+   vst2q_u32(p, v);
+}
+
+static INLINE int sf_neon_16_any(uint16x8_t m)
+{
+   uint64x2_t v = vreinterpretq_u64_u16(m);
+   return (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) != 0;
+}
+
+static INLINE int sf_neon_32_any(uint32x4_t m)
+{
+   uint64x2_t v = vreinterpretq_u64_u32(m);
+   return (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) != 0;
+}
+
+static INLINE uint16x8_t sf_neon_16_ne(uint16x8_t a, uint16x8_t b)
+{
+   return vmvnq_u16(vceqq_u16(a, b));
+}
+
+static INLINE uint32x4_t sf_neon_32_ne(uint32x4_t a, uint32x4_t b)
+{
+   return vmvnq_u32(vceqq_u32(a, b));
+}
+
+static INLINE uint16x8_t sf_neon_16_gtz(uint16x8_t a)
+{
+   return vcgtq_s16(vreinterpretq_s16_u16(a), vdupq_n_s16(0));
+}
+
+static INLINE uint32x4_t sf_neon_32_gtz(uint32x4_t a)
+{
+   return vcgtq_s32(vreinterpretq_s32_u32(a), vdupq_n_s32(0));
+}
+
+static INLINE uint16x8_t sf_neon_16_ltz(uint16x8_t a)
+{
+   return vcltq_s16(vreinterpretq_s16_u16(a), vdupq_n_s16(0));
+}
+
+static INLINE uint32x4_t sf_neon_32_ltz(uint32x4_t a)
+{
+   return vcltq_s32(vreinterpretq_s32_u32(a), vdupq_n_s32(0));
+}
+#endif
+
+#endif
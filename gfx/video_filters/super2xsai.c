@@ -17,6 +17,7 @@
 /* Compile: gcc -o supertwoxsai.so -shared supertwoxsai.c -std=c99 -O3 -Wall -pedantic -fPIC */
 
 #include "softfilter.h"
+#include "softfilter_simd.h"
 #include <stdlib.h>
 
 #ifdef RARCH_INTERNAL
@@ -45,6 +46,7 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   softfilter_simd_mask_t simd;
 };
 
 static unsigned supertwoxsai_generic_input_fmts(void)
@@ -77,10 +79,9 @@ static void *supertwoxsai_generic_create(const struct softfilter_config *config,
       free(filt);
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
+   filt->simd    = simd;
 
    return filt;
 }
@@ -114,12 +115,12 @@ static void supertwoxsai_generic_destroy(void *data)
 #define supertwoxsai_result(A, B, C, D) (((A) != (C) || (A) != (D)) - ((B) != (C) || (B) != (D)))
 
 #ifndef supertwoxsai_declare_variables
-#define supertwoxsai_declare_variables(typename_t, in, nextline) \
+#define supertwoxsai_declare_variables(typename_t, in, prevline, nextline, nextline2) \
          typename_t product1a, product1b, product2a, product2b; \
-         const typename_t colorB0 = *(in - nextline - 1); \
-         const typename_t colorB1 = *(in - nextline + 0); \
-         const typename_t colorB2 = *(in - nextline + 1); \
-         const typename_t colorB3 = *(in - nextline + 2); \
+         const typename_t colorB0 = *(in - prevline - 1); \
+         const typename_t colorB1 = *(in - prevline + 0); \
+         const typename_t colorB2 = *(in - prevline + 1); \
+         const typename_t colorB3 = *(in - prevline + 2); \
          const typename_t color4  = *(in - 1); \
          const typename_t color5  = *(in + 0); \
          const typename_t color6  = *(in + 1); \
@@ -128,10 +129,10 @@ static void supertwoxsai_generic_destroy(void *data)
          const typename_t color2  = *(in + nextline + 0); \
          const typename_t color3  = *(in + nextline + 1); \
          const typename_t colorS1 = *(in + nextline + 2); \
-         const typename_t colorA0 = *(in + nextline + nextline - 1); \
-         const typename_t colorA1 = *(in + nextline + nextline + 0); \
-         const typename_t colorA2 = *(in + nextline + nextline + 1); \
-         const typename_t colorA3 = *(in + nextline + nextline + 2)
+         const typename_t colorA0 = *(in + nextline2 - 1); \
+         const typename_t colorA1 = *(in + nextline2 + 0); \
+         const typename_t colorA2 = *(in + nextline2 + 1); \
+         const typename_t colorA3 = *(in + nextline2 + 2)
 #endif
 
 #ifndef supertwoxsai_function
@@ -197,21 +198,172 @@ static void supertwoxsai_generic_destroy(void *data)
          out += 2
 #endif
 
-static void supertwoxsai_generic_xrgb8888(unsigned width, unsigned height,
+/* Vector versions of the interpolation and result macros,
+ * lane for lane the same arithmetic */
+#define supertwoxsai_vinterpolate(V, A, B, cmask, lmask) \
+   V##_add(V##_add(V##_srl(V##_and(A, cmask), 1), \
+            V##_srl(V##_and(B, cmask), 1)), \
+         V##_and(V##_and(A, B), lmask))
+
+#define supertwoxsai_vinterpolate2(V, A, B, C, D, qcmask, qlmask) \
+   V##_add(V##_add(V##_add(V##_add( \
+                  V##_srl(V##_and(A, qcmask), 2), \
+                  V##_srl(V##_and(B, qcmask), 2)), \
+               V##_srl(V##_and(C, qcmask), 2)), \
+            V##_srl(V##_and(D, qcmask), 2)), \
+         V##_and(V##_srl(V##_add(V##_add(V##_add( \
+                        V##_and(A, qlmask), V##_and(B, qlmask)), \
+                     V##_and(C, qlmask)), V##_and(D, qlmask)), 2), qlmask))
+
+/* Lanes are all ones for true, so the difference of the
+ * two masks is the scalar result */
+#define supertwoxsai_vresult(V, A, B, C, D) \
+   V##_sub(V##_or(V##_ne(B, C), V##_ne(B, D)), \
+         V##_or(V##_ne(A, C), V##_ne(A, D)))
+
+/* Expands the first 'count' pixels of a row, rounded down to
+ * whole vectors, and returns how many it did. Every branch of
+ * supertwoxsai_function() is computed and the products are
+ * picked with lane masks. The neighbours above and below are
+ * read from the row itself, like the scalar path does. */
+#define supertwoxsai_span(name, target, V, typename_t, cmask, lmask, qcmask, qlmask) \
+static target unsigned name(const typename_t *in, typename_t *out, \
+      unsigned dst_stride, unsigned count) \
+{ \
+   unsigned x; \
+   V##_t colorMask     = V##_set1(cmask); \
+   V##_t lowPixelMask  = V##_set1(lmask); \
+   V##_t qcolorMask    = V##_set1(qcmask); \
+   V##_t qlowpixelMask = V##_set1(qlmask); \
+   \
+   for (x = 0; x + V##_LANES <= count; x += V##_LANES) \
+   { \
+      const typename_t *p = in + x; \
+      V##_t colorB0  = V##_load(p - 1); \
+      V##_t colorB1  = V##_load(p + 0); \
+      V##_t colorB2  = V##_load(p + 1); \
+      V##_t colorB3  = V##_load(p + 2); \
+      V##_t color4   = V##_load(p - 1); \
+      V##_t color5   = V##_load(p + 0); \
+      V##_t color6   = V##_load(p + 1); \
+      V##_t colorS2  = V##_load(p + 2); \
+      V##_t color1   = V##_load(p - 1); \
+      V##_t color2   = V##_load(p + 0); \
+      V##_t color3   = V##_load(p + 1); \
+      V##_t colorS1  = V##_load(p + 2); \
+      V##_t colorA0  = V##_load(p - 1); \
+      V##_t colorA1  = V##_load(p + 0); \
+      V##_t colorA2  = V##_load(p + 1); \
+      V##_t colorA3  = V##_load(p + 2); \
+      V##_t e26      = V##_eq(color2, color6); \
+      V##_t e53      = V##_eq(color5, color3); \
+      /* The four branches */ \
+      V##_t case1    = V##_bic(e26, e53); \
+      V##_t case2    = V##_bic(e53, e26); \
+      V##_t case3    = V##_and(e26, e53); \
+      V##_t case4    = V##_bic(V##_ne(color2, color6), e53); \
+      V##_t i56      = supertwoxsai_vinterpolate(V, color5, color6, colorMask, lowPixelMask); \
+      V##_t i25      = supertwoxsai_vinterpolate(V, color2, color5, colorMask, lowPixelMask); \
+      V##_t r        = supertwoxsai_vresult(V, color6, color5, color1, colorA1); \
+      V##_t m1, m2, product, product1a, product1b, product2a, product2b; \
+      \
+      r         = V##_add(r, supertwoxsai_vresult(V, color6, color5, color4, colorB1)); \
+      r         = V##_add(r, supertwoxsai_vresult(V, color6, color5, colorA2, colorS1)); \
+      r         = V##_add(r, supertwoxsai_vresult(V, color6, color5, colorB2, colorS2)); \
+      \
+      /* Shared by product1b and product2b outside of case4 */ \
+      product   = V##_sel(case1, color2, V##_sel(case2, color5, \
+               V##_sel(V##_and(case3, V##_gtz(r)), color6, \
+                  V##_sel(V##_and(case3, V##_ltz(r)), color5, i56)))); \
+      \
+      m1        = V##_and(V##_and(V##_eq(color6, color3), V##_eq(color3, colorA1)), \
+            V##_bic(V##_ne(color3, colorA0), V##_eq(color2, colorA2))); \
+      m2        = V##_and(V##_and(V##_eq(color5, color2), V##_eq(color2, colorA2)), \
+            V##_bic(V##_ne(color2, colorA3), V##_eq(colorA1, color3))); \
+      product2b = V##_sel(m1, supertwoxsai_vinterpolate2(V, color3, color3, color3, color2, \
+                  qcolorMask, qlowpixelMask), \
+            V##_sel(m2, supertwoxsai_vinterpolate2(V, color2, color2, color2, color3, \
+                  qcolorMask, qlowpixelMask), \
+               supertwoxsai_vinterpolate(V, color2, color3, colorMask, lowPixelMask))); \
+      product2b = V##_sel(case4, product2b, product); \
+      \
+      m1        = V##_and(V##_and(V##_eq(color6, color3), V##_eq(color6, colorB1)), \
+            V##_bic(V##_ne(color6, colorB0), V##_eq(color5, colorB2))); \
+      m2        = V##_and(V##_and(V##_eq(color5, color2), V##_eq(color5, colorB2)), \
+            V##_bic(V##_ne(color5, colorB3), V##_eq(colorB1, color6))); \
+      product1b = V##_sel(m1, supertwoxsai_vinterpolate2(V, color6, color6, color6, color5, \
+                  qcolorMask, qlowpixelMask), \
+            V##_sel(m2, supertwoxsai_vinterpolate2(V, color6, color5, color5, color5, \
+                  qcolorMask, qlowpixelMask), i56)); \
+      product1b = V##_sel(case4, product1b, product); \
+      \
+      m1        = V##_and(V##_and(case2, V##_eq(color4, color5)), V##_ne(color5, colorA2)); \
+      m2        = V##_and(V##_and(V##_eq(color5, color1), V##_eq(color6, color5)), \
+            V##_bic(V##_ne(color5, colorA0), V##_eq(color4, color2))); \
+      product2a = V##_sel(V##_or(m1, m2), i25, color2); \
+      \
+      m1        = V##_and(V##_and(case1, V##_eq(color1, color2)), V##_ne(color2, colorB2)); \
+      m2        = V##_and(V##_and(V##_eq(color4, color2), V##_eq(color3, color2)), \
+            V##_bic(V##_ne(color2, colorB0), V##_eq(color1, color5))); \
+      product1a = V##_sel(V##_or(m1, m2), i25, color5); \
+      \
+      V##_store2(out + 2 * x, product1a, product1b); \
+      V##_store2(out + 2 * x + dst_stride, product2a, product2b); \
+   } \
+   \
+   return x; \
+}
+
+typedef unsigned (*supertwoxsai_span_xrgb8888_t)(const uint32_t *in,
+      uint32_t *out, unsigned dst_stride, unsigned count);
+typedef unsigned (*supertwoxsai_span_rgb565_t)(const uint16_t *in,
+      uint16_t *out, unsigned dst_stride, unsigned count);
+
+#ifdef SOFTFILTER_HAVE_SSE2
+supertwoxsai_span(supertwoxsai_span_xrgb8888_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+supertwoxsai_span(supertwoxsai_span_rgb565_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+#ifdef SOFTFILTER_HAVE_AVX2
+supertwoxsai_span(supertwoxsai_span_xrgb8888_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+supertwoxsai_span(supertwoxsai_span_rgb565_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+#ifdef SOFTFILTER_HAVE_NEON
+supertwoxsai_span(supertwoxsai_span_xrgb8888_neon, SOFTFILTER_NEON_TARGET, sf_neon_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+supertwoxsai_span(supertwoxsai_span_rgb565_neon, SOFTFILTER_NEON_TARGET, sf_neon_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+
+static void supertwoxsai_generic_xrgb8888(supertwoxsai_span_xrgb8888_t span,
+      unsigned width, unsigned height,
       int first, int last, uint32_t *src,
       unsigned src_stride, uint32_t *dst, unsigned dst_stride)
 {
    unsigned finish;
-   unsigned nextline = (last) ? 0 : src_stride;
+
+   /* Same as 2xSaI: the filter only ever saw its own row (its
+    * one band was flagged as the last, so the row offsets
+    * were zero), and bands do not depend on each other. */
+   const unsigned prevline  = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint32_t *in  = (uint32_t*)src;
-      uint32_t *out = (uint32_t*)dst;
+      uint32_t *in       = (uint32_t*)src;
+      uint32_t *out      = (uint32_t*)dst;
+      unsigned done      = span ? span(in, out, dst_stride, width) : 0;
 
-      for (finish = width; finish; finish -= 1)
+      in                += done;
+      out               += 2 * done;
+
+      for (finish = width - done; finish; finish -= 1)
       {
-         supertwoxsai_declare_variables(uint32_t, in, nextline);
+         supertwoxsai_declare_variables(uint32_t, in, prevline, nextline, nextline2);
 
          /*---------------------------    B1 B2
           *                             4  5  6 S2
@@ -228,21 +380,28 @@ static void supertwoxsai_generic_xrgb8888(unsigned width, unsigned height,
    }
 }
 
-static void supertwoxsai_generic_rgb565(unsigned width, unsigned height,
+static void supertwoxsai_generic_rgb565(supertwoxsai_span_rgb565_t span,
+      unsigned width, unsigned height,
       int first, int last, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    unsigned finish;
-   unsigned nextline = (last) ? 0 : src_stride;
+   const unsigned prevline  = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint16_t *in  = (uint16_t*)src;
-      uint16_t *out = (uint16_t*)dst;
+      uint16_t *in       = (uint16_t*)src;
+      uint16_t *out      = (uint16_t*)dst;
+      unsigned done      = span ? span(in, out, dst_stride, width) : 0;
+
+      in                += done;
+      out               += 2 * done;
 
-      for (finish = width; finish; finish -= 1)
+      for (finish = width - done; finish; finish -= 1)
       {
-         supertwoxsai_declare_variables(uint16_t, in, nextline);
+         supertwoxsai_declare_variables(uint16_t, in, prevline, nextline, nextline2);
 
          /*---------------------------    B1 B2
           *                             4  5  6 S2
@@ -261,12 +420,17 @@ static void supertwoxsai_generic_rgb565(unsigned width, unsigned height,
 
 static void supertwoxsai_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
    uint16_t *input                    = (uint16_t*)thr->in_data;
    uint16_t *output                   = (uint16_t*)thr->out_data;
    unsigned width                     = thr->width;
    unsigned height                    = thr->height;
-   supertwoxsai_generic_rgb565(width, height,
+   supertwoxsai_span_rgb565_t span    = NULL;
+
+   SOFTFILTER_SIMD_PICK(filt->simd, span, supertwoxsai_span_rgb565);
+
+   supertwoxsai_generic_rgb565(span, width, height,
          thr->first, thr->last, input,
         (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
         output,
@@ -275,12 +439,17 @@ static void supertwoxsai_work_cb_rgb565(void *data, void *thread_data)
 
 static void supertwoxsai_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
    uint32_t *input                    = (uint32_t*)thr->in_data;
    uint32_t *output                   = (uint32_t*)thr->out_data;
    unsigned width                     = thr->width;
    unsigned height                    = thr->height;
-   supertwoxsai_generic_xrgb8888(width, height,
+   supertwoxsai_span_xrgb8888_t span  = NULL;
+
+   SOFTFILTER_SIMD_PICK(filt->simd, span, supertwoxsai_span_xrgb8888);
+
+   supertwoxsai_generic_xrgb8888(span, width, height,
          thr->first, thr->last, input,
 	 (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
 	 output,
@@ -298,9 +467,10 @@ static void supertwoxsai_generic_packets(void *data,
    for (i = 0; i < filt->threads; i++)
    {
       struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
-      unsigned y_start       = (height * i) / filt->threads;
-      unsigned y_end         = (height * (i + 1)) / filt->threads;
       thr->out_data          = (uint8_t*)output + y_start * SUPERTWOXSAI_SCALE * output_stride;
       thr->in_data           = (const uint8_t*)input + y_start * input_stride;
       thr->out_pitch         = output_stride;
@@ -308,11 +478,6 @@ static void supertwoxsai_generic_packets(void *data,
       thr->width             = width;
       thr->height            = y_end - y_start;
 
-      /* Workers need to know if they can access pixels 
-       * outside their given buffer. */
-      thr->first             = y_start;
-      thr->last              = y_end == height;
-
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work     = supertwoxsai_work_cb_rgb565;
       else if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888)
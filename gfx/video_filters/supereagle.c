@@ -17,6 +17,7 @@
 /* Compile: gcc -o supereagle.so -shared supereagle.c -std=c99 -O3 -Wall -pedantic -fPIC */
 
 #include "softfilter.h"
+#include "softfilter_simd.h"
 #include <stdlib.h>
 
 #ifdef RARCH_INTERNAL
@@ -45,6 +46,7 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   softfilter_simd_mask_t simd;
 };
 
 static unsigned supereagle_generic_input_fmts(void)
@@ -76,8 +78,9 @@ static void *supereagle_generic_create(const struct softfilter_config *config,
       free(filt);
       return NULL;
    }
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
+   filt->simd    = simd;
    return filt;
 }
 
@@ -109,10 +112,10 @@ static void supereagle_generic_destroy(void *data)
 
 #define supereagle_result(A, B, C, D) (((A) != (C) || (A) != (D)) - ((B) != (C) || (B) != (D)));
 
-#define supereagle_declare_variables(typename_t, in, nextline) \
+#define supereagle_declare_variables(typename_t, in, prevline, nextline, nextline2) \
          typename_t product1a, product1b, product2a, product2b; \
-         const typename_t colorB1 = *(in - nextline + 0); \
-         const typename_t colorB2 = *(in - nextline + 1); \
+         const typename_t colorB1 = *(in - prevline + 0); \
+         const typename_t colorB2 = *(in - prevline + 1); \
          const typename_t color4  = *(in - 1); \
          const typename_t color5  = *(in + 0); \
          const typename_t color6  = *(in + 1); \
@@ -121,8 +124,8 @@ static void supereagle_generic_destroy(void *data)
          const typename_t color2  = *(in + nextline + 0); \
          const typename_t color3  = *(in + nextline + 1); \
          const typename_t colorS1 = *(in + nextline + 2); \
-         const typename_t colorA1 = *(in + nextline + nextline + 0); \
-         const typename_t colorA2 = *(in + nextline + nextline + 1)
+         const typename_t colorA1 = *(in + nextline2 + 0); \
+         const typename_t colorA2 = *(in + nextline2 + 1)
 
 #ifndef supereagle_function
 #define supereagle_function(result_cb, interpolate_cb, interpolate2_cb) \
@@ -210,21 +213,167 @@ static void supereagle_generic_destroy(void *data)
          out += 2
 #endif
 
-static void supereagle_generic_xrgb8888(unsigned width, unsigned height,
+/* Vector versions of the interpolation and result macros,
+ * lane for lane the same arithmetic */
+#define supereagle_vinterpolate(V, A, B, cmask, lmask) \
+   V##_add(V##_add(V##_srl(V##_and(A, cmask), 1), \
+            V##_srl(V##_and(B, cmask), 1)), \
+         V##_and(V##_and(A, B), lmask))
+
+#define supereagle_vinterpolate2(V, A, B, C, D, qcmask, qlmask) \
+   V##_add(V##_add(V##_add(V##_add( \
+                  V##_srl(V##_and(A, qcmask), 2), \
+                  V##_srl(V##_and(B, qcmask), 2)), \
+               V##_srl(V##_and(C, qcmask), 2)), \
+            V##_srl(V##_and(D, qcmask), 2)), \
+         V##_and(V##_srl(V##_add(V##_add(V##_add( \
+                        V##_and(A, qlmask), V##_and(B, qlmask)), \
+                     V##_and(C, qlmask)), V##_and(D, qlmask)), 2), qlmask))
+
+/* Lanes are all ones for true, so the difference of the
+ * two masks is the scalar result */
+#define supereagle_vresult(V, A, B, C, D) \
+   V##_sub(V##_or(V##_ne(B, C), V##_ne(B, D)), \
+         V##_or(V##_ne(A, C), V##_ne(A, D)))
+
+/* Expands the first 'count' pixels of a row, rounded down to
+ * whole vectors, and returns how many it did. Every branch of
+ * supereagle_function() is computed and the products are
+ * picked with lane masks. The neighbours above and below are
+ * read from the row itself, like the scalar path does. */
+#define supereagle_span(name, target, V, typename_t, cmask, lmask, qcmask, qlmask) \
+static target unsigned name(const typename_t *in, typename_t *out, \
+      unsigned dst_stride, unsigned count) \
+{ \
+   unsigned x; \
+   V##_t colorMask     = V##_set1(cmask); \
+   V##_t lowPixelMask  = V##_set1(lmask); \
+   V##_t qcolorMask    = V##_set1(qcmask); \
+   V##_t qlowpixelMask = V##_set1(qlmask); \
+   \
+   for (x = 0; x + V##_LANES <= count; x += V##_LANES) \
+   { \
+      const typename_t *p = in + x; \
+      V##_t colorB1  = V##_load(p + 0); \
+      V##_t colorB2  = V##_load(p + 1); \
+      V##_t color4   = V##_load(p - 1); \
+      V##_t color5   = V##_load(p + 0); \
+      V##_t color6   = V##_load(p + 1); \
+      V##_t colorS2  = V##_load(p + 2); \
+      V##_t color1   = V##_load(p - 1); \
+      V##_t color2   = V##_load(p + 0); \
+      V##_t color3   = V##_load(p + 1); \
+      V##_t colorS1  = V##_load(p + 2); \
+      V##_t colorA1  = V##_load(p + 0); \
+      V##_t colorA2  = V##_load(p + 1); \
+      V##_t e26      = V##_eq(color2, color6); \
+      V##_t e53      = V##_eq(color5, color3); \
+      /* The four branches */ \
+      V##_t case1    = V##_bic(e26, e53); \
+      V##_t case2    = V##_bic(e53, e26); \
+      V##_t case3    = V##_and(e26, e53); \
+      V##_t case4    = V##_bic(V##_ne(color2, color6), e53); \
+      V##_t i56      = supereagle_vinterpolate(V, color5, color6, colorMask, lowPixelMask); \
+      V##_t i23      = supereagle_vinterpolate(V, color2, color3, colorMask, lowPixelMask); \
+      V##_t i26      = supereagle_vinterpolate(V, color2, color6, colorMask, lowPixelMask); \
+      V##_t i53      = supereagle_vinterpolate(V, color5, color3, colorMask, lowPixelMask); \
+      V##_t r        = supereagle_vresult(V, color6, color5, color1, colorA1); \
+      V##_t gtz, ltz, product1a, product1b, product2a, product2b, t; \
+      \
+      r         = V##_add(r, supereagle_vresult(V, color6, color5, color4, colorB1)); \
+      r         = V##_add(r, supereagle_vresult(V, color6, color5, colorA2, colorS1)); \
+      r         = V##_add(r, supereagle_vresult(V, color6, color5, colorB2, colorS2)); \
+      gtz       = V##_and(case3, V##_gtz(r)); \
+      ltz       = V##_and(case3, V##_ltz(r)); \
+      \
+      t         = supereagle_vinterpolate(V, color2, color5, colorMask, lowPixelMask); \
+      t         = supereagle_vinterpolate(V, color2, t, colorMask, lowPixelMask); \
+      product1a = V##_sel(V##_or(V##_eq(color1, color2), V##_eq(color6, colorB2)), t, i56); \
+      product1a = V##_sel(case1, product1a, V##_sel(case4, \
+               supereagle_vinterpolate2(V, color5, color5, color5, i26, \
+                  qcolorMask, qlowpixelMask), \
+               V##_sel(gtz, i56, color5))); \
+      \
+      t         = supereagle_vinterpolate(V, color5, color6, colorMask, lowPixelMask); \
+      t         = supereagle_vinterpolate(V, color5, t, colorMask, lowPixelMask); \
+      product1b = V##_sel(V##_or(V##_eq(colorB1, color5), V##_eq(color3, colorS1)), t, i56); \
+      product1b = V##_sel(case2, product1b, V##_sel(case4, \
+               supereagle_vinterpolate2(V, color6, color6, color6, i53, \
+                  qcolorMask, qlowpixelMask), \
+               V##_sel(ltz, i56, color2))); \
+      \
+      t         = supereagle_vinterpolate(V, color5, color2, colorMask, lowPixelMask); \
+      t         = supereagle_vinterpolate(V, color5, t, colorMask, lowPixelMask); \
+      product2a = V##_sel(V##_or(V##_eq(color3, colorA2), V##_eq(color4, color5)), t, i23); \
+      product2a = V##_sel(case2, product2a, V##_sel(case4, \
+               supereagle_vinterpolate2(V, color2, color2, color2, i53, \
+                  qcolorMask, qlowpixelMask), \
+               V##_sel(ltz, i56, color2))); \
+      \
+      t         = supereagle_vinterpolate(V, color2, i23, colorMask, lowPixelMask); \
+      product2b = V##_sel(V##_or(V##_eq(color6, colorS2), V##_eq(color2, colorA1)), t, i23); \
+      product2b = V##_sel(case1, product2b, V##_sel(case4, \
+               supereagle_vinterpolate2(V, color3, color3, color3, i26, \
+                  qcolorMask, qlowpixelMask), \
+               V##_sel(gtz, i56, color5))); \
+      \
+      V##_store2(out + 2 * x, product1a, product1b); \
+      V##_store2(out + 2 * x + dst_stride, product2a, product2b); \
+   } \
+   \
+   return x; \
+}
+
+typedef unsigned (*supereagle_span_xrgb8888_t)(const uint32_t *in,
+      uint32_t *out, unsigned dst_stride, unsigned count);
+typedef unsigned (*supereagle_span_rgb565_t)(const uint16_t *in,
+      uint16_t *out, unsigned dst_stride, unsigned count);
+
+#ifdef SOFTFILTER_HAVE_SSE2
+supereagle_span(supereagle_span_xrgb8888_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+supereagle_span(supereagle_span_rgb565_sse2, SOFTFILTER_SSE2_TARGET, sf_sse2_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+#ifdef SOFTFILTER_HAVE_AVX2
+supereagle_span(supereagle_span_xrgb8888_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+supereagle_span(supereagle_span_rgb565_avx2, SOFTFILTER_AVX2_TARGET, sf_avx2_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+#ifdef SOFTFILTER_HAVE_NEON
+supereagle_span(supereagle_span_xrgb8888_neon, SOFTFILTER_NEON_TARGET, sf_neon_32, uint32_t,
+      0xFEFEFEFE, 0x01010101, 0xFCFCFCFC, 0x03030303)
+supereagle_span(supereagle_span_rgb565_neon, SOFTFILTER_NEON_TARGET, sf_neon_16, uint16_t,
+      0xF7DE, 0x0821, 0xE79C, 0x1863)
+#endif
+
+static void supereagle_generic_xrgb8888(supereagle_span_xrgb8888_t span,
+      unsigned width, unsigned height,
       int first, int last, uint32_t *src,
       unsigned src_stride, uint32_t *dst, unsigned dst_stride)
 {
    unsigned finish;
-   unsigned nextline = (last) ? 0 : src_stride;
+
+   /* The row offsets stay zero, as they were with the old
+    * single band flagged 'last'. This keeps the output the
+    * filter always had and makes rows independent. */
+   const unsigned prevline  = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint32_t *in  = (uint32_t*)src;
-      uint32_t *out = (uint32_t*)dst;
+      uint32_t *in       = (uint32_t*)src;
+      uint32_t *out      = (uint32_t*)dst;
+      unsigned done      = span ? span(in, out, dst_stride, width) : 0;
+
+      in                += done;
+      out               += 2 * done;
 
-      for (finish = width; finish; finish -= 1)
+      for (finish = width - done; finish; finish -= 1)
       {
-         supereagle_declare_variables(uint32_t, in, nextline);
+         supereagle_declare_variables(uint32_t, in, prevline, nextline, nextline2);
          supereagle_function(supereagle_result, supereagle_interpolate_xrgb8888, supereagle_interpolate2_xrgb8888);
       }
 
@@ -233,21 +382,28 @@ static void supereagle_generic_xrgb8888(unsigned width, unsigned height,
    }
 }
 
-static void supereagle_generic_rgb565(unsigned width, unsigned height,
+static void supereagle_generic_rgb565(supereagle_span_rgb565_t span,
+      unsigned width, unsigned height,
       int first, int last, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    unsigned finish;
-   unsigned nextline = (last) ? 0 : src_stride;
+   const unsigned prevline  = 0;
+   const unsigned nextline  = 0;
+   const unsigned nextline2 = 0;
 
    for (; height; height--)
    {
-      uint16_t *in  = (uint16_t*)src;
-      uint16_t *out = (uint16_t*)dst;
+      uint16_t *in       = (uint16_t*)src;
+      uint16_t *out      = (uint16_t*)dst;
+      unsigned done      = span ? span(in, out, dst_stride, width) : 0;
 
-      for (finish = width; finish; finish -= 1)
+      in                += done;
+      out               += 2 * done;
+
+      for (finish = width - done; finish; finish -= 1)
       {
-         supereagle_declare_variables(uint16_t, in, nextline);
+         supereagle_declare_variables(uint16_t, in, prevline, nextline, nextline2);
          supereagle_function(supereagle_result, supereagle_interpolate_rgb565, supereagle_interpolate2_rgb565);
       }
 
@@ -258,13 +414,17 @@ static void supereagle_generic_rgb565(unsigned width, unsigned height,
 
 static void supereagle_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
-   uint16_t *input  = (uint16_t*)thr->in_data;
-   uint16_t *output = (uint16_t*)thr->out_data;
-   unsigned width   = thr->width;
-   unsigned height  = thr->height;
+   uint16_t *input                    = (uint16_t*)thr->in_data;
+   uint16_t *output                   = (uint16_t*)thr->out_data;
+   unsigned width                     = thr->width;
+   unsigned height                    = thr->height;
+   supereagle_span_rgb565_t span      = NULL;
+
+   SOFTFILTER_SIMD_PICK(filt->simd, span, supereagle_span_rgb565);
 
-   supereagle_generic_rgb565(width, height,
+   supereagle_generic_rgb565(span, width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
@@ -273,13 +433,21 @@ static void supereagle_work_cb_rgb565(void *data, void *thread_data)
 
 static void supereagle_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
-   uint32_t *input  = (uint32_t*)thr->in_data;
-   uint32_t *output = (uint32_t*)thr->out_data;
-   unsigned width   = thr->width;
-   unsigned height  = thr->height;
-
-   supereagle_generic_xrgb8888(width, height,
+   uint32_t *input                    = (uint32_t*)thr->in_data;
+   uint32_t *output                   = (uint32_t*)thr->out_data;
+   unsigned width                     = thr->width;
+   unsigned height                    = thr->height;
+   supereagle_span_xrgb8888_t span    = NULL;
+
+   /* With four lanes, computing every branch costs more than
+    * the scalar path, whose branches all but resolve on their
+    * own when the rows around are the row itself */
+   SOFTFILTER_SIMD_PICK(filt->simd & ~SOFTFILTER_SIMD_SSE2,
+         span, supereagle_span_xrgb8888);
+
+   supereagle_generic_xrgb8888(span, width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
          output,
@@ -297,9 +465,10 @@ static void supereagle_generic_packets(void *data,
    for (i = 0; i < filt->threads; i++)
    {
       struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start, y_end;
+
+      softfilter_get_band(height, i, filt->threads, &y_start, &y_end);
 
-      unsigned y_start       = (height * i) / filt->threads;
-      unsigned y_end         = (height * (i + 1)) / filt->threads;
       thr->out_data          = (uint8_t*)output + y_start * SUPEREAGLE_SCALE * output_stride;
       thr->in_data           = (const uint8_t*)input + y_start * input_stride;
       thr->out_pitch         = output_stride;
@@ -307,10 +476,6 @@ static void supereagle_generic_packets(void *data,
       thr->width             = width;
       thr->height            = y_end - y_start;
 
-      /* Workers need to know if they can access pixels outside their given buffer. */
-      thr->first             = y_start;
-      thr->last              = y_end == height;
-
       if (filt->in_fmt == SOFTFILTER_FMT_RGB565)
          packets[i].work     = supereagle_work_cb_rgb565;
       else if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888)
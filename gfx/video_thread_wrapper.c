@@ -412,17 +412,43 @@ static bool video_thread_handle_packet(
 static void video_thread_loop(void *data)
 {
    thread_packet_t pkt;
+   uint64_t count     = 0;
+   uint64_t submitted = 0;
    bool updated;
+   char msg[NAME_MAX_LENGTH];
    thread_video_t *thr = (thread_video_t*)data;
 
    for (;;)
    {
+      const thread_video_frame_t *frame = NULL;
+
       slock_lock(thr->lock);
       while (thr->send_cmd == CMD_VIDEO_NONE && !thr->frame.updated)
          scond_wait(thr->cond_thread, thr->lock);
 
       updated = thr->frame.updated;
 
+      if (updated)
+      {
+         /* Take the newest completed frame. The main thread
+          * never touches the 'read' buffer, so it can be
+          * rendered without holding the lock. */
+         if (thr->frame.fresh)
+         {
+            unsigned read      = thr->frame.read;
+            thr->frame.read    = thr->frame.ready;
+            thr->frame.ready   = read;
+            thr->frame.fresh   = false;
+         }
+         frame                 = &thr->frame.slots[thr->frame.read];
+         count                 = thr->frame.count;
+         submitted             = thr->frame.submitted;
+         strlcpy(msg, thr->frame.msg, sizeof(msg));
+         /* Only the wakeup is consumed here, the main thread
+          * waits on 'rendered' for the frame to be drawn. */
+         thr->frame.updated    = false;
+      }
+
       /* To avoid race condition where send_cmd is updated
        * right after the switch is checked. */
       pkt     = thr->cmd_data;
@@ -462,9 +488,8 @@ static void video_thread_loop(void *data)
                video_driver_build_info(&video_info);
 
                ret = thr->driver->frame(thr->driver_data,
-                  thr->frame.buffer, thr->frame.width, thr->frame.height,
-                  thr->frame.count, thr->frame.pitch,
-                  *thr->frame.msg ? thr->frame.msg : NULL,
+                  frame->buffer, frame->width, frame->height,
+                  count, frame->pitch, *msg ? msg : NULL,
                   &video_info);
 
                slock_unlock(thr->frame.lock);
@@ -489,11 +514,11 @@ static void video_thread_loop(void *data)
             slock_unlock(thr->frame.lock);
 
          slock_lock(thr->lock);
-         thr->alive         = alive;
-         thr->focus         = focus;
-         thr->has_windowed  = has_windowed;
-         thr->vp            = vp;
-         thr->frame.updated = false;
+         thr->alive               = alive;
+         thr->focus               = focus;
+         thr->has_windowed        = has_windowed;
+         thr->vp                  = vp;
+         thr->frame.rendered      = submitted;
          scond_signal(thr->cond_cmd);
          slock_unlock(thr->lock);
       }
@@ -577,6 +602,9 @@ static bool video_thread_frame(void *data, const void *frame_,
       unsigned width, unsigned height, uint64_t frame_count,
       unsigned pitch, const char *msg, video_frame_info_t *video_info)
 {
+   thread_video_frame_t *slot;
+   bool publish;
+   const uint8_t *src  = (const uint8_t*)frame_;
    thread_video_t *thr = (thread_video_t*)data;
 
    if (!thr)
@@ -595,6 +623,37 @@ static bool video_thread_frame(void *data, const void *frame_,
       return false;
    }
 
+   /* The 'write' buffer belongs to this thread, so the frame
+    * can be filled in before taking the lock. Frames the core
+    * rendered into it directly need no copy at all. A NULL
+    * frame, or the last frame pushed again, is a dupe. */
+   slot    = &thr->frame.slots[thr->frame.write];
+   publish = !thr->frame.last || (src && src != thr->frame.last);
+
+   if (publish)
+   {
+      unsigned copy_stride = width *
+         (thr->info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t));
+
+      if (src != slot->buffer)
+      {
+         uint8_t *dst = slot->buffer;
+
+         if (src)
+         {
+            unsigned i;
+            for (i = 0; i < height; i++, src += pitch, dst += copy_stride)
+               memcpy(dst, src, copy_stride);
+         }
+
+         pitch        = copy_stride;
+      }
+
+      slot->width     = width;
+      slot->height    = height;
+      slot->pitch     = pitch;
+   }
+
    slock_lock(thr->lock);
 
    if (!thr->nonblock)
@@ -604,7 +663,7 @@ static bool video_thread_frame(void *data, const void *frame_,
       retro_time_t target            = thr->last_time + target_frame_time;
 
       /* Ideally, use absolute time, but that is only a good idea on POSIX. */
-      while (thr->frame.updated)
+      while (thr->frame.rendered != thr->frame.submitted)
       {
          retro_time_t current = cpu_features_get_time_usec();
          retro_time_t delta   = target - current;
@@ -617,48 +676,42 @@ static bool video_thread_frame(void *data, const void *frame_,
       }
    }
 
-   /* Drop frame if updated flag is still set, as thread is
-    * still working on last frame. */
-   if (!thr->frame.updated)
+   if (publish)
    {
-      const uint8_t *src   = (const uint8_t*)frame_;
-      uint8_t       *dst   = thr->frame.buffer;
-      unsigned copy_stride = width *
-         (thr->info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t));
+      unsigned ready     = thr->frame.ready;
 
-      if (src)
-      {
-         int i; /* TODO/FIXME - increment counter never meaningfully used */
-         for (i = 0; i < (int)height; i++, src += pitch, dst += copy_stride)
-            memcpy(dst, src, copy_stride);
-      }
+      /* If the thread is still busy, the new frame replaces
+       * the one it has not picked up yet. */
+      if (thr->frame.fresh)
+         thr->miss_count++;
 
-      thr->frame.updated = true;
-      thr->frame.width   = width;
-      thr->frame.height  = height;
-      thr->frame.count   = frame_count;
-      thr->frame.pitch   = copy_stride;
+      thr->frame.ready   = thr->frame.write;
+      thr->frame.write   = ready;
+      thr->frame.fresh   = true;
+      thr->frame.last    = slot->buffer;
+   }
 
-      if (msg)
-         strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
-      else
-         *thr->frame.msg = '\0';
+   thr->frame.updated    = true;
+   thr->frame.submitted++;
+   thr->frame.count      = frame_count;
+
+   if (msg)
+      strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
+   else
+      *thr->frame.msg = '\0';
 
-      scond_signal(thr->cond_thread);
+   scond_signal(thr->cond_thread);
 
 #ifdef HAVE_MENU
-      if (thr->texture.enable)
+   if (thr->texture.enable)
+   {
+      do
       {
-         do
-         {
-            scond_wait(thr->cond_cmd, thr->lock);
-         } while (thr->frame.updated);
-      }
-#endif
-      thr->hit_count++;
+         scond_wait(thr->cond_cmd, thr->lock);
+      } while (thr->frame.rendered != thr->frame.submitted);
    }
-   else
-      thr->miss_count++;
+#endif
+   thr->hit_count++;
 
    slock_unlock(thr->lock);
 
@@ -695,20 +748,29 @@ static bool video_thread_init(thread_video_t *thr,
       return false;
 
    {
+      unsigned i;
       size_t max_size        = info.input_scale * RARCH_SCALE_BASE;
       max_size              *= max_size;
       max_size              *= info.rgb32 ?
          sizeof(uint32_t) : sizeof(uint16_t);
 
+      for (i = 0; i < ARRAY_SIZE(thr->frame.slots); i++)
+      {
 #ifdef _3DS
-      thr->frame.buffer      = linearMemAlign(max_size, 0x80);
+         thr->frame.slots[i].buffer = linearMemAlign(max_size, 0x80);
 #else
-      thr->frame.buffer      = (uint8_t*)malloc(max_size);
+         thr->frame.slots[i].buffer = (uint8_t*)malloc(max_size);
 #endif
-      if (!thr->frame.buffer)
-         return false;
+         if (!thr->frame.slots[i].buffer)
+            return false;
 
-      memset(thr->frame.buffer, 0x80, max_size);
+         memset(thr->frame.slots[i].buffer, 0x80, max_size);
+      }
+
+      thr->frame.buffer_size = max_size;
+      thr->frame.write       = 0;
+      thr->frame.ready       = 1;
+      thr->frame.read        = 2;
    }
 
    thr->input                = input;
@@ -818,6 +880,7 @@ static bool video_thread_read_viewport(void *data,
 
 static void video_thread_free(void *data)
 {
+   unsigned i;
    thread_video_t *thr = (thread_video_t*)data;
 
    if (thr)
@@ -840,11 +903,14 @@ static void video_thread_free(void *data)
       }
 
       free(thr->texture.frame);
+      for (i = 0; i < ARRAY_SIZE(thr->frame.slots); i++)
+      {
 #ifdef _3DS
-      linearFree(thr->frame.buffer);
+         linearFree(thr->frame.slots[i].buffer);
 #else
-      free(thr->frame.buffer);
+         free(thr->frame.slots[i].buffer);
 #endif
+      }
       free(thr->alpha_mod);
 
       slock_free(thr->frame.lock);
@@ -1258,6 +1324,43 @@ static uint32_t thread_get_flags(void *data)
    return 0;
 }
 
+/* Lets the core render straight into the buffer the next frame
+ * will be pushed from.  Only offered when the frame reaches the
+ * wrapper in the core's own pixel format. */
+static bool thread_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *framebuffer)
+{
+   size_t pitch;
+   enum retro_pixel_format fmt;
+   thread_video_t *thr            = (thread_video_t*)data;
+   video_driver_state_t *video_st = video_state_get_ptr();
+
+   if (!thr || !framebuffer)
+      return false;
+
+   if (thr->info.rgb32)
+   {
+      fmt   = RETRO_PIXEL_FORMAT_XRGB8888;
+      pitch = framebuffer->width * sizeof(uint32_t);
+   }
+   else
+   {
+      fmt   = RETRO_PIXEL_FORMAT_RGB565;
+      pitch = framebuffer->width * sizeof(uint16_t);
+   }
+
+   if (     video_st->pix_fmt != fmt
+         || pitch * framebuffer->height > thr->frame.buffer_size)
+      return false;
+
+   framebuffer->data         = thr->frame.slots[thr->frame.write].buffer;
+   framebuffer->pitch        = pitch;
+   framebuffer->format       = fmt;
+   framebuffer->memory_flags = RETRO_MEMORY_TYPE_CACHED;
+
+   return true;
+}
+
 static const video_poke_interface_t thread_poke = {
    thread_get_flags,
    thread_load_texture,
@@ -1278,7 +1381,7 @@ static const video_poke_interface_t thread_poke = {
    thread_show_mouse,
    thread_grab_mouse_toggle,
    thread_get_current_shader,
-   NULL, /* get_current_software_framebuffer */
+   thread_get_current_software_framebuffer,
    NULL, /* get_hw_render_interface */
    thread_set_hdr_max_nits,
    thread_set_hdr_paper_white_nits,
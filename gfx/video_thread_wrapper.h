@@ -166,6 +166,14 @@ typedef struct thread_packet
    enum thread_cmd type;
 } thread_packet_t;
 
+typedef struct thread_video_frame
+{
+   uint8_t *buffer;
+   unsigned width;
+   unsigned height;
+   unsigned pitch;
+} thread_video_frame_t;
+
 typedef struct thread_video
 {
    retro_time_t last_time;
@@ -218,15 +226,24 @@ typedef struct thread_video
 
    bool alpha_update;
 
+   /* Frames are handed over through three buffers: the one
+    * being written by the main thread (also given to the core
+    * as its software framebuffer), the newest completed one,
+    * and the one being rendered by the video thread. */
    struct
    {
       uint64_t count;
+      uint64_t submitted;   /* Frames pushed by the main thread */
+      uint64_t rendered;    /* Of those, rendered by the video thread */
       slock_t *lock;
-      uint8_t *buffer;
-      unsigned width;
-      unsigned height;
-      unsigned pitch;
+      const uint8_t *last;  /* Buffer of the last pushed frame */
+      size_t buffer_size;
+      thread_video_frame_t slots[3];
+      unsigned write;
+      unsigned ready;
+      unsigned read;
       char msg[NAME_MAX_LENGTH];
+      bool fresh;           /* 'ready' holds a frame not yet rendered */
       bool updated;
       bool within_thread;
    } frame;
@@ -1235,6 +1235,7 @@ THREAD
 #endif
 
 #include "../libretro-common/rthreads/rthreads.c"
+#include "../libretro-common/rthreads/band_pool.c"
 #include "../gfx/video_thread_wrapper.c"
 #include "../audio/audio_thread_wrapper.c"
 #endif
@@ -1307,6 +1308,7 @@ DATA RUNLOOP
 #ifdef HAVE_LIBRETRODB
 #include "../tasks/task_database.c"
 #include "../tasks/task_database_cue.c"
+#include "../tasks/task_database_cache.c"
 #endif
 #if defined(HAVE_NETWORKING) && defined(HAVE_MENU)
 #include "../tasks/task_core_updater.c"
@@ -1518,6 +1520,9 @@ XML
 #ifdef HAVE_LIBRETRODB
 #include "../libretro-db/bintree.c"
 #include "../libretro-db/libretrodb.c"
+#if defined(_WIN32) && !defined(_XBOX)
+#include "../libretro-common/memmap/memmap.c"
+#endif
 #include "../libretro-db/rmsgpack.c"
 #include "../libretro-db/rmsgpack_dom.c"
 #include "../libretro-db/query.c"
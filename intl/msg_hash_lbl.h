@@ -3434,6 +3434,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_REWIND_BUFFER_SIZE_STEP,
    "rewind_buffer_size_step"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_REWIND_THREADED,
+   "rewind_threaded"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_REWIND_SETTINGS,
    "rewind_settings"
@@ -3776,6 +3780,14 @@ MSG_HASH(
    MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS,
    "run_ahead_hide_warnings"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_RUN_AHEAD_SNAPSHOT,
+   "run_ahead_snapshot"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREAD,
+   "run_ahead_secondary_thread"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,
    "run_ahead_frames"
@@ -3784,6 +3796,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_PREEMPT_FRAMES,
    "preemptive_frames"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_PREEMPT_ANALOG_THRESHOLD,
+   "preemptive_frames_analog_threshold"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_SORT_SAVEFILES_ENABLE,
    "sort_savefiles_enable"
@@ -3905,6 +3921,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_ENABLE,
    "threaded_data_runloop_enable"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_WORKERS,
+   "threaded_data_runloop_workers"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_THUMBNAILS,
    "thumbnails"
@@ -4516,6 +4516,22 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_RUN_AHEAD_HIDE_WARNINGS,
    "Hide the warning message that appears when using Run-Ahead and the core does not support save states."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_RUN_AHEAD_SNAPSHOT,
+   "Snapshot Core Memory (Experimental)"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_RUN_AHEAD_SNAPSHOT,
+   "Roll back single instance Run-Ahead by restoring only the core memory pages that changed, instead of loading a save state. Only used for cores whose info file marks them as safe for it. Checked against regular save states and disabled automatically on a mismatch."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_RUN_AHEAD_SECONDARY_THREAD,
+   "Threaded Second Instance"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_RUN_AHEAD_SECONDARY_THREAD,
+   "Run the second instance on its own thread, in parallel with the main core. Reduces the cost of Run-Ahead on multi-core CPUs. Not used with hardware rendered cores."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_PREEMPT_FRAMES,
    "Number of Preemptive Frames"
@@ -4524,6 +4540,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_PREEMPT_FRAMES,
    "The number of frames to rerun. Causes gameplay issues such as jitter if the number of lag frames internal to the game is exceeded."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_PREEMPT_ANALOG_THRESHOLD,
+   "Preemptive Analog Threshold (%)"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_PREEMPT_ANALOG_THRESHOLD,
+   "Largest analog stick change that does not trigger a rerun of preemptive frames. Adapts to the jitter of each controller up to this limit. Reduces CPU usage with noisy sticks. 0 reruns on every change."
+   )
 
 /* Settings > Core */
 
@@ -5123,6 +5147,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_REWIND_BUFFER_SIZE_STEP,
    "Each time the rewind buffer size value is increased or decreased, it will change by this amount."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_REWIND_THREADED,
+   "Threaded Rewind"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_REWIND_THREADED,
+   "Compress rewind states on a separate thread. Reduces frame time spikes on cores with large save states, at the cost of an extra save state worth of memory."
+   )
 
 /* Settings > Frame Throttle > Frame Time Counter */
 
@@ -6246,6 +6278,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_THREADED_DATA_RUNLOOP_ENABLE,
    "Perform tasks on a separate thread."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_THREADED_DATA_RUNLOOP_WORKERS,
+   "Task Worker Threads"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_THREADED_DATA_RUNLOOP_WORKERS,
+   "Number of threads performing tasks. With more than one, saving and screenshots are kept apart from long tasks such as scanning content."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_PAUSE_NONACTIVE,
    "Pause Content When Not Active"
@@ -33,6 +33,7 @@
 #include <compat/posix_string.h>
 #include <retro_miscellaneous.h>
 #include <string/stdstring.h>
+#include <encodings/utf.h>
 #define VFS_FRONTEND
 #include <vfs/vfs_implementation.h>
 
@@ -98,6 +99,59 @@ int32_t path_get_size(const char *path)
    return -1;
 }
 
+/**
+ * path_get_mtime:
+ * @path               : path
+ * @size               : if not NULL, receives the size of @path
+ *
+ * Gets the modification time of @path. Goes straight to the
+ * host filesystem, since the VFS interface has no notion of
+ * file times.
+ *
+ * @return modification time in seconds since the epoch,
+ * or -1 if it cannot be determined.
+ */
+int64_t path_get_mtime(const char *path, int64_t *size)
+{
+#if defined(VITA) || defined(PSP) || defined(__PSL1GHT__) || defined(__PS3__)
+   return -1;
+#else
+#if defined(_WIN32) && !defined(LEGACY_WIN32) && !defined(_XBOX)
+   struct _stat64 buf;
+   int ret            = -1;
+   wchar_t *path_wide = utf8_to_utf16_string_alloc(path);
+
+   if (path_wide)
+   {
+      ret = _wstat64(path_wide, &buf);
+      free(path_wide);
+   }
+   if (ret != 0)
+      return -1;
+#elif defined(_WIN32)
+   struct _stat buf;
+   int ret            = -1;
+   char *path_local   = utf8_to_local_string_alloc(path);
+
+   if (path_local)
+   {
+      ret = _stat(path_local, &buf);
+      free(path_local);
+   }
+   if (ret != 0)
+      return -1;
+#else
+   struct stat buf;
+
+   if (string_is_empty(path) || stat(path, &buf) != 0)
+      return -1;
+#endif
+   if (size)
+      *size = (int64_t)buf.st_size;
+   return (int64_t)buf.st_mtime;
+#endif
+}
+
 /**
  * path_mkdir:
  * @dir                : directory
@@ -45,6 +45,281 @@
 #include <arm_neon.h>
 #endif
 
+/* The SSSE3 and AVX2 row kernels are built on top of the SSE2
+ * baseline with per-function target attributes, and are only
+ * picked if cpu_features_get() reports the extension, so this
+ * file does not need to be compiled with -mssse3 or -mavx2. */
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define PIXCONV_HAVE_X86_SIMD
+#define PIXCONV_SSSE3_TARGET __attribute__((target("ssse3")))
+#define PIXCONV_AVX2_TARGET  __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef PIXCONV_HAVE_X86_SIMD
+#include <immintrin.h>
+#include <features/features_cpu.h>
+
+#define PIXCONV_SIMD_SSSE3 (1 << 0)
+#define PIXCONV_SIMD_AVX2  (1 << 1)
+
+/* Converts the start of a row in whole vectors and returns the
+ * number of pixels done; the generic loops finish the row. */
+typedef int (*pixconv_row_t)(void *output, const void *input, int width);
+
+/* PIXCONV_SIMD_* flags, or -1 until the first conversion */
+static int pixconv_simd_flags = -1;
+
+static int pixconv_simd_detect(void)
+{
+   int flags    = 0;
+   uint64_t cpu = cpu_features_get();
+
+   if (cpu & RETRO_SIMD_SSSE3)
+      flags |= PIXCONV_SIMD_SSSE3;
+   /* RETRO_SIMD_AVX is only set if the OS saves the YMM registers */
+   if ((cpu & RETRO_SIMD_AVX) && (cpu & RETRO_SIMD_AVX2))
+      flags |= PIXCONV_SIMD_AVX2;
+
+   return flags;
+}
+
+/* Returns the widest kernel this CPU can run, or NULL.
+ * Either kernel may be NULL if there is no such variant. */
+static pixconv_row_t pixconv_pick(pixconv_row_t ssse3, pixconv_row_t avx2)
+{
+   /* Concurrent first calls all store the same flags */
+   if (pixconv_simd_flags < 0)
+      pixconv_simd_flags = pixconv_simd_detect();
+
+   if (avx2 && (pixconv_simd_flags & PIXCONV_SIMD_AVX2))
+      return avx2;
+   if (ssse3 && (pixconv_simd_flags & PIXCONV_SIMD_SSSE3))
+      return ssse3;
+   return NULL;
+}
+#endif
+
+#if defined(__SSE2__)
+/* Interleaves 8-bit channels, held in the low byte of each 16-bit
+ * lane, into two vectors of ARGB8888 */
+static INLINE void pixconv_argb_sse2(__m128i r, __m128i g,
+      __m128i b, __m128i a, __m128i *out)
+{
+   out[0] = _mm_or_si128(_mm_unpacklo_epi8(b, g),
+         _mm_slli_si128(_mm_unpacklo_epi8(r, a), 2));
+   out[1] = _mm_or_si128(_mm_unpackhi_epi8(b, g),
+         _mm_slli_si128(_mm_unpackhi_epi8(r, a), 2));
+}
+
+static INLINE void pixconv_rgb565_sse2(__m128i in, __m128i *rgb)
+{
+   rgb[0] = _mm_mulhi_epi16(_mm_and_si128(_mm_srli_epi16(in, 1),
+            _mm_set1_epi16(0x1f << 10)), _mm_set1_epi16(0x0210));
+   rgb[1] = _mm_mulhi_epi16(_mm_and_si128(in,
+            _mm_set1_epi16(0x3f <<  5)), _mm_set1_epi16(0x2080));
+   rgb[2] = _mm_mulhi_epi16(_mm_and_si128(_mm_slli_epi16(in, 5),
+            _mm_set1_epi16(0x1f <<  5)), _mm_set1_epi16(0x4200));
+}
+
+static INLINE void pixconv_0rgb1555_sse2(__m128i in, __m128i *rgb)
+{
+   rgb[0] = _mm_mulhi_epi16(_mm_and_si128(in,
+            _mm_set1_epi16(0x1f << 10)), _mm_set1_epi16(0x0210));
+   rgb[1] = _mm_mulhi_epi16(_mm_and_si128(in,
+            _mm_set1_epi16(0x1f <<  5)), _mm_set1_epi16(0x4200));
+   rgb[2] = _mm_mulhi_epi16(_mm_and_si128(_mm_slli_epi16(in, 5),
+            _mm_set1_epi16(0x1f <<  5)), _mm_set1_epi16(0x4200));
+}
+
+/* Narrows 32-bit lanes holding 16-bit values; packs_epi32 would
+ * saturate anything above 0x7fff, so sign extend them first. */
+static INLINE __m128i pixconv_pack_epi32_sse2(__m128i lo, __m128i hi)
+{
+   lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+   hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+   return _mm_packs_epi32(lo, hi);
+}
+
+static INLINE __m128i pixconv_argb8888_rgb565_sse2(__m128i c)
+{
+   __m128i r = _mm_and_si128(_mm_srli_epi32(c, 8), _mm_set1_epi32(0xf800));
+   __m128i g = _mm_and_si128(_mm_srli_epi32(c, 5), _mm_set1_epi32(0x07e0));
+   __m128i b = _mm_and_si128(_mm_srli_epi32(c, 3), _mm_set1_epi32(0x001f));
+   return _mm_or_si128(r, _mm_or_si128(g, b));
+}
+#endif
+
+#ifdef PIXCONV_HAVE_X86_SIMD
+/* Byte shuffles that pack XRGB/XBGR pixels down to BGR24 */
+#define PIXCONV_PACK_BGR24 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+#define PIXCONV_PACK_RGB24 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+/* Packs 16 pixels in four vectors down to 48 bytes */
+static PIXCONV_SSSE3_TARGET INLINE void pixconv_store_bgr24_ssse3(
+      uint8_t *out, const __m128i *px, __m128i pack)
+{
+   __m128i a = _mm_shuffle_epi8(px[0], pack);
+   __m128i b = _mm_shuffle_epi8(px[1], pack);
+   __m128i c = _mm_shuffle_epi8(px[2], pack);
+   __m128i d = _mm_shuffle_epi8(px[3], pack);
+
+   _mm_storeu_si128((__m128i*)(out +  0),
+         _mm_or_si128(a, _mm_slli_si128(b, 12)));
+   _mm_storeu_si128((__m128i*)(out + 16),
+         _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+   _mm_storeu_si128((__m128i*)(out + 32),
+         _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+}
+
+/* Expands 48 bytes of BGR24 to 16 ARGB8888 pixels */
+static PIXCONV_SSSE3_TARGET INLINE void pixconv_load_bgr24_ssse3(
+      const uint8_t *in, __m128i *px)
+{
+   const __m128i expand = _mm_setr_epi8(
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+   const __m128i alpha  = _mm_set1_epi32((int)0xff000000u);
+   __m128i in0          = _mm_loadu_si128((const __m128i*)(in +  0));
+   __m128i in1          = _mm_loadu_si128((const __m128i*)(in + 16));
+   __m128i in2          = _mm_loadu_si128((const __m128i*)(in + 32));
+
+   px[0] = _mm_or_si128(_mm_shuffle_epi8(in0, expand), alpha);
+   px[1] = _mm_or_si128(_mm_shuffle_epi8(
+            _mm_alignr_epi8(in1, in0, 12), expand), alpha);
+   px[2] = _mm_or_si128(_mm_shuffle_epi8(
+            _mm_alignr_epi8(in2, in1,  8), expand), alpha);
+   px[3] = _mm_or_si128(_mm_shuffle_epi8(
+            _mm_srli_si128(in2, 4), expand), alpha);
+}
+
+/* The AVX2 helpers mirror the SSE2 ones. Unpacks and packs work
+ * within 128-bit lanes, so results are permuted back in order. */
+static PIXCONV_AVX2_TARGET INLINE void pixconv_argb_avx2(__m256i r,
+      __m256i g, __m256i b, __m256i a, __m256i *out)
+{
+   __m256i lo = _mm256_or_si256(_mm256_unpacklo_epi8(b, g),
+         _mm256_slli_si256(_mm256_unpacklo_epi8(r, a), 2));
+   __m256i hi = _mm256_or_si256(_mm256_unpackhi_epi8(b, g),
+         _mm256_slli_si256(_mm256_unpackhi_epi8(r, a), 2));
+   out[0]     = _mm256_permute2x128_si256(lo, hi, 0x20);
+   out[1]     = _mm256_permute2x128_si256(lo, hi, 0x31);
+}
+
+static PIXCONV_AVX2_TARGET INLINE void pixconv_rgb565_avx2(__m256i in,
+      __m256i *rgb)
+{
+   rgb[0] = _mm256_mulhi_epi16(_mm256_and_si256(_mm256_srli_epi16(in, 1),
+            _mm256_set1_epi16(0x1f << 10)), _mm256_set1_epi16(0x0210));
+   rgb[1] = _mm256_mulhi_epi16(_mm256_and_si256(in,
+            _mm256_set1_epi16(0x3f <<  5)), _mm256_set1_epi16(0x2080));
+   rgb[2] = _mm256_mulhi_epi16(_mm256_and_si256(_mm256_slli_epi16(in, 5),
+            _mm256_set1_epi16(0x1f <<  5)), _mm256_set1_epi16(0x4200));
+}
+
+static PIXCONV_AVX2_TARGET INLINE void pixconv_0rgb1555_avx2(__m256i in,
+      __m256i *rgb)
+{
+   rgb[0] = _mm256_mulhi_epi16(_mm256_and_si256(in,
+            _mm256_set1_epi16(0x1f << 10)), _mm256_set1_epi16(0x0210));
+   rgb[1] = _mm256_mulhi_epi16(_mm256_and_si256(in,
+            _mm256_set1_epi16(0x1f <<  5)), _mm256_set1_epi16(0x4200));
+   rgb[2] = _mm256_mulhi_epi16(_mm256_and_si256(_mm256_slli_epi16(in, 5),
+            _mm256_set1_epi16(0x1f <<  5)), _mm256_set1_epi16(0x4200));
+}
+
+static PIXCONV_AVX2_TARGET INLINE __m256i pixconv_pack_epi32_avx2(
+      __m256i lo, __m256i hi)
+{
+   return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+}
+
+static PIXCONV_AVX2_TARGET INLINE __m256i pixconv_argb8888_rgb565_avx2(
+      __m256i c)
+{
+   __m256i r = _mm256_and_si256(_mm256_srli_epi32(c, 8),
+         _mm256_set1_epi32(0xf800));
+   __m256i g = _mm256_and_si256(_mm256_srli_epi32(c, 5),
+         _mm256_set1_epi32(0x07e0));
+   __m256i b = _mm256_and_si256(_mm256_srli_epi32(c, 3),
+         _mm256_set1_epi32(0x001f));
+   return _mm256_or_si256(r, _mm256_or_si256(g, b));
+}
+
+/* Packs 32 pixels in four vectors down to 96 bytes. Each vector
+ * becomes 24 contiguous bytes; the stores overlap so that every
+ * one but the last can be a full 32 byte store. */
+static PIXCONV_AVX2_TARGET INLINE void pixconv_store_bgr24_avx2(
+      uint8_t *out, const __m256i *px, __m256i pack)
+{
+   const __m256i order = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+   __m256i a = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8(px[0], pack), order);
+   __m256i b = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8(px[1], pack), order);
+   __m256i c = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8(px[2], pack), order);
+   __m256i d = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8(px[3], pack), order);
+
+   _mm256_storeu_si256((__m256i*)(out +  0), a);
+   _mm256_storeu_si256((__m256i*)(out + 24), b);
+   _mm256_storeu_si256((__m256i*)(out + 48), c);
+   _mm_storeu_si128((__m128i*)(out + 72), _mm256_castsi256_si128(d));
+   _mm_storel_epi64((__m128i*)(out + 88), _mm256_extracti128_si256(d, 1));
+}
+
+/* Expands 96 bytes of BGR24 to 32 ARGB8888 pixels. Each group of
+ * 8 pixels is spread over the two lanes with a dword permute; the
+ * last group is loaded 8 bytes early so nothing past the input is
+ * read, and starts 4 bytes further into its upper lane. */
+static PIXCONV_AVX2_TARGET INLINE void pixconv_load_bgr24_avx2(
+      const uint8_t *in, __m256i *px)
+{
+   const __m256i spread      = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+   const __m256i spread_last = _mm256_setr_epi32(2, 3, 4, 5, 4, 5, 6, 7);
+   const __m256i expand      = _mm256_setr_epi8(
+         0, 1,  2, -1, 3,  4,  5, -1, 6,  7,  8, -1,  9, 10, 11, -1,
+         0, 1,  2, -1, 3,  4,  5, -1, 6,  7,  8, -1,  9, 10, 11, -1);
+   const __m256i expand_last = _mm256_setr_epi8(
+         0, 1,  2, -1, 3,  4,  5, -1, 6,  7,  8, -1,  9, 10, 11, -1,
+         4, 5,  6, -1, 7,  8,  9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+   const __m256i alpha       = _mm256_set1_epi32((int)0xff000000u);
+   int i;
+
+   for (i = 0; i < 3; i++)
+      px[i] = _mm256_or_si256(_mm256_shuffle_epi8(
+               _mm256_permutevar8x32_epi32(_mm256_loadu_si256(
+                     (const __m256i*)(in + i * 24)), spread), expand), alpha);
+
+   px[3] = _mm256_or_si256(_mm256_shuffle_epi8(
+            _mm256_permutevar8x32_epi32(_mm256_loadu_si256(
+                  (const __m256i*)(in + 64)), spread_last), expand_last), alpha);
+}
+#endif
+
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_rgb565_0rgb1555_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+   const __m256i hi_mask = _mm256_set1_epi16(0x7fe0);
+   const __m256i lo_mask = _mm256_set1_epi16(0x1f);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i hi = _mm256_and_si256(_mm256_srli_epi16(in, 1), hi_mask);
+      __m256i lo = _mm256_and_si256(in, lo_mask);
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_or_si256(hi, lo));
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -52,25 +327,44 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint16_t *output = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row       = pixconv_pick(NULL, conv_rgb565_0rgb1555_avx2);
+#endif
 
 #if defined(__SSE2__)
    int max_width           = width - 7;
    const __m128i hi_mask   = _mm_set1_epi16(0x7fe0);
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width           = width - 7;
+   const uint16x8_t hi_mask = vdupq_n_u16(0x7fe0);
+   const uint16x8_t lo_mask = vdupq_n_u16(0x1f);
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
          const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
-         __m128i hi = _mm_and_si128(_mm_slli_epi16(in, 1), hi_mask);
+         __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 1), hi_mask);
          __m128i lo = _mm_and_si128(in, lo_mask);
          _mm_storeu_si128((__m128i*)(output + w), _mm_or_si128(hi, lo));
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t hi = vandq_u16(vshrq_n_u16(in, 1), hi_mask);
+         uint16x8_t lo = vandq_u16(in, lo_mask);
+         vst1q_u16(output + w, vorrq_u16(hi, lo));
+      }
 #endif
 
       for (; w < width; w++)
@@ -83,6 +377,32 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_0rgb1555_rgb565_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input   = (const uint16_t*)input_;
+   uint16_t *output        = (uint16_t*)output_;
+   const __m256i hi_mask   = _mm256_set1_epi16(
+         (int16_t)((0x1f << 11) | (0x1f << 6)));
+   const __m256i lo_mask   = _mm256_set1_epi16(0x1f);
+   const __m256i glow_mask = _mm256_set1_epi16(1 << 5);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i rg   = _mm256_and_si256(_mm256_slli_epi16(in, 1), hi_mask);
+      __m256i b    = _mm256_and_si256(in, lo_mask);
+      __m256i glow = _mm256_and_si256(_mm256_srli_epi16(in, 4), glow_mask);
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_or_si256(rg, _mm256_or_si256(b, glow)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_0rgb1555_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -90,6 +410,9 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
    int h;
    const uint16_t *input   = (const uint16_t*)input_;
    uint16_t *output        = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row       = pixconv_pick(NULL, conv_0rgb1555_rgb565_avx2);
+#endif
 
 #if defined(__SSE2__)
    int max_width           = width - 7;
@@ -98,12 +421,22 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          (int16_t)((0x1f << 11) | (0x1f << 6)));
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
    const __m128i glow_mask = _mm_set1_epi16(1 << 5);
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width              = width - 7;
+
+   const uint16x8_t hi_mask   = vdupq_n_u16((0x1f << 11) | (0x1f << 6));
+   const uint16x8_t lo_mask   = vdupq_n_u16(0x1f);
+   const uint16x8_t glow_mask = vdupq_n_u16(1 << 5);
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -114,6 +447,15 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(output + w),
                _mm_or_si128(rg, _mm_or_si128(b, glow)));
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in   = vld1q_u16(input + w);
+         uint16x8_t rg   = vandq_u16(vshlq_n_u16(in, 1), hi_mask);
+         uint16x8_t b    = vandq_u16(in, lo_mask);
+         uint16x8_t glow = vandq_u16(vshrq_n_u16(in, 4), glow_mask);
+         vst1q_u16(output + w, vorrq_u16(rg, vorrq_u16(b, glow)));
+      }
 #endif
 
       for (; w < width; w++)
@@ -127,6 +469,29 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_0rgb1555_argb8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m256i a       = _mm256_set1_epi16(0x00ff);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i rgb[3], res[2];
+      pixconv_0rgb1555_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), rgb);
+      pixconv_argb_avx2(rgb[0], rgb[1], rgb[2], a, res);
+      _mm256_storeu_si256((__m256i*)(output + w + 0), res[0]);
+      _mm256_storeu_si256((__m256i*)(output + w + 8), res[1]);
+   }
+
+   return w;
+}
+#endif
+
 void conv_0rgb1555_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -134,6 +499,9 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(NULL, conv_0rgb1555_argb8888_avx2);
+#endif
 
 #ifdef __SSE2__
    const __m128i pix_mask_r  = _mm_set1_epi16(0x1f << 10);
@@ -142,6 +510,10 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    const __m128i mul15_hi    = _mm_set1_epi16(0x0210);
    const __m128i a           = _mm_set1_epi16(0x00ff);
 
+   int max_width = width - 7;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   const uint16x8_t mask     = vdupq_n_u16(0x1f);
+
    int max_width = width - 7;
 #endif
 
@@ -149,6 +521,10 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
 #ifdef __SSE2__
       for (; w < max_width; w += 8)
       {
@@ -177,6 +553,22 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(output + w + 0), res_lo);
          _mm_storeu_si128((__m128i*)(output + w + 4), res_hi);
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t r  = vandq_u16(vshrq_n_u16(in, 10), mask);
+         uint16x8_t g  = vandq_u16(vshrq_n_u16(in,  5), mask);
+         uint16x8_t b  = vandq_u16(in, mask);
+
+         uint8x8x4_t res;
+         res.val[3] = vdup_n_u8(0xffu);
+         res.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2)));
+         res.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2)));
+         res.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2)));
+
+         vst4_u8((uint8_t*)(output + w), res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -194,6 +586,29 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_rgb565_argb8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m256i a       = _mm256_set1_epi16(0x00ff);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i rgb[3], res[2];
+      pixconv_rgb565_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), rgb);
+      pixconv_argb_avx2(rgb[0], rgb[1], rgb[2], a, res);
+      _mm256_storeu_si256((__m256i*)(output + w + 0), res[0]);
+      _mm256_storeu_si256((__m256i*)(output + w + 8), res[1]);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -201,6 +616,9 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    int h;
    const uint16_t *input    = (const uint16_t*)input_;
    uint32_t *output         = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row        = pixconv_pick(NULL, conv_rgb565_argb8888_avx2);
+#endif
 
 #if defined(__SSE2__)
    const __m128i pix_mask_r = _mm_set1_epi16(0x1f << 10);
@@ -230,6 +648,10 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -320,6 +742,29 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_rgb565_abgr8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m256i a       = _mm256_set1_epi16(0x00ff);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i rgb[3], res[2];
+      pixconv_rgb565_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), rgb);
+      pixconv_argb_avx2(rgb[2], rgb[1], rgb[0], a, res);
+      _mm256_storeu_si256((__m256i*)(output + w + 0), res[0]);
+      _mm256_storeu_si256((__m256i*)(output + w + 8), res[1]);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_abgr8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -327,6 +772,9 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
    int h;
    const uint16_t *input    = (const uint16_t*)input_;
    uint32_t *output         = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row        = pixconv_pick(NULL, conv_rgb565_abgr8888_avx2);
+#endif
  #if defined(__SSE2__)
    const __m128i pix_mask_r = _mm_set1_epi16(0x1f << 10);
    const __m128i pix_mask_g = _mm_set1_epi16(0x3f <<  5);
@@ -343,11 +791,15 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
          __m128i res_lo, res_hi;
-         __m128i res_lo_bg, res_hi_bg, res_lo_ra, res_hi_ra;
+         __m128i res_lo_rg, res_hi_rg, res_lo_ba, res_hi_ba;
          const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
          __m128i        r = _mm_and_si128(_mm_srli_epi16(in, 1), pix_mask_r);
          __m128i        g = _mm_and_si128(in, pix_mask_g);
@@ -355,14 +807,14 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          r                = _mm_mulhi_epi16(r, mul16_r);
          g                = _mm_mulhi_epi16(g, mul16_g);
          b                = _mm_mulhi_epi16(b, mul16_b);
-         res_lo_bg        = _mm_unpacklo_epi8(b, g);
-         res_hi_bg        = _mm_unpackhi_epi8(b, g);
-         res_lo_ra        = _mm_unpacklo_epi8(r, a);
-         res_hi_ra        = _mm_unpackhi_epi8(r, a);
-         res_lo           = _mm_or_si128(res_lo_bg,
-               _mm_slli_si128(res_lo_ra, 2));
-         res_hi           = _mm_or_si128(res_hi_bg,
-               _mm_slli_si128(res_hi_ra, 2));
+         res_lo_rg        = _mm_unpacklo_epi8(r, g);
+         res_hi_rg        = _mm_unpackhi_epi8(r, g);
+         res_lo_ba        = _mm_unpacklo_epi8(b, a);
+         res_hi_ba        = _mm_unpackhi_epi8(b, a);
+         res_lo           = _mm_or_si128(res_lo_rg,
+               _mm_slli_si128(res_lo_ba, 2));
+         res_hi           = _mm_or_si128(res_hi_rg,
+               _mm_slli_si128(res_hi_ba, 2));
          _mm_storeu_si128((__m128i*)(output + w + 0), res_lo);
          _mm_storeu_si128((__m128i*)(output + w + 4), res_hi);
       }
@@ -398,34 +850,141 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
    }
 }
 
+#if defined(__SSE2__)
+static INLINE __m128i pixconv_argb8888_rgba4444_sse2(__m128i c)
+{
+   __m128i r = _mm_and_si128(_mm_srli_epi32(c, 8), _mm_set1_epi32(0xf000));
+   __m128i g = _mm_and_si128(_mm_srli_epi32(c, 4), _mm_set1_epi32(0x0f00));
+   __m128i b = _mm_and_si128(c, _mm_set1_epi32(0x00f0));
+   __m128i a = _mm_srli_epi32(c, 28);
+   return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+#endif
+
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_argb8888_rgba4444_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+   const __m256i r_mask  = _mm256_set1_epi32(0xf000);
+   const __m256i g_mask  = _mm256_set1_epi32(0x0f00);
+   const __m256i b_mask  = _mm256_set1_epi32(0x00f0);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i res[2];
+      int i;
+
+      for (i = 0; i < 2; i++)
+      {
+         __m256i c = _mm256_loadu_si256((const __m256i*)(input + w + i * 8));
+         __m256i r = _mm256_and_si256(_mm256_srli_epi32(c, 8), r_mask);
+         __m256i g = _mm256_and_si256(_mm256_srli_epi32(c, 4), g_mask);
+         __m256i b = _mm256_and_si256(c, b_mask);
+         __m256i a = _mm256_srli_epi32(c, 28);
+         res[i]    = _mm256_or_si256(_mm256_or_si256(r, g),
+               _mm256_or_si256(b, a));
+      }
+
+      _mm256_storeu_si256((__m256i*)(output + w),
+            pixconv_pack_epi32_avx2(res[0], res[1]));
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_rgba4444(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(NULL, conv_argb8888_rgba4444_avx2);
+#endif
+#if defined(__SSE2__) || (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width         = width - 7;
+#endif
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   const uint8x8_t mask  = vdup_n_u8(0xf0);
+#endif
 
    for (h = 0; h < height;
-         h++, output += out_stride >> 2, input += in_stride >> 1)
+         h++, output += out_stride >> 1, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i lo = _mm_loadu_si128((const __m128i*)(input + w + 0));
+         __m128i hi = _mm_loadu_si128((const __m128i*)(input + w + 4));
+         _mm_storeu_si128((__m128i*)(output + w), pixconv_pack_epi32_sse2(
+                  pixconv_argb8888_rgba4444_sse2(lo),
+                  pixconv_argb8888_rgba4444_sse2(hi)));
+      }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+         uint16x8_t r   = vshll_n_u8(vand_u8(in.val[2], mask), 8);
+         uint16x8_t g   = vshll_n_u8(vand_u8(in.val[1], mask), 4);
+         uint16x8_t b   = vmovl_u8(vand_u8(in.val[0], mask));
+         uint16x8_t a   = vmovl_u8(vshr_n_u8(in.val[3], 4));
+         vst1q_u16(output + w, vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
-         uint32_t r   = (col >> 16) & 0xf;
-         uint32_t g   = (col >>  8) & 0xf;
-         uint32_t b   = (col) & 0xf;
-         uint32_t a   = (col >>  24) & 0xf;
-         r            = (r >> 4) | r;
-         g            = (g >> 4) | g;
-         b            = (b >> 4) | b;
-         a            = (a >> 4) | a;
+         uint32_t r   = (col >> 20) & 0xf;
+         uint32_t g   = (col >> 12) & 0xf;
+         uint32_t b   = (col >>  4) & 0xf;
+         uint32_t a   = (col >> 28) & 0xf;
 
          output[w]    = (r << 12) | (g << 8) | (b << 4) | a;
       }
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_rgba4444_argb8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m256i mask    = _mm256_set1_epi16(0xf);
+   const __m256i mul     = _mm256_set1_epi16(0x11);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i res[2];
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i r = _mm256_mullo_epi16(_mm256_srli_epi16(in, 12), mul);
+      __m256i g = _mm256_mullo_epi16(_mm256_and_si256(
+               _mm256_srli_epi16(in, 8), mask), mul);
+      __m256i b = _mm256_mullo_epi16(_mm256_and_si256(
+               _mm256_srli_epi16(in, 4), mask), mul);
+      __m256i a = _mm256_mullo_epi16(_mm256_and_si256(in, mask), mul);
+
+      pixconv_argb_avx2(r, g, b, a, res);
+      _mm256_storeu_si256((__m256i*)(output + w + 0), res[0]);
+      _mm256_storeu_si256((__m256i*)(output + w + 8), res[1]);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgba4444_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -433,24 +992,57 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(NULL, conv_rgba4444_argb8888_avx2);
+#endif
+
+#if defined(__SSE2__)
+   const __m128i mask    = _mm_set1_epi16(0xf);
+   const __m128i mul     = _mm_set1_epi16(0x11);
 
-#if defined(__MMX__)
+   int max_width         = width - 7;
+#elif defined(__MMX__)
    const __m64 pix_mask_r = _mm_set1_pi16(0xf << 10);
    const __m64 pix_mask_g = _mm_set1_pi16(0xf << 8);
    const __m64 pix_mask_b = _mm_set1_pi16(0xf << 8);
+   const __m64 pix_mask_a = _mm_set1_pi16(0xf);
    const __m64 mul16_r    = _mm_set1_pi16(0x0440);
    const __m64 mul16_g    = _mm_set1_pi16(0x1100);
    const __m64 mul16_b    = _mm_set1_pi16(0x1100);
-   const __m64 a          = _mm_set1_pi16(0x00ff);
+   const __m64 mul16_a    = _mm_set1_pi16(0x11);
 
    int max_width            = width - 3;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   const uint16x8_t mask    = vdupq_n_u16(0xf);
+
+   int max_width            = width - 7;
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
-#if defined(__MMX__)
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i res[2];
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i r = _mm_mullo_epi16(_mm_srli_epi16(in, 12), mul);
+         __m128i g = _mm_mullo_epi16(_mm_and_si128(
+                  _mm_srli_epi16(in, 8), mask), mul);
+         __m128i b = _mm_mullo_epi16(_mm_and_si128(
+                  _mm_srli_epi16(in, 4), mask), mul);
+         __m128i a = _mm_mullo_epi16(_mm_and_si128(in, mask), mul);
+
+         pixconv_argb_sse2(r, g, b, a, res);
+         _mm_storeu_si128((__m128i*)(output + w + 0), res[0]);
+         _mm_storeu_si128((__m128i*)(output + w + 4), res[1]);
+      }
+#elif defined(__MMX__)
       for (; w < max_width; w += 4)
       {
          __m64 res_lo, res_hi;
@@ -459,10 +1051,12 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
          __m64          r = _mm_and_si64(_mm_srli_pi16(in, 2), pix_mask_r);
          __m64          g = _mm_and_si64(in, pix_mask_g);
          __m64          b = _mm_and_si64(_mm_slli_pi16(in, 4), pix_mask_b);
+         __m64          a = _mm_and_si64(in, pix_mask_a);
 
          r                = _mm_mulhi_pi16(r, mul16_r);
          g                = _mm_mulhi_pi16(g, mul16_g);
          b                = _mm_mulhi_pi16(b, mul16_b);
+         a                = _mm_mullo_pi16(a, mul16_a);
 
          res_lo_bg        = _mm_unpacklo_pi8(b, g);
          res_hi_bg        = _mm_unpackhi_pi8(b, g);
@@ -479,6 +1073,23 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
       }
 
       _mm_empty();
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+         uint8x8_t r   = vmovn_u16(vshrq_n_u16(in, 12));
+         uint8x8_t g   = vmovn_u16(vandq_u16(vshrq_n_u16(in, 8), mask));
+         uint8x8_t b   = vmovn_u16(vandq_u16(vshrq_n_u16(in, 4), mask));
+         uint8x8_t a   = vmovn_u16(vandq_u16(in, mask));
+
+         uint8x8x4_t res;
+         res.val[3] = vsli_n_u8(a, a, 4);
+         res.val[2] = vsli_n_u8(r, r, 4);
+         res.val[1] = vsli_n_u8(g, g, 4);
+         res.val[0] = vsli_n_u8(b, b, 4);
+
+         vst4_u8((uint8_t*)(output + w), res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -498,23 +1109,88 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_rgba4444_rgb565_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+   const __m256i r_mask  = _mm256_set1_epi16((int16_t)0xf000);
+   const __m256i g_mask  = _mm256_set1_epi16(0x0780);
+   const __m256i b_mask  = _mm256_set1_epi16(0x001e);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i r = _mm256_and_si256(in, r_mask);
+      __m256i g = _mm256_and_si256(_mm256_srli_epi16(in, 1), g_mask);
+      __m256i b = _mm256_and_si256(_mm256_srli_epi16(in, 3), b_mask);
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_or_si256(r, _mm256_or_si256(g, b)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgba4444_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(NULL, conv_rgba4444_rgb565_avx2);
+#endif
+#if defined(__SSE2__)
+   const __m128i r_mask  = _mm_set1_epi16((int16_t)0xf000);
+   const __m128i g_mask  = _mm_set1_epi16(0x0780);
+   const __m128i b_mask  = _mm_set1_epi16(0x001e);
+   int max_width         = width - 7;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   const uint16x8_t r_mask = vdupq_n_u16(0xf000);
+   const uint16x8_t g_mask = vdupq_n_u16(0x0780);
+   const uint16x8_t b_mask = vdupq_n_u16(0x001e);
+   int max_width           = width - 7;
+#endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
       {
-         uint32_t col = input[w];
-         uint32_t r   = (col >> 12) & 0xf;
-         uint32_t g   = (col >>  8) & 0xf;
-         uint32_t b   = (col >>  4) & 0xf;
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i r = _mm_and_si128(in, r_mask);
+         __m128i g = _mm_and_si128(_mm_srli_epi16(in, 1), g_mask);
+         __m128i b = _mm_and_si128(_mm_srli_epi16(in, 3), b_mask);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(r, _mm_or_si128(g, b)));
+      }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t r  = vandq_u16(in, r_mask);
+         uint16x8_t g  = vandq_u16(vshrq_n_u16(in, 1), g_mask);
+         uint16x8_t b  = vandq_u16(vshrq_n_u16(in, 3), b_mask);
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
+      {
+         uint32_t col = input[w];
+         uint32_t r   = (col >> 12) & 0xf;
+         uint32_t g   = (col >>  8) & 0xf;
+         uint32_t b   = (col >>  4) & 0xf;
 
          output[w]    = (r << 12) | (g << 7) | (b << 1);
       }
@@ -568,6 +1244,57 @@ static INLINE void store_bgr24_sse2(void *output, __m128i a,
 }
 #endif
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_0rgb1555_bgr24_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m128i pack    = _mm_setr_epi8(PIXCONV_PACK_BGR24);
+   const __m128i a       = _mm_setzero_si128();
+
+   for (w = 0; w + 16 <= width; w += 16, out += 48)
+   {
+      __m128i rgb[3], px[4];
+      pixconv_0rgb1555_sse2(
+            _mm_loadu_si128((const __m128i*)(input + w + 0)), rgb);
+      pixconv_argb_sse2(rgb[0], rgb[1], rgb[2], a, px + 0);
+      pixconv_0rgb1555_sse2(
+            _mm_loadu_si128((const __m128i*)(input + w + 8)), rgb);
+      pixconv_argb_sse2(rgb[0], rgb[1], rgb[2], a, px + 2);
+      pixconv_store_bgr24_ssse3(out, px, pack);
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_0rgb1555_bgr24_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m256i pack    = _mm256_setr_epi8(
+         PIXCONV_PACK_BGR24, PIXCONV_PACK_BGR24);
+   const __m256i a       = _mm256_setzero_si256();
+
+   for (w = 0; w + 32 <= width; w += 32, out += 96)
+   {
+      __m256i rgb[3], px[4];
+      pixconv_0rgb1555_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w +  0)), rgb);
+      pixconv_argb_avx2(rgb[0], rgb[1], rgb[2], a, px + 0);
+      pixconv_0rgb1555_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w + 16)), rgb);
+      pixconv_argb_avx2(rgb[0], rgb[1], rgb[2], a, px + 2);
+      pixconv_store_bgr24_avx2(out, px, pack);
+   }
+
+   return w;
+}
+#endif
+
 void conv_0rgb1555_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -575,6 +1302,10 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    int h;
    const uint16_t *input     = (const uint16_t*)input_;
    uint8_t *output           = (uint8_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row         = pixconv_pick(conv_0rgb1555_bgr24_ssse3,
+         conv_0rgb1555_bgr24_avx2);
+#endif
 
 #if defined(__SSE2__)
    const __m128i pix_mask_r  = _mm_set1_epi16(0x1f << 10);
@@ -584,6 +1315,10 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    const __m128i a           = _mm_set1_epi16(0x00ff);
 
    int max_width             = width - 15;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   const uint16x8_t mask     = vdupq_n_u16(0x1f);
+
+   int max_width             = width - 7;
 #endif
 
    for (h = 0; h < height;
@@ -592,6 +1327,13 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
       uint8_t *out = output;
       int   w = 0;
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -635,6 +1377,21 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
          /* Non-POT pixel sizes for the loss */
          store_bgr24_sse2(out, res_lo0, res_hi0, res_lo1, res_hi1);
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8, out += 24)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t r  = vandq_u16(vshrq_n_u16(in, 10), mask);
+         uint16x8_t g  = vandq_u16(vshrq_n_u16(in,  5), mask);
+         uint16x8_t b  = vandq_u16(in, mask);
+
+         uint8x8x3_t res;
+         res.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2)));
+         res.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2)));
+         res.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2)));
+
+         vst3_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -654,6 +1411,57 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_rgb565_bgr24_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m128i pack    = _mm_setr_epi8(PIXCONV_PACK_BGR24);
+   const __m128i a       = _mm_setzero_si128();
+
+   for (w = 0; w + 16 <= width; w += 16, out += 48)
+   {
+      __m128i rgb[3], px[4];
+      pixconv_rgb565_sse2(
+            _mm_loadu_si128((const __m128i*)(input + w + 0)), rgb);
+      pixconv_argb_sse2(rgb[0], rgb[1], rgb[2], a, px + 0);
+      pixconv_rgb565_sse2(
+            _mm_loadu_si128((const __m128i*)(input + w + 8)), rgb);
+      pixconv_argb_sse2(rgb[0], rgb[1], rgb[2], a, px + 2);
+      pixconv_store_bgr24_ssse3(out, px, pack);
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_rgb565_bgr24_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m256i pack    = _mm256_setr_epi8(
+         PIXCONV_PACK_BGR24, PIXCONV_PACK_BGR24);
+   const __m256i a       = _mm256_setzero_si256();
+
+   for (w = 0; w + 32 <= width; w += 32, out += 96)
+   {
+      __m256i rgb[3], px[4];
+      pixconv_rgb565_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w +  0)), rgb);
+      pixconv_argb_avx2(rgb[0], rgb[1], rgb[2], a, px + 0);
+      pixconv_rgb565_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w + 16)), rgb);
+      pixconv_argb_avx2(rgb[0], rgb[1], rgb[2], a, px + 2);
+      pixconv_store_bgr24_avx2(out, px, pack);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -661,6 +1469,10 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    int h;
    const uint16_t *input    = (const uint16_t*)input_;
    uint8_t *output          = (uint8_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row        = pixconv_pick(conv_rgb565_bgr24_ssse3,
+         conv_rgb565_bgr24_avx2);
+#endif
 
 #if defined(__SSE2__)
    const __m128i pix_mask_r = _mm_set1_epi16(0x1f << 10);
@@ -672,12 +1484,21 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    const __m128i a          = _mm_set1_epi16(0x00ff);
 
    int max_width            = width - 15;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width            = width - 7;
 #endif
 
    for (h = 0; h < height; h++, output += out_stride, input += in_stride >> 1)
    {
       uint8_t *out = output;
       int        w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -720,6 +1541,22 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
 
          store_bgr24_sse2(out, res_lo0, res_hi0, res_lo1, res_hi1);
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8, out += 24)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+
+         uint16x8_t r = vsriq_n_u16(in, in, 5);
+         uint16x8_t b = vsliq_n_u16(in, in, 5);
+         uint16x8_t g = vsriq_n_u16(b,  b,  6);
+
+         uint8x8x3_t res;
+         res.val[2] = vshrn_n_u16(r, 8);
+         res.val[1] = vshrn_n_u16(g, 8);
+         res.val[0] = vshrn_n_u16(b, 2);
+
+         vst3_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -739,19 +1576,90 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_bgr24_argb8888_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint8_t *inp = (const uint8_t*)input_;
+   uint32_t *output   = (uint32_t*)output_;
+
+   for (w = 0; w + 16 <= width; w += 16, inp += 48)
+   {
+      __m128i px[4];
+      pixconv_load_bgr24_ssse3(inp, px);
+      _mm_storeu_si128((__m128i*)(output + w +  0), px[0]);
+      _mm_storeu_si128((__m128i*)(output + w +  4), px[1]);
+      _mm_storeu_si128((__m128i*)(output + w +  8), px[2]);
+      _mm_storeu_si128((__m128i*)(output + w + 12), px[3]);
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_bgr24_argb8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint8_t *inp = (const uint8_t*)input_;
+   uint32_t *output   = (uint32_t*)output_;
+
+   for (w = 0; w + 32 <= width; w += 32, inp += 96)
+   {
+      __m256i px[4];
+      pixconv_load_bgr24_avx2(inp, px);
+      _mm256_storeu_si256((__m256i*)(output + w +  0), px[0]);
+      _mm256_storeu_si256((__m256i*)(output + w +  8), px[1]);
+      _mm256_storeu_si256((__m256i*)(output + w + 16), px[2]);
+      _mm256_storeu_si256((__m256i*)(output + w + 24), px[3]);
+   }
+
+   return w;
+}
+#endif
+
 void conv_bgr24_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint8_t *input = (const uint8_t*)input_;
    uint32_t *output     = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row    = pixconv_pick(conv_bgr24_argb8888_ssse3,
+         conv_bgr24_argb8888_avx2);
+#endif
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width        = width - 15;
+#endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride)
    {
       const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      int w              = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         inp += w * 3;
+      }
+#endif
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 16, inp += 48)
+      {
+         uint8x16x3_t in = vld3q_u8(inp);
+         uint8x16x4_t res;
+         res.val[3] = vdupq_n_u8(0xffu);
+         res.val[2] = in.val[2];
+         res.val[1] = in.val[1];
+         res.val[0] = in.val[0];
+
+         vst4q_u8((uint8_t*)(output + w), res);
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t b = *inp++;
          uint32_t g = *inp++;
@@ -761,40 +1669,189 @@ void conv_bgr24_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_bgr24_rgb565_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint8_t *inp = (const uint8_t*)input_;
+   uint16_t *output   = (uint16_t*)output_;
+
+   for (w = 0; w + 16 <= width; w += 16, inp += 48)
+   {
+      __m128i px[4];
+      pixconv_load_bgr24_ssse3(inp, px);
+      _mm_storeu_si128((__m128i*)(output + w + 0), pixconv_pack_epi32_sse2(
+               pixconv_argb8888_rgb565_sse2(px[0]),
+               pixconv_argb8888_rgb565_sse2(px[1])));
+      _mm_storeu_si128((__m128i*)(output + w + 8), pixconv_pack_epi32_sse2(
+               pixconv_argb8888_rgb565_sse2(px[2]),
+               pixconv_argb8888_rgb565_sse2(px[3])));
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_bgr24_rgb565_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint8_t *inp = (const uint8_t*)input_;
+   uint16_t *output   = (uint16_t*)output_;
+
+   for (w = 0; w + 32 <= width; w += 32, inp += 96)
+   {
+      __m256i px[4];
+      pixconv_load_bgr24_avx2(inp, px);
+      _mm256_storeu_si256((__m256i*)(output + w +  0),
+            pixconv_pack_epi32_avx2(
+               pixconv_argb8888_rgb565_avx2(px[0]),
+               pixconv_argb8888_rgb565_avx2(px[1])));
+      _mm256_storeu_si256((__m256i*)(output + w + 16),
+            pixconv_pack_epi32_avx2(
+               pixconv_argb8888_rgb565_avx2(px[2]),
+               pixconv_argb8888_rgb565_avx2(px[3])));
+   }
+
+   return w;
+}
+#endif
+
 void conv_bgr24_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint8_t *input = (const uint8_t*)input_;
    uint16_t *output     = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row    = pixconv_pick(conv_bgr24_rgb565_ssse3,
+         conv_bgr24_rgb565_avx2);
+#endif
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width        = width - 7;
+#endif
+
    for (h = 0; h < height;
-         h++, output += out_stride, input += in_stride)
+         h++, output += out_stride >> 1, input += in_stride)
    {
       const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      int w              = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         inp += w * 3;
+      }
+#endif
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8, inp += 24)
+      {
+         uint8x8x3_t in = vld3_u8(inp);
+         uint16x8_t r   = vshll_n_u8(vand_u8(in.val[2], vdup_n_u8(0xf8)), 8);
+         uint16x8_t g   = vshll_n_u8(vand_u8(in.val[1], vdup_n_u8(0xfc)), 3);
+         uint16x8_t b   = vmovl_u8(vshr_n_u8(in.val[0], 3));
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint16_t b = *inp++;
          uint16_t g = *inp++;
          uint16_t r = *inp++;
-    
+
          output[w] = ((r & 0x00F8) << 8) | ((g&0x00FC) << 3) | ((b&0x00F8) >> 3);
-      }  
+      }
+   }
+}
+
+#if defined(__SSE2__)
+static INLINE __m128i pixconv_argb8888_0rgb1555_sse2(__m128i c)
+{
+   __m128i r = _mm_and_si128(_mm_srli_epi32(c, 9), _mm_set1_epi32(0x7c00));
+   __m128i g = _mm_and_si128(_mm_srli_epi32(c, 6), _mm_set1_epi32(0x03e0));
+   __m128i b = _mm_and_si128(_mm_srli_epi32(c, 3), _mm_set1_epi32(0x001f));
+   return _mm_or_si128(r, _mm_or_si128(g, b));
+}
+#endif
+
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_argb8888_0rgb1555_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+   const __m256i r_mask  = _mm256_set1_epi32(0x7c00);
+   const __m256i g_mask  = _mm256_set1_epi32(0x03e0);
+   const __m256i b_mask  = _mm256_set1_epi32(0x001f);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i res[2];
+      int i;
+
+      for (i = 0; i < 2; i++)
+      {
+         __m256i c = _mm256_loadu_si256((const __m256i*)(input + w + i * 8));
+         __m256i r = _mm256_and_si256(_mm256_srli_epi32(c, 9), r_mask);
+         __m256i g = _mm256_and_si256(_mm256_srli_epi32(c, 6), g_mask);
+         __m256i b = _mm256_and_si256(_mm256_srli_epi32(c, 3), b_mask);
+         res[i]    = _mm256_or_si256(r, _mm256_or_si256(g, b));
+      }
+
+      _mm256_storeu_si256((__m256i*)(output + w),
+            pixconv_pack_epi32_avx2(res[0], res[1]));
    }
+
+   return w;
 }
+#endif
 
 void conv_argb8888_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(NULL, conv_argb8888_0rgb1555_avx2);
+#endif
+#if defined(__SSE2__) || (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width         = width - 7;
+#endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i lo = _mm_loadu_si128((const __m128i*)(input + w + 0));
+         __m128i hi = _mm_loadu_si128((const __m128i*)(input + w + 4));
+         _mm_storeu_si128((__m128i*)(output + w), pixconv_pack_epi32_sse2(
+                  pixconv_argb8888_0rgb1555_sse2(lo),
+                  pixconv_argb8888_0rgb1555_sse2(hi)));
+      }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+         uint16x8_t r   = vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10);
+         uint16x8_t g   = vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),  5);
+         uint16x8_t b   = vmovl_u8(vshr_n_u8(in.val[0], 3));
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          uint16_t r   = (col >> 19) & 0x1f;
@@ -805,6 +1862,125 @@ void conv_argb8888_0rgb1555(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_AVX2_TARGET int conv_argb8888_rgb565_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i lo = _mm256_loadu_si256((const __m256i*)(input + w + 0));
+      __m256i hi = _mm256_loadu_si256((const __m256i*)(input + w + 8));
+      _mm256_storeu_si256((__m256i*)(output + w), pixconv_pack_epi32_avx2(
+               pixconv_argb8888_rgb565_avx2(lo),
+               pixconv_argb8888_rgb565_avx2(hi)));
+   }
+
+   return w;
+}
+#endif
+
+void conv_argb8888_rgb565(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(NULL, conv_argb8888_rgb565_avx2);
+#endif
+#if defined(__SSE2__) || (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width         = width - 7;
+#endif
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 1, input += in_stride >> 2)
+   {
+      int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i lo = _mm_loadu_si128((const __m128i*)(input + w + 0));
+         __m128i hi = _mm_loadu_si128((const __m128i*)(input + w + 4));
+         _mm_storeu_si128((__m128i*)(output + w), pixconv_pack_epi32_sse2(
+                  pixconv_argb8888_rgb565_sse2(lo),
+                  pixconv_argb8888_rgb565_sse2(hi)));
+      }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+         uint16x8_t r   = vshll_n_u8(vand_u8(in.val[2], vdup_n_u8(0xf8)), 8);
+         uint16x8_t g   = vshll_n_u8(vand_u8(in.val[1], vdup_n_u8(0xfc)), 3);
+         uint16x8_t b   = vmovl_u8(vshr_n_u8(in.val[0], 3));
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
+      {
+         uint32_t col = input[w];
+         uint16_t r   = (col >> 19) & 0x1f;
+         uint16_t g   = (col >> 10) & 0x3f;
+         uint16_t b   = (col >>  3) & 0x1f;
+         output[w]    = (r << 11) | (g << 5) | (b << 0);
+      }
+   }
+}
+
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_argb8888_bgr24_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m128i pack    = _mm_setr_epi8(PIXCONV_PACK_BGR24);
+
+   for (w = 0; w + 16 <= width; w += 16, out += 48)
+   {
+      __m128i px[4];
+      px[0] = _mm_loadu_si128((const __m128i*)(input + w +  0));
+      px[1] = _mm_loadu_si128((const __m128i*)(input + w +  4));
+      px[2] = _mm_loadu_si128((const __m128i*)(input + w +  8));
+      px[3] = _mm_loadu_si128((const __m128i*)(input + w + 12));
+      pixconv_store_bgr24_ssse3(out, px, pack);
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_argb8888_bgr24_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m256i pack    = _mm256_setr_epi8(
+         PIXCONV_PACK_BGR24, PIXCONV_PACK_BGR24);
+
+   for (w = 0; w + 32 <= width; w += 32, out += 96)
+   {
+      __m256i px[4];
+      px[0] = _mm256_loadu_si256((const __m256i*)(input + w +  0));
+      px[1] = _mm256_loadu_si256((const __m256i*)(input + w +  8));
+      px[2] = _mm256_loadu_si256((const __m256i*)(input + w + 16));
+      px[3] = _mm256_loadu_si256((const __m256i*)(input + w + 24));
+      pixconv_store_bgr24_avx2(out, px, pack);
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -812,8 +1988,12 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
    int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint8_t *output       = (uint8_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(conv_argb8888_bgr24_ssse3,
+         conv_argb8888_bgr24_avx2);
+#endif
 
-#if defined(__SSE2__)
+#if defined(__SSE2__) || (defined(__ARM_NEON__) || defined(__ARM_NEON))
    int max_width = width - 15;
 #endif
 
@@ -822,6 +2002,13 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
    {
       uint8_t *out = output;
       int        w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -831,6 +2018,17 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
          __m128i l3 = _mm_loadu_si128((const __m128i*)(input + w + 12));
          store_bgr24_sse2(out, l0, l1, l2, l3);
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 16, out += 48)
+      {
+         uint8x16x4_t in = vld4q_u8((const uint8_t*)(input + w));
+         uint8x16x3_t res;
+         res.val[0] = in.val[0];
+         res.val[1] = in.val[1];
+         res.val[2] = in.val[2];
+
+         vst3q_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -858,6 +2056,51 @@ static INLINE __m128i conv_shuffle_rb_epi32(__m128i c)
 }
 #endif
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_abgr8888_bgr24_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m128i pack    = _mm_setr_epi8(PIXCONV_PACK_RGB24);
+
+   for (w = 0; w + 16 <= width; w += 16, out += 48)
+   {
+      __m128i px[4];
+      px[0] = _mm_loadu_si128((const __m128i*)(input + w +  0));
+      px[1] = _mm_loadu_si128((const __m128i*)(input + w +  4));
+      px[2] = _mm_loadu_si128((const __m128i*)(input + w +  8));
+      px[3] = _mm_loadu_si128((const __m128i*)(input + w + 12));
+      pixconv_store_bgr24_ssse3(out, px, pack);
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_abgr8888_bgr24_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint8_t *out          = (uint8_t*)output_;
+   const __m256i pack    = _mm256_setr_epi8(
+         PIXCONV_PACK_RGB24, PIXCONV_PACK_RGB24);
+
+   for (w = 0; w + 32 <= width; w += 32, out += 96)
+   {
+      __m256i px[4];
+      px[0] = _mm256_loadu_si256((const __m256i*)(input + w +  0));
+      px[1] = _mm256_loadu_si256((const __m256i*)(input + w +  8));
+      px[2] = _mm256_loadu_si256((const __m256i*)(input + w + 16));
+      px[3] = _mm256_loadu_si256((const __m256i*)(input + w + 24));
+      pixconv_store_bgr24_avx2(out, px, pack);
+   }
+
+   return w;
+}
+#endif
+
 void conv_abgr8888_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -865,8 +2108,12 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
    int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint8_t *output       = (uint8_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(conv_abgr8888_bgr24_ssse3,
+         conv_abgr8888_bgr24_avx2);
+#endif
 
-#if defined(__SSE2__)
+#if defined(__SSE2__) || (defined(__ARM_NEON__) || defined(__ARM_NEON))
    int max_width = width - 15;
 #endif
 
@@ -875,6 +2122,13 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
    {
       uint8_t *out = output;
       int        w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -888,6 +2142,17 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
          d = conv_shuffle_rb_epi32(d);
          store_bgr24_sse2(out, a, b, c, d);
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 16, out += 48)
+      {
+         uint8x16x4_t in = vld4q_u8((const uint8_t*)(input + w));
+         uint8x16x3_t res;
+         res.val[0] = in.val[2];
+         res.val[1] = in.val[1];
+         res.val[2] = in.val[0];
+
+         vst3q_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -900,18 +2165,102 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+static PIXCONV_SSSE3_TARGET int conv_argb8888_abgr8888_ssse3(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m128i swap    = _mm_setr_epi8(
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      __m128i lo = _mm_loadu_si128((const __m128i*)(input + w + 0));
+      __m128i hi = _mm_loadu_si128((const __m128i*)(input + w + 4));
+      _mm_storeu_si128((__m128i*)(output + w + 0), _mm_shuffle_epi8(lo, swap));
+      _mm_storeu_si128((__m128i*)(output + w + 4), _mm_shuffle_epi8(hi, swap));
+   }
+
+   return w;
+}
+
+static PIXCONV_AVX2_TARGET int conv_argb8888_abgr8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m256i swap    = _mm256_setr_epi8(
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i lo = _mm256_loadu_si256((const __m256i*)(input + w + 0));
+      __m256i hi = _mm256_loadu_si256((const __m256i*)(input + w + 8));
+      _mm256_storeu_si256((__m256i*)(output + w + 0),
+            _mm256_shuffle_epi8(lo, swap));
+      _mm256_storeu_si256((__m256i*)(output + w + 8),
+            _mm256_shuffle_epi8(hi, swap));
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_abgr8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row     = pixconv_pick(conv_argb8888_abgr8888_ssse3,
+         conv_argb8888_abgr8888_avx2);
+#endif
+#if defined(__SSE2__)
+   const __m128i ag_mask = _mm_set1_epi32((int)0xff00ff00u);
+   const __m128i r_mask  = _mm_set1_epi32(0x00ff0000);
+   const __m128i b_mask  = _mm_set1_epi32(0x000000ff);
+   int max_width         = width - 3;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width         = width - 15;
+#endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+         w = row(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 4)
+      {
+         __m128i c  = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i ag = _mm_and_si128(c, ag_mask);
+         __m128i r  = _mm_and_si128(_mm_slli_epi32(c, 16), r_mask);
+         __m128i b  = _mm_and_si128(_mm_srli_epi32(c, 16), b_mask);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(ag, _mm_or_si128(r, b)));
+      }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 16)
+      {
+         uint8x16x4_t px = vld4q_u8((const uint8_t*)(input + w));
+         uint8x16_t tmp  = px.val[0];
+         px.val[0]       = px.val[2];
+         px.val[2]       = tmp;
+
+         vst4q_u8((uint8_t*)(output + w), px);
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          output[w]    = ((col << 16) & 0xff0000) |
@@ -928,6 +2277,93 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
 #define YUV_MAT_V_R (90)
 #define YUV_MAT_V_G (-46)
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+/* Same arithmetic as the SSE2 loop below, 32 pixels at a time.
+ * The lane-wise packs leave chroma for pixels 0-7 and 16-23 in
+ * the lower lane, which lines up with the luma of each load. */
+static PIXCONV_AVX2_TARGET int conv_yuyv_argb8888_avx2(void *output_,
+      const void *input_, int width)
+{
+   int w;
+   const uint8_t *src          = (const uint8_t*)input_;
+   uint32_t *dst               = (uint32_t*)output_;
+   const __m256i mask_y        = _mm256_set1_epi16(0xff);
+   const __m256i mask_u        = _mm256_set1_epi32(0xff << 8);
+   const __m256i mask_v        = _mm256_set1_epi32((int)(0xffu << 24));
+   const __m256i chroma_offset = _mm256_set1_epi16(128);
+   const __m256i round_offset  = _mm256_set1_epi16(YUV_OFFSET);
+   const __m256i yuv_mul       = _mm256_set1_epi16(YUV_MAT_Y);
+   const __m256i u_g_mul       = _mm256_set1_epi16(YUV_MAT_U_G);
+   const __m256i u_b_mul       = _mm256_set1_epi16(YUV_MAT_U_B);
+   const __m256i v_r_mul       = _mm256_set1_epi16(YUV_MAT_V_R);
+   const __m256i v_g_mul       = _mm256_set1_epi16(YUV_MAT_V_G);
+   const __m256i a             = _mm256_set1_epi8(-1);
+
+   for (w = 0; w + 32 <= width; w += 32, src += 64, dst += 32)
+   {
+      __m256i u, v, r0, g0, b0, r1, g1, b1;
+      __m256i res_lo_bg, res_hi_bg, res_lo_ra, res_hi_ra;
+      __m256i res0, res1, res2, res3;
+      __m256i yuv0 = _mm256_loadu_si256((const __m256i*)(src +  0));
+      __m256i yuv1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+      __m256i _y0  = _mm256_mullo_epi16(
+            _mm256_and_si256(yuv0, mask_y), yuv_mul);
+      __m256i _y1  = _mm256_mullo_epi16(
+            _mm256_and_si256(yuv1, mask_y), yuv_mul);
+      __m256i u0   = _mm256_srli_si256(_mm256_and_si256(yuv0, mask_u), 1);
+      __m256i v0   = _mm256_srli_si256(_mm256_and_si256(yuv0, mask_v), 3);
+      __m256i u1   = _mm256_srli_si256(_mm256_and_si256(yuv1, mask_u), 1);
+      __m256i v1   = _mm256_srli_si256(_mm256_and_si256(yuv1, mask_v), 3);
+
+      u  = _mm256_sub_epi16(_mm256_packs_epi32(u0, u1), chroma_offset);
+      v  = _mm256_sub_epi16(_mm256_packs_epi32(v0, v1), chroma_offset);
+      u0 = _mm256_unpacklo_epi16(u, u);
+      u1 = _mm256_unpackhi_epi16(u, u);
+      v0 = _mm256_unpacklo_epi16(v, v);
+      v1 = _mm256_unpackhi_epi16(v, v);
+
+      r0 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_y0,
+                  _mm256_mullo_epi16(v0, v_r_mul)), round_offset), YUV_SHIFT);
+      g0 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_y0,
+                  _mm256_add_epi16(_mm256_mullo_epi16(u0, u_g_mul),
+                     _mm256_mullo_epi16(v0, v_g_mul))), round_offset), YUV_SHIFT);
+      b0 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_y0,
+                  _mm256_mullo_epi16(u0, u_b_mul)), round_offset), YUV_SHIFT);
+      r1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_y1,
+                  _mm256_mullo_epi16(v1, v_r_mul)), round_offset), YUV_SHIFT);
+      g1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_y1,
+                  _mm256_add_epi16(_mm256_mullo_epi16(u1, u_g_mul),
+                     _mm256_mullo_epi16(v1, v_g_mul))), round_offset), YUV_SHIFT);
+      b1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_y1,
+                  _mm256_mullo_epi16(u1, u_b_mul)), round_offset), YUV_SHIFT);
+
+      /* Saturate into 8-bit, then interleave into ARGB */
+      r0        = _mm256_packus_epi16(r0, r1);
+      g0        = _mm256_packus_epi16(g0, g1);
+      b0        = _mm256_packus_epi16(b0, b1);
+      res_lo_bg = _mm256_unpacklo_epi8(b0, g0);
+      res_hi_bg = _mm256_unpackhi_epi8(b0, g0);
+      res_lo_ra = _mm256_unpacklo_epi8(r0, a);
+      res_hi_ra = _mm256_unpackhi_epi8(r0, a);
+      res0      = _mm256_unpacklo_epi16(res_lo_bg, res_lo_ra);
+      res1      = _mm256_unpackhi_epi16(res_lo_bg, res_lo_ra);
+      res2      = _mm256_unpacklo_epi16(res_hi_bg, res_hi_ra);
+      res3      = _mm256_unpackhi_epi16(res_hi_bg, res_hi_ra);
+
+      _mm256_storeu_si256((__m256i*)(dst +  0),
+            _mm256_permute2x128_si256(res0, res1, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst +  8),
+            _mm256_permute2x128_si256(res0, res1, 0x31));
+      _mm256_storeu_si256((__m256i*)(dst + 16),
+            _mm256_permute2x128_si256(res2, res3, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + 24),
+            _mm256_permute2x128_si256(res2, res3, 0x31));
+   }
+
+   return w;
+}
+#endif
+
 void conv_yuyv_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -935,6 +2371,9 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
    int h;
    const uint8_t *input        = (const uint8_t*)input_;
    uint32_t *output            = (uint32_t*)output_;
+#ifdef PIXCONV_HAVE_X86_SIMD
+   pixconv_row_t row           = pixconv_pick(NULL, conv_yuyv_argb8888_avx2);
+#endif
 
 #if defined(__SSE2__)
    const __m128i mask_y        = _mm_set1_epi16(0xffu);
@@ -958,6 +2397,14 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
       uint32_t      *dst = output;
       int              w = 0;
 
+#ifdef PIXCONV_HAVE_X86_SIMD
+      if (row)
+      {
+         w    = row(output, input, width);
+         src += w * 2;
+         dst += w;
+      }
+#endif
 #if defined(__SSE2__)
       /* Each loop processes 16 pixels. */
       for (; w + 16 <= width; w += 16, src += 32, dst += 16)
@@ -1041,6 +2488,45 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(dst +  8), res2);
          _mm_storeu_si128((__m128i*)(dst + 12), res3);
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      /* Each loop processes 16 pixels; vqrshrun does the rounding
+       * shift and the clamp of the C path in one go. */
+      for (; w + 16 <= width; w += 16, src += 32, dst += 16)
+      {
+         uint8x8x4_t yuv = vld4_u8(src); /* [Y0, U, Y1, V] planes */
+         int16x8_t _y0   = vreinterpretq_s16_u16(vshll_n_u8(yuv.val[0], 6));
+         int16x8_t _y1   = vreinterpretq_s16_u16(vshll_n_u8(yuv.val[2], 6));
+         int16x8_t u     = vsubq_s16(vreinterpretq_s16_u16(
+                  vmovl_u8(yuv.val[1])), vdupq_n_s16(128));
+         int16x8_t v     = vsubq_s16(vreinterpretq_s16_u16(
+                  vmovl_u8(yuv.val[3])), vdupq_n_s16(128));
+         int16x8_t r_uv  = vmulq_n_s16(v, YUV_MAT_V_R);
+         int16x8_t g_uv  = vmlaq_n_s16(vmulq_n_s16(u, YUV_MAT_U_G),
+               v, YUV_MAT_V_G);
+         int16x8_t b_uv  = vmulq_n_s16(u, YUV_MAT_U_B);
+
+         uint8x8x2_t r   = vzip_u8(
+               vqrshrun_n_s16(vaddq_s16(_y0, r_uv), YUV_SHIFT),
+               vqrshrun_n_s16(vaddq_s16(_y1, r_uv), YUV_SHIFT));
+         uint8x8x2_t g   = vzip_u8(
+               vqrshrun_n_s16(vaddq_s16(_y0, g_uv), YUV_SHIFT),
+               vqrshrun_n_s16(vaddq_s16(_y1, g_uv), YUV_SHIFT));
+         uint8x8x2_t b   = vzip_u8(
+               vqrshrun_n_s16(vaddq_s16(_y0, b_uv), YUV_SHIFT),
+               vqrshrun_n_s16(vaddq_s16(_y1, b_uv), YUV_SHIFT));
+
+         uint8x8x4_t res;
+         res.val[3] = vdup_n_u8(0xffu);
+         res.val[2] = r.val[0];
+         res.val[1] = g.val[0];
+         res.val[0] = b.val[0];
+         vst4_u8((uint8_t*)(dst + 0), res);
+
+         res.val[2] = r.val[1];
+         res.val[1] = g.val[1];
+         res.val[0] = b.val[1];
+         vst4_u8((uint8_t*)(dst + 8), res);
+      }
 #endif
 
       /* Finish off the rest (if any) in C. */
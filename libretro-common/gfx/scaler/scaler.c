@@ -30,6 +30,10 @@
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/band_pool.h>
+#endif
+
 static bool allocate_frames(struct scaler_ctx *ctx)
 {
    uint64_t *scaled_frame = NULL;
@@ -74,6 +78,94 @@ static bool allocate_frames(struct scaler_ctx *ctx)
    return true;
 }
 
+/* Runs the input conversion and horizontal pass on scaled rows
+ * [first, last). Each row only depends on the same input row. */
+static void scaler_ctx_horiz_band(const struct scaler_ctx *ctx,
+      const void *input, int first, int last)
+{
+   struct scaler_ctx band     = *ctx;
+   const uint8_t *input_frame = (const uint8_t*)input
+      + first * ctx->in_stride;
+   int input_stride           = ctx->in_stride;
+
+   if (first >= last)
+      return;
+
+   if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+   {
+      uint8_t *converted = (uint8_t*)ctx->input.frame
+         + first * ctx->input.stride;
+
+      ctx->in_pixconv(converted, input_frame,
+            ctx->in_width, last - first,
+            ctx->input.stride, ctx->in_stride);
+
+      input_frame        = converted;
+      input_stride       = ctx->input.stride;
+   }
+
+   band.scaled.frame  = ctx->scaled.frame
+      + first * (ctx->scaled.stride >> 3);
+   band.scaled.height = last - first;
+
+   if (ctx->scaler_horiz)
+      ctx->scaler_horiz(&band, input_frame, input_stride);
+}
+
+/* Runs the vertical pass and output conversion on output rows
+ * [first, last). Needs every scaled row the band's filters touch. */
+static void scaler_ctx_vert_band(const struct scaler_ctx *ctx,
+      void *output, int first, int last)
+{
+   struct scaler_ctx band = *ctx;
+   uint8_t *output_frame  = (uint8_t*)output + first * ctx->out_stride;
+   int output_stride      = ctx->out_stride;
+
+   if (first >= last)
+      return;
+
+   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+   {
+      output_frame  = (uint8_t*)ctx->output.frame
+         + first * ctx->output.stride;
+      output_stride = ctx->output.stride;
+   }
+
+   band.vert.filter     = ctx->vert.filter
+      + first * ctx->vert.filter_stride;
+   band.vert.filter_pos = ctx->vert.filter_pos + first;
+   band.out_height      = last - first;
+
+   if (ctx->scaler_vert)
+      ctx->scaler_vert(&band, output_frame, output_stride);
+
+   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+      ctx->out_pixconv((uint8_t*)output + first * ctx->out_stride,
+            output_frame, ctx->out_width, last - first,
+            ctx->out_stride, ctx->output.stride);
+}
+
+#ifdef HAVE_THREADS
+struct scaler_pass
+{
+   const struct scaler_ctx *ctx;
+   const void *input;
+   void *output;
+};
+
+static void scaler_pass_horiz(void *data, unsigned first, unsigned last)
+{
+   const struct scaler_pass *pass = (const struct scaler_pass*)data;
+   scaler_ctx_horiz_band(pass->ctx, pass->input, first, last);
+}
+
+static void scaler_pass_vert(void *data, unsigned first, unsigned last)
+{
+   const struct scaler_pass *pass = (const struct scaler_pass*)data;
+   scaler_ctx_vert_band(pass->ctx, pass->output, first, last);
+}
+#endif
+
 bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 {
    scaler_ctx_gen_reset(ctx);
@@ -261,6 +353,12 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
       if (!scaler_gen_filter(ctx))
          return false;
+
+#ifdef HAVE_THREADS
+      /* Without a pool, bands simply run on the calling thread */
+      if (ctx->threads > 1 && !ctx->scaler_special)
+         ctx->pool = band_pool_new(ctx->threads - 1);
+#endif
    }
 
    return true;
@@ -268,6 +366,11 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 {
+#ifdef HAVE_THREADS
+   band_pool_free(ctx->pool);
+   ctx->pool                = NULL;
+#endif
+
    if (ctx->horiz.filter)
       free(ctx->horiz.filter);
    if (ctx->horiz.filter_pos)
@@ -321,6 +424,30 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
    int input_stride        = ctx->in_stride;
    int output_stride       = ctx->out_stride;
 
+   /* Take generic filter path. */
+   if (!ctx->scaler_special)
+   {
+#ifdef HAVE_THREADS
+      if (ctx->pool)
+      {
+         /* The horizontal pass of every band is done
+          * before any vertical pass starts */
+         struct scaler_pass pass;
+         pass.ctx    = ctx;
+         pass.input  = input;
+         pass.output = output;
+         band_pool_run(ctx->pool, ctx->scaled.height,
+               scaler_pass_horiz, &pass);
+         band_pool_run(ctx->pool, ctx->out_height,
+               scaler_pass_vert, &pass);
+         return;
+      }
+#endif
+      scaler_ctx_horiz_band(ctx, input,  0, ctx->scaled.height);
+      scaler_ctx_vert_band (ctx, output, 0, ctx->out_height);
+      return;
+   }
+
    if (ctx->in_fmt != SCALER_FMT_ARGB8888)
    {
       ctx->in_pixconv(ctx->input.frame, input,
@@ -338,19 +465,10 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
    }
 
    /* Take some special, and (hopefully) more optimized path. */
-   if (ctx->scaler_special)
-      ctx->scaler_special(ctx, output_frame, input_frame,
-            ctx->out_width, ctx->out_height,
-            ctx->in_width, ctx->in_height,
-            output_stride, input_stride);
-   else
-   {
-      /* Take generic filter path. */
-      if (ctx->scaler_horiz)
-         ctx->scaler_horiz(ctx, input_frame, input_stride);
-      if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
-   }
+   ctx->scaler_special(ctx, output_frame, input_frame,
+         ctx->out_width, ctx->out_height,
+         ctx->in_width, ctx->in_height,
+         output_stride, input_stride);
 
    if (ctx->out_fmt != SCALER_FMT_ARGB8888)
       ctx->out_pixconv(output, ctx->output.frame,
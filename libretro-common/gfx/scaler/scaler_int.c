@@ -20,6 +20,8 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <string.h>
+
 #include <gfx/scaler/scaler_int.h>
 
 #include <retro_inline.h>
@@ -33,6 +35,18 @@
 #ifdef _WIN32
 #include <intrin.h>
 #endif
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#endif
+
+/* The AVX2 kernels are built with a target attribute and only
+ * used if cpu_features_get() reports AVX2, like the ones in
+ * pixconv.c. */
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define SCALER_HAVE_X86_SIMD
+#define SCALER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
 #endif
 
 /* ARGB8888 scaler is split in two:
@@ -62,6 +76,402 @@
  * SIMD code for testing purposes.
  */
 
+/* The row kernels below work on several output pixels at once, but
+ * keep the order of the saturating adds of the per-pixel SSE2 code:
+ * even taps and odd taps are summed apart, an odd last tap goes to
+ * the even sum, and both sums are added last. Their output is
+ * therefore identical to it. Each kernel starts at pixel @w and
+ * returns the first pixel it did not do; the per-pixel loops finish
+ * the row. */
+
+#ifdef SCALER_HAVE_X86_SIMD
+#include <immintrin.h>
+#include <features/features_cpu.h>
+
+#define SCALER_SIMD_AVX2 (1 << 0)
+
+/* SCALER_SIMD_* flags, or -1 until the first scale */
+static int scaler_simd_flags = -1;
+
+static int scaler_simd_detect(void)
+{
+   uint64_t cpu = cpu_features_get();
+
+   /* RETRO_SIMD_AVX is only set if the OS saves the YMM registers */
+   if ((cpu & RETRO_SIMD_AVX) && (cpu & RETRO_SIMD_AVX2))
+      return SCALER_SIMD_AVX2;
+   return 0;
+}
+
+static bool scaler_simd_avx2(void)
+{
+   /* Concurrent first calls all store the same flags */
+   if (scaler_simd_flags < 0)
+      scaler_simd_flags = scaler_simd_detect();
+   return (scaler_simd_flags & SCALER_SIMD_AVX2) != 0;
+}
+
+/* Two adjacent taps of a filter as one 32-bit lane */
+static INLINE int scaler_coeff_pair(const int16_t *coeff)
+{
+   int32_t pair;
+   memcpy(&pair, coeff, sizeof(pair));
+   return pair;
+}
+
+/* 8 output pixels per iteration, in two vectors of 4 */
+static SCALER_AVX2_TARGET int scaler_argb8888_vert_avx2(
+      const struct scaler_ctx *ctx, uint32_t *output,
+      const uint64_t *input, const int16_t *filter_vert, int w)
+{
+   int y;
+   /* The vector stores may alias ctx, so keep its fields in locals */
+   const int row   = ctx->scaled.stride >> 3;
+   const int len   = ctx->vert.filter_len;
+   const int width = ctx->out_width;
+
+   for (; w + 8 <= width; w += 8)
+   {
+      const uint64_t *input_base_y = input + w;
+      __m256i even0 = _mm256_setzero_si256();
+      __m256i even1 = _mm256_setzero_si256();
+      __m256i odd0  = _mm256_setzero_si256();
+      __m256i odd1  = _mm256_setzero_si256();
+      __m256i res0, res1;
+
+      for (y = 0; (y + 1) < len; y += 2,
+            input_base_y += 2 * row)
+      {
+         __m256i coeff0 = _mm256_set1_epi16(filter_vert[y + 0]);
+         __m256i coeff1 = _mm256_set1_epi16(filter_vert[y + 1]);
+         const __m256i *col0 = (const __m256i*)input_base_y;
+         const __m256i *col1 = (const __m256i*)(input_base_y + row);
+
+         even0 = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_loadu_si256(col0 + 0), coeff0), even0);
+         even1 = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_loadu_si256(col0 + 1), coeff0), even1);
+         odd0  = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_loadu_si256(col1 + 0), coeff1), odd0);
+         odd1  = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_loadu_si256(col1 + 1), coeff1), odd1);
+      }
+
+      if (y < len)
+      {
+         __m256i coeff = _mm256_set1_epi16(filter_vert[y]);
+         const __m256i *col = (const __m256i*)input_base_y;
+
+         even0 = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_loadu_si256(col + 0), coeff), even0);
+         even1 = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_loadu_si256(col + 1), coeff), even1);
+      }
+
+      res0 = _mm256_srai_epi16(_mm256_adds_epi16(odd0, even0), (7 - 2 - 2));
+      res1 = _mm256_srai_epi16(_mm256_adds_epi16(odd1, even1), (7 - 2 - 2));
+
+      /* packus works within 128-bit lanes, so pixels come out
+       * as 0-1, 4-5, 2-3, 6-7 */
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_permute4x64_epi64(
+               _mm256_packus_epi16(res0, res1), 0xd8));
+   }
+
+   return w;
+}
+
+/* 4 output pixels per iteration, one per 128-bit lane of two
+ * vectors, two taps at a time. Only for even filter lengths. */
+static SCALER_AVX2_TARGET int scaler_argb8888_horiz_avx2(
+      const struct scaler_ctx *ctx, uint64_t *output,
+      const uint32_t *input, int w)
+{
+   int x;
+   const int16_t *filter = ctx->horiz.filter;
+   const int *filter_pos = ctx->horiz.filter_pos;
+   const int stride      = ctx->horiz.filter_stride;
+   const int len         = ctx->horiz.filter_len;
+   const int width       = ctx->scaled.width;
+   /* Spread the taps of two pixels over the lanes of a vector */
+   const __m256i coeff_mask0 = _mm256_setr_epi8(
+          0,  1,  0,  1,  0,  1,  0,  1,  2,  3,  2,  3,  2,  3,  2,  3,
+          4,  5,  4,  5,  4,  5,  4,  5,  6,  7,  6,  7,  6,  7,  6,  7);
+   const __m256i coeff_mask1 = _mm256_setr_epi8(
+          8,  9,  8,  9,  8,  9,  8,  9, 10, 11, 10, 11, 10, 11, 10, 11,
+         12, 13, 12, 13, 12, 13, 12, 13, 14, 15, 14, 15, 14, 15, 14, 15);
+
+   if (len & 1)
+      return w;
+
+   for (; w + 4 <= width; w += 4)
+   {
+      const int16_t *filter_horiz = filter + w * stride;
+      const uint32_t *input0 = input + filter_pos[w + 0];
+      const uint32_t *input1 = input + filter_pos[w + 1];
+      const uint32_t *input2 = input + filter_pos[w + 2];
+      const uint32_t *input3 = input + filter_pos[w + 3];
+      __m256i res01 = _mm256_setzero_si256();
+      __m256i res23 = _mm256_setzero_si256();
+      __m256i res;
+
+      for (x = 0; x < len; x += 2)
+      {
+         /* Bilinear filters of adjacent pixels are contiguous */
+         __m256i coeff = _mm256_broadcastsi128_si256(stride == 2
+               ? _mm_loadu_si128((const __m128i*)filter_horiz)
+               : _mm_setr_epi32(
+                  scaler_coeff_pair(filter_horiz + x),
+                  scaler_coeff_pair(filter_horiz + x + stride),
+                  scaler_coeff_pair(filter_horiz + x + 2 * stride),
+                  scaler_coeff_pair(filter_horiz + x + 3 * stride)));
+         __m256i col01 = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+                  _mm_loadl_epi64((const __m128i*)(input0 + x)),
+                  _mm_loadl_epi64((const __m128i*)(input1 + x))));
+         __m256i col23 = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+                  _mm_loadl_epi64((const __m128i*)(input2 + x)),
+                  _mm_loadl_epi64((const __m128i*)(input3 + x))));
+
+         res01 = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_slli_epi16(col01, 7),
+                  _mm256_shuffle_epi8(coeff, coeff_mask0)), res01);
+         res23 = _mm256_adds_epi16(_mm256_mulhi_epi16(
+                  _mm256_slli_epi16(col23, 7),
+                  _mm256_shuffle_epi8(coeff, coeff_mask1)), res23);
+      }
+
+      /* Pixels 0, 2 | 1, 3 */
+      res = _mm256_adds_epi16(_mm256_unpackhi_epi64(res01, res23),
+            _mm256_unpacklo_epi64(res01, res23));
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_permute4x64_epi64(res, 0xd8));
+   }
+
+   return w;
+}
+#endif
+
+#if defined(__SSE2__)
+/* 4 output pixels per iteration, in two vectors of 2 */
+static int scaler_argb8888_vert_sse2(const struct scaler_ctx *ctx,
+      uint32_t *output, const uint64_t *input,
+      const int16_t *filter_vert, int w)
+{
+   int y;
+   const int row   = ctx->scaled.stride >> 3;
+   const int len   = ctx->vert.filter_len;
+   const int width = ctx->out_width;
+
+   for (; w + 4 <= width; w += 4)
+   {
+      const uint64_t *input_base_y = input + w;
+      __m128i even0 = _mm_setzero_si128();
+      __m128i even1 = _mm_setzero_si128();
+      __m128i odd0  = _mm_setzero_si128();
+      __m128i odd1  = _mm_setzero_si128();
+      __m128i res0, res1;
+
+      for (y = 0; (y + 1) < len; y += 2,
+            input_base_y += 2 * row)
+      {
+         __m128i coeff0 = _mm_set1_epi16(filter_vert[y + 0]);
+         __m128i coeff1 = _mm_set1_epi16(filter_vert[y + 1]);
+         const __m128i *col0 = (const __m128i*)input_base_y;
+         const __m128i *col1 = (const __m128i*)(input_base_y + row);
+
+         even0 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_loadu_si128(col0 + 0), coeff0), even0);
+         even1 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_loadu_si128(col0 + 1), coeff0), even1);
+         odd0  = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_loadu_si128(col1 + 0), coeff1), odd0);
+         odd1  = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_loadu_si128(col1 + 1), coeff1), odd1);
+      }
+
+      if (y < len)
+      {
+         __m128i coeff = _mm_set1_epi16(filter_vert[y]);
+         const __m128i *col = (const __m128i*)input_base_y;
+
+         even0 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_loadu_si128(col + 0), coeff), even0);
+         even1 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_loadu_si128(col + 1), coeff), even1);
+      }
+
+      res0 = _mm_srai_epi16(_mm_adds_epi16(odd0, even0), (7 - 2 - 2));
+      res1 = _mm_srai_epi16(_mm_adds_epi16(odd1, even1), (7 - 2 - 2));
+
+      _mm_storeu_si128((__m128i*)(output + w), _mm_packus_epi16(res0, res1));
+   }
+
+   return w;
+}
+
+/* 2 output pixels per iteration, sharing the final reduction */
+static int scaler_argb8888_horiz_sse2(const struct scaler_ctx *ctx,
+      uint64_t *output, const uint32_t *input, int w)
+{
+   int x;
+   const int16_t *filter = ctx->horiz.filter;
+   const int *filter_pos = ctx->horiz.filter_pos;
+   const int stride      = ctx->horiz.filter_stride;
+   const int len         = ctx->horiz.filter_len;
+   const int width       = ctx->scaled.width;
+   const __m128i zero    = _mm_setzero_si128();
+
+   for (; w + 2 <= width; w += 2)
+   {
+      const int16_t *filter0 = filter + w * stride;
+      const int16_t *filter1 = filter0 + stride;
+      const uint32_t *input0 = input + filter_pos[w + 0];
+      const uint32_t *input1 = input + filter_pos[w + 1];
+      __m128i res0 = zero;
+      __m128i res1 = zero;
+
+      for (x = 0; (x + 1) < len; x += 2)
+      {
+         __m128i coeff0 = _mm_unpacklo_epi64(
+               _mm_set1_epi16(filter0[x]), _mm_set1_epi16(filter0[x + 1]));
+         __m128i coeff1 = _mm_unpacklo_epi64(
+               _mm_set1_epi16(filter1[x]), _mm_set1_epi16(filter1[x + 1]));
+         __m128i col0   = _mm_unpacklo_epi8(
+               _mm_loadl_epi64((const __m128i*)(input0 + x)), zero);
+         __m128i col1   = _mm_unpacklo_epi8(
+               _mm_loadl_epi64((const __m128i*)(input1 + x)), zero);
+
+         res0 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_slli_epi16(col0, 7), coeff0), res0);
+         res1 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_slli_epi16(col1, 7), coeff1), res1);
+      }
+
+      if (x < len)
+      {
+         __m128i col0 = _mm_unpacklo_epi8(
+               _mm_cvtsi32_si128((int)input0[x]), zero);
+         __m128i col1 = _mm_unpacklo_epi8(
+               _mm_cvtsi32_si128((int)input1[x]), zero);
+
+         res0 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_slli_epi16(col0, 7), _mm_set1_epi16(filter0[x])), res0);
+         res1 = _mm_adds_epi16(_mm_mulhi_epi16(
+                  _mm_slli_epi16(col1, 7), _mm_set1_epi16(filter1[x])), res1);
+      }
+
+      _mm_storeu_si128((__m128i*)(output + w), _mm_adds_epi16(
+               _mm_unpackhi_epi64(res0, res1),
+               _mm_unpacklo_epi64(res0, res1)));
+   }
+
+   return w;
+}
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+/* (a * b) >> 16, as _mm_mulhi_epi16. vqdmulh would double
+ * the product and saturate. */
+static INLINE int16x8_t scaler_mulhi_neon(int16x8_t a, int16x8_t b)
+{
+   return vcombine_s16(
+         vshrn_n_s32(vmull_s16(vget_low_s16(a),  vget_low_s16(b)),  16),
+         vshrn_n_s32(vmull_s16(vget_high_s16(a), vget_high_s16(b)), 16));
+}
+
+/* 4 output pixels per iteration, in two vectors of 2 */
+static int scaler_argb8888_vert_neon(const struct scaler_ctx *ctx,
+      uint32_t *output, const uint64_t *input,
+      const int16_t *filter_vert, int w)
+{
+   int y;
+   const int row   = ctx->scaled.stride >> 3;
+   const int len   = ctx->vert.filter_len;
+   const int width = ctx->out_width;
+
+   for (; w + 4 <= width; w += 4)
+   {
+      const uint64_t *input_base_y = input + w;
+      int16x8_t even0 = vdupq_n_s16(0);
+      int16x8_t even1 = vdupq_n_s16(0);
+      int16x8_t odd0  = vdupq_n_s16(0);
+      int16x8_t odd1  = vdupq_n_s16(0);
+      int16x8_t res0, res1;
+
+      for (y = 0; (y + 1) < len; y += 2,
+            input_base_y += 2 * row)
+      {
+         int16x8_t coeff0    = vdupq_n_s16(filter_vert[y + 0]);
+         int16x8_t coeff1    = vdupq_n_s16(filter_vert[y + 1]);
+         const int16_t *col0 = (const int16_t*)input_base_y;
+         const int16_t *col1 = (const int16_t*)(input_base_y + row);
+
+         even0 = vqaddq_s16(scaler_mulhi_neon(vld1q_s16(col0 + 0), coeff0), even0);
+         even1 = vqaddq_s16(scaler_mulhi_neon(vld1q_s16(col0 + 8), coeff0), even1);
+         odd0  = vqaddq_s16(scaler_mulhi_neon(vld1q_s16(col1 + 0), coeff1), odd0);
+         odd1  = vqaddq_s16(scaler_mulhi_neon(vld1q_s16(col1 + 8), coeff1), odd1);
+      }
+
+      if (y < len)
+      {
+         int16x8_t coeff    = vdupq_n_s16(filter_vert[y]);
+         const int16_t *col = (const int16_t*)input_base_y;
+
+         even0 = vqaddq_s16(scaler_mulhi_neon(vld1q_s16(col + 0), coeff), even0);
+         even1 = vqaddq_s16(scaler_mulhi_neon(vld1q_s16(col + 8), coeff), even1);
+      }
+
+      res0 = vshrq_n_s16(vqaddq_s16(odd0, even0), (7 - 2 - 2));
+      res1 = vshrq_n_s16(vqaddq_s16(odd1, even1), (7 - 2 - 2));
+
+      vst1q_u8((uint8_t*)(output + w),
+            vcombine_u8(vqmovun_s16(res0), vqmovun_s16(res1)));
+   }
+
+   return w;
+}
+
+/* One output pixel per iteration, even taps in the low half */
+static int scaler_argb8888_horiz_neon(const struct scaler_ctx *ctx,
+      uint64_t *output, const uint32_t *input, int w)
+{
+   int x;
+   const int16_t *filter = ctx->horiz.filter;
+   const int *filter_pos = ctx->horiz.filter_pos;
+   const int stride      = ctx->horiz.filter_stride;
+   const int len         = ctx->horiz.filter_len;
+   const int width       = ctx->scaled.width;
+
+   for (; w < width; w++)
+   {
+      const int16_t *filter_horiz  = filter + w * stride;
+      const uint32_t *input_base_x = input + filter_pos[w];
+      int16x8_t res = vdupq_n_s16(0);
+
+      for (x = 0; (x + 1) < len; x += 2)
+      {
+         int16x8_t coeff = vcombine_s16(
+               vdup_n_s16(filter_horiz[x]), vdup_n_s16(filter_horiz[x + 1]));
+         int16x8_t col   = vreinterpretq_s16_u16(vshll_n_u8(
+                  vld1_u8((const uint8_t*)(input_base_x + x)), 7));
+
+         res = vqaddq_s16(scaler_mulhi_neon(col, coeff), res);
+      }
+
+      if (x < len)
+      {
+         int16x8_t coeff = vdupq_n_s16(filter_horiz[x]);
+         int16x8_t col   = vreinterpretq_s16_u16(vshll_n_u8(
+                  vcreate_u8((uint64_t)input_base_x[x]), 7));
+
+         res = vqaddq_s16(scaler_mulhi_neon(col, coeff), res);
+      }
+
+      vst1_s16((int16_t*)(output + w),
+            vqadd_s16(vget_high_s16(res), vget_low_s16(res)));
+   }
+
+   return w;
+}
+#endif
+
 void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
 {
    int h, w, y;
@@ -69,6 +479,9 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
    uint32_t           *output = (uint32_t*)output_;
 
    const int16_t *filter_vert = ctx->vert.filter;
+#ifdef SCALER_HAVE_X86_SIMD
+   bool avx2                  = scaler_simd_avx2();
+#endif
 
    for (h = 0; h < ctx->out_height; h++,
          filter_vert += ctx->vert.filter_stride, output += stride >> 2)
@@ -76,7 +489,18 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
       const uint64_t *input_base = input + ctx->vert.filter_pos[h]
          * (ctx->scaled.stride >> 3);
 
-      for (w = 0; w < ctx->out_width; w++)
+      w = 0;
+#ifdef SCALER_HAVE_X86_SIMD
+      if (avx2)
+         w = scaler_argb8888_vert_avx2(ctx, output, input_base, filter_vert, w);
+#endif
+#if defined(__SSE2__)
+      w = scaler_argb8888_vert_sse2(ctx, output, input_base, filter_vert, w);
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      w = scaler_argb8888_vert_neon(ctx, output, input_base, filter_vert, w);
+#endif
+
+      for (; w < ctx->out_width; w++)
       {
          const uint64_t *input_base_y = input_base + w;
 #if defined(__SSE2__)
@@ -86,7 +510,8 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
          for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
                input_base_y += (ctx->scaled.stride >> 2))
          {
-            __m128i coeff = _mm_set_epi64x(filter_vert[y + 1] * 0x0001000100010001ll, filter_vert[y + 0] * 0x0001000100010001ll);
+            __m128i coeff = _mm_unpacklo_epi64(
+                  _mm_set1_epi16(filter_vert[y + 0]), _mm_set1_epi16(filter_vert[y + 1]));
             __m128i col   = _mm_set_epi64x(input_base_y[ctx->scaled.stride >> 3], input_base_y[0]);
 
             res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
@@ -94,7 +519,7 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
 
          for (; y < ctx->vert.filter_len; y++, input_base_y += (ctx->scaled.stride >> 3))
          {
-            __m128i coeff = _mm_set_epi64x(0, filter_vert[y] * 0x0001000100010001ll);
+            __m128i coeff = _mm_set1_epi16(filter_vert[y]);
             __m128i col   = _mm_set_epi64x(0, input_base_y[0]);
 
             res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
@@ -150,13 +575,28 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
    int h, w, x;
    const uint32_t *input = (uint32_t*)input_;
    uint64_t *output      = ctx->scaled.frame;
+#ifdef SCALER_HAVE_X86_SIMD
+   bool avx2             = scaler_simd_avx2();
+#endif
 
    for (h = 0; h < ctx->scaled.height; h++, input += stride >> 2,
          output += ctx->scaled.stride >> 3)
    {
-      const int16_t *filter_horiz = ctx->horiz.filter;
+      const int16_t *filter_horiz = NULL;
+
+      w = 0;
+#ifdef SCALER_HAVE_X86_SIMD
+      if (avx2)
+         w = scaler_argb8888_horiz_avx2(ctx, output, input, w);
+#endif
+#if defined(__SSE2__)
+      w = scaler_argb8888_horiz_sse2(ctx, output, input, w);
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      w = scaler_argb8888_horiz_neon(ctx, output, input, w);
+#endif
 
-      for (w = 0; w < ctx->scaled.width; w++,
+      for (filter_horiz = ctx->horiz.filter + w * ctx->horiz.filter_stride;
+            w < ctx->scaled.width; w++,
             filter_horiz += ctx->horiz.filter_stride)
       {
          const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
@@ -171,7 +611,8 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
 #endif
          for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
          {
-            __m128i coeff = _mm_set_epi64x(filter_horiz[x + 1] * 0x0001000100010001ll, filter_horiz[x + 0] * 0x0001000100010001ll);
+            __m128i coeff = _mm_unpacklo_epi64(
+                  _mm_set1_epi16(filter_horiz[x + 0]), _mm_set1_epi16(filter_horiz[x + 1]));
 
             __m128i col   = _mm_unpacklo_epi8(_mm_set_epi64x(0,
                      ((uint64_t)input_base_x[x + 1] << 32) | input_base_x[x + 0]), _mm_setzero_si128());
@@ -182,7 +623,7 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
 
          for (; x < ctx->horiz.filter_len; x++)
          {
-            __m128i coeff = _mm_set_epi64x(0, filter_horiz[x] * 0x0001000100010001ll);
+            __m128i coeff = _mm_set1_epi16(filter_horiz[x]);
             __m128i col   = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, 0, input_base_x[x]), _mm_setzero_si128());
 
             col           = _mm_slli_epi16(col, 7);
@@ -221,11 +662,12 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
             res_b         += (b * coeff) >> 16;
          }
 
+         /* Negative sums must not sign-extend into other channels */
          output[w]         = (
-               (uint64_t)res_a  << 48)  |
-               ((uint64_t)res_r << 32)  |
-               ((uint64_t)res_g << 16)  |
-               ((uint64_t)res_b << 0);
+               (uint64_t)(uint16_t)res_a  << 48)  |
+               ((uint64_t)(uint16_t)res_r << 32)  |
+               ((uint64_t)(uint16_t)res_g << 16)  |
+               ((uint64_t)(uint16_t)res_b << 0);
 #endif
       }
    }
@@ -59,6 +59,8 @@ struct scaler_filter
    int      filter_stride;
 };
 
+struct band_pool;
+
 struct scaler_ctx
 {
    void (*scaler_horiz)(const struct scaler_ctx*,
@@ -73,6 +75,9 @@ struct scaler_ctx
    void (*direct_pixconv)(void*, const void*, int, int, int, int);
    struct scaler_filter horiz, vert;   /* ptr alignment */
 
+   /* Workers for the row bands, created by scaler_ctx_gen_filter() */
+   struct band_pool *pool;
+
    struct
    {
       uint32_t *frame;
@@ -105,6 +110,11 @@ struct scaler_ctx
    enum scaler_pix_fmt out_fmt;
    enum scaler_type scaler_type;
 
+   /* Number of row bands the filter passes are split into, each on
+    * its own thread (HAVE_THREADS only). 0 or 1 scales on the
+    * calling thread. Read by scaler_ctx_gen_filter(). */
+   unsigned threads;
+
    bool unscaled;
 };
 
@@ -34,6 +34,9 @@
 
 RETRO_BEGIN_DECLS
 
+/** Upper bound for \c task_queue_set_workers. */
+#define TASK_QUEUE_MAX_WORKERS 8
+
 enum task_type
 {
    /** A regular task. The vast majority of tasks will use this type. */
@@ -46,6 +49,26 @@ enum task_type
    TASK_TYPE_BLOCKING
 };
 
+/**
+ * How urgently a task should run relative to other tasks.
+ * Among the tasks that are due (see \c retro_task::when),
+ * the one with the lowest value runs first,
+ * then the one with the earliest \c when.
+ */
+enum task_priority
+{
+   /** Work the user is waiting on, e.g. save states and screenshots. */
+   TASK_PRIORITY_INTERACTIVE = 0,
+
+   /** The default. */
+   TASK_PRIORITY_NORMAL,
+
+   /** Long-running bulk work, e.g. content scans and downloads. */
+   TASK_PRIORITY_BACKGROUND,
+
+   TASK_PRIORITY_LAST
+};
+
 enum task_style
 {
    TASK_STYLE_NONE,
@@ -276,6 +299,14 @@ struct retro_task
    enum task_style style;
 
    uint8_t flags;
+
+   /**
+    * The scheduling priority of this task.
+    * Defaults to \c TASK_PRIORITY_NORMAL.
+    * Set by the caller before the task is pushed.
+    * @see task_priority
+    */
+   uint8_t priority;
 };
 
 /**
@@ -548,6 +579,34 @@ void task_queue_unset_threaded(void);
  */
 bool task_queue_is_threaded(void);
 
+/**
+ * Sets the number of worker threads used in threaded mode.
+ *
+ * With a single worker, all tasks run in sequence on one thread.
+ * With more than one, tasks are spread over a pool of workers
+ * that steal from each other's queues when idle.
+ * The first worker is reserved for \c TASK_PRIORITY_INTERACTIVE
+ * and \c TASK_TYPE_BLOCKING tasks (save states, screenshots and the like),
+ * so they never wait behind long-running bulk work.
+ * A single task is never run by two workers at the same time.
+ *
+ * Next time \c retro_task_queue_check is called,
+ * the task queue will be recreated with the new worker count.
+ *
+ * @param workers Number of worker threads,
+ * clamped to the range [1, \c TASK_QUEUE_MAX_WORKERS].
+ * @see task_queue_set_threaded
+ */
+void task_queue_set_workers(unsigned workers);
+
+/**
+ * Returns the number of worker threads used in threaded mode.
+ *
+ * @return The worker count last given to \c task_queue_set_workers,
+ * or 1 if it was never called.
+ */
+unsigned task_queue_get_workers(void);
+
 /**
  * Calls the function given in \c find_data for each task
  * until it returns \c true for one of them,
@@ -657,7 +716,8 @@ void task_queue_deinit(void);
  *
  * @param threaded \c true if tasks should run on a separate thread,
  * \c false if they should remain on the calling thread.
- * All tasks run in sequence on a single thread.
+ * Unless \c task_queue_set_workers was called with a count above 1,
+ * all tasks run in sequence on a single thread.
  * If you want to scale a task to multiple threads,
  * you must do so within the task itself.
  * @param msg_push The task system will call this function to output messages.
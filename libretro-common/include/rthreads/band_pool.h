@@ -0,0 +1,83 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (band_pool.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_BAND_POOL_H__
+#define __LIBRETRO_SDK_BAND_POOL_H__
+
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+struct band_pool;
+typedef struct band_pool band_pool_t;
+
+/**
+ * (*band_pool_work_t):
+ * @userdata      : Value passed to band_pool_run().
+ * @first         : First row of the band.
+ * @last          : One past the last row of the band.
+ *
+ * Processes rows [@first, @last). Bands of the same run are
+ * processed concurrently and never overlap.
+ **/
+typedef void (*band_pool_work_t)(void *userdata,
+      unsigned first, unsigned last);
+
+/**
+ * band_pool_new:
+ * @num_threads   : Number of worker threads to create.
+ *
+ * Creates a pool that splits rows into @num_threads + 1
+ * bands, one for each worker and one for the calling thread.
+ * Idle workers poll for the next run for a short while before
+ * going to sleep, so back-to-back runs (the passes of a frame,
+ * fast-forwarded frames) do not pay for a wake-up each.
+ *
+ * Returns: pool, or NULL on failure.
+ **/
+band_pool_t *band_pool_new(unsigned num_threads);
+
+/**
+ * band_pool_free:
+ * @pool          : Pool to free, may be NULL.
+ *
+ * Stops and joins the workers, then frees the pool.
+ **/
+void band_pool_free(band_pool_t *pool);
+
+/**
+ * band_pool_run:
+ * @pool          : Pool handle.
+ * @rows          : Number of rows to process.
+ * @work          : Callback run for each band.
+ * @userdata      : Passed to @work.
+ *
+ * Splits rows [0, @rows) into evenly sized bands and runs
+ * @work on each of them, on the workers and the calling
+ * thread. Returns once every band is done.
+ **/
+void band_pool_run(band_pool_t *pool, unsigned rows,
+      band_pool_work_t work, void *userdata);
+
+RETRO_END_DECLS
+
+#endif
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include <queues/task_queue.h>
 
@@ -59,6 +60,7 @@ static task_queue_t tasks_finished          = {NULL, NULL};
 
 static struct retro_task_impl *impl_current = NULL;
 static bool task_threaded_enable            = false;
+static unsigned task_worker_count           = 1;
 
 #ifdef HAVE_THREADS
 static uintptr_t main_thread_id             = 0;
@@ -70,6 +72,35 @@ static scond_t *worker_cond                 = NULL;
 static sthread_t *worker_thread             = NULL;
 static bool worker_continue                 = true;
 /* use running_lock when touching it */
+
+/* Worker pool, used instead of the single worker
+ * when more than one worker is requested.
+ * Each worker owns one deque per priority. While a task
+ * waits for its next slice it sits in exactly one deque,
+ * and while it runs it sits in none, so two workers
+ * never call the same handler at once. 'tasks_running'
+ * stays the registry for find/retrieve/cancel. */
+typedef struct
+{
+   retro_task_t **tasks;
+   size_t count;
+   size_t capacity;
+} task_pool_deque_t;
+
+typedef struct
+{
+   task_pool_deque_t deque[TASK_PRIORITY_LAST];
+   slock_t *lock;
+   sthread_t *thread;
+} task_pool_worker_t;
+
+static task_pool_worker_t pool_workers[TASK_QUEUE_MAX_WORKERS];
+static unsigned pool_size                   = 0;
+static slock_t *pool_lock                   = NULL;
+static scond_t *pool_cond                   = NULL;
+static unsigned pool_generation             = 0;
+static bool pool_continue                   = true;
+/* use pool_lock when touching the last two */
 #endif
 
 static void task_queue_msg_push(retro_task_t *task,
@@ -174,6 +205,13 @@ static retro_task_t *task_queue_get(task_queue_t *queue)
    return task;
 }
 
+static unsigned task_queue_priority(retro_task_t *task)
+{
+   if (task->priority < TASK_PRIORITY_LAST)
+      return task->priority;
+   return TASK_PRIORITY_LAST - 1;
+}
+
 static void retro_task_internal_gather(void)
 {
    retro_task_t *task = NULL;
@@ -210,9 +248,10 @@ static void retro_task_regular_cancel(void *task)
 
 static void retro_task_regular_gather(void)
 {
+   unsigned priority;
    retro_task_t *task  = NULL;
    retro_task_t *queue = NULL;
-   retro_task_t *next  = NULL;
+   bool interactive    = false;
 
    while ((task = task_queue_get(&tasks_running)))
    {
@@ -220,21 +259,39 @@ static void retro_task_regular_gather(void)
       queue = task;
    }
 
-   for (task = queue; task; task = next)
+   /* Run due tasks in priority order. Background tasks
+    * sit out any frame in which interactive work ran,
+    * so they don't add to its latency. */
+   for (priority = 0; priority < TASK_PRIORITY_LAST; priority++)
    {
-      next = task->next;
+      retro_task_t **link = &queue;
 
-      if (!task->when || task->when < cpu_features_get_time_usec())
+      while ((task = *link))
       {
-         task->handler(task);
+         if (task_queue_priority(task) != priority)
+         {
+            link = &task->next;
+            continue;
+         }
 
-         task_queue_push_progress(task);
-      }
+         *link = task->next;
 
-      if ((task->flags & RETRO_TASK_FLG_FINISHED) > 0)
-         task_queue_put(&tasks_finished, task);
-      else
-         task_queue_put(&tasks_running, task);
+         if (     (!task->when || task->when < cpu_features_get_time_usec())
+               && !(interactive && priority == TASK_PRIORITY_BACKGROUND))
+         {
+            task->handler(task);
+
+            task_queue_push_progress(task);
+
+            if (priority == TASK_PRIORITY_INTERACTIVE)
+               interactive = true;
+         }
+
+         if ((task->flags & RETRO_TASK_FLG_FINISHED) > 0)
+            task_queue_put(&tasks_finished, task);
+         else
+            task_queue_put(&tasks_running, task);
+      }
    }
 
    retro_task_internal_gather();
@@ -330,6 +387,34 @@ static struct retro_task_impl impl_regular = {
 
 #ifdef HAVE_THREADS
 
+/* Earliest-deadline-ready: among the tasks due by 'due',
+ * returns the one with the highest priority. The queue
+ * is sorted by 'when', so the first match also has the
+ * earliest deadline, and requeued tasks of equal rank
+ * still take turns. If nothing is due, 'next_when' is
+ * set to the earliest pending 'when'. */
+static retro_task_t *task_queue_pick(task_queue_t *queue,
+      retro_time_t due, retro_time_t *next_when)
+{
+   retro_task_t *task = NULL;
+   retro_task_t *best = NULL;
+
+   for (task = queue->front; task; task = task->next)
+   {
+      if (task->when > due)
+      {
+         if (!*next_when || task->when < *next_when)
+            *next_when = task->when;
+         continue;
+      }
+
+      if (!best || task_queue_priority(task) < task_queue_priority(best))
+         best = task;
+   }
+
+   return best;
+}
+
 /* 'queue_lock' must be held for the duration of this function */
 static void task_queue_remove(task_queue_t *queue, retro_task_t *task)
 {
@@ -478,34 +563,30 @@ static void threaded_worker(void *userdata)
 {
    for (;;)
    {
-      retro_task_t *task  = NULL;
-      bool       finished = false;
+      retro_task_t *task     = NULL;
+      retro_time_t now       = 0;
+      retro_time_t next_when = 0;
+      bool       finished    = false;
 
       if (!worker_continue)
          break; /* should we keep running until all tasks finished? */
 
       slock_lock(running_lock);
 
-      /* Get first task to run */
-      if (!(task = tasks_running.front))
+      /* Get the most urgent task that is due,
+       * allowing half a millisecond for context switching */
+      now = cpu_features_get_time_usec();
+      if (!(task = task_queue_pick(&tasks_running, now + 500, &next_when)))
       {
-         scond_wait(worker_cond, running_lock);
+         if (!next_when)
+            scond_wait(worker_cond, running_lock);
+         else if (next_when - now - 500 > 0)
+            scond_wait_timeout(worker_cond, running_lock,
+                  next_when - now - 500);
          slock_unlock(running_lock);
          continue;
       }
 
-      if (task->when)
-      {
-         retro_time_t now   = cpu_features_get_time_usec();
-         retro_time_t delay = task->when - now - 500; /* allow half a millisecond for context switching */
-         if (delay > 0)
-         {
-            scond_wait_timeout(worker_cond, running_lock, delay);
-            slock_unlock(running_lock);
-            continue;
-         }
-      }
-
       slock_unlock(running_lock);
 
       task->handler(task);
@@ -523,7 +604,7 @@ static void threaded_worker(void *userdata)
          slock_lock(running_lock);
          slock_lock(queue_lock);
 
-         /* do nothing if only item in queue */
+         /* do nothing if already at the back */
          if (task->next)
          {
             task_queue_remove(&tasks_running, task);
@@ -600,6 +681,361 @@ static struct retro_task_impl impl_threaded = {
    retro_task_threaded_init,
    retro_task_threaded_deinit
 };
+
+/* Blocking tasks are always treated as interactive */
+static unsigned task_pool_get_class(retro_task_t *task)
+{
+   if (task->type == TASK_TYPE_BLOCKING)
+      return TASK_PRIORITY_INTERACTIVE;
+   return task_queue_priority(task);
+}
+
+/* The owning worker's lock must be held */
+static bool task_pool_deque_push(task_pool_deque_t *deque,
+      retro_task_t *task)
+{
+   if (deque->count == deque->capacity)
+   {
+      size_t new_capacity   = deque->capacity ? deque->capacity * 2 : 8;
+      retro_task_t **tasks  = (retro_task_t**)realloc(deque->tasks,
+            new_capacity * sizeof(*tasks));
+      if (!tasks)
+         return false;
+      deque->tasks          = tasks;
+      deque->capacity       = new_capacity;
+   }
+
+   deque->tasks[deque->count++] = task;
+   return true;
+}
+
+/* Removes the due task with the earliest 'when'. On a tie
+ * the owner takes from the front, thieves from the back.
+ * 'next_when' is lowered to the earliest pending 'when'.
+ * The owning worker's lock must be held. */
+static retro_task_t *task_pool_deque_take(task_pool_deque_t *deque,
+      bool steal, retro_time_t now, retro_time_t *next_when)
+{
+   size_t i;
+   size_t best        = deque->count;
+   retro_task_t *task = NULL;
+
+   for (i = 0; i < deque->count; i++)
+   {
+      size_t idx = steal ? deque->count - 1 - i : i;
+
+      task       = deque->tasks[idx];
+
+      if (task->when > now)
+      {
+         if (!*next_when || task->when < *next_when)
+            *next_when = task->when;
+         continue;
+      }
+
+      if (best == deque->count || task->when < deque->tasks[best]->when)
+         best    = idx;
+   }
+
+   if (best == deque->count)
+      return NULL;
+
+   task = deque->tasks[best];
+   memmove(&deque->tasks[best], &deque->tasks[best + 1],
+         (deque->count - best - 1) * sizeof(*deque->tasks));
+   deque->count--;
+   return task;
+}
+
+/* Queues the task on the first worker, starting at 'first',
+ * that has room for it. Returns the length of the deque it
+ * went to, or 0 if every push failed. */
+static size_t task_pool_queue(unsigned first, retro_task_t *task)
+{
+   unsigned i;
+   unsigned klass = task_pool_get_class(task);
+
+   for (i = 0; i < pool_size; i++)
+   {
+      task_pool_worker_t *w    = &pool_workers[(first + i) % pool_size];
+      task_pool_deque_t *deque = &w->deque[klass];
+      size_t count             = 0;
+
+      slock_lock(w->lock);
+      if (task_pool_deque_push(deque, task))
+         count = deque->count;
+      slock_unlock(w->lock);
+
+      if (count)
+         return count;
+   }
+
+   return 0;
+}
+
+/* Out of memory: nothing would ever run the task again,
+ * so finish it with an error instead of leaving it stuck
+ * in 'tasks_running'. */
+static void task_pool_fail(retro_task_t *task)
+{
+   slock_lock(property_lock);
+   task->flags |= RETRO_TASK_FLG_FINISHED;
+   if (!task->error)
+      task->error = strdup("Out of memory, task was not queued");
+   slock_unlock(property_lock);
+
+   slock_lock(running_lock);
+   slock_lock(queue_lock);
+   task_queue_remove(&tasks_running, task);
+   slock_unlock(queue_lock);
+   slock_unlock(running_lock);
+
+   slock_lock(finished_lock);
+   task_queue_put(&tasks_finished, task);
+   slock_unlock(finished_lock);
+}
+
+static void task_pool_notify(void)
+{
+   slock_lock(pool_lock);
+   pool_generation++;
+   scond_broadcast(pool_cond);
+   slock_unlock(pool_lock);
+}
+
+/* Interactive tasks always go to worker 0, which runs
+ * nothing else. Other tasks go to the least loaded of
+ * the remaining workers. */
+static void task_pool_dispatch(retro_task_t *task)
+{
+   unsigned i, j;
+   unsigned target = 0;
+   unsigned klass  = task_pool_get_class(task);
+
+   if (klass != TASK_PRIORITY_INTERACTIVE)
+   {
+      size_t best = (size_t)-1;
+
+      for (i = 1; i < pool_size; i++)
+      {
+         size_t count = 0;
+         slock_lock(pool_workers[i].lock);
+         for (j = 0; j < TASK_PRIORITY_LAST; j++)
+            count += pool_workers[i].deque[j].count;
+         slock_unlock(pool_workers[i].lock);
+
+         if (count < best)
+         {
+            best   = count;
+            target = i;
+         }
+      }
+   }
+
+   if (!task_pool_queue(target, task))
+      task_pool_fail(task);
+}
+
+/* Own deque first, then steal from the others,
+ * one priority at a time so that due interactive work
+ * always runs before normal work, and normal work
+ * before background work. */
+static retro_task_t *task_pool_next(unsigned id, retro_time_t *next_when)
+{
+   unsigned i, klass;
+   retro_time_t now = cpu_features_get_time_usec();
+
+   for (klass = 0; klass < TASK_PRIORITY_LAST; klass++)
+   {
+      if (id == 0 && klass != TASK_PRIORITY_INTERACTIVE)
+         break;
+
+      for (i = 0; i < pool_size; i++)
+      {
+         unsigned       victim    = (id + i) % pool_size;
+         task_pool_worker_t *w    = &pool_workers[victim];
+         retro_task_t      *task  = NULL;
+
+         slock_lock(w->lock);
+         task = task_pool_deque_take(&w->deque[klass],
+               victim != id, now, next_when);
+         slock_unlock(w->lock);
+
+         if (task)
+            return task;
+      }
+   }
+
+   return NULL;
+}
+
+static void task_pool_worker(void *userdata)
+{
+   unsigned id = (unsigned)(uintptr_t)userdata;
+
+   for (;;)
+   {
+      retro_task_t *task     = NULL;
+      retro_time_t next_when = 0;
+      unsigned generation    = 0;
+      bool finished          = false;
+
+      slock_lock(pool_lock);
+      if (!pool_continue)
+      {
+         slock_unlock(pool_lock);
+         break;
+      }
+      generation = pool_generation;
+      slock_unlock(pool_lock);
+
+      if (!(task = task_pool_next(id, &next_when)))
+      {
+         slock_lock(pool_lock);
+         /* Only sleep if nothing was queued since the scan began */
+         if (pool_continue && generation == pool_generation)
+         {
+            if (next_when)
+            {
+               retro_time_t delay = next_when - cpu_features_get_time_usec();
+               if (delay > 0)
+                  scond_wait_timeout(pool_cond, pool_lock, delay);
+            }
+            else
+               scond_wait(pool_cond, pool_lock);
+         }
+         slock_unlock(pool_lock);
+         continue;
+      }
+
+      task->handler(task);
+
+      slock_lock(property_lock);
+      finished = ((task->flags & RETRO_TASK_FLG_FINISHED) > 0) ? true : false;
+      slock_unlock(property_lock);
+
+      if (!finished)
+      {
+         /* Back of our own deque. If others are waiting
+          * behind it, let an idle worker come and take them. */
+         size_t count = task_pool_queue(id, task);
+
+         if (!count)
+            task_pool_fail(task);
+         else if (count > 1)
+            task_pool_notify();
+      }
+      else
+      {
+         slock_lock(running_lock);
+         slock_lock(queue_lock);
+         task_queue_remove(&tasks_running, task);
+         slock_unlock(queue_lock);
+         slock_unlock(running_lock);
+
+         slock_lock(finished_lock);
+         task_queue_put(&tasks_finished, task);
+         slock_unlock(finished_lock);
+      }
+   }
+}
+
+static void retro_task_pool_push_running(retro_task_t *task)
+{
+   slock_lock(running_lock);
+   slock_lock(queue_lock);
+   task_queue_put(&tasks_running, task);
+   slock_unlock(queue_lock);
+   slock_unlock(running_lock);
+
+   task_pool_dispatch(task);
+   task_pool_notify();
+}
+
+static void retro_task_pool_init(void)
+{
+   unsigned i;
+   retro_task_t *task = NULL;
+   retro_task_t *next = NULL;
+
+   running_lock    = slock_new();
+   finished_lock   = slock_new();
+   property_lock   = slock_new();
+   queue_lock      = slock_new();
+   pool_lock       = slock_new();
+   pool_cond       = scond_new();
+
+   pool_continue   = true;
+   pool_generation = 0;
+   pool_size       = task_worker_count;
+
+   for (i = 0; i < pool_size; i++)
+   {
+      memset(&pool_workers[i], 0, sizeof(pool_workers[i]));
+      pool_workers[i].lock = slock_new();
+   }
+
+   /* Hand out tasks left behind by the previous implementation */
+   for (task = tasks_running.front; task; task = next)
+   {
+      next = task->next;
+      task_pool_dispatch(task);
+   }
+
+   for (i = 0; i < pool_size; i++)
+      pool_workers[i].thread = sthread_create(task_pool_worker,
+            (void*)(uintptr_t)i);
+}
+
+static void retro_task_pool_deinit(void)
+{
+   unsigned i, j;
+
+   slock_lock(pool_lock);
+   pool_continue = false;
+   scond_broadcast(pool_cond);
+   slock_unlock(pool_lock);
+
+   for (i = 0; i < pool_size; i++)
+      if (pool_workers[i].thread)
+         sthread_join(pool_workers[i].thread);
+
+   for (i = 0; i < pool_size; i++)
+   {
+      for (j = 0; j < TASK_PRIORITY_LAST; j++)
+         free(pool_workers[i].deque[j].tasks);
+      slock_free(pool_workers[i].lock);
+      memset(&pool_workers[i], 0, sizeof(pool_workers[i]));
+   }
+
+   scond_free(pool_cond);
+   slock_free(pool_lock);
+   slock_free(running_lock);
+   slock_free(finished_lock);
+   slock_free(property_lock);
+   slock_free(queue_lock);
+
+   pool_size       = 0;
+   pool_cond       = NULL;
+   pool_lock       = NULL;
+   running_lock    = NULL;
+   finished_lock   = NULL;
+   property_lock   = NULL;
+   queue_lock      = NULL;
+}
+
+static struct retro_task_impl impl_pool = {
+   NULL,
+   retro_task_pool_push_running,
+   retro_task_threaded_cancel,
+   retro_task_threaded_reset,
+   retro_task_threaded_wait,
+   retro_task_threaded_gather,
+   retro_task_threaded_find,
+   retro_task_threaded_retrieve,
+   retro_task_pool_init,
+   retro_task_pool_deinit
+};
 #endif
 
 /* Deinitializes the task system.
@@ -621,7 +1057,8 @@ void task_queue_init(bool threaded, retro_task_queue_msg_t msg_push)
    if (threaded)
    {
       task_threaded_enable = true;
-      impl_current         = &impl_threaded;
+      impl_current         = (task_worker_count > 1)
+         ? &impl_pool : &impl_threaded;
    }
 #endif
 
@@ -646,6 +1083,20 @@ bool task_queue_is_threaded(void)
    return task_threaded_enable;
 }
 
+void task_queue_set_workers(unsigned workers)
+{
+   if (workers < 1)
+      workers = 1;
+   else if (workers > TASK_QUEUE_MAX_WORKERS)
+      workers = TASK_QUEUE_MAX_WORKERS;
+   task_worker_count = workers;
+}
+
+unsigned task_queue_get_workers(void)
+{
+   return task_worker_count;
+}
+
 bool task_queue_find(task_finder_data_t *find_data)
 {
    return impl_current->find(find_data->func, find_data->userdata);
@@ -659,10 +1110,14 @@ void task_queue_retrieve(task_retriever_data_t *data)
 void task_queue_check(void)
 {
 #ifdef HAVE_THREADS
-   bool current_threaded = (impl_current == &impl_threaded);
-   bool want_threaded    = task_threaded_enable;
+   bool want_threaded                = task_threaded_enable;
+   struct retro_task_impl *want_impl = &impl_regular;
+
+   if (want_threaded)
+      want_impl = (task_worker_count > 1) ? &impl_pool : &impl_threaded;
 
-   if (want_threaded != current_threaded)
+   if (     want_impl != impl_current
+         || (want_impl == &impl_pool && pool_size != task_worker_count))
       task_queue_deinit();
 
    if (!impl_current)
@@ -928,6 +1383,7 @@ retro_task_t *task_init(void)
    task->title             = NULL;
    task->type              = TASK_TYPE_NONE;
    task->style             = TASK_STYLE_NONE;
+   task->priority          = TASK_PRIORITY_NORMAL;
    task->ident             = task_count++;
    task->frontend_userdata = NULL;
    task->next              = NULL;
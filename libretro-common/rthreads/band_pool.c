@@ -0,0 +1,195 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (band_pool.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <boolean.h>
+
+#include <rthreads/rthreads.h>
+#include <rthreads/band_pool.h>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define BAND_POOL_PAUSE() _mm_pause()
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define BAND_POOL_PAUSE() __builtin_ia32_pause()
+#elif defined(__GNUC__) && (defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7))
+#define BAND_POOL_PAUSE() __asm__ __volatile__("yield")
+#else
+#define BAND_POOL_PAUSE() ((void)0)
+#endif
+
+/* Number of times an idle worker polls for the next run
+ * before going to sleep on the condition variable */
+#define BAND_POOL_SPIN 2048
+
+/* The calling thread publishes a run by bumping 'generation';
+ * workers and the caller then pull bands until none are left. */
+struct band_pool
+{
+   sthread_t **threads;
+   band_pool_work_t work;
+   void *userdata;
+   slock_t *lock;
+   scond_t *cond_work;
+   scond_t *cond_done;
+   unsigned num_threads;
+   unsigned num_bands;
+   unsigned rows;
+   unsigned next;                /* Next band to hand out */
+   unsigned pending;             /* Bands handed out or queued, not yet done */
+   volatile unsigned generation; /* Polled without the lock while spinning */
+   volatile bool die;
+};
+
+/* Runs the queued bands of the current run.
+ * Must be called with the pool lock held. */
+static void band_pool_run_bands(band_pool_t *pool)
+{
+   while (pool->next < pool->num_bands)
+   {
+      unsigned band  = pool->next++;
+      unsigned first = pool->rows * band       / pool->num_bands;
+      unsigned last  = pool->rows * (band + 1) / pool->num_bands;
+
+      slock_unlock(pool->lock);
+      if (first < last)
+         pool->work(pool->userdata, first, last);
+      slock_lock(pool->lock);
+
+      if (--pool->pending == 0)
+         scond_signal(pool->cond_done);
+   }
+}
+
+static void band_pool_loop(void *data)
+{
+   band_pool_t *pool   = (band_pool_t*)data;
+   unsigned generation = 0;
+
+   for (;;)
+   {
+      unsigned spin;
+
+      /* Wait for the next run without touching the lock,
+       * which the calling thread is about to take */
+      for (spin = 0; spin < BAND_POOL_SPIN; spin++)
+      {
+         if (pool->generation != generation || pool->die)
+            break;
+         BAND_POOL_PAUSE();
+      }
+
+      slock_lock(pool->lock);
+      while (pool->generation == generation && !pool->die)
+         scond_wait(pool->cond_work, pool->lock);
+
+      if (pool->die)
+      {
+         slock_unlock(pool->lock);
+         break;
+      }
+
+      generation = pool->generation;
+      band_pool_run_bands(pool);
+      slock_unlock(pool->lock);
+   }
+}
+
+void band_pool_free(band_pool_t *pool)
+{
+   unsigned i;
+
+   if (!pool)
+      return;
+
+   if (pool->lock)
+   {
+      slock_lock(pool->lock);
+      pool->die = true;
+      if (pool->cond_work)
+         scond_broadcast(pool->cond_work);
+      slock_unlock(pool->lock);
+   }
+
+   for (i = 0; i < pool->num_threads; i++)
+      sthread_join(pool->threads[i]);
+
+   if (pool->cond_work)
+      scond_free(pool->cond_work);
+   if (pool->cond_done)
+      scond_free(pool->cond_done);
+   if (pool->lock)
+      slock_free(pool->lock);
+   free(pool->threads);
+   free(pool);
+}
+
+band_pool_t *band_pool_new(unsigned num_threads)
+{
+   unsigned i;
+   band_pool_t *pool = (band_pool_t*)calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+   if (     !(pool->threads   = (sthread_t**)
+               calloc(num_threads ? num_threads : 1, sizeof(*pool->threads)))
+         || !(pool->lock      = slock_new())
+         || !(pool->cond_work = scond_new())
+         || !(pool->cond_done = scond_new()))
+      goto error;
+
+   for (i = 0; i < num_threads; i++)
+   {
+      if (!(pool->threads[i] = sthread_create(band_pool_loop, pool)))
+         goto error;
+      pool->num_threads++;
+   }
+
+   pool->num_bands = num_threads + 1;
+   return pool;
+
+error:
+   band_pool_free(pool);
+   return NULL;
+}
+
+void band_pool_run(band_pool_t *pool, unsigned rows,
+      band_pool_work_t work, void *userdata)
+{
+   slock_lock(pool->lock);
+
+   pool->work     = work;
+   pool->userdata = userdata;
+   pool->rows     = rows;
+   pool->next     = 0;
+   pool->pending  = pool->num_bands;
+   pool->generation++;
+   scond_broadcast(pool->cond_work);
+
+   band_pool_run_bands(pool);
+
+   while (pool->pending)
+      scond_wait(pool->cond_done, pool->lock);
+
+   slock_unlock(pool->lock);
+}
@@ -0,0 +1,224 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (bench_crc32.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Checks every CRC32 kernel built for this host against a
+ * bytewise reference, then prints their throughput.
+ *
+ * Usage: bench_crc32 [megabytes] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The kernels are static, so pull in the implementation */
+#include "../../encodings/encoding_crc32.c"
+
+typedef uint32_t (*crc32_kernel_t)(uint32_t crc,
+      const uint8_t *buf, size_t len);
+
+static uint32_t bench_crc32_table[256];
+/* Keeps the timed calls from being optimized out */
+static volatile uint32_t bench_crc32_sink;
+
+static void bench_crc32_init(void)
+{
+   unsigned i, j;
+   for (i = 0; i < 256; i++)
+   {
+      uint32_t c = i;
+      for (j = 0; j < 8; j++)
+         c = (c >> 1) ^ ((c & 1) ? 0xedb88320 : 0);
+      bench_crc32_table[i] = c;
+   }
+}
+
+/* All kernels take and return the inverted CRC */
+static uint32_t bench_crc32_bytewise(uint32_t crc,
+      const uint8_t *buf, size_t len)
+{
+   while (len--)
+      crc = bench_crc32_table[(crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
+   return crc;
+}
+
+static uint32_t bench_crc32_dispatch(uint32_t crc,
+      const uint8_t *buf, size_t len)
+{
+   return ~encoding_crc32(~crc, buf, len);
+}
+
+#if !__ARM_FEATURE_CRC32
+static uint32_t bench_crc32_slice8(uint32_t crc,
+      const uint8_t *buf, size_t len)
+{
+   return crc32_slice8(crc, buf, len);
+}
+
+#ifdef CRC32_HAVE_PCLMUL
+/* The folding kernel only takes whole 16 byte blocks */
+static uint32_t bench_crc32_pclmul(uint32_t crc,
+      const uint8_t *buf, size_t len)
+{
+   size_t _len = len & ~(size_t)15;
+   if (len < 64)
+      return crc32_slice8(crc, buf, len);
+   crc = crc32_pclmul(crc, buf, _len);
+   return crc32_slice8(crc, buf + _len, len - _len);
+}
+#endif
+#endif
+
+static double bench_crc32_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench_crc32_verify(const char *name, crc32_kernel_t kernel,
+      const uint8_t *buf, size_t size)
+{
+   size_t len, offset;
+
+   /* Every short length, and every alignment, plus a few long runs */
+   for (offset = 0; offset < 16; offset++)
+   {
+      for (len = 0; len < 300 && offset + len <= size; len++)
+      {
+         uint32_t expected = bench_crc32_bytewise(~0u, buf + offset, len);
+         uint32_t got      = kernel(~0u, buf + offset, len);
+         if (expected != got)
+         {
+            printf("%-10s MISMATCH at offset %u, length %u: "
+                  "%08x != %08x\n", name, (unsigned)offset,
+                  (unsigned)len, got, expected);
+            return 0;
+         }
+      }
+   }
+
+   for (len = 4093; len < size; len = len * 3 + 7)
+   {
+      if (     bench_crc32_bytewise(0x12345678, buf + 3, len)
+            != kernel(0x12345678, buf + 3, len))
+      {
+         printf("%-10s MISMATCH at length %u\n", name, (unsigned)len);
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+/* Returns the throughput in MB/s */
+static double bench_crc32_run(const char *name, crc32_kernel_t kernel,
+      const uint8_t *buf, size_t size, double base)
+{
+   unsigned runs   = 0;
+   double start    = bench_crc32_now();
+   double elapsed  = 0.0;
+   double mbps;
+   uint32_t crc    = 0;
+
+   do
+   {
+      crc     = kernel(crc, buf, size);
+      elapsed = bench_crc32_now() - start;
+      runs++;
+   } while (elapsed < 0.5);
+
+   bench_crc32_sink = crc;
+   mbps = (double)size * runs / elapsed / (1024.0 * 1024.0);
+   printf("%-10s %9.1f MB/s %6.2fx\n", name, mbps,
+         base > 0.0 ? mbps / base : 1.0);
+   return mbps;
+}
+
+int main(int argc, char *argv[])
+{
+   size_t i;
+   int ok        = 1;
+   double base   = 0.0;
+   size_t size   = (size_t)(argc > 1 ? atoi(argv[1]) : 64) * 1024 * 1024;
+   uint8_t *buf  = (uint8_t*)malloc(size);
+   struct
+   {
+      const char *name;
+      crc32_kernel_t kernel;
+   } kernels[] = {
+      { "bytewise", bench_crc32_bytewise },
+#if !__ARM_FEATURE_CRC32
+      { "slice8",   bench_crc32_slice8 },
+#ifdef CRC32_HAVE_PCLMUL
+      { "pclmul",   bench_crc32_pclmul },
+#endif
+#endif
+      { "dispatch", bench_crc32_dispatch }
+   };
+
+   if (!buf || size < 65536)
+   {
+      fprintf(stderr, "Usage: %s [megabytes]\n", argv[0]);
+      return 1;
+   }
+
+   bench_crc32_init();
+   srand(1);
+   for (i = 0; i < size; i++)
+      buf[i] = (uint8_t)rand();
+
+#if !__ARM_FEATURE_CRC32 && defined(CRC32_HAVE_PCLMUL)
+   if (!crc32_pclmul_supported())
+   {
+      printf("pclmul     not supported by this CPU, skipped\n");
+      kernels[2] = kernels[3];
+   }
+#endif
+
+   for (i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+      if (!bench_crc32_verify(kernels[i].name, kernels[i].kernel,
+               buf, size))
+         ok = 0;
+
+   if (!ok)
+   {
+      free(buf);
+      return 1;
+   }
+
+   /* Speedups are reported against the bytewise reference */
+   printf("%u MB buffer\n", (unsigned)(size / (1024 * 1024)));
+   for (i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+   {
+      double mbps;
+      if (i > 0 && kernels[i].kernel == kernels[i - 1].kernel)
+         continue;
+      mbps = bench_crc32_run(kernels[i].name, kernels[i].kernel,
+            buf, size, base);
+      if (i == 0)
+         base = mbps;
+   }
+
+   free(buf);
+   return 0;
+}
@@ -0,0 +1,423 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (bench_pixconv.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Checks every pixel conversion, at every SIMD level this CPU
+ * runs, against a per-pixel reference, then prints throughput.
+ *
+ * Usage: bench_pixconv [width height] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The kernels and the dispatch state are static, so pull in
+ * the implementation */
+#include "../../gfx/scaler/pixconv.c"
+
+typedef void (*bench_pixconv_t)(void *output, const void *input,
+      int width, int height, int out_stride, int in_stride);
+/* Converts one pixel, or one pixel pair for YUYV */
+typedef void (*bench_pixconv_ref_t)(uint8_t *out, const uint8_t *in);
+
+/* Pads every row so that overruns show up */
+#define BENCH_PIXCONV_PAD 64
+
+/* Keeps the timed calls from being optimized out */
+static volatile uint8_t bench_pixconv_sink;
+
+static unsigned bench_get16(const uint8_t *in)
+{
+   return in[0] | (in[1] << 8);
+}
+
+static void bench_put16(uint8_t *out, unsigned col)
+{
+   out[0] = (uint8_t)col;
+   out[1] = (uint8_t)(col >> 8);
+}
+
+static void bench_put32(uint8_t *out, uint32_t col)
+{
+   out[0] = (uint8_t)col;
+   out[1] = (uint8_t)(col >> 8);
+   out[2] = (uint8_t)(col >> 16);
+   out[3] = (uint8_t)(col >> 24);
+}
+
+static unsigned bench_expand5(unsigned c) { return (c << 3) | (c >> 2); }
+static unsigned bench_expand6(unsigned c) { return (c << 2) | (c >> 4); }
+
+static int bench_clamp(int c) { return c < 0 ? 0 : c > 255 ? 255 : c; }
+
+static uint32_t bench_argb(unsigned a, unsigned r, unsigned g, unsigned b)
+{
+   return ((uint32_t)a << 24) | (r << 16) | (g << 8) | b;
+}
+
+static void ref_rgb565_0rgb1555(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   bench_put16(out, ((c >> 11) << 10) | (((c >> 6) & 0x1f) << 5) | (c & 0x1f));
+}
+
+static void ref_0rgb1555_rgb565(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   unsigned g = (c >> 5) & 0x1f;
+   bench_put16(out, (((c >> 10) & 0x1f) << 11) | (((g << 1) | (g >> 4)) << 5)
+         | (c & 0x1f));
+}
+
+static void ref_0rgb1555_argb8888(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   bench_put32(out, bench_argb(0xff, bench_expand5((c >> 10) & 0x1f),
+            bench_expand5((c >> 5) & 0x1f), bench_expand5(c & 0x1f)));
+}
+
+static void ref_rgb565_argb8888(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   bench_put32(out, bench_argb(0xff, bench_expand5(c >> 11),
+            bench_expand6((c >> 5) & 0x3f), bench_expand5(c & 0x1f)));
+}
+
+static void ref_rgb565_abgr8888(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   bench_put32(out, bench_argb(0xff, bench_expand5(c & 0x1f),
+            bench_expand6((c >> 5) & 0x3f), bench_expand5(c >> 11)));
+}
+
+static void ref_argb8888_rgba4444(uint8_t *out, const uint8_t *in)
+{
+   bench_put16(out, ((in[2] >> 4) << 12) | ((in[1] >> 4) << 8)
+         | ((in[0] >> 4) << 4) | (in[3] >> 4));
+}
+
+static void ref_rgba4444_argb8888(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   bench_put32(out, bench_argb((c & 0xf) * 17, (c >> 12) * 17,
+            ((c >> 8) & 0xf) * 17, ((c >> 4) & 0xf) * 17));
+}
+
+static void ref_rgba4444_rgb565(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   bench_put16(out, ((c >> 12) << 12) | (((c >> 8) & 0xf) << 7)
+         | (((c >> 4) & 0xf) << 1));
+}
+
+static void ref_0rgb1555_bgr24(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   out[0]     = bench_expand5(c & 0x1f);
+   out[1]     = bench_expand5((c >> 5) & 0x1f);
+   out[2]     = bench_expand5((c >> 10) & 0x1f);
+}
+
+static void ref_rgb565_bgr24(uint8_t *out, const uint8_t *in)
+{
+   unsigned c = bench_get16(in);
+   out[0]     = bench_expand5(c & 0x1f);
+   out[1]     = bench_expand6((c >> 5) & 0x3f);
+   out[2]     = bench_expand5(c >> 11);
+}
+
+static void ref_bgr24_argb8888(uint8_t *out, const uint8_t *in)
+{
+   bench_put32(out, bench_argb(0xff, in[2], in[1], in[0]));
+}
+
+static void ref_bgr24_rgb565(uint8_t *out, const uint8_t *in)
+{
+   bench_put16(out, ((in[2] >> 3) << 11) | ((in[1] >> 2) << 5) | (in[0] >> 3));
+}
+
+static void ref_argb8888_0rgb1555(uint8_t *out, const uint8_t *in)
+{
+   bench_put16(out, ((in[2] >> 3) << 10) | ((in[1] >> 3) << 5) | (in[0] >> 3));
+}
+
+static void ref_argb8888_rgb565(uint8_t *out, const uint8_t *in)
+{
+   ref_bgr24_rgb565(out, in);
+}
+
+static void ref_argb8888_bgr24(uint8_t *out, const uint8_t *in)
+{
+   out[0] = in[0];
+   out[1] = in[1];
+   out[2] = in[2];
+}
+
+static void ref_abgr8888_bgr24(uint8_t *out, const uint8_t *in)
+{
+   out[0] = in[2];
+   out[1] = in[1];
+   out[2] = in[0];
+}
+
+static void ref_argb8888_abgr8888(uint8_t *out, const uint8_t *in)
+{
+   out[0] = in[2];
+   out[1] = in[1];
+   out[2] = in[0];
+   out[3] = in[3];
+}
+
+static void ref_yuyv_argb8888(uint8_t *out, const uint8_t *in)
+{
+   int i;
+   int u = in[1] - 128;
+   int v = in[3] - 128;
+
+   for (i = 0; i < 2; i++)
+   {
+      int y = in[i * 2] * 64 + 32;
+      bench_put32(out + i * 4, bench_argb(0xff,
+               bench_clamp((y + 90 * v) >> 6),
+               bench_clamp((y - 22 * u - 46 * v) >> 6),
+               bench_clamp((y + 113 * u) >> 6)));
+   }
+}
+
+static const struct
+{
+   const char *name;
+   bench_pixconv_t conv;
+   bench_pixconv_ref_t ref;
+   int in_bpp;
+   int out_bpp;
+   int step;
+} bench_convs[] = {
+   { "rgb565_0rgb1555",   conv_rgb565_0rgb1555,   ref_rgb565_0rgb1555,   2, 2, 1 },
+   { "0rgb1555_rgb565",   conv_0rgb1555_rgb565,   ref_0rgb1555_rgb565,   2, 2, 1 },
+   { "0rgb1555_argb8888", conv_0rgb1555_argb8888, ref_0rgb1555_argb8888, 2, 4, 1 },
+   { "rgb565_argb8888",   conv_rgb565_argb8888,   ref_rgb565_argb8888,   2, 4, 1 },
+   { "rgb565_abgr8888",   conv_rgb565_abgr8888,   ref_rgb565_abgr8888,   2, 4, 1 },
+   { "argb8888_rgba4444", conv_argb8888_rgba4444, ref_argb8888_rgba4444, 4, 2, 1 },
+   { "rgba4444_argb8888", conv_rgba4444_argb8888, ref_rgba4444_argb8888, 2, 4, 1 },
+   { "rgba4444_rgb565",   conv_rgba4444_rgb565,   ref_rgba4444_rgb565,   2, 2, 1 },
+   { "0rgb1555_bgr24",    conv_0rgb1555_bgr24,    ref_0rgb1555_bgr24,    2, 3, 1 },
+   { "rgb565_bgr24",      conv_rgb565_bgr24,      ref_rgb565_bgr24,      2, 3, 1 },
+   { "bgr24_argb8888",    conv_bgr24_argb8888,    ref_bgr24_argb8888,    3, 4, 1 },
+   { "bgr24_rgb565",      conv_bgr24_rgb565,      ref_bgr24_rgb565,      3, 2, 1 },
+   { "argb8888_0rgb1555", conv_argb8888_0rgb1555, ref_argb8888_0rgb1555, 4, 2, 1 },
+   { "argb8888_rgb565",   conv_argb8888_rgb565,   ref_argb8888_rgb565,   4, 2, 1 },
+   { "argb8888_bgr24",    conv_argb8888_bgr24,    ref_argb8888_bgr24,    4, 3, 1 },
+   { "abgr8888_bgr24",    conv_abgr8888_bgr24,    ref_abgr8888_bgr24,    4, 3, 1 },
+   { "argb8888_abgr8888", conv_argb8888_abgr8888, ref_argb8888_abgr8888, 4, 4, 1 },
+   { "yuyv_argb8888",     conv_yuyv_argb8888,     ref_yuyv_argb8888,     2, 4, 2 }
+};
+
+static const struct
+{
+   const char *name;
+   int flags;
+} bench_levels[] = {
+   { "base",  0 },
+#ifdef PIXCONV_HAVE_X86_SIMD
+   { "ssse3", PIXCONV_SIMD_SSSE3 },
+   { "avx2",  PIXCONV_SIMD_SSSE3 | PIXCONV_SIMD_AVX2 },
+#endif
+};
+
+#define BENCH_NUM_CONVS  (sizeof(bench_convs)  / sizeof(bench_convs[0]))
+#define BENCH_NUM_LEVELS (sizeof(bench_levels) / sizeof(bench_levels[0]))
+
+static int bench_set_level(unsigned level)
+{
+#ifdef PIXCONV_HAVE_X86_SIMD
+   int flags = pixconv_simd_detect();
+   if ((flags & bench_levels[level].flags) != bench_levels[level].flags)
+      return 0;
+   pixconv_simd_flags = bench_levels[level].flags;
+#endif
+   return 1;
+}
+
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench_verify(unsigned conv, unsigned level,
+      uint8_t *in, uint8_t *out, int width, int height)
+{
+   int x, y;
+   int in_stride  = width * bench_convs[conv].in_bpp  + BENCH_PIXCONV_PAD;
+   int out_stride = width * bench_convs[conv].out_bpp + BENCH_PIXCONV_PAD;
+   int step       = bench_convs[conv].step;
+
+   memset(out, 0xa5, (size_t)out_stride * height);
+   bench_convs[conv].conv(out, in, width, height, out_stride, in_stride);
+
+   for (y = 0; y < height; y++)
+   {
+      const uint8_t *src = in  + (size_t)y * in_stride;
+      const uint8_t *dst = out + (size_t)y * out_stride;
+      int row_len        = width * bench_convs[conv].out_bpp;
+
+      for (x = 0; x < width; x += step)
+      {
+         uint8_t expected[8];
+         int size = bench_convs[conv].out_bpp * step;
+
+         bench_convs[conv].ref(expected,
+               src + x * bench_convs[conv].in_bpp);
+         if (memcmp(expected, dst + x * bench_convs[conv].out_bpp, size))
+         {
+            printf("%-18s %-5s MISMATCH at %dx%d, pixel %d,%d\n",
+                  bench_convs[conv].name, bench_levels[level].name,
+                  width, height, x, y);
+            return 0;
+         }
+      }
+
+      for (x = row_len; x < out_stride; x++)
+      {
+         if (dst[x] != 0xa5)
+         {
+            printf("%-18s %-5s OVERRUN at %dx%d, row %d\n",
+                  bench_convs[conv].name, bench_levels[level].name,
+                  width, height, y);
+            return 0;
+         }
+      }
+   }
+
+   return 1;
+}
+
+/* Returns the throughput in megapixels per second */
+static double bench_run(unsigned conv, uint8_t *in, uint8_t *out,
+      int width, int height)
+{
+   unsigned runs  = 0;
+   double start   = bench_now();
+   double elapsed = 0.0;
+   int in_stride  = width * bench_convs[conv].in_bpp;
+   int out_stride = width * bench_convs[conv].out_bpp;
+
+   do
+   {
+      bench_convs[conv].conv(out, in, width, height, out_stride, in_stride);
+      elapsed = bench_now() - start;
+      runs++;
+   } while (elapsed < 0.25);
+
+   bench_pixconv_sink = out[runs % (out_stride * height)];
+   return (double)width * height * runs / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   int w;
+   int ok         = 1;
+   int width      = argc > 2 ? atoi(argv[1]) : 1920;
+   int height     = argc > 2 ? atoi(argv[2]) : 1080;
+   size_t size;
+   uint8_t *in;
+   uint8_t *out;
+
+   if (width < 2 || height < 1 || (width & 1))
+   {
+      fprintf(stderr, "Usage: %s [width height]\n", argv[0]);
+      return 1;
+   }
+
+   /* Big enough for either the timed frame or the padded checks */
+   size = (size_t)(width + 1024) * 4 * (height + 4) + 4096;
+   in   = (uint8_t*)malloc(size);
+   out  = (uint8_t*)malloc(size);
+   if (!in || !out)
+      return 1;
+
+   srand(1);
+   for (i = 0; i < size; i++)
+      in[i] = (uint8_t)rand();
+
+   /* Every short width and a few long ones, with misaligned input */
+   for (j = 0; j < BENCH_NUM_LEVELS; j++)
+   {
+      if (!bench_set_level(j))
+      {
+         printf("%-5s not supported by this CPU, skipped\n",
+               bench_levels[j].name);
+         continue;
+      }
+
+      for (i = 0; i < BENCH_NUM_CONVS; i++)
+      {
+         int step = bench_convs[i].step;
+         for (w = step; w <= 130 && ok; w += step)
+            ok = bench_verify(i, j, in + 1, out, w, 3);
+         for (w = 958; w <= 962 && ok; w += step)
+            ok = bench_verify(i, j, in + 3, out, w, 2);
+      }
+   }
+
+   if (!ok)
+   {
+      free(in);
+      free(out);
+      return 1;
+   }
+
+   /* Speedups are reported against the baseline build */
+   printf("%dx%d frame, megapixels per second\n%-18s", width, height, "");
+   for (j = 0; j < BENCH_NUM_LEVELS; j++)
+      printf(" %14s", bench_levels[j].name);
+   printf("\n");
+
+   for (i = 0; i < BENCH_NUM_CONVS; i++)
+   {
+      double base = 0.0;
+
+      printf("%-18s", bench_convs[i].name);
+      for (j = 0; j < BENCH_NUM_LEVELS; j++)
+      {
+         double mpps;
+         if (!bench_set_level(j))
+            break;
+         mpps = bench_run(i, in, out, width, height);
+         if (j == 0)
+         {
+            base = mpps;
+            printf(" %14.1f", mpps);
+         }
+         else
+            printf(" %7.1f %5.2fx", mpps, mpps / base);
+      }
+      printf("\n");
+   }
+
+   free(in);
+   free(out);
+   return 0;
+}
@@ -0,0 +1,396 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (bench_scaler.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Checks the bilinear and sinc filter paths of scaler_ctx_scale(),
+ * at every SIMD level this CPU runs and with and without row
+ * bands, against a per-pixel reference, then prints the time per
+ * frame of a few recording-sized scales.
+ *
+ * Usage: bench_scaler */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The kernels and the dispatch state are static, so pull in
+ * the implementation */
+#include "../../gfx/scaler/scaler_int.c"
+#include "../../gfx/scaler/scaler.c"
+
+/* Pads every output row so that overruns show up */
+#define BENCH_SCALER_PAD 64
+#define BENCH_SCALER_THREADS 4
+
+/* Keeps the timed calls from being optimized out */
+static volatile uint8_t bench_scaler_sink;
+
+static int16_t bench_adds(int16_t a, int16_t b)
+{
+   int sum = a + b;
+   if (sum > 32767)
+      return 32767;
+   if (sum < -32768)
+      return -32768;
+   return (int16_t)sum;
+}
+
+static int16_t bench_mulhi(int16_t a, int16_t b)
+{
+   return (int16_t)((a * b) >> 16);
+}
+
+/* Even and odd taps are summed apart, as in the SIMD code */
+static int16_t bench_tap_sum(const int16_t *col, const int16_t *coeff,
+      int len)
+{
+   int i;
+   int16_t sum[2] = {0, 0};
+   for (i = 0; i < len; i++)
+      sum[i & 1] = bench_adds(sum[i & 1], bench_mulhi(col[i], coeff[i]));
+   return bench_adds(sum[1], sum[0]);
+}
+
+/* Scales ARGB8888 with the filters of @ctx */
+static void bench_scaler_ref(const struct scaler_ctx *ctx,
+      uint32_t *output, int out_stride,
+      const uint32_t *input, int in_stride)
+{
+   int x, y, i, c;
+   int16_t col[1024];
+   int16_t *scaled = (int16_t*)malloc(
+         ctx->out_width * ctx->in_height * 4 * sizeof(int16_t));
+
+   for (y = 0; y < ctx->in_height; y++)
+   {
+      const uint32_t *in = input + y * (in_stride >> 2);
+      for (x = 0; x < ctx->out_width; x++)
+      {
+         const uint32_t *taps = in + ctx->horiz.filter_pos[x];
+         for (c = 0; c < 4; c++)
+         {
+            for (i = 0; i < ctx->horiz.filter_len; i++)
+               col[i] = (int16_t)(((taps[i] >> (8 * c)) & 0xff) << 7);
+            scaled[(y * ctx->out_width + x) * 4 + c] = bench_tap_sum(col,
+                  ctx->horiz.filter + x * ctx->horiz.filter_stride,
+                  ctx->horiz.filter_len);
+         }
+      }
+   }
+
+   for (y = 0; y < ctx->out_height; y++)
+   {
+      uint32_t *out = output + y * (out_stride >> 2);
+      for (x = 0; x < ctx->out_width; x++)
+      {
+         uint32_t pix = 0;
+         for (c = 0; c < 4; c++)
+         {
+            int16_t res;
+            for (i = 0; i < ctx->vert.filter_len; i++)
+               col[i] = scaled[((ctx->vert.filter_pos[y] + i)
+                     * ctx->out_width + x) * 4 + c];
+            res  = bench_tap_sum(col,
+                  ctx->vert.filter + y * ctx->vert.filter_stride,
+                  ctx->vert.filter_len) >> (7 - 2 - 2);
+            pix |= (uint32_t)(res < 0 ? 0 : res > 255 ? 255 : res)
+               << (8 * c);
+         }
+         out[x] = pix;
+      }
+   }
+
+   free(scaled);
+}
+
+static bool bench_scaler_init(struct scaler_ctx *ctx,
+      enum scaler_type type, unsigned threads,
+      enum scaler_pix_fmt in_fmt, int in_width, int in_height,
+      enum scaler_pix_fmt out_fmt, int out_width, int out_height,
+      int in_bpp, int out_bpp)
+{
+   memset(ctx, 0, sizeof(*ctx));
+   ctx->scaler_type = type;
+   ctx->threads     = threads;
+   ctx->in_fmt      = in_fmt;
+   ctx->in_width    = in_width;
+   ctx->in_height   = in_height;
+   ctx->in_stride   = in_width * in_bpp + 16;
+   ctx->out_fmt     = out_fmt;
+   ctx->out_width   = out_width;
+   ctx->out_height  = out_height;
+   ctx->out_stride  = out_width * out_bpp + BENCH_SCALER_PAD;
+   return scaler_ctx_gen_filter(ctx);
+}
+
+static void bench_scaler_fill(uint8_t *buf, size_t size)
+{
+   size_t i;
+   for (i = 0; i < size; i++)
+      buf[i] = (uint8_t)rand();
+}
+
+/* Scales ARGB8888 and RGB565 to BGR24 (the recording formats),
+ * and compares both to the reference */
+static int bench_scaler_verify(const char *level, enum scaler_type type,
+      unsigned threads, int in_width, int in_height,
+      int out_width, int out_height)
+{
+   struct scaler_ctx ctx;
+   int y;
+   int ok          = 1;
+   int in_stride   = in_width * 4 + 16;
+   int out_stride  = out_width * 4 + BENCH_SCALER_PAD;
+   uint8_t *input  = (uint8_t*)malloc(in_stride * in_height);
+   uint8_t *argb   = (uint8_t*)malloc(in_stride * in_height);
+   uint8_t *output = (uint8_t*)malloc(out_stride * out_height);
+   uint8_t *ref    = (uint8_t*)malloc(out_stride * out_height);
+   uint8_t *bgr    = (uint8_t*)malloc(out_stride * out_height);
+   const char *name = type == SCALER_TYPE_SINC ? "sinc" : "bilinear";
+
+   bench_scaler_fill(input, in_stride * in_height);
+
+   /* ARGB8888 to ARGB8888 */
+   if (!bench_scaler_init(&ctx, type, threads,
+            SCALER_FMT_ARGB8888, in_width, in_height,
+            SCALER_FMT_ARGB8888, out_width, out_height, 4, 4))
+   {
+      printf("%-6s %-8s %dx%d -> %dx%d: no filter\n", level, name,
+            in_width, in_height, out_width, out_height);
+      ok = 0;
+      goto end;
+   }
+
+   memset(output, 0xa5, out_stride * out_height);
+   memcpy(ref, output, out_stride * out_height);
+   scaler_ctx_scale(&ctx, output, input);
+   bench_scaler_ref(&ctx, (uint32_t*)ref, out_stride,
+         (const uint32_t*)input, in_stride);
+
+   if (memcmp(output, ref, out_stride * out_height))
+   {
+      printf("%-6s %-8s %dx%d -> %dx%d, %u threads: ARGB8888 MISMATCH\n",
+            level, name, in_width, in_height, out_width, out_height,
+            threads);
+      ok = 0;
+   }
+   scaler_ctx_gen_reset(&ctx);
+
+   /* RGB565 to BGR24, against the same conversions done apart */
+   in_stride = in_width * 2 + 16;
+   if (!bench_scaler_init(&ctx, type, threads,
+            SCALER_FMT_RGB565, in_width, in_height,
+            SCALER_FMT_BGR24, out_width, out_height, 2, 3))
+   {
+      ok = 0;
+      goto end;
+   }
+
+   conv_rgb565_argb8888(argb, input, in_width, in_height,
+         in_width * 4, in_stride);
+   memset(ref, 0, out_stride * out_height);
+   bench_scaler_ref(&ctx, (uint32_t*)ref, out_width * 4,
+         (const uint32_t*)argb, in_width * 4);
+   memset(bgr, 0xa5, out_stride * out_height);
+   conv_argb8888_bgr24(bgr, ref, out_width, out_height,
+         ctx.out_stride, out_width * 4);
+
+   memset(output, 0xa5, out_stride * out_height);
+   scaler_ctx_scale(&ctx, output, input);
+
+   for (y = 0; y < out_height; y++)
+   {
+      if (memcmp(output + y * ctx.out_stride, bgr + y * ctx.out_stride,
+               ctx.out_stride))
+      {
+         printf("%-6s %-8s %dx%d -> %dx%d, %u threads: "
+               "RGB565 -> BGR24 MISMATCH at row %d\n",
+               level, name, in_width, in_height, out_width, out_height,
+               threads, y);
+         ok = 0;
+         break;
+      }
+   }
+   scaler_ctx_gen_reset(&ctx);
+
+end:
+   free(input);
+   free(argb);
+   free(output);
+   free(ref);
+   free(bgr);
+   return ok;
+}
+
+static double bench_scaler_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Returns the time per frame in ms */
+static double bench_scaler_run(enum scaler_type type, unsigned threads,
+      enum scaler_pix_fmt out_fmt, int out_bpp,
+      int in_width, int in_height, int out_width, int out_height)
+{
+   struct scaler_ctx ctx;
+   unsigned runs   = 0;
+   double elapsed  = 0.0;
+   double start;
+   uint8_t *input  = (uint8_t*)malloc((in_width * 4 + 16) * in_height);
+   uint8_t *output = (uint8_t*)malloc(
+         (out_width * out_bpp + BENCH_SCALER_PAD) * out_height);
+
+   bench_scaler_fill(input, (in_width * 4 + 16) * in_height);
+   if (!bench_scaler_init(&ctx, type, threads,
+            SCALER_FMT_ARGB8888, in_width, in_height,
+            out_fmt, out_width, out_height, 4, out_bpp))
+   {
+      free(input);
+      free(output);
+      return 0.0;
+   }
+
+   /* Warm up the caches and the workers */
+   scaler_ctx_scale(&ctx, output, input);
+
+   start = bench_scaler_now();
+   do
+   {
+      scaler_ctx_scale(&ctx, output, input);
+      elapsed = bench_scaler_now() - start;
+      runs++;
+   } while (elapsed < 0.5);
+
+   bench_scaler_sink = output[0];
+   scaler_ctx_gen_reset(&ctx);
+   free(input);
+   free(output);
+   return elapsed * 1000.0 / runs;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j, l;
+   int ok = 1;
+   static const int sizes[][4] = {
+      {   37,   23,   61,   45 },
+      {   61,   45,   37,   23 },
+      {  130,   77,   17,    9 },
+      {  320,  240,  957,  541 },
+      { 1920, 1080, 1277,  719 }
+   };
+   static const unsigned threads[] = { 1, 3 };
+   static const enum scaler_type types[] = {
+      SCALER_TYPE_BILINEAR, SCALER_TYPE_SINC
+   };
+   static const struct
+   {
+      const char *name;
+      enum scaler_type type;
+      enum scaler_pix_fmt out_fmt;
+      int out_bpp;
+      int in_width, in_height, out_width, out_height;
+   } runs[] = {
+      { "1440p -> 1080p bilinear BGR24", SCALER_TYPE_BILINEAR,
+         SCALER_FMT_BGR24,    3, 2560, 1440, 1920, 1080 },
+      { "2160p -> 1080p bilinear BGR24", SCALER_TYPE_BILINEAR,
+         SCALER_FMT_BGR24,    3, 3840, 2160, 1920, 1080 },
+      { "1080p -> 720p sinc ARGB8888",   SCALER_TYPE_SINC,
+         SCALER_FMT_ARGB8888, 4, 1920, 1080, 1280,  720 }
+   };
+   struct
+   {
+      const char *name;
+      int flags;
+   } levels[2];
+   unsigned num_levels = 0;
+
+   (void)argc;
+   (void)argv;
+
+#ifdef SCALER_HAVE_X86_SIMD
+   levels[num_levels].name  = "sse2";
+   levels[num_levels].flags = 0;
+   num_levels++;
+   if (scaler_simd_avx2())
+   {
+      levels[num_levels].name  = "avx2";
+      levels[num_levels].flags = SCALER_SIMD_AVX2;
+      num_levels++;
+   }
+   else
+      printf("avx2 not supported by this CPU, skipped\n");
+#else
+   levels[num_levels].name  = "base";
+   levels[num_levels].flags = 0;
+   num_levels++;
+#endif
+
+   srand(1);
+   for (l = 0; l < num_levels; l++)
+   {
+#ifdef SCALER_HAVE_X86_SIMD
+      scaler_simd_flags = levels[l].flags;
+#endif
+      for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+         for (j = 0; j < sizeof(types) / sizeof(types[0]); j++)
+         {
+            unsigned t;
+            for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+               if (!bench_scaler_verify(levels[l].name, types[j],
+                        threads[t], sizes[i][0], sizes[i][1],
+                        sizes[i][2], sizes[i][3]))
+                  ok = 0;
+         }
+   }
+
+   if (!ok)
+      return 1;
+
+   printf("%-32s", "ms per frame");
+   for (l = 0; l < num_levels; l++)
+      printf(" %6s x1 %6s x%u", levels[l].name, levels[l].name,
+            BENCH_SCALER_THREADS);
+   printf("\n");
+
+   for (i = 0; i < sizeof(runs) / sizeof(runs[0]); i++)
+   {
+      printf("%-32s", runs[i].name);
+      for (l = 0; l < num_levels; l++)
+      {
+         unsigned t;
+#ifdef SCALER_HAVE_X86_SIMD
+         scaler_simd_flags = levels[l].flags;
+#endif
+         for (t = 1; t <= BENCH_SCALER_THREADS; t += BENCH_SCALER_THREADS - 1)
+            printf(" %9.3f", bench_scaler_run(runs[i].type, t,
+                     runs[i].out_fmt, runs[i].out_bpp,
+                     runs[i].in_width, runs[i].in_height,
+                     runs[i].out_width, runs[i].out_height));
+      }
+      printf("\n");
+   }
+
+   return 0;
+}
@@ -71,6 +71,28 @@ START_TEST (test_crc32)
 }
 END_TEST
 
+/* Long enough for the wide kernels, and split at odd offsets
+ * so every tail path is taken */
+START_TEST (test_crc32_long)
+{
+   size_t i;
+   uint32_t crc;
+   uint8_t *buf = (uint8_t*)malloc(100003);
+   ck_assert(buf != NULL);
+   for (i = 0; i < 100003; i++)
+      buf[i] = (uint8_t)(i * 31 + 7);
+
+   ck_assert_uint_eq(encoding_crc32(0, buf, 100003), 0x17340963);
+   ck_assert_uint_eq(encoding_crc32(0, buf + 5, 77), 0x398c34f6);
+
+   crc = encoding_crc32(0, buf, 13);
+   crc = encoding_crc32(crc, buf + 13, 4099);
+   crc = encoding_crc32(crc, buf + 4112, 100003 - 4112);
+   ck_assert_uint_eq(crc, 0x17340963);
+   free(buf);
+}
+END_TEST
+
 #define CRC32_BUFFER_SIZE 1048576
 #define CRC32_MAX_MB 64
 
@@ -141,6 +163,7 @@ Suite *create_suite(void)
    TCase *tc_core = tcase_create("Core");
    tcase_add_test(tc_core, test_md5);
    tcase_add_test(tc_core, test_crc32);
+   tcase_add_test(tc_core, test_crc32_long);
    tcase_add_test(tc_core, test_crc32_file);
    suite_add_tcase(s, tc_core);
 
@@ -20,6 +20,10 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <sys/types.h>
 #ifdef _WIN32
 #include <direct.h>
@@ -30,8 +34,21 @@
 #include <sys/stat.h>
 #include <stdlib.h>
 
+#if defined(HAVE_MMAP) || (defined(_WIN32) && !defined(_XBOX))
+#include <fcntl.h>
+#include <memmap.h>
+/* memmap.h emulates mmap() on Windows with a file mapping */
+#if defined(HAVE_MMAN) || defined(_WIN32)
+#define LIBRETRODB_HAVE_MAP
+#endif
+#endif
+
+#include <array/rbuf.h>
+#include <array/rhmap.h>
 #include <streams/file_stream.h>
+#include <file/file_path.h>
 #include <retro_endianness.h>
+#include <retro_inline.h>
 #include <string/stdstring.h>
 #include <compat/strl.h>
 
@@ -44,28 +61,64 @@
 
 #define MAGIC_NUMBER "RARCHDB"
 
+/* Columnar companion format, see libretrodb_columns_create():
+ *
+ *   "RARCHDBC"                   magic
+ *   uint32 version, rows, columns, pool_size
+ *   uint64 source_size           size of the database it came from
+ *   int64  source_mtime          and its modification time
+ *   columns x { uint32 name, uint32 type }
+ *   columns x rows x cell        cells, one column after another
+ *   pool                         NUL terminated strings and
+ *                                uint32 length prefixed binaries
+ *
+ * All integers are little-endian. Integer cells are int64 and hold
+ * the value itself, string and binary cells are a uint32 pool
+ * offset. */
+#define COLUMNS_MAGIC_NUMBER "RARCHDBC"
+#define COLUMNS_VERSION      2
+#define COLUMNS_HEADER_SIZE  40
+#define COLUMNS_CELL_ABSENT  0x80000000U
+#define COLUMNS_INT_ABSENT   ((uint64_t)1 << 63)
+
+#define COLUMNS_CELL_WIDTH(type) \
+   ((type) == LIBRETRODB_COLUMN_INT ? sizeof(uint64_t) : sizeof(uint32_t))
+
 struct node_iter_ctx
 {
    libretrodb_t *db;
    libretrodb_index_t *idx;
 };
 
+struct libretrodb_index
+{
+   char name[50];
+   uint64_t key_size;
+   uint64_t next;
+   uint64_t count;
+};
+
+/* Parsed index header, kept for the lifetime of the handle */
+typedef struct libretrodb_index_desc
+{
+   libretrodb_index_t idx;
+   uint64_t offset; /* file offset of the first key */
+   uint8_t *keys;   /* cached keys when the file is not mapped */
+} libretrodb_index_desc_t;
+
 struct libretrodb
 {
    RFILE *fd;
    char *path;
-   bool can_write;
+   libretrodb_index_desc_t *indices;
+   const uint8_t *map; /* read-only mapping of the file, or NULL */
+   uint64_t map_size;
    uint64_t root;
    uint64_t count;
    uint64_t first_index_offset;
-};
-
-struct libretrodb_index
-{
-   char name[50];
-   uint64_t key_size;
-   uint64_t next;
-   uint64_t count;
+   size_t index_count;
+   bool can_write;
+   bool indices_loaded;
 };
 
 typedef struct libretrodb_metadata
@@ -79,11 +132,20 @@ typedef struct libretrodb_header
    uint64_t metadata_offset;
 } libretrodb_header_t;
 
+/* Filtered cursors read ahead in blocks of this size and match
+ * records against the query before decoding them */
+#define LIBRETRODB_CURSOR_CHUNK 65536
+
 struct libretrodb_cursor
 {
    RFILE *fd;
    libretrodb_query_t *query;
    libretrodb_t *db;
+   uint8_t *raw;       /* read-ahead buffer */
+   int64_t raw_base;   /* file offset of raw[0] */
+   size_t raw_cap;
+   size_t raw_len;
+   size_t raw_pos;
    int is_valid;
    int eof;
 };
@@ -171,12 +233,71 @@ clean:
    return rv;
 }
 
+static void libretrodb_free_indices(libretrodb_t *db)
+{
+   size_t i;
+
+   for (i = 0; i < db->index_count; i++)
+      free(db->indices[i].keys);
+   free(db->indices);
+
+   db->indices        = NULL;
+   db->index_count    = 0;
+   db->indices_loaded = false;
+}
+
+static void libretrodb_unmap(libretrodb_t *db)
+{
+#ifdef LIBRETRODB_HAVE_MAP
+   if (db->map)
+      munmap((void*)db->map, (size_t)db->map_size);
+#endif
+   db->map      = NULL;
+   db->map_size = 0;
+}
+
+/* Maps a read-only database so keyed lookups can binary search
+ * the on-disk index in place. Failure is not an error, lookups
+ * then fall back to a cached copy read through the file stream. */
+static void libretrodb_map(libretrodb_t *db, const char *path)
+{
+#ifdef LIBRETRODB_HAVE_MAP
+   struct stat st;
+   void *map = MAP_FAILED;
+   int fd;
+
+   if (db->map)
+      return;
+
+#ifdef _WIN32
+   if ((fd = open(path, O_RDONLY | O_BINARY)) < 0)
+#else
+   if ((fd = open(path, O_RDONLY)) < 0)
+#endif
+      return;
+
+   if (     fstat(fd, &st) == 0
+         && st.st_size > 0
+         && (uint64_t)st.st_size == (uint64_t)(size_t)st.st_size)
+      map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+
+   if (map == MAP_FAILED)
+      return;
+
+   db->map      = (const uint8_t*)map;
+   db->map_size = (uint64_t)st.st_size;
+#endif
+}
+
 void libretrodb_close(libretrodb_t *db)
 {
    if (db->fd)
       filestream_close(db->fd);
    if (!string_is_empty(db->path))
       free(db->path);
+   libretrodb_free_indices(db);
+   libretrodb_unmap(db);
    db->path = NULL;
    db->fd   = NULL;
 }
@@ -195,6 +316,9 @@ int libretrodb_open(const char *path, libretrodb_t *db, bool write)
    if (!string_is_empty(db->path))
       free(db->path);
 
+   libretrodb_free_indices(db);
+   libretrodb_unmap(db);
+
    db->path  = strdup(path);
    db->root  = filestream_tell(fd);
 
@@ -253,69 +377,156 @@ static int libretrodb_find_index(libretrodb_t *db, const char *index_name,
    return -1;
 }
 
-static int binsearch(const void *buff, const void *item,
+static int binsearch(const uint8_t *buff, const void *item,
       uint64_t count, uint8_t field_size, uint64_t *offset)
 {
-   int mid            = (int)(count / 2);
-   int item_size      = field_size + sizeof(uint64_t);
-   uint8_t *current   = ((uint8_t *)buff + (mid * item_size));
-   int rv             = memcmp(current, item, field_size);
+   size_t item_size = field_size + sizeof(uint64_t);
+   uint64_t lo      = 0;
+   uint64_t hi      = count;
 
-   if (rv == 0)
+   while (lo < hi)
    {
-      *offset         = *(uint64_t *)(current + field_size);
-      return 0;
-   }
+      uint64_t mid           = lo + ((hi - lo) >> 1);
+      const uint8_t *current = buff + mid * item_size;
+      int rv                 = memcmp(current, item, field_size);
 
-   if (count == 0)
-      return -1;
+      if (rv == 0)
+      {
+         /* Keys are packed, so the offset may be unaligned */
+         memcpy(offset, current + field_size, sizeof(uint64_t));
+         return 0;
+      }
 
-   if (rv > 0)
-      return binsearch(buff, item, mid, field_size, offset);
+      if (rv > 0)
+         hi = mid;
+      else
+         lo = mid + 1;
+   }
 
-   return binsearch(current + item_size, item,
-         count - mid, field_size, offset);
+   return -1;
 }
 
-int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
-      const void *key, struct rmsgpack_dom_value *out)
+/* Walks the index headers once and keeps them, so that
+ * lookups no longer have to re-parse them every time */
+static void libretrodb_load_indices(libretrodb_t *db)
 {
    libretrodb_index_t idx;
-   int rv;
-   uint8_t *buff;
-   uint64_t offset;
-   ssize_t bufflen, nread = 0;
 
-   if (libretrodb_find_index(db, index_name, &idx) < 0)
-      return -1;
+   db->indices_loaded = true;
 
-   bufflen        = idx.next;
-   if (!(buff = (uint8_t*)malloc(bufflen)))
-      return -1;
+   /* Only keyed lookups benefit from the mapping, so it is
+    * set up here rather than for every cursor user */
+   if (!db->can_write && db->path)
+      libretrodb_map(db, db->path);
+
+   filestream_seek(db->fd,
+                   (ssize_t)db->first_index_offset,
+                   RETRO_VFS_SEEK_POSITION_START);
 
-   while (nread < bufflen)
+   while (!filestream_eof(db->fd))
    {
-      void *buff_ = (buff + nread);
-      rv          = (int)filestream_read(db->fd, buff_, bufflen - nread);
+      libretrodb_index_desc_t *desc = NULL;
+      uint64_t name_len             = 50;
+
+      if (rmsgpack_dom_read_into(db->fd,
+            "name",     idx.name, &name_len,
+            "key_size", &idx.key_size,
+            "next",     &idx.next,
+            "count",    &idx.count,
+                                 NULL) < 0)
+         break;
+
+      if (!(desc = (libretrodb_index_desc_t*)realloc(db->indices,
+            (db->index_count + 1) * sizeof(*desc))))
+         break;
+
+      db->indices                  = desc;
+      desc                         = &db->indices[db->index_count++];
+      desc->idx                    = idx;
+      desc->offset                 = filestream_tell(db->fd);
+      desc->keys                   = NULL;
+
+      filestream_seek(db->fd, (ssize_t)idx.next,
+            RETRO_VFS_SEEK_POSITION_CURRENT);
+   }
+}
+
+static const uint8_t *libretrodb_get_index_keys(libretrodb_t *db,
+      const char *index_name, libretrodb_index_t *idx)
+{
+   size_t i;
+   libretrodb_index_desc_t *desc = NULL;
 
-      if (rv <= 0)
+   if (!db->indices_loaded)
+      libretrodb_load_indices(db);
+
+   for (i = 0; i < db->index_count; i++)
+   {
+      const char *name = db->indices[i].idx.name;
+      if (strncmp(index_name, name, strlen(name)) == 0)
       {
-         free(buff);
-         return -1;
+         desc = &db->indices[i];
+         break;
       }
-      nread += rv;
    }
 
-   rv = binsearch(buff, key, idx.count, (ssize_t)idx.key_size, &offset);
-   free(buff);
+   if (!desc)
+      return NULL;
 
-   if (rv == 0) {
-      filestream_seek(db->fd, (ssize_t)offset, RETRO_VFS_SEEK_POSITION_START);
-      rmsgpack_dom_read(db->fd, out);
-      return 0;
-   } else {
-     return -1;
+   *idx = desc->idx;
+
+   if (     desc->idx.count
+         && desc->idx.next / desc->idx.count
+         != desc->idx.key_size + sizeof(uint64_t))
+      return NULL;
+
+   if (db->map && desc->offset + desc->idx.next <= db->map_size)
+      return db->map + desc->offset;
+
+   if (!desc->keys)
+   {
+      int64_t nread = 0;
+      int64_t len   = (int64_t)desc->idx.next;
+
+      if (!(desc->keys = (uint8_t*)malloc((size_t)len + 1)))
+         return NULL;
+
+      filestream_seek(db->fd, (ssize_t)desc->offset,
+            RETRO_VFS_SEEK_POSITION_START);
+
+      while (nread < len)
+      {
+         int64_t rv = filestream_read(db->fd,
+               desc->keys + nread, len - nread);
+
+         if (rv <= 0)
+         {
+            free(desc->keys);
+            desc->keys = NULL;
+            return NULL;
+         }
+         nread += rv;
+      }
    }
+
+   return desc->keys;
+}
+
+int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
+      const void *key, struct rmsgpack_dom_value *out)
+{
+   libretrodb_index_t idx;
+   uint64_t offset;
+   const uint8_t *keys = libretrodb_get_index_keys(db, index_name, &idx);
+
+   if (!keys)
+      return -1;
+
+   if (binsearch(keys, key, idx.count, (uint8_t)idx.key_size, &offset) != 0)
+      return -1;
+
+   filestream_seek(db->fd, (ssize_t)offset, RETRO_VFS_SEEK_POSITION_START);
+   return (rmsgpack_dom_read(db->fd, out) < 0) ? -1 : 0;
 }
 
 /**
@@ -328,12 +539,68 @@ int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
  **/
 int libretrodb_cursor_reset(libretrodb_cursor_t *cursor)
 {
-   cursor->eof = 0;
+   cursor->eof      = 0;
+   cursor->raw_len  = 0;
+   cursor->raw_pos  = 0;
+   cursor->raw_base = cursor->db->root + sizeof(libretrodb_header_t);
    return (int)filestream_seek(cursor->fd,
-         (ssize_t)(cursor->db->root + sizeof(libretrodb_header_t)),
+         (ssize_t)cursor->raw_base,
          RETRO_VFS_SEEK_POSITION_START);
 }
 
+/* Returns the size of the next complete record in the read-ahead
+ * buffer, refilling (and if need be growing) it from the file,
+ * or -1 if the file holds no valid record at that point. */
+static int64_t libretrodb_cursor_next_raw(libretrodb_cursor_t *cursor,
+      const uint8_t **data)
+{
+   for (;;)
+   {
+      int64_t read_len;
+      size_t avail = cursor->raw_len - cursor->raw_pos;
+
+      if (avail)
+      {
+         int64_t size = rmsgpack_raw_size(
+               cursor->raw + cursor->raw_pos, avail);
+         if (size < 0)
+            return -1;
+         if (size > 0)
+         {
+            *data            = cursor->raw + cursor->raw_pos;
+            cursor->raw_pos += (size_t)size;
+            return size;
+         }
+      }
+
+      /* Keep the partial record and read the rest behind it */
+      if (cursor->raw_pos)
+      {
+         memmove(cursor->raw, cursor->raw + cursor->raw_pos, avail);
+         cursor->raw_base += cursor->raw_pos;
+         cursor->raw_len   = avail;
+         cursor->raw_pos   = 0;
+      }
+
+      if (cursor->raw_len == cursor->raw_cap)
+      {
+         size_t cap   = cursor->raw_cap
+            ? cursor->raw_cap * 2 : LIBRETRODB_CURSOR_CHUNK;
+         uint8_t *raw = (uint8_t*)realloc(cursor->raw, cap);
+         if (!raw)
+            return -1;
+         cursor->raw     = raw;
+         cursor->raw_cap = cap;
+      }
+
+      if ((read_len = filestream_read(cursor->fd,
+                  cursor->raw + cursor->raw_len,
+                  cursor->raw_cap - cursor->raw_len)) <= 0)
+         return -1;
+      cursor->raw_len += (size_t)read_len;
+   }
+}
+
 int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
       struct rmsgpack_dom_value *out)
 {
@@ -343,9 +610,55 @@ int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
       return EOF;
 
 retry:
+   if (cursor->query)
+   {
+      /* Reject records straight from the read-ahead buffer,
+       * only decoding the ones that match */
+      const uint8_t *data = NULL;
+      int64_t offset      = cursor->raw_base + (int64_t)cursor->raw_pos;
+      int64_t size        = libretrodb_cursor_next_raw(cursor, &data);
+
+      if (size > 0)
+      {
+         struct rmsgpack_raw_value head;
+         int match;
+
+         rmsgpack_raw_parse(data, (size_t)size, &head);
+         if (head.type == RDT_NULL)
+         {
+            cursor->eof = 1;
+            return EOF;
+         }
+
+         if ((match = libretrodb_query_filter_raw(
+                     cursor->query, data, (size_t)size)) == 0)
+            goto retry;
+
+         if (rmsgpack_dom_read_raw(data, (size_t)size, out) < 0)
+            return -1;
+
+         if (match > 0 || libretrodb_query_filter(cursor->query, out))
+            return 0;
+
+         rmsgpack_dom_value_free(out);
+         goto retry;
+      }
+
+      /* Not something the raw reader understands; decode it
+       * from the file and resume buffering after it */
+      cursor->raw_len = 0;
+      cursor->raw_pos = 0;
+      if (filestream_seek(cursor->fd, offset,
+               RETRO_VFS_SEEK_POSITION_START) < 0)
+         return -1;
+   }
+
    if ((rv = rmsgpack_dom_read(cursor->fd, out)) < 0)
       return rv;
 
+   if (cursor->query)
+      cursor->raw_base = filestream_tell(cursor->fd);
+
    if (out->type == RDT_NULL)
    {
       cursor->eof = 1;
@@ -364,6 +677,34 @@ retry:
    return 0;
 }
 
+int64_t libretrodb_cursor_tell(libretrodb_cursor_t *cursor)
+{
+   if (!cursor || !cursor->fd || cursor->eof)
+      return -1;
+   if (cursor->raw_len)
+      return cursor->raw_base + (int64_t)cursor->raw_pos;
+   return filestream_tell(cursor->fd);
+}
+
+int libretrodb_read_item_at(libretrodb_t *db, uint64_t offset,
+      struct rmsgpack_dom_value *out)
+{
+   if (!db || !db->fd)
+      return -1;
+
+   if (filestream_seek(db->fd, (int64_t)offset,
+            RETRO_VFS_SEEK_POSITION_START) < 0)
+      return -1;
+
+   if (rmsgpack_dom_read(db->fd, out) < 0)
+      return -1;
+
+   if (out->type == RDT_NULL)
+      return -1;
+
+   return 0;
+}
+
 /**
  * libretrodb_cursor_close:
  * @cursor              : Handle to database cursor.
@@ -381,11 +722,15 @@ void libretrodb_cursor_close(libretrodb_cursor_t *cursor)
    if (cursor->query)
       libretrodb_query_free(cursor->query);
 
+   free(cursor->raw);
+
    cursor->is_valid = 0;
    cursor->eof      = 1;
    cursor->fd       = NULL;
    cursor->db       = NULL;
    cursor->query    = NULL;
+   cursor->raw      = NULL;
+   cursor->raw_cap  = 0;
 }
 
 /**
@@ -414,6 +759,8 @@ int libretrodb_cursor_open(libretrodb_t *db,
    cursor->fd       = fd;
    cursor->db       = db;
    cursor->is_valid = 1;
+   cursor->raw      = NULL;
+   cursor->raw_cap  = 0;
    libretrodb_cursor_reset(cursor);
    cursor->query    = q;
 
@@ -451,7 +798,7 @@ int libretrodb_create_index(libretrodb_t *db,
    void *buff                       = NULL;
    uint64_t *buff_u64               = NULL;
    uint8_t field_size               = 0;
-   uint64_t item_loc                = filestream_tell(db->fd);
+   uint64_t item_loc                = 0;
    bintree_t *tree;
    uint64_t item_count              = 0;
    int rval                         = -1;
@@ -468,6 +815,10 @@ int libretrodb_create_index(libretrodb_t *db,
    if (!tree || (libretrodb_cursor_open(db, &cur, NULL) != 0))
       goto clean;
 
+   /* The first item starts where the cursor does, not
+    * wherever the database handle was last left */
+   item_loc                         = filestream_tell(cur.fd);
+
    key.type                         = RDT_STRING;
    key.val.string.len               = (uint32_t)strlen(field_name);
    key.val.string.buff              = (char *)field_name;   /* We know we aren't going to change it */
@@ -520,6 +871,9 @@ int libretrodb_create_index(libretrodb_t *db,
 
    filestream_seek(db->fd, 0, RETRO_VFS_SEEK_POSITION_END);
 
+   /* A new index invalidates the cached descriptors */
+   libretrodb_free_indices(db);
+
    strlcpy(idx.name, name, sizeof(idx.name));
 
    idx.key_size = field_size;
@@ -566,6 +920,10 @@ libretrodb_cursor_t *libretrodb_cursor_new(void)
    dbc->eof                 = 0;
    dbc->query               = NULL;
    dbc->db                  = NULL;
+   dbc->raw                 = NULL;
+   dbc->raw_cap             = 0;
+   dbc->raw_len             = 0;
+   dbc->raw_pos             = 0;
 
    return dbc;
 }
@@ -588,6 +946,12 @@ libretrodb_t *libretrodb_new(void)
    db->count              = 0;
    db->first_index_offset = 0;
    db->path               = NULL;
+   db->indices            = NULL;
+   db->index_count        = 0;
+   db->indices_loaded     = false;
+   db->map                = NULL;
+   db->map_size           = 0;
+   db->can_write          = false;
 
    return db;
 }
@@ -597,3 +961,429 @@ void libretrodb_free(libretrodb_t *db)
    if (db)
       free(db);
 }
+
+typedef struct libretrodb_column_builder
+{
+   uint64_t *cells; /* RBUF */
+   uint32_t name;
+   uint32_t type;
+} libretrodb_column_builder_t;
+
+/* The rbuf/rhmap macros index their argument unparenthesized,
+ * so these work on local copies of the caller's pointers */
+static uint32_t libretrodb_columns_pool_string(uint8_t **pool_ptr,
+      uint32_t **strings_ptr, const char *str, size_t len)
+{
+   uint8_t *pool     = *pool_ptr;
+   uint32_t *strings = *strings_ptr;
+   uint32_t offset   = RHMAP_GET_STR(strings, str);
+
+   if (!offset)
+   {
+      offset = (uint32_t)RBUF_LEN(pool);
+      RBUF_RESIZE(pool, offset + len + 1);
+      memcpy(pool + offset, str, len);
+      pool[offset + len] = '\0';
+      RHMAP_SET_STR(strings, str, offset + 1);
+      offset++;
+   }
+
+   *pool_ptr    = pool;
+   *strings_ptr = strings;
+   return offset - 1;
+}
+
+static uint32_t libretrodb_columns_pool_binary(uint8_t **pool_ptr,
+      const char *buff, uint32_t len)
+{
+   uint8_t *pool   = *pool_ptr;
+   uint32_t offset = (uint32_t)RBUF_LEN(pool);
+
+   RBUF_RESIZE(pool, offset + sizeof(uint32_t) + len);
+   retro_set_unaligned_32le(pool + offset, len);
+   if (len)
+      memcpy(pool + offset + sizeof(uint32_t), buff, len);
+
+   *pool_ptr = pool;
+   return offset;
+}
+
+int libretrodb_columns_create(libretrodb_t *db, const char *path)
+{
+   size_t i;
+   uint8_t header[COLUMNS_HEADER_SIZE];
+   struct rmsgpack_dom_value item;
+   libretrodb_cursor_t cur                = {0};
+   libretrodb_column_builder_t *columns   = NULL;
+   uint32_t *column_map                   = NULL;
+   uint32_t *strings                      = NULL;
+   uint8_t *pool                          = NULL;
+   uint8_t *out                           = NULL;
+   RFILE *fd                              = NULL;
+   int64_t source_size                    = 0;
+   int64_t source_mtime                   = 0;
+   uint32_t rows                          = 0;
+   int rval                               = -1;
+
+   item.type                              = RDT_NULL;
+
+   if (libretrodb_cursor_open(db, &cur, NULL) != 0)
+      return -1;
+
+   while (libretrodb_cursor_read_item(&cur, &item) == 0)
+   {
+      if (item.type == RDT_MAP)
+      {
+         for (i = 0; i < item.val.map.len; i++)
+         {
+            uint64_t cell;
+            uint32_t type, col;
+            const struct rmsgpack_dom_value *key = &item.val.map.items[i].key;
+            const struct rmsgpack_dom_value *val = &item.val.map.items[i].value;
+
+            if (key->type != RDT_STRING || !key->val.string.buff)
+               continue;
+
+            switch (val->type)
+            {
+               case RDT_BOOL:
+               case RDT_UINT:
+               case RDT_INT:
+                  type = LIBRETRODB_COLUMN_INT;
+                  break;
+               case RDT_STRING:
+                  type = LIBRETRODB_COLUMN_STRING;
+                  break;
+               case RDT_BINARY:
+                  type = LIBRETRODB_COLUMN_BINARY;
+                  break;
+               default:
+                  continue;
+            }
+
+            if (!(col = RHMAP_GET_STR(column_map, key->val.string.buff)))
+            {
+               libretrodb_column_builder_t column;
+               size_t j;
+
+               column.cells = NULL;
+               column.type  = type;
+               column.name  = libretrodb_columns_pool_string(&pool,
+                     &strings, key->val.string.buff,
+                     strlen(key->val.string.buff));
+               RBUF_RESIZE(column.cells, rows);
+               for (j = 0; j < rows; j++)
+                  column.cells[j] = (type == LIBRETRODB_COLUMN_INT)
+                     ? COLUMNS_INT_ABSENT : COLUMNS_CELL_ABSENT;
+               RBUF_PUSH(columns, column);
+               col = (uint32_t)RBUF_LEN(columns);
+               RHMAP_SET_STR(column_map, key->val.string.buff, col);
+            }
+
+            /* A column keeps the type it was first seen with */
+            if (columns[col - 1].type != type)
+               continue;
+
+            switch (type)
+            {
+               case LIBRETRODB_COLUMN_INT:
+                  if (val->type == RDT_BOOL)
+                     cell = val->val.bool_ ? 1 : 0;
+                  else
+                     cell = val->val.uint_;
+                  /* Keep the one value that doubles as 'absent' */
+                  if (cell == COLUMNS_INT_ABSENT)
+                     cell++;
+                  break;
+               case LIBRETRODB_COLUMN_STRING:
+                  cell = libretrodb_columns_pool_string(&pool, &strings,
+                        val->val.string.buff ? val->val.string.buff : "",
+                        val->val.string.buff
+                        ? strlen(val->val.string.buff) : 0);
+                  break;
+               default:
+                  cell = libretrodb_columns_pool_binary(&pool,
+                        val->val.binary.buff, val->val.binary.len);
+                  break;
+            }
+
+            RBUF_RESIZE(columns[col - 1].cells, rows + 1);
+            columns[col - 1].cells[rows] = cell;
+         }
+      }
+
+      rmsgpack_dom_value_free(&item);
+      item.type = RDT_NULL;
+
+      /* Absent fields stay absent in columns that the
+       * record did not touch */
+      rows++;
+      for (i = 0; i < RBUF_LEN(columns); i++)
+      {
+         size_t len = RBUF_LEN(columns[i].cells);
+         if (len < rows)
+         {
+            RBUF_RESIZE(columns[i].cells, rows);
+            columns[i].cells[len] = (columns[i].type == LIBRETRODB_COLUMN_INT)
+               ? COLUMNS_INT_ABSENT : COLUMNS_CELL_ABSENT;
+         }
+      }
+
+      if (RBUF_LEN(pool) >= COLUMNS_CELL_ABSENT)
+         goto clean;
+   }
+
+   /* Terminates the pool so any in-range string offset is safe */
+   RBUF_PUSH(pool, 0);
+
+   if (!(fd = filestream_open(path, RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      goto clean;
+
+   memcpy(header, COLUMNS_MAGIC_NUMBER, 8);
+   retro_set_unaligned_32le(header + 8,  COLUMNS_VERSION);
+   retro_set_unaligned_32le(header + 12, rows);
+   retro_set_unaligned_32le(header + 16, (uint32_t)RBUF_LEN(columns));
+   retro_set_unaligned_32le(header + 20, (uint32_t)RBUF_LEN(pool));
+   /* Lets readers tell a companion left behind by an update */
+   source_mtime = path_get_mtime(db->path, &source_size);
+   retro_set_unaligned_64le(header + 24, (uint64_t)source_size);
+   retro_set_unaligned_64le(header + 32, (uint64_t)source_mtime);
+
+   if (filestream_write(fd, header, sizeof(header)) != sizeof(header))
+      goto clean;
+
+   for (i = 0; i < RBUF_LEN(columns); i++)
+   {
+      uint8_t desc[8];
+      retro_set_unaligned_32le(desc,     columns[i].name);
+      retro_set_unaligned_32le(desc + 4, columns[i].type);
+      if (filestream_write(fd, desc, sizeof(desc)) != sizeof(desc))
+         goto clean;
+   }
+
+   RBUF_RESIZE(out, (size_t)rows * sizeof(uint64_t));
+
+   for (i = 0; i < RBUF_LEN(columns); i++)
+   {
+      size_t j;
+      uint64_t *cells = columns[i].cells;
+      size_t width    = COLUMNS_CELL_WIDTH(columns[i].type);
+
+      for (j = 0; j < rows; j++)
+      {
+         if (width == sizeof(uint64_t))
+            retro_set_unaligned_64le(out + j * width, cells[j]);
+         else
+            retro_set_unaligned_32le(out + j * width, (uint32_t)cells[j]);
+      }
+
+      if (rows && filestream_write(fd, out, rows * width)
+            != (int64_t)(rows * width))
+         goto clean;
+   }
+
+   if (filestream_write(fd, pool, RBUF_LEN(pool))
+         != (int64_t)RBUF_LEN(pool))
+      goto clean;
+
+   rval = 0;
+
+clean:
+   rmsgpack_dom_value_free(&item);
+   if (fd)
+      filestream_close(fd);
+   libretrodb_cursor_close(&cur);
+   for (i = 0; i < RBUF_LEN(columns); i++)
+      RBUF_FREE(columns[i].cells);
+   RBUF_FREE(columns);
+   RHMAP_FREE(column_map);
+   RHMAP_FREE(strings);
+   RBUF_FREE(pool);
+   RBUF_FREE(out);
+   return rval;
+}
+
+struct libretrodb_columns
+{
+   uint8_t *data;
+   uint8_t *dir;
+   uint8_t *pool;
+   size_t *cells;        /* offset of each column's cells in data */
+   uint64_t source_size;
+   int64_t source_mtime;
+   uint32_t rows;
+   uint32_t columns;
+   uint32_t pool_size;
+};
+
+libretrodb_columns_t *libretrodb_columns_open(const char *path)
+{
+   uint32_t i;
+   uint64_t expected;
+   void *buf                  = NULL;
+   int64_t len                = 0;
+   libretrodb_columns_t *cols = NULL;
+
+   if (!filestream_read_file(path, &buf, &len))
+      return NULL;
+
+   if (     len < COLUMNS_HEADER_SIZE
+         || memcmp(buf, COLUMNS_MAGIC_NUMBER, 8) != 0
+         || retro_get_unaligned_32le((uint8_t*)buf + 8) != COLUMNS_VERSION)
+      goto error;
+
+   if (!(cols = (libretrodb_columns_t*)calloc(1, sizeof(*cols))))
+      goto error;
+
+   cols->data         = (uint8_t*)buf;
+   cols->rows         = retro_get_unaligned_32le(cols->data + 12);
+   cols->columns      = retro_get_unaligned_32le(cols->data + 16);
+   cols->pool_size    = retro_get_unaligned_32le(cols->data + 20);
+   cols->source_size  = retro_get_unaligned_64le(cols->data + 24);
+   cols->source_mtime = (int64_t)retro_get_unaligned_64le(cols->data + 32);
+   cols->dir          = cols->data + COLUMNS_HEADER_SIZE;
+   expected           = COLUMNS_HEADER_SIZE + (uint64_t)cols->columns * 8;
+
+   if (     expected > (uint64_t)len
+         || !(cols->cells = (size_t*)malloc(
+               (cols->columns + 1) * sizeof(size_t))))
+      goto error;
+
+   for (i = 0; i < cols->columns; i++)
+   {
+      uint32_t type     = retro_get_unaligned_32le(cols->dir + i * 8 + 4);
+      cols->cells[i]    = (size_t)expected;
+      expected         += (uint64_t)cols->rows * COLUMNS_CELL_WIDTH(type);
+      if (expected > (uint64_t)len)
+         goto error;
+   }
+
+   if (     expected + cols->pool_size != (uint64_t)len
+         || !cols->pool_size
+         || cols->data[len - 1] != '\0')
+      goto error;
+
+   cols->pool         = cols->data + (size_t)expected;
+
+   return cols;
+
+error:
+   if (cols)
+      free(cols->cells);
+   free(cols);
+   free(buf);
+   return NULL;
+}
+
+void libretrodb_columns_free(libretrodb_columns_t *cols)
+{
+   if (!cols)
+      return;
+   free(cols->cells);
+   free(cols->data);
+   free(cols);
+}
+
+uint32_t libretrodb_columns_rows(const libretrodb_columns_t *cols)
+{
+   return cols->rows;
+}
+
+bool libretrodb_columns_is_current(const libretrodb_columns_t *cols,
+      const char *path)
+{
+   int64_t size  = 0;
+   int64_t mtime = path_get_mtime(path, &size);
+
+   return      (uint64_t)size == cols->source_size
+            && mtime          == cols->source_mtime;
+}
+
+int libretrodb_columns_find(const libretrodb_columns_t *cols,
+      const char *name, enum libretrodb_column_type type)
+{
+   uint32_t i;
+
+   for (i = 0; i < cols->columns; i++)
+   {
+      uint32_t name_offset = retro_get_unaligned_32le(cols->dir + i * 8);
+
+      if (     name_offset < cols->pool_size
+            && retro_get_unaligned_32le(cols->dir + i * 8 + 4) == (uint32_t)type
+            && string_is_equal((const char*)cols->pool + name_offset, name))
+         return (int)i;
+   }
+
+   return -1;
+}
+
+/* Returns the address of a cell, or NULL if the column
+ * does not exist or does not have the expected type */
+static INLINE uint8_t *libretrodb_columns_cell(
+      const libretrodb_columns_t *cols, int col, uint32_t row,
+      enum libretrodb_column_type type)
+{
+   if (     col < 0
+         || (uint32_t)col >= cols->columns
+         || row >= cols->rows
+         || retro_get_unaligned_32le(cols->dir + col * 8 + 4)
+            != (uint32_t)type)
+      return NULL;
+   return cols->data + cols->cells[col]
+      + (size_t)row * COLUMNS_CELL_WIDTH(type);
+}
+
+/* String and binary cells, a pool offset */
+static INLINE uint32_t libretrodb_columns_offset(
+      const libretrodb_columns_t *cols, int col, uint32_t row,
+      enum libretrodb_column_type type)
+{
+   uint8_t *cell = libretrodb_columns_cell(cols, col, row, type);
+   if (!cell)
+      return COLUMNS_CELL_ABSENT;
+   return retro_get_unaligned_32le(cell);
+}
+
+bool libretrodb_columns_get_int(const libretrodb_columns_t *cols,
+      int col, uint32_t row, int64_t *out)
+{
+   uint64_t value;
+   uint8_t *cell = libretrodb_columns_cell(cols, col, row,
+         LIBRETRODB_COLUMN_INT);
+
+   if (!cell || (value = retro_get_unaligned_64le(cell)) == COLUMNS_INT_ABSENT)
+      return false;
+   *out = (int64_t)value;
+   return true;
+}
+
+const char *libretrodb_columns_get_string(const libretrodb_columns_t *cols,
+      int col, uint32_t row)
+{
+   uint32_t cell = libretrodb_columns_offset(cols, col, row,
+         LIBRETRODB_COLUMN_STRING);
+
+   if (cell >= cols->pool_size)
+      return NULL;
+   return (const char*)cols->pool + cell;
+}
+
+const uint8_t *libretrodb_columns_get_binary(const libretrodb_columns_t *cols,
+      int col, uint32_t row, uint32_t *len)
+{
+   uint32_t size;
+   uint32_t cell = libretrodb_columns_offset(cols, col, row,
+         LIBRETRODB_COLUMN_BINARY);
+
+   if (     cell >= cols->pool_size
+         || cols->pool_size - cell < sizeof(uint32_t))
+      return NULL;
+
+   size = retro_get_unaligned_32le(cols->pool + cell);
+   if (cols->pool_size - cell - sizeof(uint32_t) < size)
+      return NULL;
+
+   *len = size;
+   return cols->pool + cell + sizeof(uint32_t);
+}
@@ -37,6 +37,8 @@
 
 RETRO_BEGIN_DECLS
 
+#define LIBRETRODB_COLUMNS_EXTENSION ".rdbc"
+
 typedef struct libretrodb libretrodb_t;
 
 typedef struct libretrodb_cursor libretrodb_cursor_t;
@@ -105,6 +107,97 @@ void libretrodb_query_free(void *q);
 int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
       struct rmsgpack_dom_value *out);
 
+/**
+ * libretrodb_cursor_tell:
+ * @cursor              : Handle to database cursor.
+ *
+ * Only meaningful for cursors opened without a query,
+ * since a filtering cursor skips over items while reading.
+ *
+ * Returns: file offset of the next item read by @cursor,
+ * otherwise negative.
+ **/
+int64_t libretrodb_cursor_tell(libretrodb_cursor_t *cursor);
+
+/**
+ * libretrodb_read_item_at:
+ * @db                  : Handle to database.
+ * @offset              : File offset of the item, as returned
+ *                        by libretrodb_cursor_tell().
+ * @out                 : Item read from the database.
+ *
+ * Reads a single item without scanning the database.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int libretrodb_read_item_at(libretrodb_t *db, uint64_t offset,
+      struct rmsgpack_dom_value *out);
+
+typedef struct libretrodb_columns libretrodb_columns_t;
+
+enum libretrodb_column_type
+{
+   LIBRETRODB_COLUMN_INT = 1,
+   LIBRETRODB_COLUMN_STRING,
+   LIBRETRODB_COLUMN_BINARY
+};
+
+/**
+ * libretrodb_columns_create:
+ * @db                  : Handle to database.
+ * @path                : Output path, by convention the database
+ *                        path with LIBRETRODB_COLUMNS_EXTENSION.
+ *
+ * Compiles @db into the columnar companion format: every field
+ * becomes a packed column of fixed size cells, with strings and
+ * binaries stored once in a shared pool. Bulk readers can then
+ * walk just the columns they need without decoding records.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int libretrodb_columns_create(libretrodb_t *db, const char *path);
+
+/**
+ * libretrodb_columns_open:
+ * @path                : Path to a file made by libretrodb_columns_create().
+ *
+ * Loads the whole file with a single read.
+ *
+ * Returns: handle, or NULL if the file is missing or invalid.
+ **/
+libretrodb_columns_t *libretrodb_columns_open(const char *path);
+
+void libretrodb_columns_free(libretrodb_columns_t *cols);
+
+uint32_t libretrodb_columns_rows(const libretrodb_columns_t *cols);
+
+/* Whether @cols was compiled from the database at @path as it
+ * is now. A companion left behind by an update differs in the
+ * database size or modification time. */
+bool libretrodb_columns_is_current(const libretrodb_columns_t *cols,
+      const char *path);
+
+/**
+ * libretrodb_columns_find:
+ * @cols                : Columns handle.
+ * @name                : Field name.
+ * @type                : Expected column type.
+ *
+ * Returns: column number, or -1 if there is no such column.
+ * Passing -1 to the getters below yields absent values.
+ **/
+int libretrodb_columns_find(const libretrodb_columns_t *cols,
+      const char *name, enum libretrodb_column_type type);
+
+bool libretrodb_columns_get_int(const libretrodb_columns_t *cols,
+      int col, uint32_t row, int64_t *out);
+
+const char *libretrodb_columns_get_string(const libretrodb_columns_t *cols,
+      int col, uint32_t row);
+
+const uint8_t *libretrodb_columns_get_binary(const libretrodb_columns_t *cols,
+      int col, uint32_t row, uint32_t *len);
+
 RETRO_END_DECLS
 
 #endif
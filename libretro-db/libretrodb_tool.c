@@ -24,6 +24,9 @@
 #include <string.h>
 
 #include <string/stdstring.h>
+#include <compat/strl.h>
+#include <file/file_path.h>
+#include <retro_miscellaneous.h>
 
 #include "libretrodb.h"
 #include "rmsgpack_dom.h"
@@ -46,6 +49,7 @@ int main(int argc, char ** argv)
       printf("Available Commands:\n");
       printf("\tlist\n");
       printf("\tcreate-index <index name> <field name>\n");
+      printf("\tcompile-columns [output file]\n");
       printf("\tfind <query expression>\n");
       printf("\tget-names <query expression>\n");
       return 1;
@@ -174,6 +178,28 @@ int main(int argc, char ** argv)
 
       libretrodb_create_index(db, index_name, field_name);
    }
+   else if (memcmp(command, "compile-columns", 15) == 0)
+   {
+      char columns_path[PATH_MAX_LENGTH];
+
+      if (argc != 3 && argc != 4)
+      {
+         printf("Usage: %s <db file> compile-columns [output file]\n", argv[0]);
+         goto error;
+      }
+
+      if (argc == 4)
+         strlcpy(columns_path, argv[3], sizeof(columns_path));
+      else
+         fill_pathname(columns_path, path,
+               LIBRETRODB_COLUMNS_EXTENSION, sizeof(columns_path));
+
+      if (libretrodb_columns_create(db, columns_path) != 0)
+      {
+         printf("Could not write columns to '%s'\n", columns_path);
+         goto error;
+      }
+   }
    else
    {
       printf("Unknown command %s\n", argv[2]);
@@ -30,6 +30,7 @@
 #include <ctype.h>
 #include <string.h>
 
+#include <boolean.h>
 #include <compat/fnmatch.h>
 #include <compat/strl.h>
 #include <string/stdstring.h>
@@ -37,6 +38,7 @@
 
 #include "libretrodb.h"
 #include "query.h"
+#include "rmsgpack.h"
 #include "rmsgpack_dom.h"
 
 #define MAX_ERROR_LEN   256
@@ -80,9 +82,38 @@ struct argument
    enum argument_type type;
 };
 
+/* The parsed invocation tree is flattened into a pre-order
+ * array of ops, which is what libretrodb_query_filter_raw
+ * evaluates against undecoded records.  Every op records the
+ * size of its subtree, so the children of an op start right
+ * after it and a sibling is one 'size' away. */
+enum query_op_type
+{
+   QOP_FALSE = 0,
+   QOP_NOT_MAP,
+   QOP_IS_TRUE,
+   QOP_EQUALS,  /* value */
+   QOP_OR,
+   QOP_AND,
+   QOP_BETWEEN, /* value .. value2 */
+   QOP_GLOB,    /* value */
+   QOP_ALL_MAP, /* argc QOP_FIELD ops */
+   QOP_FIELD    /* value = key, followed by its predicate */
+};
+
+struct query_op
+{
+   const struct rmsgpack_dom_value *value;  /* ptr alignment */
+   const struct rmsgpack_dom_value *value2; /* ptr alignment */
+   unsigned size;
+   unsigned argc;
+   enum query_op_type type;
+};
+
 struct query
 {
    struct invocation root; /* ptr alignment */
+   struct query_op *ops;   /* ptr alignment */
    unsigned ref_count;
 };
 
@@ -911,11 +942,145 @@ void libretrodb_query_free(void *q)
       query_argument_free(&real_q->root.argv[i]);
 
    free(real_q->root.argv);
+   free(real_q->ops);
    real_q->root.argv = NULL;
    real_q->root.argc = 0;
+   real_q->ops       = NULL;
    free(real_q);
 }
 
+static int query_ops_emit_invocation(const struct invocation *inv,
+      struct query_op *ops, unsigned *n);
+
+static int query_ops_emit_argument(const struct argument *arg,
+      struct query_op *ops, unsigned *n)
+{
+   if (arg->type == AT_FUNCTION)
+      return query_ops_emit_invocation(&arg->a.invocation, ops, n);
+
+   /* Bare values in predicate position are equality tests */
+   if (ops)
+   {
+      struct query_op *op = &ops[*n];
+      op->type            = QOP_EQUALS;
+      op->value           = &arg->a.value;
+      op->value2          = NULL;
+      op->size            = 1;
+      op->argc            = 0;
+   }
+   (*n)++;
+   return 0;
+}
+
+/* Emits the ops for 'inv' at ops[*n], or only counts them when
+ * 'ops' is NULL.  The degenerate argument lists the tree
+ * evaluators reject up front become QOP_FALSE/QOP_NOT_MAP. */
+static int query_ops_emit_invocation(const struct invocation *inv,
+      struct query_op *ops, unsigned *n)
+{
+   unsigned i;
+   enum query_op_type type                = QOP_FALSE;
+   const struct rmsgpack_dom_value *value  = NULL;
+   const struct rmsgpack_dom_value *value2 = NULL;
+   unsigned argc                          = 0;
+   unsigned start                         = (*n)++;
+
+   if (inv->func == query_func_is_true)
+      type = inv->argc ? QOP_FALSE : QOP_IS_TRUE;
+   else if (   inv->func == query_func_operator_or
+            || inv->func == query_func_operator_and)
+   {
+      type = (inv->func == query_func_operator_or) ? QOP_OR : QOP_AND;
+      argc = inv->argc;
+      for (i = 0; i < inv->argc; i++)
+         if (query_ops_emit_argument(&inv->argv[i], ops, n) < 0)
+            return -1;
+   }
+   else if (inv->func == query_func_between)
+   {
+      if (     inv->argc == 2
+            && inv->argv[0].type == AT_VALUE
+            && inv->argv[1].type == AT_VALUE
+            && inv->argv[0].a.value.type == RDT_INT
+            && inv->argv[1].a.value.type == RDT_INT)
+      {
+         type   = QOP_BETWEEN;
+         value  = &inv->argv[0].a.value;
+         value2 = &inv->argv[1].a.value;
+      }
+   }
+   else if (inv->func == query_func_glob)
+   {
+      if (     inv->argc == 1
+            && inv->argv[0].type == AT_VALUE
+            && inv->argv[0].a.value.type == RDT_STRING)
+      {
+         type  = QOP_GLOB;
+         value = &inv->argv[0].a.value;
+      }
+   }
+   else if (inv->func == query_func_all_map)
+   {
+      if (inv->argc % 2 == 0)
+      {
+         type = QOP_ALL_MAP;
+         argc = inv->argc / 2;
+         for (i = 0; i < inv->argc; i += 2)
+         {
+            if (inv->argv[i].type != AT_VALUE)
+            {
+               /* Any non-value key fails every map */
+               type = QOP_NOT_MAP;
+               argc = 0;
+               *n   = start + 1;
+               break;
+            }
+         }
+
+         for (i = 0; i < argc * 2; i += 2)
+         {
+            unsigned field = (*n)++;
+            if (query_ops_emit_argument(&inv->argv[i + 1], ops, n) < 0)
+               return -1;
+            if (ops)
+            {
+               ops[field].type   = QOP_FIELD;
+               ops[field].value  = &inv->argv[i].a.value;
+               ops[field].value2 = NULL;
+               ops[field].size   = *n - field;
+               ops[field].argc   = 1;
+            }
+         }
+      }
+   }
+   else
+      return -1;
+
+   if (ops)
+   {
+      ops[start].type   = type;
+      ops[start].value  = value;
+      ops[start].value2 = value2;
+      ops[start].size   = *n - start;
+      ops[start].argc   = argc;
+   }
+   return 0;
+}
+
+static struct query_op *query_ops_compile(const struct invocation *root)
+{
+   struct query_op *ops = NULL;
+   unsigned count       = 0;
+
+   if (query_ops_emit_invocation(root, NULL, &count) < 0)
+      return NULL;
+   if (!(ops = (struct query_op*)malloc(count * sizeof(*ops))))
+      return NULL;
+   count = 0;
+   query_ops_emit_invocation(root, ops, &count);
+   return ops;
+}
+
 void *libretrodb_query_compile(libretrodb_t *db,
       const char *query, size_t buff_len, const char **error_string)
 {
@@ -929,6 +1094,7 @@ void *libretrodb_query_compile(libretrodb_t *db,
       return NULL;
 
    q->ref_count          = 1;
+   q->ops                = NULL;
    q->root.argc          = 0;
    q->root.func          = NULL;
    q->root.argv          = NULL;
@@ -969,6 +1135,10 @@ void *libretrodb_query_compile(libretrodb_t *db,
       goto error;
    }
 
+   /* Without ops, records are simply decoded and
+    * filtered through the tree */
+   q->ops = query_ops_compile(&q->root);
+
    return q;
 
 error:
@@ -991,3 +1161,157 @@ int libretrodb_query_filter(libretrodb_query_t *q,
    struct rmsgpack_dom_value res = inv.func(*v, inv.argc, inv.argv);
    return (res.type == RDT_BOOL && res.val.bool_);
 }
+
+/* Equality as rmsgpack_dom_value_cmp() sees it, so that the compiled
+ * ops and the tree evaluators agree on every record */
+static bool query_raw_value_cmp(const struct rmsgpack_raw_value *a,
+      const struct rmsgpack_dom_value *b)
+{
+   if (a->type != b->type)
+      return false;
+
+   switch (b->type)
+   {
+      case RDT_NULL:
+         return true;
+      case RDT_BOOL:
+         return a->val.bool_ == b->val.bool_;
+      case RDT_INT:
+         return a->val.int_  == b->val.int_;
+      case RDT_UINT:
+         return a->val.uint_ == b->val.uint_;
+      case RDT_STRING:
+         return a->len == b->val.string.len
+            && strncmp((const char*)a->val.data,
+                  b->val.string.buff, a->len) == 0;
+      case RDT_BINARY:
+         return a->len == b->val.binary.len
+            && memcmp(a->val.data, b->val.binary.buff, a->len) == 0;
+      default:
+         break;
+   }
+
+   /* Maps and arrays: rmsgpack_dom_value_cmp() falls out of its
+    * switch and returns non-zero even when every element matches,
+    * so func_equals() never matches a container either */
+   return false;
+}
+
+static bool query_raw_value_equals(const struct rmsgpack_raw_value *a,
+      const struct rmsgpack_dom_value *b)
+{
+   if (a->type == RDT_UINT && b->type == RDT_INT)
+      return a->val.uint_ == (uint64_t)b->val.int_;
+   return query_raw_value_cmp(a, b);
+}
+
+static bool query_raw_map_value(const struct rmsgpack_raw_value *map,
+      const uint8_t *end, const struct rmsgpack_dom_value *key,
+      struct rmsgpack_raw_value *out)
+{
+   uint32_t i;
+   const uint8_t *ptr = map->val.data;
+
+   for (i = 0; i < map->len; i++)
+   {
+      struct rmsgpack_raw_value k;
+      int64_t key_size = rmsgpack_raw_size(ptr, end - ptr);
+      int64_t val_size;
+
+      if (key_size <= 0 || rmsgpack_raw_parse(ptr, end - ptr, &k) <= 0)
+         return false;
+      ptr += key_size;
+
+      if (query_raw_value_cmp(&k, key))
+         return rmsgpack_raw_parse(ptr, end - ptr, out) > 0;
+
+      if ((val_size = rmsgpack_raw_size(ptr, end - ptr)) <= 0)
+         return false;
+      ptr += val_size;
+   }
+
+   return false;
+}
+
+static bool query_ops_eval(const struct query_op *op,
+      const struct rmsgpack_raw_value *input, const uint8_t *end)
+{
+   unsigned i;
+   const struct query_op *child = op + 1;
+
+   switch (op->type)
+   {
+      case QOP_FALSE:
+         break;
+      case QOP_NOT_MAP:
+         return input->type != RDT_MAP;
+      case QOP_IS_TRUE:
+         return input->type == RDT_BOOL && input->val.bool_;
+      case QOP_EQUALS:
+         return query_raw_value_equals(input, op->value);
+      case QOP_OR:
+         for (i = 0; i < op->argc; i++, child += child->size)
+            if (query_ops_eval(child, input, end))
+               return true;
+         break;
+      case QOP_AND:
+         for (i = 0; i < op->argc; i++, child += child->size)
+            if (!query_ops_eval(child, input, end))
+               return false;
+         return op->argc > 0;
+      case QOP_BETWEEN:
+         if (input->type == RDT_INT)
+            return input->val.int_ >= op->value->val.int_
+               &&  input->val.int_ <= op->value2->val.int_;
+         if (input->type == RDT_UINT)
+            return (unsigned)input->val.int_ >= op->value->val.uint_
+               &&  input->val.int_ <= op->value2->val.int_;
+         break;
+      case QOP_GLOB:
+         if (input->type == RDT_STRING)
+         {
+            /* rl_fnmatch wants a terminated string */
+            bool match;
+            char tmp[256];
+            char *str = (input->len < sizeof(tmp))
+               ? tmp : (char*)malloc(input->len + 1);
+            if (!str)
+               return false;
+            memcpy(str, input->val.data, input->len);
+            str[input->len] = '\0';
+            match = rl_fnmatch(op->value->val.string.buff, str, 0) == 0;
+            if (str != tmp)
+               free(str);
+            return match;
+         }
+         break;
+      case QOP_ALL_MAP:
+         if (input->type != RDT_MAP)
+            return true;
+         for (i = 0; i < op->argc; i++, child += child->size)
+         {
+            /* All missing fields are nil */
+            struct rmsgpack_raw_value value;
+            if (!query_raw_map_value(input, end, child->value, &value))
+               value.type = RDT_NULL;
+            if (!query_ops_eval(child + 1, &value, end))
+               return false;
+         }
+         return true;
+      case QOP_FIELD:
+         break;
+   }
+
+   return false;
+}
+
+int libretrodb_query_filter_raw(libretrodb_query_t *q,
+      const uint8_t *data, size_t len)
+{
+   struct rmsgpack_raw_value input;
+   struct query *rq = (struct query*)q;
+
+   if (!rq->ops || rmsgpack_raw_parse(data, len, &input) <= 0)
+      return -1;
+   return query_ops_eval(rq->ops, &input, data + len) ? 1 : 0;
+}
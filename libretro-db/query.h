@@ -38,6 +38,15 @@ void libretrodb_query_dec_ref(libretrodb_query_t *q);
 
 int libretrodb_query_filter(libretrodb_query_t *q, struct rmsgpack_dom_value *v);
 
+/**
+ * libretrodb_query_filter_raw:
+ * Matches one undecoded msgpack record without building its DOM.
+ * Returns 1 on a match, 0 otherwise, or -1 when the record has to
+ * be decoded and passed to libretrodb_query_filter instead.
+ */
+int libretrodb_query_filter_raw(libretrodb_query_t *q,
+      const uint8_t *data, size_t len);
+
 RETRO_END_DECLS
 
 #endif
@@ -32,6 +32,7 @@
 #include <retro_endianness.h>
 
 #include "rmsgpack.h"
+#include "rmsgpack_dom.h"
 
 #define _MPF_FIXMAP     0x80
 #define _MPF_MAP16      0xde
@@ -593,3 +594,149 @@ end:
       free(buff);
    return 0;
 }
+
+static uint64_t rmsgpack_raw_be(const uint8_t *data, size_t size)
+{
+   uint64_t val = 0;
+   size_t i;
+   for (i = 0; i < size; i++)
+      val = (val << 8) | data[i];
+   return val;
+}
+
+int64_t rmsgpack_raw_parse(const uint8_t *data, size_t len,
+      struct rmsgpack_raw_value *out)
+{
+   size_t size;
+   uint8_t type;
+
+   if (len < 1)
+      return 0;
+
+   type = data[0];
+
+   if (type < MPF_FIXMAP)
+   {
+      out->type     = RDT_INT;
+      out->val.int_ = type;
+      return 1;
+   }
+   else if (type < MPF_FIXARRAY)
+   {
+      out->type     = RDT_MAP;
+      out->len      = type - MPF_FIXMAP;
+      out->val.data = data + 1;
+      return 1;
+   }
+   else if (type < MPF_FIXSTR)
+   {
+      out->type     = RDT_ARRAY;
+      out->len      = type - MPF_FIXARRAY;
+      out->val.data = data + 1;
+      return 1;
+   }
+   else if (type < MPF_NIL)
+   {
+      out->type     = RDT_STRING;
+      out->len      = type - MPF_FIXSTR;
+      out->val.data = data + 1;
+      return (len < 1 + (size_t)out->len) ? 0 : 1 + out->len;
+   }
+   else if (type > MPF_MAP32)
+   {
+      out->type     = RDT_INT;
+      out->val.int_ = type - 0xff - 1;
+      return 1;
+   }
+
+   switch (type)
+   {
+      case _MPF_NIL:
+         out->type     = RDT_NULL;
+         return 1;
+      case _MPF_FALSE:
+      case _MPF_TRUE:
+         out->type     = RDT_BOOL;
+         out->val.bool_ = (type == _MPF_TRUE);
+         return 1;
+      case _MPF_BIN8:
+      case _MPF_BIN16:
+      case _MPF_BIN32:
+      case _MPF_STR8:
+      case _MPF_STR16:
+      case _MPF_STR32:
+         size = (type >= _MPF_STR8)
+            ? (size_t)1 << (type - _MPF_STR8)
+            : (size_t)1 << (type - _MPF_BIN8);
+         if (len < 1 + size)
+            return 0;
+         out->type     = (type >= _MPF_STR8) ? RDT_STRING : RDT_BINARY;
+         out->len      = (uint32_t)rmsgpack_raw_be(data + 1, size);
+         out->val.data = data + 1 + size;
+         if (len - 1 - size < out->len)
+            return 0;
+         return 1 + size + out->len;
+      case _MPF_UINT8:
+      case _MPF_UINT16:
+      case _MPF_UINT32:
+      case _MPF_UINT64:
+         size = (size_t)1 << (type - _MPF_UINT8);
+         if (len < 1 + size)
+            return 0;
+         out->type     = RDT_UINT;
+         out->val.uint_ = rmsgpack_raw_be(data + 1, size);
+         return 1 + size;
+      case _MPF_INT8:
+      case _MPF_INT16:
+      case _MPF_INT32:
+      case _MPF_INT64:
+         size = (size_t)1 << (type - _MPF_INT8);
+         if (len < 1 + size)
+            return 0;
+         out->type     = RDT_INT;
+         out->val.uint_ = rmsgpack_raw_be(data + 1, size);
+         /* Sign-extend the narrower encodings */
+         if (size < 8 && (out->val.uint_ >> (size * 8 - 1)))
+            out->val.uint_ |= ~UINT64_C(0) << (size * 8);
+         return 1 + size;
+      case _MPF_ARRAY16:
+      case _MPF_ARRAY32:
+      case _MPF_MAP16:
+      case _MPF_MAP32:
+         size = (type >= _MPF_MAP16)
+            ? (size_t)2 << (type - _MPF_MAP16)
+            : (size_t)2 << (type - _MPF_ARRAY16);
+         if (len < 1 + size)
+            return 0;
+         out->type     = (type >= _MPF_MAP16) ? RDT_MAP : RDT_ARRAY;
+         out->len      = (uint32_t)rmsgpack_raw_be(data + 1, size);
+         out->val.data = data + 1 + size;
+         return 1 + size;
+   }
+
+   return -1;
+}
+
+int64_t rmsgpack_raw_size(const uint8_t *data, size_t len)
+{
+   /* Walk the objects iteratively, counting how many
+    * are still owed to the enclosing maps and arrays */
+   uint64_t pending = 1;
+   size_t pos       = 0;
+
+   while (pending)
+   {
+      struct rmsgpack_raw_value val;
+      int64_t n = rmsgpack_raw_parse(data + pos, len - pos, &val);
+      if (n <= 0)
+         return n;
+      pos += (size_t)n;
+      pending--;
+      if (val.type == RDT_MAP)
+         pending += (uint64_t)val.len * 2;
+      else if (val.type == RDT_ARRAY)
+         pending += val.len;
+   }
+
+   return (int64_t)pos;
+}
@@ -39,6 +39,23 @@ struct rmsgpack_read_callbacks
    int (*read_array_start)(uint32_t, void *);
 };
 
+/* An undecoded object inside an in-memory msgpack buffer.
+ * Strings and binaries point into the buffer and are not
+ * NUL-terminated; maps and arrays point at their first element
+ * and report their pair/item count in 'len'. */
+struct rmsgpack_raw_value
+{
+   union
+   {
+      uint64_t uint_;
+      int64_t int_;
+      int bool_;
+      const uint8_t *data;
+   } val;
+   uint32_t len;
+   uint8_t type; /* enum rmsgpack_dom_type */
+};
+
 int rmsgpack_write_array_header(RFILE *fd, uint32_t size);
 
 int rmsgpack_write_map_header(RFILE *fd, uint32_t size);
@@ -57,4 +74,23 @@ int rmsgpack_write_uint(RFILE *fd, uint64_t value );
 
 int rmsgpack_read(RFILE *fd, struct rmsgpack_read_callbacks *callbacks, void *data);
 
+/**
+ * rmsgpack_raw_parse:
+ * Decodes the object header at @data without allocating.
+ * Returns the number of bytes consumed (the header, plus the
+ * payload for scalars, strings and binaries; map and array
+ * elements follow it), 0 if @len is too short, or -1 if the
+ * type is not one rmsgpack_read understands.
+ */
+int64_t rmsgpack_raw_parse(const uint8_t *data, size_t len,
+      struct rmsgpack_raw_value *out);
+
+/**
+ * rmsgpack_raw_size:
+ * Measures the complete object at @data, including nested
+ * elements.  Returns its size in bytes, 0 if @len is too short
+ * to hold it, or -1 on an unknown type.
+ */
+int64_t rmsgpack_raw_size(const uint8_t *data, size_t len);
+
 #endif
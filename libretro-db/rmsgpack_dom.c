@@ -417,6 +417,120 @@ int rmsgpack_dom_read(RFILE *fd, struct rmsgpack_dom_value *out)
    return rv;
 }
 
+static int64_t dom_read_raw(const uint8_t *data, size_t len,
+      struct rmsgpack_dom_value *v, unsigned depth)
+{
+   uint32_t i;
+   struct rmsgpack_raw_value raw;
+   int64_t pos = rmsgpack_raw_parse(data, len, &raw);
+
+   v->type     = RDT_NULL;
+
+   if (pos <= 0 || depth >= MAX_DEPTH)
+      return -1;
+
+   switch (raw.type)
+   {
+      case RDT_BOOL:
+         v->val.bool_ = raw.val.bool_;
+         break;
+      case RDT_INT:
+         v->val.int_  = raw.val.int_;
+         break;
+      case RDT_UINT:
+         v->val.uint_ = raw.val.uint_;
+         break;
+      case RDT_STRING:
+      case RDT_BINARY:
+         {
+            char *buff = (char*)malloc(raw.len + 1);
+            if (!buff)
+               return -1;
+            memcpy(buff, raw.val.data, raw.len);
+            buff[raw.len]          = '\0';
+            if (raw.type == RDT_STRING)
+            {
+               v->val.string.len   = raw.len;
+               v->val.string.buff  = buff;
+            }
+            else
+            {
+               v->val.binary.len   = raw.len;
+               v->val.binary.buff  = buff;
+            }
+         }
+         break;
+      case RDT_MAP:
+         {
+            struct rmsgpack_dom_pair *items = NULL;
+            /* Every element takes at least a byte */
+            if (     raw.len > (len - pos) / 2
+                  || !(items = (struct rmsgpack_dom_pair*)
+                     calloc(raw.len ? raw.len : 1, sizeof(*items))))
+               return -1;
+            v->type           = RDT_MAP;
+            v->val.map.len    = raw.len;
+            v->val.map.items  = items;
+            /* rmsgpack_dom_read fills containers back to front;
+             * keep the same item order */
+            for (i = raw.len; i-- > 0; )
+            {
+               int64_t n;
+               if ((n = dom_read_raw(data + pos, len - pos,
+                           &items[i].key, depth + 1)) < 0)
+                  return -1;
+               pos += n;
+               if ((n = dom_read_raw(data + pos, len - pos,
+                           &items[i].value, depth + 1)) < 0)
+                  return -1;
+               pos += n;
+            }
+         }
+         return pos;
+      case RDT_ARRAY:
+         {
+            struct rmsgpack_dom_value *items = NULL;
+            if (     raw.len > len - pos
+                  || !(items = (struct rmsgpack_dom_value*)
+                     calloc(raw.len ? raw.len : 1, sizeof(*items))))
+               return -1;
+            v->type            = RDT_ARRAY;
+            v->val.array.len   = raw.len;
+            v->val.array.items = items;
+            for (i = raw.len; i-- > 0; )
+            {
+               int64_t n;
+               if ((n = dom_read_raw(data + pos, len - pos,
+                           &items[i], depth + 1)) < 0)
+                  return -1;
+               pos += n;
+            }
+         }
+         return pos;
+      default:
+         break;
+   }
+
+   v->type = (enum rmsgpack_dom_type)raw.type;
+   return pos;
+}
+
+/**
+ * rmsgpack_dom_read_raw:
+ * Same as rmsgpack_dom_read, but decodes the object at @data,
+ * which has already been read into memory.
+ **/
+int rmsgpack_dom_read_raw(const uint8_t *data, size_t len,
+      struct rmsgpack_dom_value *out)
+{
+   if (dom_read_raw(data, len, out, 0) < 0)
+   {
+      rmsgpack_dom_value_free(out);
+      return -1;
+   }
+   return 0;
+}
+
 int rmsgpack_dom_read_into(RFILE *fd, ...)
 {
    int rv;
@@ -746,8 +746,11 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_runahead_mode,                 MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_runahead_mode,                 MENU_ENUM_SUBLABEL_RUNAHEAD_MODE_NO_SECOND_INSTANCE)
 #endif
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_hide_warnings,       MENU_ENUM_SUBLABEL_RUN_AHEAD_HIDE_WARNINGS)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_snapshot,            MENU_ENUM_SUBLABEL_RUN_AHEAD_SNAPSHOT)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_secondary_thread,    MENU_ENUM_SUBLABEL_RUN_AHEAD_SECONDARY_THREAD)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_frames,              MENU_ENUM_SUBLABEL_RUN_AHEAD_FRAMES)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_preempt_frames,                MENU_ENUM_SUBLABEL_PREEMPT_FRAMES)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_preempt_analog_threshold,      MENU_ENUM_SUBLABEL_PREEMPT_ANALOG_THRESHOLD)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_input_block_timeout,           MENU_ENUM_SUBLABEL_INPUT_BLOCK_TIMEOUT)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind,                        MENU_ENUM_SUBLABEL_REWIND_ENABLE)
 #ifdef HAVE_CHEATS
@@ -791,6 +794,7 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_cheat_file_save_as,            MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_granularity,            MENU_ENUM_SUBLABEL_REWIND_GRANULARITY)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_buffer_size,            MENU_ENUM_SUBLABEL_REWIND_BUFFER_SIZE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_buffer_size_step,       MENU_ENUM_SUBLABEL_REWIND_BUFFER_SIZE_STEP)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_threaded,               MENU_ENUM_SUBLABEL_REWIND_THREADED)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_libretro_log_level,            MENU_ENUM_SUBLABEL_LIBRETRO_LOG_LEVEL)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_frontend_log_level,            MENU_ENUM_SUBLABEL_FRONTEND_LOG_LEVEL)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_perfcnt_enable,                MENU_ENUM_SUBLABEL_PERFCNT_ENABLE)
@@ -1053,6 +1057,7 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_core_options_reset,
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_core_options_flush,                    MENU_ENUM_SUBLABEL_CORE_OPTIONS_FLUSH)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_show_advanced_settings,                MENU_ENUM_SUBLABEL_SHOW_ADVANCED_SETTINGS)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_threaded_data_runloop_enable,          MENU_ENUM_SUBLABEL_THREADED_DATA_RUNLOOP_ENABLE)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_threaded_data_runloop_workers,         MENU_ENUM_SUBLABEL_THREADED_DATA_RUNLOOP_WORKERS)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_playlist_entry_rename,                 MENU_ENUM_SUBLABEL_PLAYLIST_ENTRY_RENAME)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_playlist_entry_remove,                 MENU_ENUM_SUBLABEL_PLAYLIST_ENTRY_REMOVE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_system_directory,                      MENU_ENUM_SUBLABEL_SYSTEM_DIRECTORY)
@@ -3293,6 +3298,9 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_ENABLE:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_threaded_data_runloop_enable);
             break;
+         case MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_WORKERS:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_threaded_data_runloop_workers);
+            break;
          case MENU_ENUM_LABEL_SHOW_ADVANCED_SETTINGS:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_show_advanced_settings);
             break;
@@ -4052,6 +4060,9 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_REWIND_BUFFER_SIZE_STEP:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_buffer_size_step);
             break;
+         case MENU_ENUM_LABEL_REWIND_THREADED:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_threaded);
+            break;
          case MENU_ENUM_LABEL_CHEAT_IDX:
 #ifdef HAVE_CHEATS
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_cheat_idx);
@@ -4184,12 +4195,21 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_hide_warnings);
             break;
+         case MENU_ENUM_LABEL_RUN_AHEAD_SNAPSHOT:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_snapshot);
+            break;
+         case MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREAD:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_secondary_thread);
+            break;
          case MENU_ENUM_LABEL_RUN_AHEAD_FRAMES:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_frames);
             break;
          case MENU_ENUM_LABEL_PREEMPT_FRAMES:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_preempt_frames);
             break;
+         case MENU_ENUM_LABEL_PREEMPT_ANALOG_THRESHOLD:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_preempt_analog_threshold);
+            break;
          case MENU_ENUM_LABEL_INPUT_BLOCK_TIMEOUT:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_input_block_timeout);
             break;
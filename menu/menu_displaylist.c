@@ -9376,6 +9376,7 @@ unsigned menu_displaylist_build_list(
                {MENU_ENUM_LABEL_MOUSE_ENABLE,                                          PARSE_ONLY_BOOL,   true},
                {MENU_ENUM_LABEL_POINTER_ENABLE,                                        PARSE_ONLY_BOOL,   true},
                {MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_ENABLE,                          PARSE_ONLY_BOOL,   true},
+               {MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_WORKERS,                         PARSE_ONLY_UINT,   false},
                {MENU_ENUM_LABEL_MENU_SCREENSAVER_TIMEOUT,                              PARSE_ONLY_UINT,   false},
                {MENU_ENUM_LABEL_MENU_SCREENSAVER_ANIMATION,                            PARSE_ONLY_UINT,   false},
                {MENU_ENUM_LABEL_MENU_SCREENSAVER_ANIMATION_SPEED,                      PARSE_ONLY_FLOAT,  false},
@@ -9418,6 +9419,10 @@ unsigned menu_displaylist_build_list(
                      if (kiosk_mode_enable)
                         build_list[i].checked = true;
                      break;
+                  case MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_WORKERS:
+                     if (settings->bools.threaded_data_runloop_enable)
+                        build_list[i].checked = true;
+                     break;
                   case MENU_ENUM_LABEL_MENU_SCREENSAVER_TIMEOUT:
                      if (menu_screensaver_supported)
                         build_list[i].checked = true;
@@ -10302,6 +10307,9 @@ unsigned menu_displaylist_build_list(
             bool runahead_supported       = true;
             bool runahead_enabled         = settings->bools.run_ahead_enabled;
             bool preempt_enabled          = settings->bools.preemptive_frames_enable;
+#if defined(HAVE_RUNAHEAD_SNAPSHOT) || defined(HAVE_RUNAHEAD_THREAD)
+            bool runahead_secondary       = settings->bools.run_ahead_secondary_instance;
+#endif
 #endif
             menu_displaylist_build_info_selective_t build_list[] = {
                {MENU_ENUM_LABEL_AUDIO_LATENCY,                         PARSE_ONLY_UINT, true },
@@ -10316,7 +10324,14 @@ unsigned menu_displaylist_build_list(
                {MENU_ENUM_LABEL_RUNAHEAD_MODE,                         PARSE_ONLY_UINT, false },
                {MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,                      PARSE_ONLY_UINT, false },
                {MENU_ENUM_LABEL_PREEMPT_FRAMES,                        PARSE_ONLY_UINT, false },
+               {MENU_ENUM_LABEL_PREEMPT_ANALOG_THRESHOLD,              PARSE_ONLY_UINT, false },
                {MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS,               PARSE_ONLY_BOOL, false },
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+               {MENU_ENUM_LABEL_RUN_AHEAD_SNAPSHOT,                    PARSE_ONLY_BOOL, false },
+#endif
+#ifdef HAVE_RUNAHEAD_THREAD
+               {MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREAD,            PARSE_ONLY_BOOL, false },
+#endif
 #endif
             };
 
@@ -10377,6 +10392,7 @@ unsigned menu_displaylist_build_list(
                            build_list[i].checked = true;
                         break;
                      case MENU_ENUM_LABEL_PREEMPT_FRAMES:
+                     case MENU_ENUM_LABEL_PREEMPT_ANALOG_THRESHOLD:
                         if (preempt_enabled)
                            build_list[i].checked = true;
                         break;
@@ -10384,6 +10400,18 @@ unsigned menu_displaylist_build_list(
                         if (runahead_enabled || preempt_enabled)
                            build_list[i].checked = true;
                         break;
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+                     case MENU_ENUM_LABEL_RUN_AHEAD_SNAPSHOT:
+                        if (runahead_enabled && !runahead_secondary)
+                           build_list[i].checked = true;
+                        break;
+#endif
+#ifdef HAVE_RUNAHEAD_THREAD
+                     case MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREAD:
+                        if (runahead_enabled && runahead_secondary)
+                           build_list[i].checked = true;
+                        break;
+#endif
                      default:
                         break;
                   }
@@ -11372,6 +11400,7 @@ unsigned menu_displaylist_build_list(
                {MENU_ENUM_LABEL_REWIND_GRANULARITY,      PARSE_ONLY_UINT, false},
                {MENU_ENUM_LABEL_REWIND_BUFFER_SIZE,      PARSE_ONLY_SIZE, false},
                {MENU_ENUM_LABEL_REWIND_BUFFER_SIZE_STEP, PARSE_ONLY_UINT, false},
+               {MENU_ENUM_LABEL_REWIND_THREADED,         PARSE_ONLY_BOOL, false},
             };
 
             for (i = 0; i < ARRAY_SIZE(build_list); i++)
@@ -11381,6 +11410,7 @@ unsigned menu_displaylist_build_list(
                   case MENU_ENUM_LABEL_REWIND_GRANULARITY:
                   case MENU_ENUM_LABEL_REWIND_BUFFER_SIZE:
                   case MENU_ENUM_LABEL_REWIND_BUFFER_SIZE_STEP:
+                  case MENU_ENUM_LABEL_REWIND_THREADED:
                      if (rewind_enable)
                         build_list[i].checked = true;
                      break;
@@ -462,6 +462,7 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
    struct explore_rdb
    {
       libretrodb_t *handle;
+      libretrodb_columns_t *columns;
       struct explore_source *playlist_crcs;
       struct explore_source *playlist_names;
       size_t count;
@@ -554,9 +555,11 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
          {
             size_t systemname_len;
             struct explore_rdb newrdb;
+            char columns_path[PATH_MAX_LENGTH];
             char *ext_path        = NULL;
 
             newrdb.handle         = libretrodb_new();
+            newrdb.columns        = NULL;
             newrdb.count          = 0;
             newrdb.playlist_crcs  = NULL;
             newrdb.playlist_names = NULL;
@@ -590,6 +593,18 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
                continue;
             }
 
+            /* Use the columnar companion if one was compiled
+             * from this exact database, it spares decoding
+             * every record below */
+            fill_pathname(columns_path, tmp,
+                  LIBRETRODB_COLUMNS_EXTENSION, sizeof(columns_path));
+            if ((newrdb.columns = libretrodb_columns_open(columns_path))
+                  && !libretrodb_columns_is_current(newrdb.columns, tmp))
+            {
+               libretrodb_columns_free(newrdb.columns);
+               newrdb.columns = NULL;
+            }
+
             RBUF_PUSH(rdbs, newrdb);
             rdb_num = (int)RBUF_LEN(rdbs);
             RHMAP_SET(rdb_indices, rdb_hash, rdb_num);
@@ -624,15 +639,51 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
     * and load meta data strings */
    for (i = 0; i != RBUF_LEN(rdbs); i++)
    {
+      bool more;
       struct rmsgpack_dom_value item;
-      struct explore_rdb* rdb  = &rdbs[i];
-      libretrodb_cursor_t *cur = libretrodb_cursor_new();
-      bool more                =
-         (
-          libretrodb_cursor_open(rdb->handle, cur, NULL) == 0
-          && libretrodb_cursor_read_item(cur, &item) == 0);
-
-      for (; more; more = (rmsgpack_dom_value_free(&item),
+      int cat_columns[EXPLORE_CAT_COUNT];
+      int crc_column              = -1;
+      int name_column             = -1;
+#ifdef EXPLORE_SHOW_ORIGINAL_TITLE
+      int original_title_column   = -1;
+#endif
+      uint32_t row                = 0;
+      struct explore_rdb* rdb     = &rdbs[i];
+      libretrodb_columns_t *cols  = rdb->columns;
+      libretrodb_cursor_t *cur    = NULL;
+
+      if (cols)
+      {
+         unsigned cat;
+
+         crc_column  = libretrodb_columns_find(cols, "crc",
+               LIBRETRODB_COLUMN_BINARY);
+         name_column = libretrodb_columns_find(cols, "name",
+               LIBRETRODB_COLUMN_STRING);
+#ifdef EXPLORE_SHOW_ORIGINAL_TITLE
+         original_title_column = libretrodb_columns_find(cols,
+               "original_title", LIBRETRODB_COLUMN_STRING);
+#endif
+         for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+            cat_columns[cat] = libretrodb_columns_find(cols,
+                  explore_by_info[cat].rdbkey,
+                  (     explore_by_info[cat].is_numeric
+                     || explore_by_info[cat].is_boolean)
+                  ? LIBRETRODB_COLUMN_INT : LIBRETRODB_COLUMN_STRING);
+         more = libretrodb_columns_rows(cols) > 0;
+      }
+      else
+      {
+         cur  = libretrodb_cursor_new();
+         more =
+            (
+             libretrodb_cursor_open(rdb->handle, cur, NULL) == 0
+             && libretrodb_cursor_read_item(cur, &item) == 0);
+      }
+
+      for (; more; more = cols
+            ? (++row < libretrodb_columns_rows(cols))
+            : (rmsgpack_dom_value_free(&item),
                libretrodb_cursor_read_item(cur, &item) == 0))
       {
          unsigned k, l, cat;
@@ -647,13 +698,74 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
 #endif
          struct explore_source* src         = NULL;
 
-         if (item.type != RDT_MAP)
-            continue;
-
          for (k = 0; k < EXPLORE_CAT_COUNT; k++)
             fields[k]                       = NULL;
 
-         for (k = 0; k < item.val.map.len; k++)
+         if (cols)
+         {
+            uint32_t crc_len      = 0;
+            const uint8_t *crc    = libretrodb_columns_get_binary(
+                  cols, crc_column, row, &crc_len);
+
+            if (crc)
+            {
+               switch (crc_len)
+               {
+                  case 1:
+                     crc32 = crc[0];
+                     break;
+                  case 2:
+                     crc32 = ((uint32_t)crc[0] << 8) | crc[1];
+                     break;
+                  case 4:
+                     crc32 = ((uint32_t)crc[0] << 24)
+                           | ((uint32_t)crc[1] << 16)
+                           | ((uint32_t)crc[2] << 8)
+                           |  (uint32_t)crc[3];
+                     break;
+                  default:
+                     break;
+               }
+            }
+
+            name = (char*)libretrodb_columns_get_string(
+                  cols, name_column, row);
+#ifdef EXPLORE_SHOW_ORIGINAL_TITLE
+            original_title = (char*)libretrodb_columns_get_string(
+                  cols, original_title_column, row);
+#endif
+
+            for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+            {
+               int64_t value;
+
+               if (     explore_by_info[cat].is_numeric
+                     || explore_by_info[cat].is_boolean)
+               {
+                  if (!libretrodb_columns_get_int(cols,
+                           cat_columns[cat], row, &value))
+                     continue;
+                  meta_count++;
+                  if (explore_by_info[cat].is_numeric)
+                  {
+                     snprintf(numeric_buf[cat],
+                           sizeof(numeric_buf[cat]), "%d", (int)value);
+                     fields[cat] = numeric_buf[cat];
+                  }
+                  else
+                     fields[cat] = msg_hash_to_str(value ?
+                           MENU_ENUM_LABEL_VALUE_YES
+                           : MENU_ENUM_LABEL_VALUE_NO);
+               }
+               else if ((fields[cat] = libretrodb_columns_get_string(
+                           cols, cat_columns[cat], row)))
+                  meta_count++;
+            }
+         }
+         else if (item.type != RDT_MAP)
+            continue;
+
+         for (k = 0; !cols && k < item.val.map.len; k++)
          {
             const char *key_str             = NULL;
             struct rmsgpack_dom_value *key  = &item.val.map.items[k].key;
@@ -706,8 +818,8 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
                   if (val->type >= RDT_STRING)
                      break;
                   snprintf(numeric_buf[cat],
-                        sizeof(numeric_buf[cat]),
-                        "%d", (int)val->val.int_);
+                        sizeof(numeric_buf[cat]), "%d", (int)
+                        (val->type == RDT_BOOL ? val->val.bool_ : val->val.int_));
                   fields[cat] = numeric_buf[cat];
                   break;
                }
@@ -715,8 +827,9 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
                {
                   if (val->type >= RDT_STRING)
                      break;
-                  fields[cat] = msg_hash_to_str(val->val.int_ ?
-                        MENU_ENUM_LABEL_VALUE_YES : MENU_ENUM_LABEL_VALUE_NO);
+                  fields[cat] = msg_hash_to_str(
+                        (val->type == RDT_BOOL ? val->val.bool_ : val->val.int_)
+                        ? MENU_ENUM_LABEL_VALUE_YES : MENU_ENUM_LABEL_VALUE_NO);
                   break;
                }
                if (val->type != RDT_STRING)
@@ -790,13 +903,18 @@ explore_state_t *menu_explore_build_list(const char *directory_playlist,
          /* if all entries have found connections, we can leave early */
          if (--rdb->count == 0)
          {
-            rmsgpack_dom_value_free(&item);
+            if (!cols)
+               rmsgpack_dom_value_free(&item);
             break;
          }
       }
 
-      libretrodb_cursor_close(cur);
-      libretrodb_cursor_free(cur);
+      if (cur)
+      {
+         libretrodb_cursor_close(cur);
+         libretrodb_cursor_free(cur);
+      }
+      libretrodb_columns_free(cols);
       libretrodb_close(rdb->handle);
       libretrodb_free(rdb->handle);
       RHMAP_FREE(rdb->playlist_crcs);
@@ -8494,6 +8494,9 @@ static void general_write_handler(rarch_setting_t *setting)
          else
             task_queue_unset_threaded();
          break;
+      case MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_WORKERS:
+         task_queue_set_workers(*setting->value.target.unsigned_integer);
+         break;
 #ifndef HAVE_LAKKA
       case MENU_ENUM_LABEL_GAMEMODE_ENABLE:
          if (frontend_driver_has_gamemode())
@@ -12287,6 +12290,24 @@ static bool setting_append_list(
             (*list)[list_info->index - 1].offset_by     = 1;
             menu_settings_list_current_add_range(list, list_info, 1, 100, 1, true, true);
 
+#ifdef HAVE_THREADS
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.rewind_threaded,
+                  MENU_ENUM_LABEL_REWIND_THREADED,
+                  MENU_ENUM_LABEL_VALUE_REWIND_THREADED,
+                  DEFAULT_REWIND_THREADED,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_CMD_APPLY_AUTO);
+            MENU_SETTINGS_LIST_CURRENT_ADD_CMD(list, list_info, CMD_EVENT_REWIND_REINIT);
+#endif
+
          END_SUB_GROUP(list, list_info, parent_group);
          END_GROUP(list, list_info, parent_group);
          break;
@@ -16644,6 +16665,42 @@ static bool setting_append_list(
                SD_FLAG_ADVANCED
                );
 
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.run_ahead_snapshot,
+               MENU_ENUM_LABEL_RUN_AHEAD_SNAPSHOT,
+               MENU_ENUM_LABEL_VALUE_RUN_AHEAD_SNAPSHOT,
+               DEFAULT_RUN_AHEAD_SNAPSHOT,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_ADVANCED
+               );
+#endif
+
+#ifdef HAVE_RUNAHEAD_THREAD
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.run_ahead_secondary_thread,
+               MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREAD,
+               MENU_ENUM_LABEL_VALUE_RUN_AHEAD_SECONDARY_THREAD,
+               DEFAULT_RUN_AHEAD_SECONDARY_THREAD,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_ADVANCED
+               );
+#endif
+
          CONFIG_UINT(
                list, list_info,
                &settings->uints.run_ahead_frames,
@@ -16660,6 +16717,21 @@ static bool setting_append_list(
          (*list)[list_info->index - 1].offset_by = 1;
          (*list)[list_info->index - 1].change_handler = runahead_change_handler;
          menu_settings_list_current_add_range(list, list_info, 1, MAX_RUNAHEAD_FRAMES, 1, true, true);
+
+         CONFIG_UINT(
+               list, list_info,
+               &settings->uints.preemptive_frames_analog_threshold,
+               MENU_ENUM_LABEL_PREEMPT_ANALOG_THRESHOLD,
+               MENU_ENUM_LABEL_VALUE_PREEMPT_ANALOG_THRESHOLD,
+               DEFAULT_PREEMPT_ANALOG_THRESHOLD,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler);
+         (*list)[list_info->index - 1].action_ok = &setting_action_ok_uint;
+         menu_settings_list_current_add_range(list, list_info, 0, 25, 1, true, true);
+         SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
 #endif
 
 #ifdef ANDROID
@@ -18925,6 +18997,21 @@ static bool setting_append_list(
                general_read_handler,
                SD_FLAG_ADVANCED
                );
+
+         CONFIG_UINT(
+               list, list_info,
+               &settings->uints.threaded_data_runloop_workers,
+               MENU_ENUM_LABEL_THREADED_DATA_RUNLOOP_WORKERS,
+               MENU_ENUM_LABEL_VALUE_THREADED_DATA_RUNLOOP_WORKERS,
+               DEFAULT_THREADED_DATA_RUNLOOP_WORKERS,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler);
+         (*list)[list_info->index - 1].action_ok = &setting_action_ok_uint;
+         menu_settings_list_current_add_range(list, list_info, 1, TASK_QUEUE_MAX_WORKERS, 1, true, true);
+         SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
 #endif
 
          END_SUB_GROUP(list, list_info, parent_group);
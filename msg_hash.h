@@ -1596,6 +1596,7 @@ enum msg_hash_enums
    MENU_LABEL(NAVIGATION_WRAPAROUND),
    MENU_LABEL(SHOW_ADVANCED_SETTINGS),
    MENU_LABEL(THREADED_DATA_RUNLOOP_ENABLE),
+   MENU_LABEL(THREADED_DATA_RUNLOOP_WORKERS),
    MENU_LABEL(XMB_ALPHA_FACTOR),
    MENU_LABEL(MENU_FONT_COLOR_RED),
    MENU_LABEL(MENU_FONT_COLOR_GREEN),
@@ -2378,6 +2379,7 @@ enum msg_hash_enums
    MENU_LABEL(REWIND_GRANULARITY),
    MENU_LABEL(REWIND_BUFFER_SIZE),
    MENU_LABEL(REWIND_BUFFER_SIZE_STEP),
+   MENU_LABEL(REWIND_THREADED),
    /* TODO/FIXME: INPUT_META_REWIND is incorrectly defined;
     * the LABEL/SUBLABEL enums should be entered 'manually',
     * like all the other hotkeys. Moreover, the resultant
@@ -2777,8 +2779,11 @@ enum msg_hash_enums
    MENU_LABEL(SLOWMOTION_RATIO),
    MENU_LABEL(RUN_AHEAD_UNSUPPORTED),
    MENU_LABEL(RUN_AHEAD_HIDE_WARNINGS),
+   MENU_LABEL(RUN_AHEAD_SNAPSHOT),
+   MENU_LABEL(RUN_AHEAD_SECONDARY_THREAD),
    MENU_LABEL(RUN_AHEAD_FRAMES),
    MENU_LABEL(PREEMPT_FRAMES),
+   MENU_LABEL(PREEMPT_ANALOG_THRESHOLD),
    MENU_LABEL(INPUT_BLOCK_TIMEOUT),
    MENU_LABEL(TURBO),
 
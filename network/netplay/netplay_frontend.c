@@ -1106,6 +1106,9 @@ bool netplay_handshake_init(netplay_t *netplay,
    if (compression == -1)
       return false;
    connection->compression_supported = (uint32_t)compression;
+   if (ntohl(header[2]) & NETPLAY_COMPRESSION_SUPPORTED
+         & NETPLAY_COMPRESSION_DELTA)
+      connection->flags |= NETPLAY_CONN_FLAG_DELTA_STATES;
 
    if (!netplay->is_server)
    {
@@ -2677,6 +2680,89 @@ static bool netplay_cmd_request_savestate(netplay_t *netplay)
       NETPLAY_CMD_REQUEST_SAVESTATE, NULL, 0);
 }
 
+/**
+ * netplay_cmd_request_full_savestate
+ *
+ * Send a request for a savestate that is not a delta,
+ * because our delta base did not match the server's.
+ */
+static bool netplay_cmd_request_full_savestate(netplay_t *netplay)
+{
+   if (     (netplay->connections_size == 0)
+       || (!(netplay->connections[0].flags & NETPLAY_CONN_FLAG_ACTIVE))
+       ||   (netplay->connections[0].mode  < NETPLAY_CONNECTION_CONNECTED))
+      return false;
+   netplay->delta_base_valid              = false;
+   netplay->savestate_request_outstanding = true;
+   return netplay_send_raw_cmd(netplay, &netplay->connections[0],
+      NETPLAY_CMD_REQUEST_FULL_SAVESTATE, NULL, 0);
+}
+
+/**
+ * netplay_delta_base_set
+ *
+ * Keep a copy of a state that both sides are known to have,
+ * to send or receive later savestates as a delta against it.
+ */
+static void netplay_delta_base_set(netplay_t *netplay,
+      const void *state, uint32_t frame, uint32_t crc)
+{
+   if (!netplay->delta_base || !netplay->delta_scratch)
+      return;
+
+   memcpy(netplay->delta_base, state, netplay->state_size);
+   netplay->delta_base_frame = frame;
+   netplay->delta_base_crc   = crc;
+   netplay->delta_base_valid = true;
+}
+
+/**
+ * netplay_has_delta_peers
+ *
+ * Is any connected peer able to receive delta savestates?
+ */
+static bool netplay_has_delta_peers(netplay_t *netplay)
+{
+   size_t i;
+
+   for (i = 0; i < netplay->connections_size; i++)
+   {
+      struct netplay_connection *connection = &netplay->connections[i];
+      if (     (connection->flags & NETPLAY_CONN_FLAG_ACTIVE)
+            && (connection->flags & NETPLAY_CONN_FLAG_DELTA_STATES)
+            && (connection->mode  >= NETPLAY_CONNECTION_CONNECTED))
+         return true;
+   }
+
+   return false;
+}
+
+/**
+ * netplay_cmd_crc_confirm
+ *
+ * A CRC from the server matched our own state for this frame.
+ * Keep that state as the delta base and let the server know.
+ */
+static bool netplay_cmd_crc_confirm(netplay_t *netplay,
+      struct delta_frame *delta, uint32_t crc)
+{
+   uint32_t frame;
+
+   if (     netplay->is_server
+         || !netplay->state_size
+         || (netplay->connections_size == 0)
+         || !(netplay->connections[0].flags & NETPLAY_CONN_FLAG_ACTIVE)
+         || !(netplay->connections[0].flags & NETPLAY_CONN_FLAG_DELTA_STATES)
+         ||  (netplay->connections[0].mode  < NETPLAY_CONNECTION_CONNECTED))
+      return false;
+
+   netplay_delta_base_set(netplay, delta->state, delta->frame, crc);
+
+   frame = htonl(delta->frame);
+   return netplay_send_raw_cmd(netplay, &netplay->connections[0],
+      NETPLAY_CMD_CRC_CONFIRM, &frame, sizeof(frame));
+}
+
 /**
  * netplay_cmd_stall
  *
@@ -3175,6 +3261,17 @@ static void netplay_handle_frame_hash(netplay_t *netplay,
          delta->crc = netplay->state_size ?
             netplay_delta_frame_crc(netplay, delta) : 0;
          netplay_cmd_crc(netplay, delta);
+
+         /* This becomes the delta base for every peer
+          * that confirms the CRC */
+         if (netplay->state_size && netplay_has_delta_peers(netplay))
+         {
+            size_t i;
+            netplay_delta_base_set(netplay, delta->state,
+                  delta->frame, delta->crc);
+            for (i = 0; i < netplay->connections_size; i++)
+               netplay->connections[i].flags &= ~NETPLAY_CONN_FLAG_DELTA_BASE;
+         }
       }
    }
    else
@@ -3201,7 +3298,10 @@ static void netplay_handle_frame_hash(netplay_t *netplay,
                RARCH_WARN("[Netplay] Netplay CRCs mismatch!\n");
          }
          else
+         {
             netplay->crc_validity_checked = true;
+            netplay_cmd_crc_confirm(netplay, delta, local_crc);
+         }
       }
    }
 }
@@ -5945,6 +6045,9 @@ static bool netplay_get_cmd(netplay_t *netplay,
                /* Problem! */
                if (buffer[1] != local_crc)
                   netplay_cmd_request_savestate(netplay);
+               else
+                  netplay_cmd_crc_confirm(netplay,
+                        &netplay->buffer[tmp_ptr], local_crc);
             }
             /* We'll have to check it when we catch up */
             else
@@ -5960,7 +6063,50 @@ static bool netplay_get_cmd(netplay_t *netplay,
          netplay->force_send_savestate = true;
          break;
 
+      case NETPLAY_CMD_REQUEST_FULL_SAVESTATE:
+         NETPLAY_ASSERT_MODUS(NETPLAY_MODUS_INPUT_FRAME_SYNC);
+
+         if (!netplay->is_server)
+         {
+            RARCH_ERR("[Netplay] NETPLAY_CMD_REQUEST_FULL_SAVESTATE from server.\n");
+            return netplay_cmd_nak(netplay, connection);
+         }
+
+         /* Their delta base is not ours */
+         connection->flags            &= ~NETPLAY_CONN_FLAG_DELTA_BASE;
+         netplay->force_send_savestate = true;
+         break;
+
+      case NETPLAY_CMD_CRC_CONFIRM:
+         {
+            uint32_t frame;
+            NETPLAY_ASSERT_MODUS(NETPLAY_MODUS_INPUT_FRAME_SYNC);
+
+            if (!netplay->is_server)
+            {
+               RARCH_ERR("[Netplay] NETPLAY_CMD_CRC_CONFIRM from server.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            if (cmd_size != sizeof(frame))
+            {
+               RARCH_ERR("[Netplay] NETPLAY_CMD_CRC_CONFIRM received unexpected payload size.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            RECV(&frame, sizeof(frame))
+               return false;
+
+            /* A confirmation for an older base is of no use */
+            if (     netplay->delta_base_valid
+                  && netplay->delta_base_frame == ntohl(frame))
+               connection->flags |= NETPLAY_CONN_FLAG_DELTA_BASE;
+
+            break;
+         }
+
       case NETPLAY_CMD_LOAD_SAVESTATE:
+      case NETPLAY_CMD_LOAD_SAVESTATE_DELTA:
          {
             uint32_t i;
             uint32_t frame;
@@ -5968,7 +6114,12 @@ static bool netplay_get_cmd(netplay_t *netplay,
             size_t   load_ptr;
             uint32_t load_frame_count;
             uint32_t rd, wn;
+            /* Base frame, base CRC and CRC of the result */
+            uint32_t delta_info[3];
             struct compression_transcoder *ctrans = NULL;
+            bool     is_delta   = (cmd == NETPLAY_CMD_LOAD_SAVESTATE_DELTA);
+            size_t   info_size  = sizeof(frame) + sizeof(state_size)
+               + (is_delta ? sizeof(delta_info) : 0);
             NETPLAY_ASSERT_MODUS(NETPLAY_MODUS_INPUT_FRAME_SYNC);
 
             if (netplay->is_server)
@@ -5977,7 +6128,7 @@ static bool netplay_get_cmd(netplay_t *netplay,
                return netplay_cmd_nak(netplay, connection);
             }
 
-            if (cmd_size < sizeof(frame) + sizeof(state_size))
+            if (cmd_size < info_size)
             {
                RARCH_ERR("[Netplay] Received invalid payload size for NETPLAY_CMD_LOAD_SAVESTATE.\n");
                return netplay_cmd_nak(netplay, connection);
@@ -6039,7 +6190,16 @@ static bool netplay_get_cmd(netplay_t *netplay,
             RECV(&state_size, sizeof(state_size))
                return false;
             state_size     = ntohl(state_size);
-            state_size_raw = cmd_size - (sizeof(frame) + sizeof(state_size));
+            state_size_raw = cmd_size - info_size;
+
+            if (is_delta)
+            {
+               RECV(delta_info, sizeof(delta_info))
+                  return false;
+               delta_info[0] = ntohl(delta_info[0]);
+               delta_info[1] = ntohl(delta_info[1]);
+               delta_info[2] = ntohl(delta_info[2]);
+            }
 
             if (state_size != netplay->state_size ||
                   state_size_raw > netplay->zbuffer_size)
@@ -6051,6 +6211,16 @@ static bool netplay_get_cmd(netplay_t *netplay,
             RECV(netplay->zbuffer, state_size_raw)
                return false;
 
+            /* A delta is only any good against the same base */
+            if (is_delta && (  !netplay->delta_base_valid
+                            || netplay->delta_base_frame != delta_info[0]
+                            || netplay->delta_base_crc   != delta_info[1]))
+            {
+               RARCH_WARN("[Netplay] Delta savestate base mismatch, requesting a full savestate.\n");
+               netplay_cmd_request_full_savestate(netplay);
+               break;
+            }
+
             switch (connection->compression_supported)
             {
                case NETPLAY_COMPRESSION_ZLIB:
@@ -6064,13 +6234,42 @@ static bool netplay_get_cmd(netplay_t *netplay,
             ctrans->decompression_backend->set_in(
                ctrans->decompression_stream,
                netplay->zbuffer, state_size_raw);
+            /* A delta is decoded on the side and only replaces
+             * the frame's state once its CRC checks out */
             ctrans->decompression_backend->set_out(
                ctrans->decompression_stream,
-               (uint8_t*)netplay->buffer[load_ptr].state, state_size);
+               is_delta
+                  ? netplay->delta_scratch
+                  : (uint8_t*)netplay->buffer[load_ptr].state,
+               state_size);
             ctrans->decompression_backend->trans(
                ctrans->decompression_stream,
                true, &rd, &wn, NULL);
 
+            if (is_delta)
+            {
+               uint8_t *state = netplay->delta_scratch;
+
+               for (i = 0; i < state_size; i++)
+                  state[i] ^= netplay->delta_base[i];
+
+               if (     wn != state_size
+                     || encoding_crc32(0L, state, state_size) != delta_info[2])
+               {
+                  RARCH_WARN("[Netplay] Delta savestate CRC mismatch, requesting a full savestate.\n");
+                  netplay_cmd_request_full_savestate(netplay);
+                  break;
+               }
+
+               memcpy(netplay->buffer[load_ptr].state, state, state_size);
+               netplay_delta_base_set(netplay, state, load_frame_count,
+                     delta_info[2]);
+            }
+            else if (connection->flags & NETPLAY_CONN_FLAG_DELTA_STATES)
+               netplay_delta_base_set(netplay, netplay->buffer[load_ptr].state,
+                     load_frame_count, netplay_delta_frame_crc(netplay,
+                        &netplay->buffer[load_ptr]));
+
             /* Force a rewind to the relevant frame. */
             netplay->force_rewind = true;
 
@@ -7018,6 +7217,15 @@ static bool netplay_init_serialization(netplay_t *netplay)
       return false;
    }
 
+   /* Sized with the states, so a delta always covers a whole state */
+   free(netplay->delta_base);
+   free(netplay->delta_scratch);
+   netplay->delta_base_valid = false;
+   netplay->delta_base       = (uint8_t*)malloc(netplay->state_size);
+   netplay->delta_scratch    = (uint8_t*)malloc(netplay->state_size);
+   if (!netplay->delta_base || !netplay->delta_scratch)
+      return false;
+
    return true;
 }
 
@@ -7161,6 +7369,8 @@ static void netplay_free(netplay_t *netplay)
    }
 
    free(netplay->zbuffer);
+   free(netplay->delta_base);
+   free(netplay->delta_scratch);
 
    if (netplay->compress_nil.compression_stream)
       netplay->compress_nil.compression_backend->stream_free(
@@ -7314,59 +7524,122 @@ failure:
    return NULL;
 }
 
+/**
+ * netplay_compress_savestate
+ * @netplay              : pointer to netplay object
+ * @data                 : state (or delta) to compress
+ * @size                 : size of @data
+ * @z                    : compression backend to use
+ * @wn                   : receives the compressed size
+ *
+ * Compress a savestate into the netplay zbuffer.
+ */
+static bool netplay_compress_savestate(netplay_t *netplay,
+   const uint8_t *data, size_t size,
+   struct compression_transcoder *z, uint32_t *wn)
+{
+   uint32_t rd;
+   z->compression_backend->set_in(z->compression_stream,
+      data, (uint32_t)size);
+   z->compression_backend->set_out(z->compression_stream,
+      netplay->zbuffer, (uint32_t)netplay->zbuffer_size);
+   return z->compression_backend->trans(z->compression_stream, true, &rd,
+         wn, NULL);
+}
+
 /**
  * netplay_send_savestate
  * @netplay              : pointer to netplay object
  * @serial_info          : the savestate being loaded
  * @cx                   : compression type
  * @z                    : compression backend to use
+ * @crc                  : CRC of the savestate, if delta peers exist
  *
  * Send a loaded savestate to those connected peers using the given compression
- * scheme.
+ * scheme. Peers holding our delta base get the XOR against it instead, which
+ * is mostly zeroes and compresses to a fraction of the full state.
  */
 static void netplay_send_savestate(netplay_t *netplay,
    retro_ctx_serialize_info_t *serial_info, uint32_t cx,
-   struct compression_transcoder *z)
+   struct compression_transcoder *z, uint32_t crc)
 {
-   uint32_t header[4];
-   uint32_t rd, wn;
-   size_t i;
+   uint32_t header[7];
+   uint32_t wn;
+   size_t i, j;
+   unsigned pass;
+   const uint8_t *state = (const uint8_t*)serial_info->data_const;
+   bool can_delta       =  netplay->is_server
+                        && netplay->delta_base_valid
+                        && serial_info->size == netplay->state_size;
 
-   /* Compress it */
-   z->compression_backend->set_in(z->compression_stream,
-      (const uint8_t*)serial_info->data_const, (uint32_t)serial_info->size);
-   z->compression_backend->set_out(z->compression_stream,
-      netplay->zbuffer, (uint32_t)netplay->zbuffer_size);
-   if (!z->compression_backend->trans(z->compression_stream, true, &rd,
-         &wn, NULL))
+   /* Full states first, then deltas. Each is only built if someone needs it */
+   for (pass = 0; pass < 2; pass++)
    {
-      /* Catastrophe! */
+      bool delta    = (pass == 1);
+      bool ready    = false;
+      size_t hsize  = 0;
+
       for (i = 0; i < netplay->connections_size; i++)
-         netplay_hangup(netplay, &netplay->connections[i]);
-      return;
-   }
+      {
+         struct netplay_connection *connection = &netplay->connections[i];
+         bool conn_delta;
 
-   /* Send it to relevant peers */
-   header[0] = htonl(NETPLAY_CMD_LOAD_SAVESTATE);
-   header[1] = htonl(wn + 2*sizeof(uint32_t));
-   header[2] = htonl(netplay->run_frame_count);
-   header[3] = htonl(serial_info->size);
+         if (  (!(connection->flags & NETPLAY_CONN_FLAG_ACTIVE))
+             ||  (connection->mode  < NETPLAY_CONNECTION_CONNECTED)
+             ||  (connection->compression_supported != cx))
+            continue;
 
-   for (i = 0; i < netplay->connections_size; i++)
-   {
-      struct netplay_connection *connection = &netplay->connections[i];
-      if (  (!(connection->flags & NETPLAY_CONN_FLAG_ACTIVE))
-          ||  (connection->mode  < NETPLAY_CONNECTION_CONNECTED)
-          ||  (connection->compression_supported != cx))
-         continue;
+         conn_delta = can_delta
+            && (connection->flags & NETPLAY_CONN_FLAG_DELTA_STATES)
+            && (connection->flags & NETPLAY_CONN_FLAG_DELTA_BASE);
+         if (conn_delta != delta)
+            continue;
 
-      if (   !netplay_send(&connection->send_packet_buffer,
-               connection->fd, header,
-               sizeof(header))
-          || !netplay_send(&connection->send_packet_buffer,
-             connection->fd,
-             netplay->zbuffer, wn))
-         netplay_hangup(netplay, connection);
+         if (!ready)
+         {
+            const uint8_t *src = state;
+
+            if (delta)
+            {
+               for (j = 0; j < serial_info->size; j++)
+                  netplay->delta_scratch[j] = state[j]
+                     ^ netplay->delta_base[j];
+               src = netplay->delta_scratch;
+            }
+
+            if (!netplay_compress_savestate(netplay, src,
+                     serial_info->size, z, &wn))
+            {
+               /* Catastrophe! */
+               for (j = 0; j < netplay->connections_size; j++)
+                  netplay_hangup(netplay, &netplay->connections[j]);
+               return;
+            }
+
+            header[0] = htonl(delta
+                  ? NETPLAY_CMD_LOAD_SAVESTATE_DELTA
+                  : NETPLAY_CMD_LOAD_SAVESTATE);
+            header[2] = htonl(netplay->run_frame_count);
+            header[3] = htonl(serial_info->size);
+            hsize     = 4 * sizeof(uint32_t);
+            if (delta)
+            {
+               header[4] = htonl(netplay->delta_base_frame);
+               header[5] = htonl(netplay->delta_base_crc);
+               header[6] = htonl(crc);
+               hsize     = 7 * sizeof(uint32_t);
+            }
+            header[1] = htonl(wn + hsize - 2*sizeof(uint32_t));
+            ready     = true;
+         }
+
+         if (   !netplay_send(&connection->send_packet_buffer,
+                  connection->fd, header, hsize)
+             || !netplay_send(&connection->send_packet_buffer,
+                connection->fd,
+                netplay->zbuffer, wn))
+            netplay_hangup(netplay, connection);
+      }
    }
 }
 
@@ -7542,13 +7815,39 @@ void netplay_load_savestate(netplay_t *netplay,
    /* Don't send it if we're expected to be desynced. */
    if (!netplay->desync)
    {
+      uint32_t crc     = 0;
+      bool delta_peers =    netplay->is_server
+                         && serial_info->size == netplay->state_size
+                         && netplay_has_delta_peers(netplay);
+
+      if (delta_peers)
+         crc = encoding_crc32(0L,
+               (const unsigned char*)serial_info->data_const,
+               serial_info->size);
+
       /* Send this to every peer. */
       if (netplay->compress_nil.compression_backend)
          netplay_send_savestate(netplay, serial_info, 0,
-            &netplay->compress_nil);
+            &netplay->compress_nil, crc);
       if (netplay->compress_zlib.compression_backend)
          netplay_send_savestate(netplay, serial_info, NETPLAY_COMPRESSION_ZLIB,
-            &netplay->compress_zlib);
+            &netplay->compress_zlib, crc);
+
+      /* Everyone now holds this state, so it is the next delta base */
+      if (delta_peers)
+      {
+         size_t i;
+         netplay_delta_base_set(netplay, serial_info->data_const,
+               netplay->run_frame_count, crc);
+         for (i = 0; i < netplay->connections_size; i++)
+         {
+            struct netplay_connection *connection = &netplay->connections[i];
+            if (     (connection->flags & NETPLAY_CONN_FLAG_ACTIVE)
+                  && (connection->flags & NETPLAY_CONN_FLAG_DELTA_STATES)
+                  && (connection->mode  >= NETPLAY_CONNECTION_CONNECTED))
+               connection->flags |= NETPLAY_CONN_FLAG_DELTA_BASE;
+         }
+      }
    }
 }
 
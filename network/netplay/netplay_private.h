@@ -73,8 +73,12 @@
 
 /* Compression protocols supported */
 #define NETPLAY_COMPRESSION_ZLIB (1<<0)
+/* Not a compression scheme of its own: savestates may be sent as the
+ * XOR against a state both sides confirmed by CRC, which then compresses
+ * to almost nothing. Only worth it together with zlib. */
+#define NETPLAY_COMPRESSION_DELTA (1<<1)
 #if HAVE_ZLIB
-#define NETPLAY_COMPRESSION_SUPPORTED NETPLAY_COMPRESSION_ZLIB
+#define NETPLAY_COMPRESSION_SUPPORTED (NETPLAY_COMPRESSION_ZLIB | NETPLAY_COMPRESSION_DELTA)
 #else
 #define NETPLAY_COMPRESSION_SUPPORTED 0
 #endif
@@ -165,6 +169,15 @@ enum netplay_cmd
    /* Send a network packet from the raw packet core interface */
    NETPLAY_CMD_NETPACKET      = 0x0048,
 
+   /* Send a savestate as a delta against the last confirmed state */
+   NETPLAY_CMD_LOAD_SAVESTATE_DELTA = 0x0049,
+
+   /* Tell the server a CRC matched, making that frame a delta base */
+   NETPLAY_CMD_CRC_CONFIRM    = 0x004A,
+
+   /* Request a savestate that does not depend on a delta base */
+   NETPLAY_CMD_REQUEST_FULL_SAVESTATE = 0x004B,
+
    /* Misc. commands */
 
    /* Sends multiple config requests over,
@@ -364,7 +377,11 @@ enum netplay_connection_flags
    /* Is this connection allowed to play (server only)? */
    NETPLAY_CONN_FLAG_CAN_PLAY       = (1 << 2),
    /* Did we request a ping response? */
-   NETPLAY_CONN_FLAG_PING_REQUESTED = (1 << 3)
+   NETPLAY_CONN_FLAG_PING_REQUESTED = (1 << 3),
+   /* Does this peer understand delta savestates? */
+   NETPLAY_CONN_FLAG_DELTA_STATES   = (1 << 4),
+   /* Does this peer hold our delta base (server only)? */
+   NETPLAY_CONN_FLAG_DELTA_BASE     = (1 << 5)
 };
 
 /* Each connection gets a connection struct */
@@ -522,6 +539,12 @@ struct netplay
    /* A buffer into which to compress frames for transfer */
    uint8_t *zbuffer;
 
+   /* Last state both sides agreed on, the base for delta savestates,
+    * and a scratch buffer to build (server) or decode (client) deltas.
+    * Both are state_size bytes, allocated with the frame states. */
+   uint8_t *delta_base;
+   uint8_t *delta_scratch;
+
    size_t connections_size;
    size_t buffer_size;
    size_t zbuffer_size;
@@ -594,6 +617,10 @@ struct netplay
    /* Frequency with which to check CRCs */
    uint32_t check_frames;
 
+   /* Frame and CRC of delta_base */
+   uint32_t delta_base_frame;
+   uint32_t delta_base_crc;
+
    /* How far behind did we fall? */
    uint32_t catch_up_behind;
 
@@ -656,6 +683,9 @@ struct netplay
    /* Are they valid? */
    bool crcs_valid;
 
+   /* Does delta_base hold a state? */
+   bool delta_base_valid;
+
    /* Netplay pausing */
    bool local_paused;
    bool remote_paused;
@@ -22,14 +22,17 @@
 #include <libretro.h>
 #include <boolean.h>
 #include <retro_miscellaneous.h>
+#include <retro_endianness.h>
 #include <compat/posix_string.h>
 #include <string/stdstring.h>
 #include <streams/interface_stream.h>
+#include <streams/file_stream.h>
 #include <file/file_path.h>
 #include <file/archive_file.h>
 #include <lists/string_list.h>
 #include <formats/rjson.h>
 #include <array/rbuf.h>
+#include <array/rhmap.h>
 
 #include "playlist.h"
 #include "verbosity.h"
@@ -47,6 +50,12 @@
 #define WINDOWS_PATH_DELIMITER '\\'
 #define POSIX_PATH_DELIMITER '/'
 
+/* Binary playlist cache, see playlist_cache_read() */
+#define PLAYLIST_CACHE_MAGIC       "RARCHPLC"
+#define PLAYLIST_CACHE_VERSION     2
+/* Smaller playlists parse quickly enough as they are */
+#define PLAYLIST_CACHE_MIN_ENTRIES 256
+
 /* Holds all configuration parameters required
  * to repeat a manual content scan for a
  * previously manual-scan-generated playlist */
@@ -66,9 +75,29 @@ enum content_playlist_flags
    CNT_PLAYLIST_FLG_MOD        = (1 << 0),
    CNT_PLAYLIST_FLG_OLD_FMT    = (1 << 1),
    CNT_PLAYLIST_FLG_COMPRESSED = (1 << 2),
-   CNT_PLAYLIST_FLG_CACHED_EXT = (1 << 3)
+   CNT_PLAYLIST_FLG_CACHED_EXT = (1 << 3),
+   CNT_PLAYLIST_FLG_INDEXED    = (1 << 4)
 };
 
+/* Entry strings are carved out of a chain of large blocks
+ * rather than allocated one by one. Blocks never move, so the
+ * char pointers in struct playlist_entry stay valid; strings
+ * that are replaced or deleted are counted as dead and only
+ * reclaimed when playlist_write_file() compacts the arena
+ * (or by playlist_clear()). */
+typedef struct playlist_str_block
+{
+   struct playlist_str_block *next;
+   char *data;
+   size_t size;
+   size_t used;
+} playlist_str_block_t;
+
+#define PLAYLIST_STR_BLOCK_SIZE (64 * 1024)
+
+/* Number of string fields in struct playlist_entry */
+#define PLAYLIST_ENTRY_STRINGS 10
+
 struct content_playlist
 {
    char *default_core_path;
@@ -76,6 +105,10 @@ struct content_playlist
    char *base_content_directory;
 
    struct playlist_entry *entries;
+   playlist_str_block_t *str_blocks;
+   size_t str_dead;                           /* replaced arena bytes */
+   uint32_t *index_buckets;                   /* see playlist_index_find() */
+   uint32_t *index_links;
 
    playlist_manual_scan_record_t scan_record; /* ptr alignment */
    playlist_config_t config;                  /* size_t alignment */
@@ -100,6 +133,7 @@ enum json_ctx_flags
 typedef struct
 {
    struct playlist_entry *current_entry;
+   struct playlist_entry *prev_entry;
    char **current_string_val;
    unsigned *current_entry_uint_val;
    enum playlist_label_display_mode *current_meta_label_display_mode_val;
@@ -571,37 +605,210 @@ void playlist_get_index(playlist_t *playlist,
    *entry = &playlist->entries[idx];
 }
 
+/* Returns a copy of 'str' in the playlist string arena,
+ * or NULL if 'str' is NULL or allocation fails */
+static char *playlist_strdup(playlist_t *playlist, const char *str)
+{
+   char *dst;
+   size_t _len;
+   playlist_str_block_t *block;
+
+   if (!str)
+      return NULL;
+
+   _len  = strlen(str) + 1;
+   block = playlist->str_blocks;
+
+   if (!block || block->size - block->used < _len)
+   {
+      size_t size = (_len > PLAYLIST_STR_BLOCK_SIZE)
+         ? _len : PLAYLIST_STR_BLOCK_SIZE;
+
+      if (!(block = (playlist_str_block_t*)malloc(
+                  sizeof(*block) + size)))
+         return NULL;
+
+      block->data          = (char*)(block + 1);
+      block->size          = size;
+      block->used          = 0;
+      block->next          = playlist->str_blocks;
+      playlist->str_blocks = block;
+   }
+
+   dst          = block->data + block->used;
+   block->used += _len;
+   memcpy(dst, str, _len);
+   return dst;
+}
+
+/* Hands a malloc'd buffer that entry strings point into
+ * over to the string arena */
+static bool playlist_str_adopt(playlist_t *playlist, void *buf, size_t size)
+{
+   playlist_str_block_t *block = (playlist_str_block_t*)
+      malloc(sizeof(*block));
+
+   if (!block)
+      return false;
+
+   block->data = (char*)buf;
+   block->size = size;
+   block->used = size;
+
+   /* Keep the current block in front, it may still have room */
+   if (playlist->str_blocks)
+   {
+      block->next                = playlist->str_blocks->next;
+      playlist->str_blocks->next = block;
+   }
+   else
+   {
+      block->next                = NULL;
+      playlist->str_blocks       = block;
+   }
+
+   return true;
+}
+
+static void playlist_str_free(playlist_t *playlist)
+{
+   playlist_str_block_t *block = playlist->str_blocks;
+
+   while (block)
+   {
+      playlist_str_block_t *next = block->next;
+      if (block->data != (char*)(block + 1))
+         free(block->data);
+      free(block);
+      block = next;
+   }
+
+   playlist->str_blocks = NULL;
+   playlist->str_dead   = 0;
+}
+
+static void playlist_entry_strings(struct playlist_entry *entry,
+      char **fields[PLAYLIST_ENTRY_STRINGS])
+{
+   fields[0] = &entry->path;
+   fields[1] = &entry->label;
+   fields[2] = &entry->core_path;
+   fields[3] = &entry->core_name;
+   fields[4] = &entry->db_name;
+   fields[5] = &entry->crc32;
+   fields[6] = &entry->subsystem_ident;
+   fields[7] = &entry->subsystem_name;
+   fields[8] = &entry->runtime_str;
+   fields[9] = &entry->last_played_str;
+}
+
+/* Points '*field' at a copy of 'str'. The current string is
+ * kept if it is equal, otherwise it is counted as dead.
+ * Returns true if the field changed. */
+static bool playlist_str_replace(playlist_t *playlist,
+      char **field, const char *str)
+{
+   if (*field == str || (*field && str && string_is_equal(*field, str)))
+      return false;
+
+   if (*field)
+      playlist->str_dead += strlen(*field) + 1;
+   *field = playlist_strdup(playlist, str);
+   return true;
+}
+
+static void playlist_str_release(playlist_t *playlist,
+      struct playlist_entry *entry)
+{
+   size_t i;
+   char **fields[PLAYLIST_ENTRY_STRINGS];
+
+   playlist_entry_strings(entry, fields);
+   for (i = 0; i < PLAYLIST_ENTRY_STRINGS; i++)
+      if (*fields[i])
+         playlist->str_dead += strlen(*fields[i]) + 1;
+}
+
+/* Copies all live strings into a fresh arena once more than
+ * half of it is dead. This moves every entry string, so it
+ * must only run where no caller holds on to entry pointers
+ * (i.e. when the playlist is written). Strings shared with the
+ * previous entry by the loaders stay shared. */
+static void playlist_str_compact(playlist_t *playlist)
+{
+   size_t i, j, len;
+   size_t total                = 0;
+   playlist_str_block_t *old   = playlist->str_blocks;
+   playlist_str_block_t *block;
+   char *prev_old[PLAYLIST_ENTRY_STRINGS];
+   char *prev_new[PLAYLIST_ENTRY_STRINGS];
+
+   for (block = old; block; block = block->next)
+      total += block->used;
+
+   if (     playlist->str_dead < PLAYLIST_STR_BLOCK_SIZE
+         || playlist->str_dead < total / 2)
+      return;
+
+   memset(prev_old, 0, sizeof(prev_old));
+   memset(prev_new, 0, sizeof(prev_new));
+   playlist->str_blocks = NULL;
+
+   for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
+   {
+      char **fields[PLAYLIST_ENTRY_STRINGS];
+
+      playlist_entry_strings(&playlist->entries[i], fields);
+      for (j = 0; j < PLAYLIST_ENTRY_STRINGS; j++)
+      {
+         char *str = *fields[j];
+         char *dst;
+
+         if (!str)
+            continue;
+
+         if (str == prev_old[j])
+            dst = prev_new[j];
+         else if (!(dst = playlist_strdup(playlist, str)))
+            goto error;
+
+         prev_old[j] = str;
+         prev_new[j] = dst;
+         *fields[j]  = dst;
+      }
+   }
+
+   block                = playlist->str_blocks;
+   playlist->str_blocks = old;
+   playlist_str_free(playlist);
+   playlist->str_blocks = block;
+   return;
+
+error:
+   /* Out of memory: entries now point into both chains,
+    * keep them all and try again on the next write */
+   if ((block = playlist->str_blocks))
+   {
+      while (block->next)
+         block = block->next;
+      block->next       = old;
+   }
+   else
+      playlist->str_blocks = old;
+}
+
 /**
  * playlist_free_entry:
  * @entry               : Playlist entry handle.
  *
- * Frees playlist entry.
+ * Frees playlist entry. Its strings belong to the
+ * playlist string arena and are left alone.
  **/
 static void playlist_free_entry(struct playlist_entry *entry)
 {
    if (!entry)
       return;
 
-   if (entry->path)
-      free(entry->path);
-   if (entry->label)
-      free(entry->label);
-   if (entry->core_path)
-      free(entry->core_path);
-   if (entry->core_name)
-      free(entry->core_name);
-   if (entry->db_name)
-      free(entry->db_name);
-   if (entry->crc32)
-      free(entry->crc32);
-   if (entry->subsystem_ident)
-      free(entry->subsystem_ident);
-   if (entry->subsystem_name)
-      free(entry->subsystem_name);
-   if (entry->runtime_str)
-      free(entry->runtime_str);
-   if (entry->last_played_str)
-      free(entry->last_played_str);
    if (entry->subsystem_roms)
       string_list_free(entry->subsystem_roms);
    if (entry->path_id)
@@ -632,6 +839,173 @@ static void playlist_free_entry(struct playlist_entry *entry)
    entry->last_played_second = 0;
 }
 
+/* Path index
+ *
+ * Hash table over the path ID hashes of all entries, so that
+ * looking up a path does not have to compare it with every
+ * entry. Each entry has two nodes, one for its 'real' path and
+ * one for its parent archive path (if any); node 'n' belongs to
+ * the entry (n >> 1) places from the bottom of the playlist.
+ * Counting from the bottom means that pushing a new entry to
+ * the top leaves all other nodes alone, so the index can be
+ * kept up to date while scanning. Anything else that moves or
+ * changes entries just drops the index, and the next lookup
+ * rebuilds it. */
+#define PLAYLIST_INDEX_NODE_REAL    0
+#define PLAYLIST_INDEX_NODE_ARCHIVE 1
+
+static void playlist_index_link(playlist_t *playlist,
+      uint32_t node, uint32_t hash)
+{
+   size_t bucket = hash & (RBUF_LEN(playlist->index_buckets) - 1);
+   playlist->index_links[node]     = playlist->index_buckets[bucket];
+   playlist->index_buckets[bucket] = node + 1;
+}
+
+static void playlist_index_add(playlist_t *playlist, size_t idx)
+{
+   playlist_path_id_t *path_id = playlist->entries[idx].path_id;
+   uint32_t node               = (uint32_t)
+      (RBUF_LEN(playlist->entries) - 1 - idx) << 1;
+
+   playlist_index_link(playlist, node | PLAYLIST_INDEX_NODE_REAL,
+         path_id->real_path_hash);
+   if (path_id->archive_path)
+      playlist_index_link(playlist, node | PLAYLIST_INDEX_NODE_ARCHIVE,
+            path_id->archive_path_hash);
+}
+
+static bool playlist_index_build(playlist_t *playlist)
+{
+   size_t i;
+   size_t len     = RBUF_LEN(playlist->entries);
+   size_t nodes   = len * 2;
+   size_t buckets = 64;
+
+   /* Keep the table at most half full */
+   while (buckets < nodes * 2)
+      buckets <<= 1;
+
+   for (i = 0; i < len; i++)
+   {
+      struct playlist_entry *entry = &playlist->entries[i];
+      if (     !entry->path_id
+            && !(entry->path_id = playlist_path_id_init(entry->path)))
+         return false;
+   }
+
+   RBUF_CLEAR(playlist->index_buckets);
+   RBUF_CLEAR(playlist->index_links);
+   if (     !RBUF_TRYFIT(playlist->index_buckets, buckets)
+         || !RBUF_TRYFIT(playlist->index_links, nodes))
+      return false;
+   RBUF_RESIZE(playlist->index_buckets, buckets);
+   RBUF_RESIZE(playlist->index_links, nodes);
+   memset(playlist->index_buckets, 0, buckets * sizeof(uint32_t));
+
+   for (i = 0; i < len; i++)
+      playlist_index_add(playlist, i);
+
+   playlist->flags |= CNT_PLAYLIST_FLG_INDEXED;
+   return true;
+}
+
+/* Called after a new entry has been pushed to the top */
+static void playlist_index_push(playlist_t *playlist)
+{
+   size_t nodes = RBUF_LEN(playlist->entries) * 2;
+
+   if (!(playlist->flags & CNT_PLAYLIST_FLG_INDEXED))
+      return;
+
+   if (     nodes * 2 > RBUF_LEN(playlist->index_buckets)
+         || !RBUF_TRYFIT(playlist->index_links, nodes))
+   {
+      playlist->flags &= ~CNT_PLAYLIST_FLG_INDEXED;
+      return;
+   }
+
+   RBUF_RESIZE(playlist->index_links, nodes);
+   playlist_index_add(playlist, 0);
+}
+
+static void playlist_index_collect(playlist_t *playlist,
+      uint32_t hash, unsigned type, size_t **matches)
+{
+   size_t len    = RBUF_LEN(playlist->entries);
+   uint32_t node = playlist->index_buckets[
+      hash & (RBUF_LEN(playlist->index_buckets) - 1)];
+
+   while (node--)
+   {
+      size_t idx                  = len - 1 - (node >> 1);
+      playlist_path_id_t *path_id = playlist->entries[idx].path_id;
+
+      if (     (node & 1) == type
+            && hash == ((type == PLAYLIST_INDEX_NODE_REAL)
+                  ? path_id->real_path_hash
+                  : path_id->archive_path_hash))
+      {
+         /* Insert in playlist order, an entry can turn up twice */
+         size_t i = RBUF_LEN(*matches);
+         while (i > 0 && (*matches)[i - 1] > idx)
+            i--;
+         if (i == 0 || (*matches)[i - 1] != idx)
+         {
+            RBUF_PUSH(*matches, idx);
+            memmove(*matches + i + 1, *matches + i,
+                  (RBUF_LEN(*matches) - 1 - i) * sizeof(size_t));
+            (*matches)[i] = idx;
+         }
+      }
+
+      node = playlist->index_links[node];
+   }
+}
+
+/**
+ * playlist_index_find:
+ * @playlist            : Playlist handle.
+ * @path_id             : Path identity to look up.
+ *
+ * Finds the entries that may match @path_id, i.e. those
+ * sharing its 'real' path hash or, with fuzzy archive matching,
+ * its parent archive path hash. The caller still has to compare
+ * them with playlist_path_matches_entry().
+ *
+ * Returns: RBUF of entry indices in playlist order,
+ * to be freed with RBUF_FREE().
+ **/
+static size_t *playlist_index_find(playlist_t *playlist,
+      playlist_path_id_t *path_id)
+{
+   size_t *matches = NULL;
+
+   if (     !(playlist->flags & CNT_PLAYLIST_FLG_INDEXED)
+         && !playlist_index_build(playlist))
+   {
+      /* Out of memory - check every entry instead */
+      size_t i, len = RBUF_LEN(playlist->entries);
+      for (i = 0; i < len; i++)
+         RBUF_PUSH(matches, i);
+      return matches;
+   }
+
+   playlist_index_collect(playlist, path_id->real_path_hash,
+         PLAYLIST_INDEX_NODE_REAL, &matches);
+
+#ifdef RARCH_INTERNAL
+   if (playlist->config.fuzzy_archive_match)
+#endif
+   {
+      if (path_id->archive_path)
+         playlist_index_collect(playlist, path_id->archive_path_hash,
+               PLAYLIST_INDEX_NODE_ARCHIVE, &matches);
+   }
+
+   return matches;
+}
+
 /**
  * playlist_delete_index:
  * @playlist            : Playlist handle.
@@ -655,7 +1029,10 @@ void playlist_delete_index(playlist_t *playlist,
    /* Free unwanted entry */
    entry_to_delete = (struct playlist_entry *)(playlist->entries + idx);
    if (entry_to_delete)
+   {
+      playlist_str_release(playlist, entry_to_delete);
       playlist_free_entry(entry_to_delete);
+   }
 
    /* Shift remaining entries to fill the gap */
    memmove(playlist->entries + idx, playlist->entries + idx + 1,
@@ -664,6 +1041,7 @@ void playlist_delete_index(playlist_t *playlist,
    RBUF_RESIZE(playlist->entries, len - 1);
 
    playlist->flags |= CNT_PLAYLIST_FLG_MOD;
+   playlist->flags &= ~CNT_PLAYLIST_FLG_INDEXED;
 }
 
 /**
@@ -678,7 +1056,8 @@ void playlist_delete_by_path(playlist_t *playlist,
       const char *search_path)
 {
    playlist_path_id_t *path_id = NULL;
-   size_t i                    = 0;
+   size_t *matches             = NULL;
+   size_t i;
 
    if (!playlist || string_is_empty(search_path))
       return;
@@ -686,22 +1065,18 @@ void playlist_delete_by_path(playlist_t *playlist,
    if (!(path_id = playlist_path_id_init(search_path)))
       return;
 
-   while (i < RBUF_LEN(playlist->entries))
-   {
-      if (!playlist_path_matches_entry(path_id,
-            &playlist->entries[i], &playlist->config))
-      {
-         i++;
-         continue;
-      }
-
-      /* Paths are equal - delete entry */
-      playlist_delete_index(playlist, i);
+   matches = playlist_index_find(playlist, path_id);
 
-      /* Entries are shifted up by the delete
-       * operation - *do not* increment i */
+   /* Go from the bottom up, so that deleting an entry
+    * does not shift the ones still to be checked */
+   for (i = RBUF_LEN(matches); i-- > 0; )
+   {
+      if (playlist_path_matches_entry(path_id,
+            &playlist->entries[matches[i]], &playlist->config))
+         playlist_delete_index(playlist, matches[i]);
    }
 
+   RBUF_FREE(matches);
    playlist_path_id_free(path_id);
 }
 
@@ -710,7 +1085,8 @@ void playlist_get_index_by_path(playlist_t *playlist,
       const struct playlist_entry **entry)
 {
    playlist_path_id_t *path_id = NULL;
-   size_t i, len;
+   size_t *matches             = NULL;
+   size_t i;
 
    if (!playlist || !entry || string_is_empty(search_path))
       return;
@@ -718,16 +1094,19 @@ void playlist_get_index_by_path(playlist_t *playlist,
    if (!(path_id = playlist_path_id_init(search_path)))
       return;
 
-   for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
+   matches = playlist_index_find(playlist, path_id);
+
+   for (i = 0; i < RBUF_LEN(matches); i++)
    {
       if (!playlist_path_matches_entry(path_id,
-            &playlist->entries[i], &playlist->config))
+            &playlist->entries[matches[i]], &playlist->config))
          continue;
 
-      *entry = &playlist->entries[i];
+      *entry = &playlist->entries[matches[i]];
       break;
    }
 
+   RBUF_FREE(matches);
    playlist_path_id_free(path_id);
 }
 
@@ -735,7 +1114,9 @@ bool playlist_entry_exists(playlist_t *playlist,
       const char *path)
 {
    playlist_path_id_t *path_id = NULL;
-   size_t i, len;
+   size_t *matches             = NULL;
+   bool found                  = false;
+   size_t i;
 
    if (!playlist || string_is_empty(path))
       return false;
@@ -743,18 +1124,21 @@ bool playlist_entry_exists(playlist_t *playlist,
    if (!(path_id = playlist_path_id_init(path)))
       return false;
 
-   for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
+   matches = playlist_index_find(playlist, path_id);
+
+   for (i = 0; i < RBUF_LEN(matches); i++)
    {
       if (playlist_path_matches_entry(path_id,
-            &playlist->entries[i], &playlist->config))
+            &playlist->entries[matches[i]], &playlist->config))
       {
-         playlist_path_id_free(path_id);
-         return true;
+         found = true;
+         break;
       }
    }
 
+   RBUF_FREE(matches);
    playlist_path_id_free(path_id);
-   return false;
+   return found;
 }
 
 void playlist_update(playlist_t *playlist, size_t idx,
@@ -767,58 +1151,53 @@ void playlist_update(playlist_t *playlist, size_t idx,
 
    entry            = &playlist->entries[idx];
 
-   if (update_entry->path && (update_entry->path != entry->path))
+   if (     update_entry->path
+         && playlist_str_replace(playlist, &entry->path,
+            update_entry->path))
    {
-      if (entry->path)
-         free(entry->path);
-      entry->path        = strdup(update_entry->path);
-
       if (entry->path_id)
       {
          playlist_path_id_free(entry->path_id);
          entry->path_id  = NULL;
       }
 
+      playlist->flags   &= ~CNT_PLAYLIST_FLG_INDEXED;
+
       playlist->flags |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->label && (update_entry->label != entry->label))
+   if (     update_entry->label
+         && playlist_str_replace(playlist, &entry->label,
+            update_entry->label))
    {
-      if (entry->label)
-         free(entry->label);
-      entry->label       = strdup(update_entry->label);
       playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->core_path && (update_entry->core_path != entry->core_path))
+   if (     update_entry->core_path
+         && playlist_str_replace(playlist, &entry->core_path,
+            update_entry->core_path))
    {
-      if (entry->core_path)
-         free(entry->core_path);
-      entry->core_path   = strdup(update_entry->core_path);
       playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->core_name && (update_entry->core_name != entry->core_name))
+   if (     update_entry->core_name
+         && playlist_str_replace(playlist, &entry->core_name,
+            update_entry->core_name))
    {
-      if (entry->core_name)
-         free(entry->core_name);
-      entry->core_name   = strdup(update_entry->core_name);
       playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->db_name && (update_entry->db_name != entry->db_name))
+   if (     update_entry->db_name
+         && playlist_str_replace(playlist, &entry->db_name,
+            update_entry->db_name))
    {
-      if (entry->db_name)
-         free(entry->db_name);
-      entry->db_name     = strdup(update_entry->db_name);
       playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->crc32 && (update_entry->crc32 != entry->crc32))
+   if (     update_entry->crc32
+         && playlist_str_replace(playlist, &entry->crc32,
+            update_entry->crc32))
    {
-      if (entry->crc32)
-         free(entry->crc32);
-      entry->crc32       = strdup(update_entry->crc32);
       playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 }
@@ -834,27 +1213,26 @@ void playlist_update_runtime(playlist_t *playlist, size_t idx,
 
    entry            = &playlist->entries[idx];
 
-   if (update_entry->path && (update_entry->path != entry->path))
+   if (     update_entry->path
+         && playlist_str_replace(playlist, &entry->path,
+            update_entry->path))
    {
-      if (entry->path)
-         free(entry->path);
-      entry->path        = strdup(update_entry->path);
-
       if (entry->path_id)
       {
          playlist_path_id_free(entry->path_id);
          entry->path_id  = NULL;
       }
 
+      playlist->flags   &= ~CNT_PLAYLIST_FLG_INDEXED;
+
       if (register_update)
          playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->core_path && (update_entry->core_path != entry->core_path))
+   if (     update_entry->core_path
+         && playlist_str_replace(playlist, &entry->core_path,
+            update_entry->core_path))
    {
-      if (entry->core_path)
-         free(entry->core_path);
-      entry->core_path      = strdup(update_entry->core_path);
       if (register_update)
          playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
@@ -929,21 +1307,18 @@ void playlist_update_runtime(playlist_t *playlist, size_t idx,
          playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->runtime_str && (update_entry->runtime_str != entry->runtime_str))
+   if (     update_entry->runtime_str
+         && playlist_str_replace(playlist, &entry->runtime_str,
+            update_entry->runtime_str))
    {
-      if (entry->runtime_str)
-         free(entry->runtime_str);
-      entry->runtime_str    = strdup(update_entry->runtime_str);
       if (register_update)
          playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    }
 
-   if (update_entry->last_played_str && (update_entry->last_played_str != entry->last_played_str))
+   if (     update_entry->last_played_str
+         && playlist_str_replace(playlist, &entry->last_played_str,
+            update_entry->last_played_str))
    {
-      if (entry->last_played_str)
-         free(entry->last_played_str);
-      entry->last_played_str = NULL;
-      entry->last_played_str = strdup(update_entry->last_played_str);
       if (register_update)
          playlist->flags    |= CNT_PLAYLIST_FLG_MOD;
    }
@@ -953,7 +1328,8 @@ bool playlist_push_runtime(playlist_t *playlist,
       const struct playlist_entry *entry)
 {
    playlist_path_id_t *path_id = NULL;
-   size_t i, len;
+   size_t *matches             = NULL;
+   size_t i, j, len;
    char real_core_path[PATH_MAX_LENGTH];
 
    if (!playlist || !entry)
@@ -982,11 +1358,15 @@ bool playlist_push_runtime(playlist_t *playlist,
       goto error;
    }
 
-   len = RBUF_LEN(playlist->entries);
-   for (i = 0; i < len; i++)
+   len     = RBUF_LEN(playlist->entries);
+   matches = playlist_index_find(playlist, path_id);
+   for (j = 0; j < RBUF_LEN(matches); j++)
    {
       struct playlist_entry tmp;
-      bool equal_path  = (string_is_empty(path_id->real_path)
+      bool equal_path;
+
+      i                = matches[j];
+      equal_path       = (string_is_empty(path_id->real_path)
             && string_is_empty(playlist->entries[i].path));
 
       equal_path       = equal_path || playlist_path_matches_entry(
@@ -1010,6 +1390,7 @@ bool playlist_push_runtime(playlist_t *playlist,
       memmove(playlist->entries + 1, playlist->entries,
             i * sizeof(struct playlist_entry));
       playlist->entries[0] = tmp;
+      playlist->flags     &= ~CNT_PLAYLIST_FLG_INDEXED;
 
       goto success;
    }
@@ -1020,7 +1401,9 @@ bool playlist_push_runtime(playlist_t *playlist,
    if (len == playlist->config.capacity)
    {
       struct playlist_entry *last_entry = &playlist->entries[len - 1];
+      playlist_str_release(playlist, last_entry);
       playlist_free_entry(last_entry);
+      playlist->flags                  &= ~CNT_PLAYLIST_FLG_INDEXED;
       len--;
    }
    else
@@ -1040,12 +1423,12 @@ bool playlist_push_runtime(playlist_t *playlist,
       playlist->entries[0].core_path          = NULL;
 
       if (!string_is_empty(path_id->real_path))
-         playlist->entries[0].path            = strdup(path_id->real_path);
+         playlist->entries[0].path            = playlist_strdup(playlist, path_id->real_path);
       playlist->entries[0].path_id            = path_id;
       path_id                                 = NULL;
 
       if (!string_is_empty(real_core_path))
-         playlist->entries[0].core_path       = strdup(real_core_path);
+         playlist->entries[0].core_path       = playlist_strdup(playlist, real_core_path);
 
       playlist->entries[0].runtime_status     = entry->runtime_status;
       playlist->entries[0].runtime_hours      = entry->runtime_hours;
@@ -1062,18 +1445,22 @@ bool playlist_push_runtime(playlist_t *playlist,
       playlist->entries[0].last_played_str    = NULL;
 
       if (!string_is_empty(entry->runtime_str))
-         playlist->entries[0].runtime_str     = strdup(entry->runtime_str);
+         playlist->entries[0].runtime_str     = playlist_strdup(playlist, entry->runtime_str);
       if (!string_is_empty(entry->last_played_str))
-         playlist->entries[0].last_played_str = strdup(entry->last_played_str);
+         playlist->entries[0].last_played_str = playlist_strdup(playlist, entry->last_played_str);
+
+      playlist_index_push(playlist);
    }
 
 success:
+   RBUF_FREE(matches);
    if (path_id)
       playlist_path_id_free(path_id);
    playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    return true;
 
 error:
+   RBUF_FREE(matches);
    if (path_id)
       playlist_path_id_free(path_id);
    return false;
@@ -1300,9 +1687,10 @@ bool playlist_content_path_is_valid(const char *path)
 bool playlist_push(playlist_t *playlist,
       const struct playlist_entry *entry)
 {
-   size_t i, len;
+   size_t i, j, len;
    char real_core_path[PATH_MAX_LENGTH];
    playlist_path_id_t *path_id = NULL;
+   size_t *matches             = NULL;
    const char *core_name       = entry->core_name;
    bool entry_updated          = false;
 
@@ -1347,11 +1735,15 @@ bool playlist_push(playlist_t *playlist,
       }
    }
 
-   len = RBUF_LEN(playlist->entries);
-   for (i = 0; i < len; i++)
+   len     = RBUF_LEN(playlist->entries);
+   matches = playlist_index_find(playlist, path_id);
+   for (j = 0; j < RBUF_LEN(matches); j++)
    {
       struct playlist_entry tmp;
-      bool equal_path  = (string_is_empty(path_id->real_path)
+      bool equal_path;
+
+      i                = matches[j];
+      equal_path       = (string_is_empty(path_id->real_path)
                        && string_is_empty(playlist->entries[i].path));
 
       equal_path       = equal_path || playlist_path_matches_entry(
@@ -1437,19 +1829,19 @@ bool playlist_push(playlist_t *playlist,
       if (     !playlist->entries[i].label
             && !string_is_empty(entry->label))
       {
-         playlist->entries[i].label       = strdup(entry->label);
+         playlist->entries[i].label       = playlist_strdup(playlist, entry->label);
          entry_updated                    = true;
       }
       if (     !playlist->entries[i].crc32
             && !string_is_empty(entry->crc32))
       {
-         playlist->entries[i].crc32       = strdup(entry->crc32);
+         playlist->entries[i].crc32       = playlist_strdup(playlist, entry->crc32);
          entry_updated                    = true;
       }
       if (     !playlist->entries[i].db_name
             && !string_is_empty(entry->db_name))
       {
-         playlist->entries[i].db_name     = strdup(entry->db_name);
+         playlist->entries[i].db_name     = playlist_strdup(playlist, entry->db_name);
          entry_updated                    = true;
       }
 
@@ -1468,6 +1860,7 @@ bool playlist_push(playlist_t *playlist,
       memmove(playlist->entries + 1, playlist->entries,
             i * sizeof(struct playlist_entry));
       playlist->entries[0] = tmp;
+      playlist->flags     &= ~CNT_PLAYLIST_FLG_INDEXED;
 
       goto success;
    }
@@ -1478,7 +1871,9 @@ bool playlist_push(playlist_t *playlist,
    if (len == playlist->config.capacity)
    {
       struct playlist_entry *last_entry = &playlist->entries[len - 1];
+      playlist_str_release(playlist, last_entry);
       playlist_free_entry(last_entry);
+      playlist->flags                  &= ~CNT_PLAYLIST_FLG_INDEXED;
       len--;
    }
    else
@@ -1518,26 +1913,26 @@ bool playlist_push(playlist_t *playlist,
       playlist->entries[0].last_played_second = 0;
 
       if (!string_is_empty(path_id->real_path))
-         playlist->entries[0].path            = strdup(path_id->real_path);
+         playlist->entries[0].path            = playlist_strdup(playlist, path_id->real_path);
       playlist->entries[0].path_id            = path_id;
       path_id                                 = NULL;
 
       playlist->entries[0].entry_slot         = entry->entry_slot;
 
       if (!string_is_empty(entry->label))
-         playlist->entries[0].label           = strdup(entry->label);
+         playlist->entries[0].label           = playlist_strdup(playlist, entry->label);
       if (!string_is_empty(real_core_path))
-         playlist->entries[0].core_path       = strdup(real_core_path);
+         playlist->entries[0].core_path       = playlist_strdup(playlist, real_core_path);
       if (!string_is_empty(core_name))
-         playlist->entries[0].core_name       = strdup(core_name);
+         playlist->entries[0].core_name       = playlist_strdup(playlist, core_name);
       if (!string_is_empty(entry->db_name))
-         playlist->entries[0].db_name         = strdup(entry->db_name);
+         playlist->entries[0].db_name         = playlist_strdup(playlist, entry->db_name);
       if (!string_is_empty(entry->crc32))
-         playlist->entries[0].crc32           = strdup(entry->crc32);
+         playlist->entries[0].crc32           = playlist_strdup(playlist, entry->crc32);
       if (!string_is_empty(entry->subsystem_ident))
-         playlist->entries[0].subsystem_ident = strdup(entry->subsystem_ident);
+         playlist->entries[0].subsystem_ident = playlist_strdup(playlist, entry->subsystem_ident);
       if (!string_is_empty(entry->subsystem_name))
-         playlist->entries[0].subsystem_name  = strdup(entry->subsystem_name);
+         playlist->entries[0].subsystem_name  = playlist_strdup(playlist, entry->subsystem_name);
 
       if (entry->subsystem_roms)
       {
@@ -1548,20 +1943,528 @@ bool playlist_push(playlist_t *playlist,
          for (i = 0; i < entry->subsystem_roms->size; i++)
             string_list_append(playlist->entries[0].subsystem_roms, entry->subsystem_roms->elems[i].data, attributes);
       }
+
+      playlist_index_push(playlist);
    }
 
 success:
+   RBUF_FREE(matches);
    if (path_id)
       playlist_path_id_free(path_id);
    playlist->flags   |= CNT_PLAYLIST_FLG_MOD;
    return true;
 
 error:
+   RBUF_FREE(matches);
    if (path_id)
       playlist_path_id_free(path_id);
    return false;
 }
 
+/* Binary playlist cache
+ *
+ * Parsing a large JSON playlist costs far more than reading it,
+ * so after a successful parse the result is stored in a sidecar
+ * file next to the playlist (same name, FILE_PATH_LPL_CACHE_EXTENSION).
+ * It is only trusted while the playlist's size and modification
+ * time match the ones recorded in it, and is deleted whenever the
+ * playlist is written.
+ *
+ * Layout, all words are little endian uint32:
+ *   magic, PLAYLIST_CACHE_HDR_WORDS header words,
+ *   strings_size bytes of NUL terminated strings,
+ *   entry_count x PLAYLIST_CACHE_ENTRY_WORDS entry words
+ * Strings are referenced by byte offset; offset 0 is an empty
+ * string at the start of the string block and stands for NULL.
+ * The subsystem ROMs of an entry are stored back to back.
+ * Entry strings point straight into the loaded file, which is
+ * cut down to the string block and kept in the string arena. */
+enum playlist_cache_hdr_word
+{
+   PLAYLIST_CACHE_HDR_VERSION = 0,
+   PLAYLIST_CACHE_HDR_FLAGS,
+   PLAYLIST_CACHE_HDR_SIZE_LO,
+   PLAYLIST_CACHE_HDR_SIZE_HI,
+   PLAYLIST_CACHE_HDR_MTIME_LO,
+   PLAYLIST_CACHE_HDR_MTIME_HI,
+   PLAYLIST_CACHE_HDR_DEFAULT_CORE_PATH,
+   PLAYLIST_CACHE_HDR_DEFAULT_CORE_NAME,
+   PLAYLIST_CACHE_HDR_BASE_CONTENT_DIRECTORY,
+   PLAYLIST_CACHE_HDR_SCAN_CONTENT_DIR,
+   PLAYLIST_CACHE_HDR_SCAN_FILE_EXTS,
+   PLAYLIST_CACHE_HDR_SCAN_DAT_FILE_PATH,
+   PLAYLIST_CACHE_HDR_LABEL_DISPLAY_MODE,
+   PLAYLIST_CACHE_HDR_RIGHT_THUMBNAIL_MODE,
+   PLAYLIST_CACHE_HDR_LEFT_THUMBNAIL_MODE,
+   PLAYLIST_CACHE_HDR_THUMBNAIL_MATCH_MODE,
+   PLAYLIST_CACHE_HDR_SORT_MODE,
+   PLAYLIST_CACHE_HDR_SCAN_FLAGS,
+   PLAYLIST_CACHE_HDR_ENTRY_COUNT,
+   PLAYLIST_CACHE_HDR_STRINGS_SIZE,
+   PLAYLIST_CACHE_HDR_WORDS
+};
+
+enum playlist_cache_entry_word
+{
+   /* String fields, in the order of playlist_cache_entry_strings() */
+   PLAYLIST_CACHE_ENTRY_PATH = 0,
+   PLAYLIST_CACHE_ENTRY_LABEL,
+   PLAYLIST_CACHE_ENTRY_CORE_PATH,
+   PLAYLIST_CACHE_ENTRY_CORE_NAME,
+   PLAYLIST_CACHE_ENTRY_DB_NAME,
+   PLAYLIST_CACHE_ENTRY_CRC32,
+   PLAYLIST_CACHE_ENTRY_SUBSYSTEM_IDENT,
+   PLAYLIST_CACHE_ENTRY_SUBSYSTEM_NAME,
+   PLAYLIST_CACHE_ENTRY_STRINGS,
+   PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS = PLAYLIST_CACHE_ENTRY_STRINGS,
+   PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS_COUNT,
+   /* Unsigned fields, in the order of playlist_cache_entry_uints() */
+   PLAYLIST_CACHE_ENTRY_ENTRY_SLOT,
+   PLAYLIST_CACHE_ENTRY_RUNTIME_HOURS,
+   PLAYLIST_CACHE_ENTRY_RUNTIME_MINUTES,
+   PLAYLIST_CACHE_ENTRY_RUNTIME_SECONDS,
+   PLAYLIST_CACHE_ENTRY_LAST_PLAYED_YEAR,
+   PLAYLIST_CACHE_ENTRY_LAST_PLAYED_MONTH,
+   PLAYLIST_CACHE_ENTRY_LAST_PLAYED_DAY,
+   PLAYLIST_CACHE_ENTRY_LAST_PLAYED_HOUR,
+   PLAYLIST_CACHE_ENTRY_LAST_PLAYED_MINUTE,
+   PLAYLIST_CACHE_ENTRY_LAST_PLAYED_SECOND,
+   PLAYLIST_CACHE_ENTRY_WORDS
+};
+
+#define PLAYLIST_CACHE_ENTRY_UINTS (PLAYLIST_CACHE_ENTRY_WORDS - PLAYLIST_CACHE_ENTRY_ENTRY_SLOT)
+
+enum playlist_cache_flags
+{
+   PLAYLIST_CACHE_FLG_COMPRESSED = (1 << 0)
+};
+
+enum playlist_cache_scan_flags
+{
+   PLAYLIST_CACHE_SCAN_SEARCH_RECURSIVELY = (1 << 0),
+   PLAYLIST_CACHE_SCAN_SEARCH_ARCHIVES    = (1 << 1),
+   PLAYLIST_CACHE_SCAN_FILTER_DAT_CONTENT = (1 << 2),
+   PLAYLIST_CACHE_SCAN_OVERWRITE_PLAYLIST = (1 << 3)
+};
+
+static void playlist_cache_entry_strings(struct playlist_entry *entry,
+      char **fields[PLAYLIST_CACHE_ENTRY_STRINGS])
+{
+   fields[PLAYLIST_CACHE_ENTRY_PATH]            = &entry->path;
+   fields[PLAYLIST_CACHE_ENTRY_LABEL]           = &entry->label;
+   fields[PLAYLIST_CACHE_ENTRY_CORE_PATH]       = &entry->core_path;
+   fields[PLAYLIST_CACHE_ENTRY_CORE_NAME]       = &entry->core_name;
+   fields[PLAYLIST_CACHE_ENTRY_DB_NAME]         = &entry->db_name;
+   fields[PLAYLIST_CACHE_ENTRY_CRC32]           = &entry->crc32;
+   fields[PLAYLIST_CACHE_ENTRY_SUBSYSTEM_IDENT] = &entry->subsystem_ident;
+   fields[PLAYLIST_CACHE_ENTRY_SUBSYSTEM_NAME]  = &entry->subsystem_name;
+}
+
+static void playlist_cache_entry_uints(struct playlist_entry *entry,
+      unsigned *fields[PLAYLIST_CACHE_ENTRY_UINTS])
+{
+   fields[0] = &entry->entry_slot;
+   fields[1] = &entry->runtime_hours;
+   fields[2] = &entry->runtime_minutes;
+   fields[3] = &entry->runtime_seconds;
+   fields[4] = &entry->last_played_year;
+   fields[5] = &entry->last_played_month;
+   fields[6] = &entry->last_played_day;
+   fields[7] = &entry->last_played_hour;
+   fields[8] = &entry->last_played_minute;
+   fields[9] = &entry->last_played_second;
+}
+
+static void playlist_cache_get_path(playlist_t *playlist,
+      char *s, size_t len)
+{
+   fill_pathname(s, playlist->config.path,
+         FILE_PATH_LPL_CACHE_EXTENSION, len);
+}
+
+/* Called before the playlist file is rewritten */
+static void playlist_cache_delete(playlist_t *playlist)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   playlist_cache_get_path(playlist, cache_path, sizeof(cache_path));
+   if (path_is_valid(cache_path))
+      filestream_delete(cache_path);
+}
+
+static uint32_t playlist_cache_get_word(const uint8_t *words, size_t idx)
+{
+   uint32_t val;
+   memcpy(&val, words + idx * sizeof(uint32_t), sizeof(val));
+   return retro_le_to_cpu32(val);
+}
+
+static char *playlist_cache_get_string(const char *strings, uint32_t offset)
+{
+   return offset ? strdup(strings + offset) : NULL;
+}
+
+/* Returns the offset of 'str' in the string block, adding it
+ * if it is not there yet. Entries share most of their core and
+ * database names, so every string is only stored once. */
+static uint32_t playlist_cache_add_string(char **strings,
+      uint32_t **offsets, const char *str)
+{
+   size_t _len;
+   uint32_t offset;
+   /* The rhmap macros need a plain lvalue */
+   uint32_t *map = *offsets;
+
+   if (string_is_empty(str))
+      return 0;
+
+   if ((offset = RHMAP_GET_STR(map, str)))
+   {
+      *offsets = map;
+      return offset;
+   }
+
+   offset = (uint32_t)RBUF_LEN(*strings);
+   _len   = strlen(str) + 1;
+   RBUF_RESIZE(*strings, offset + _len);
+   memcpy(*strings + offset, str, _len);
+   RHMAP_SET_STR(map, str, offset);
+   *offsets = map;
+   return offset;
+}
+
+/**
+ * playlist_cache_read:
+ * @playlist            : Playlist handle, with no entries yet.
+ *
+ * Fills @playlist from its binary cache, if that is still
+ * valid for the playlist file.
+ *
+ * Returns: true if the playlist was read from the cache.
+ **/
+static bool playlist_cache_read(playlist_t *playlist)
+{
+   size_t i, j;
+   char cache_path[PATH_MAX_LENGTH];
+   uint8_t header[STRLEN_CONST(PLAYLIST_CACHE_MAGIC)
+      + PLAYLIST_CACHE_HDR_WORDS * sizeof(uint32_t)];
+   uint32_t count, strings_size, scan_flags;
+   size_t entry_words_size;
+   const uint8_t *words = header + STRLEN_CONST(PLAYLIST_CACHE_MAGIC);
+   uint8_t *entry_words = NULL;
+   char *strings        = NULL;
+   RFILE *file          = NULL;
+   int64_t lpl_size     = 0;
+   int64_t lpl_mtime    = path_get_mtime(playlist->config.path, &lpl_size);
+
+   if (lpl_mtime < 0)
+      return false;
+
+   playlist_cache_get_path(playlist, cache_path, sizeof(cache_path));
+
+   if (     !path_is_valid(cache_path)
+         || !(file = filestream_open(cache_path,
+               RETRO_VFS_FILE_ACCESS_READ,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return false;
+
+   if (     filestream_read(file, header, sizeof(header))
+               != (int64_t)sizeof(header)
+         || memcmp(header, PLAYLIST_CACHE_MAGIC,
+               STRLEN_CONST(PLAYLIST_CACHE_MAGIC))
+         || playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_VERSION)
+               != PLAYLIST_CACHE_VERSION
+         || playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SIZE_LO)
+               != (uint32_t)lpl_size
+         || playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SIZE_HI)
+               != (uint32_t)((uint64_t)lpl_size >> 32)
+         || playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_MTIME_LO)
+               != (uint32_t)lpl_mtime
+         || playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_MTIME_HI)
+               != (uint32_t)((uint64_t)lpl_mtime >> 32))
+      goto error;
+
+   count            = playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_ENTRY_COUNT);
+   strings_size     = playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_STRINGS_SIZE);
+   entry_words_size = (size_t)count
+      * PLAYLIST_CACHE_ENTRY_WORDS * sizeof(uint32_t);
+
+   /* A playlist above capacity is truncated (and rewritten)
+    * when parsed, so leave that to the parser */
+   if (     !count
+         || count > playlist->config.capacity
+         || !strings_size
+         || filestream_get_size(file) != (int64_t)(sizeof(header)
+               + strings_size + entry_words_size))
+      goto error;
+
+   /* The string block gets its own allocation, since it
+    * becomes part of the string arena; the entry words are
+    * only needed while filling in the entries */
+   if (     !(strings = (char*)malloc(strings_size))
+         || !(entry_words = (uint8_t*)malloc(entry_words_size))
+         || filestream_read(file, strings, strings_size)
+               != (int64_t)strings_size
+         || filestream_read(file, entry_words, entry_words_size)
+               != (int64_t)entry_words_size)
+      goto error;
+
+   filestream_close(file);
+   file = NULL;
+
+   if (strings[strings_size - 1] != '\0')
+      goto error;
+
+   /* Check every reference before touching the playlist */
+   for (i = PLAYLIST_CACHE_HDR_DEFAULT_CORE_PATH;
+        i <= PLAYLIST_CACHE_HDR_SCAN_DAT_FILE_PATH; i++)
+      if (playlist_cache_get_word(words, i) >= strings_size)
+         goto error;
+
+   for (i = 0; i < count; i++)
+   {
+      const uint8_t *e = entry_words
+         + i * PLAYLIST_CACHE_ENTRY_WORDS * sizeof(uint32_t);
+      uint32_t offset;
+
+      for (j = 0; j < PLAYLIST_CACHE_ENTRY_STRINGS; j++)
+         if (playlist_cache_get_word(e, j) >= strings_size)
+            goto error;
+
+      offset = playlist_cache_get_word(e, PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS);
+      for (j = playlist_cache_get_word(e,
+               PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS_COUNT); j > 0; j--)
+      {
+         if (!offset || offset >= strings_size)
+            goto error;
+         offset += (uint32_t)strlen(strings + offset) + 1;
+      }
+   }
+
+   if (     !RBUF_TRYFIT(playlist->entries, count)
+         || !playlist_str_adopt(playlist, strings, strings_size))
+      goto error;
+
+   playlist->default_core_path      = playlist_cache_get_string(strings,
+         playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_DEFAULT_CORE_PATH));
+   playlist->default_core_name      = playlist_cache_get_string(strings,
+         playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_DEFAULT_CORE_NAME));
+   playlist->base_content_directory = playlist_cache_get_string(strings,
+         playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_BASE_CONTENT_DIRECTORY));
+   playlist->scan_record.content_dir   = playlist_cache_get_string(strings,
+         playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SCAN_CONTENT_DIR));
+   playlist->scan_record.file_exts     = playlist_cache_get_string(strings,
+         playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SCAN_FILE_EXTS));
+   playlist->scan_record.dat_file_path = playlist_cache_get_string(strings,
+         playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SCAN_DAT_FILE_PATH));
+
+   playlist->label_display_mode   = (enum playlist_label_display_mode)
+      playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_LABEL_DISPLAY_MODE);
+   playlist->right_thumbnail_mode = (enum playlist_thumbnail_mode)
+      playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_RIGHT_THUMBNAIL_MODE);
+   playlist->left_thumbnail_mode  = (enum playlist_thumbnail_mode)
+      playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_LEFT_THUMBNAIL_MODE);
+   playlist->thumbnail_match_mode = (enum playlist_thumbnail_match_mode)
+      playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_THUMBNAIL_MATCH_MODE);
+   playlist->sort_mode            = (enum playlist_sort_mode)
+      playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SORT_MODE);
+
+   scan_flags = playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_SCAN_FLAGS);
+   playlist->scan_record.search_recursively =
+      (scan_flags & PLAYLIST_CACHE_SCAN_SEARCH_RECURSIVELY) > 0;
+   playlist->scan_record.search_archives    =
+      (scan_flags & PLAYLIST_CACHE_SCAN_SEARCH_ARCHIVES)    > 0;
+   playlist->scan_record.filter_dat_content =
+      (scan_flags & PLAYLIST_CACHE_SCAN_FILTER_DAT_CONTENT) > 0;
+   playlist->scan_record.overwrite_playlist =
+      (scan_flags & PLAYLIST_CACHE_SCAN_OVERWRITE_PLAYLIST) > 0;
+
+   if (playlist_cache_get_word(words, PLAYLIST_CACHE_HDR_FLAGS)
+         & PLAYLIST_CACHE_FLG_COMPRESSED)
+      playlist->flags |=  CNT_PLAYLIST_FLG_COMPRESSED;
+   else
+      playlist->flags &= ~CNT_PLAYLIST_FLG_COMPRESSED;
+   playlist->flags    &= ~CNT_PLAYLIST_FLG_OLD_FMT;
+
+   RBUF_RESIZE(playlist->entries, count);
+
+   for (i = 0; i < count; i++)
+   {
+      char **str_fields[PLAYLIST_CACHE_ENTRY_STRINGS];
+      unsigned *uint_fields[PLAYLIST_CACHE_ENTRY_UINTS];
+      uint32_t roms, offset;
+      struct playlist_entry *entry = &playlist->entries[i];
+      const uint8_t *e             = entry_words
+         + i * PLAYLIST_CACHE_ENTRY_WORDS * sizeof(uint32_t);
+
+      memset(entry, 0, sizeof(*entry));
+
+      playlist_cache_entry_strings(entry, str_fields);
+      for (j = 0; j < PLAYLIST_CACHE_ENTRY_STRINGS; j++)
+      {
+         offset         = playlist_cache_get_word(e, j);
+         *str_fields[j] = offset ? strings + offset : NULL;
+      }
+
+      playlist_cache_entry_uints(entry, uint_fields);
+      for (j = 0; j < PLAYLIST_CACHE_ENTRY_UINTS; j++)
+         *uint_fields[j] = playlist_cache_get_word(e,
+               PLAYLIST_CACHE_ENTRY_ENTRY_SLOT + j);
+
+      offset = playlist_cache_get_word(e, PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS);
+      roms   = playlist_cache_get_word(e, PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS_COUNT);
+      if (roms)
+      {
+         union string_list_elem_attr attr = {0};
+         entry->subsystem_roms            = string_list_new();
+         for (j = 0; j < roms; j++)
+         {
+            string_list_append(entry->subsystem_roms, strings + offset, attr);
+            offset += (uint32_t)strlen(strings + offset) + 1;
+         }
+      }
+   }
+
+   free(entry_words);
+   return true;
+
+error:
+   if (file)
+      filestream_close(file);
+   free(strings);
+   free(entry_words);
+   return false;
+}
+
+/* Stores a freshly parsed playlist in its binary cache */
+static void playlist_cache_write(playlist_t *playlist)
+{
+   size_t i, j, len;
+   char cache_path[PATH_MAX_LENGTH];
+   uint32_t *words      = NULL;
+   uint32_t *offsets    = NULL;
+   char *strings        = NULL;
+   uint8_t *out         = NULL;
+   uint32_t scan_flags  = 0;
+   int64_t lpl_size     = 0;
+   int64_t lpl_mtime    = path_get_mtime(playlist->config.path, &lpl_size);
+   size_t count         = RBUF_LEN(playlist->entries);
+
+   if (lpl_mtime < 0 || count < PLAYLIST_CACHE_MIN_ENTRIES)
+      return;
+
+   /* Offset 0 is NULL */
+   RBUF_PUSH(strings, '\0');
+
+   RBUF_RESIZE(words, PLAYLIST_CACHE_HDR_WORDS
+         + count * PLAYLIST_CACHE_ENTRY_WORDS);
+
+   words[PLAYLIST_CACHE_HDR_VERSION]     = PLAYLIST_CACHE_VERSION;
+   words[PLAYLIST_CACHE_HDR_FLAGS]       =
+      (playlist->flags & CNT_PLAYLIST_FLG_COMPRESSED)
+      ? PLAYLIST_CACHE_FLG_COMPRESSED : 0;
+   words[PLAYLIST_CACHE_HDR_SIZE_LO]     = (uint32_t)lpl_size;
+   words[PLAYLIST_CACHE_HDR_SIZE_HI]     = (uint32_t)((uint64_t)lpl_size >> 32);
+   words[PLAYLIST_CACHE_HDR_MTIME_LO]    = (uint32_t)lpl_mtime;
+   words[PLAYLIST_CACHE_HDR_MTIME_HI]    = (uint32_t)((uint64_t)lpl_mtime >> 32);
+   words[PLAYLIST_CACHE_HDR_DEFAULT_CORE_PATH]      = playlist_cache_add_string(
+         &strings, &offsets, playlist->default_core_path);
+   words[PLAYLIST_CACHE_HDR_DEFAULT_CORE_NAME]      = playlist_cache_add_string(
+         &strings, &offsets, playlist->default_core_name);
+   words[PLAYLIST_CACHE_HDR_BASE_CONTENT_DIRECTORY] = playlist_cache_add_string(
+         &strings, &offsets, playlist->base_content_directory);
+   words[PLAYLIST_CACHE_HDR_SCAN_CONTENT_DIR]       = playlist_cache_add_string(
+         &strings, &offsets, playlist->scan_record.content_dir);
+   words[PLAYLIST_CACHE_HDR_SCAN_FILE_EXTS]         = playlist_cache_add_string(
+         &strings, &offsets, playlist->scan_record.file_exts);
+   words[PLAYLIST_CACHE_HDR_SCAN_DAT_FILE_PATH]     = playlist_cache_add_string(
+         &strings, &offsets, playlist->scan_record.dat_file_path);
+   words[PLAYLIST_CACHE_HDR_LABEL_DISPLAY_MODE]     = (uint32_t)playlist->label_display_mode;
+   words[PLAYLIST_CACHE_HDR_RIGHT_THUMBNAIL_MODE]   = (uint32_t)playlist->right_thumbnail_mode;
+   words[PLAYLIST_CACHE_HDR_LEFT_THUMBNAIL_MODE]    = (uint32_t)playlist->left_thumbnail_mode;
+   words[PLAYLIST_CACHE_HDR_THUMBNAIL_MATCH_MODE]   = (uint32_t)playlist->thumbnail_match_mode;
+   words[PLAYLIST_CACHE_HDR_SORT_MODE]              = (uint32_t)playlist->sort_mode;
+
+   if (playlist->scan_record.search_recursively)
+      scan_flags |= PLAYLIST_CACHE_SCAN_SEARCH_RECURSIVELY;
+   if (playlist->scan_record.search_archives)
+      scan_flags |= PLAYLIST_CACHE_SCAN_SEARCH_ARCHIVES;
+   if (playlist->scan_record.filter_dat_content)
+      scan_flags |= PLAYLIST_CACHE_SCAN_FILTER_DAT_CONTENT;
+   if (playlist->scan_record.overwrite_playlist)
+      scan_flags |= PLAYLIST_CACHE_SCAN_OVERWRITE_PLAYLIST;
+   words[PLAYLIST_CACHE_HDR_SCAN_FLAGS]  = scan_flags;
+   words[PLAYLIST_CACHE_HDR_ENTRY_COUNT] = (uint32_t)count;
+
+   for (i = 0; i < count; i++)
+   {
+      char **str_fields[PLAYLIST_CACHE_ENTRY_STRINGS];
+      unsigned *uint_fields[PLAYLIST_CACHE_ENTRY_UINTS];
+      struct playlist_entry *entry = &playlist->entries[i];
+      uint32_t *e                  = words + PLAYLIST_CACHE_HDR_WORDS
+         + i * PLAYLIST_CACHE_ENTRY_WORDS;
+
+      playlist_cache_entry_strings(entry, str_fields);
+      for (j = 0; j < PLAYLIST_CACHE_ENTRY_STRINGS; j++)
+         e[j] = playlist_cache_add_string(&strings, &offsets,
+               *str_fields[j]);
+
+      playlist_cache_entry_uints(entry, uint_fields);
+      for (j = 0; j < PLAYLIST_CACHE_ENTRY_UINTS; j++)
+         e[PLAYLIST_CACHE_ENTRY_ENTRY_SLOT + j] = *uint_fields[j];
+
+      /* Kept in sequence, so never shared */
+      e[PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS]       = 0;
+      e[PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS_COUNT] = 0;
+      if (entry->subsystem_roms && entry->subsystem_roms->size > 0)
+      {
+         e[PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS] = (uint32_t)RBUF_LEN(strings);
+         for (j = 0; j < entry->subsystem_roms->size; j++)
+         {
+            const char *rom = entry->subsystem_roms->elems[j].data;
+            size_t _len     = strlen(rom) + 1;
+            size_t pos      = RBUF_LEN(strings);
+            RBUF_RESIZE(strings, pos + _len);
+            memcpy(strings + pos, rom, _len);
+         }
+         e[PLAYLIST_CACHE_ENTRY_SUBSYSTEM_ROMS_COUNT] =
+            (uint32_t)entry->subsystem_roms->size;
+      }
+   }
+
+   words[PLAYLIST_CACHE_HDR_STRINGS_SIZE] = (uint32_t)RBUF_LEN(strings);
+
+   len = STRLEN_CONST(PLAYLIST_CACHE_MAGIC)
+       + RBUF_LEN(words) * sizeof(uint32_t) + RBUF_LEN(strings);
+
+   if ((out = (uint8_t*)malloc(len)))
+   {
+      uint8_t *p = out;
+
+      memcpy(p, PLAYLIST_CACHE_MAGIC, STRLEN_CONST(PLAYLIST_CACHE_MAGIC));
+      p += STRLEN_CONST(PLAYLIST_CACHE_MAGIC);
+      for (i = 0; i < RBUF_LEN(words); i++)
+      {
+         uint32_t word = retro_cpu_to_le32(words[i]);
+         if (i == PLAYLIST_CACHE_HDR_WORDS)
+         {
+            memcpy(p, strings, RBUF_LEN(strings));
+            p += RBUF_LEN(strings);
+         }
+         memcpy(p, &word, sizeof(word));
+         p += sizeof(word);
+      }
+
+      playlist_cache_get_path(playlist, cache_path, sizeof(cache_path));
+      if (!filestream_write_file(cache_path, out, (int64_t)len))
+         RARCH_WARN("[Playlist]: Failed to write cache \"%s\".\n", cache_path);
+      free(out);
+   }
+
+   RBUF_FREE(words);
+   RBUF_FREE(strings);
+   RHMAP_FREE(offsets);
+}
+
 void playlist_write_runtime_file(playlist_t *playlist)
 {
    size_t i, len;
@@ -1571,6 +2474,8 @@ void playlist_write_runtime_file(playlist_t *playlist)
    if (!playlist || !(playlist->flags & CNT_PLAYLIST_FLG_MOD))
       return;
 
+   playlist_cache_delete(playlist);
+
    if (!(file = intfstream_open_file(playlist->config.path,
          RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE)))
    {
@@ -1735,6 +2640,10 @@ void playlist_write_file(playlist_t *playlist)
    bool pl_compressed   = ((playlist->flags & CNT_PLAYLIST_FLG_COMPRESSED) > 0);
    bool pl_old_fmt      = ((playlist->flags & CNT_PLAYLIST_FLG_OLD_FMT)    > 0);
 
+   /* Nothing holds on to entry strings across a write,
+    * so this is where replaced strings are reclaimed */
+   playlist_str_compact(playlist);
+
    if (   !playlist
        || !((playlist->flags & CNT_PLAYLIST_FLG_MOD) ||
 #if defined(HAVE_ZLIB)
@@ -1743,6 +2652,8 @@ void playlist_write_file(playlist_t *playlist)
         (pl_old_fmt    != playlist->config.old_format)))
       return;
 
+   playlist_cache_delete(playlist);
+
 #if defined(HAVE_ZLIB)
    if (playlist->config.compress)
       file = intfstream_open_rzip_file(playlist->config.path,
@@ -2173,6 +3084,9 @@ void playlist_free(playlist_t *playlist)
       RBUF_FREE(playlist->entries);
    }
 
+   playlist_str_free(playlist);
+   RBUF_FREE(playlist->index_buckets);
+   RBUF_FREE(playlist->index_links);
    free(playlist);
 }
 
@@ -2196,6 +3110,8 @@ void playlist_clear(playlist_t *playlist)
          playlist_free_entry(entry);
    }
    RBUF_CLEAR(playlist->entries);
+   playlist_str_free(playlist);
+   playlist->flags &= ~CNT_PLAYLIST_FLG_INDEXED;
 }
 
 /**
@@ -2277,6 +3193,8 @@ static bool JSONStartObjectHandler(void *context)
                return false;
             }
             pCtx->current_entry = &pCtx->playlist->entries[len];
+            pCtx->prev_entry    = len
+               ? &pCtx->playlist->entries[len - 1] : NULL;
             memset(pCtx->current_entry, 0, sizeof(*pCtx->current_entry));
          }
          else
@@ -2345,9 +3263,24 @@ static bool JSONStringHandler(void *context, const char *pValue, size_t length)
                && length
                && !string_is_empty(pValue))
          {
-            if (*pCtx->current_string_val)
-                free(*pCtx->current_string_val);
-             *pCtx->current_string_val = strdup(pValue);
+            /* Scanned playlists repeat the same core and
+             * database names on every entry, so share the
+             * previous entry's copy of the same field */
+            char **prev_val = NULL;
+            if (pCtx->prev_entry)
+            {
+               size_t field = (char*)pCtx->current_string_val
+                  - (char*)pCtx->current_entry;
+               prev_val     = (char**)((char*)pCtx->prev_entry + field);
+            }
+
+            if (     prev_val
+                  && *prev_val
+                  && string_is_equal(*prev_val, pValue))
+               *pCtx->current_string_val = *prev_val;
+            else
+               *pCtx->current_string_val = playlist_strdup(
+                     pCtx->playlist, pValue);
          }
       }
    }
@@ -2594,15 +3527,21 @@ static bool playlist_read_file(playlist_t *playlist)
    unsigned i;
    int test_char;
    bool res             = true;
+   bool parsed          = false;
+   intfstream_t *file   = NULL;
+
+   if (playlist_cache_read(playlist))
+      return true;
+
 #if defined(HAVE_ZLIB)
-      /* Always use RZIP interface when reading playlists
-       * > this will automatically handle uncompressed
-       *   data */
-   intfstream_t *file   = intfstream_open_rzip_file(
+   /* Always use RZIP interface when reading playlists
+    * > this will automatically handle uncompressed
+    *   data */
+   file = intfstream_open_rzip_file(
          playlist->config.path,
          RETRO_VFS_FILE_ACCESS_READ);
 #else
-   intfstream_t *file   = intfstream_open_file(
+   file = intfstream_open_file(
          playlist->config.path,
          RETRO_VFS_FILE_ACCESS_READ,
          RETRO_VFS_FILE_ACCESS_HINT_NONE);
@@ -2664,7 +3603,9 @@ static bool playlist_read_file(playlist_t *playlist)
             JSONEndArrayHandler,
             JSONBoolHandler,
             NULL) /* Unused null handler */
-            != RJSON_DONE)
+            == RJSON_DONE)
+         parsed = true;
+      else
       {
          if (context.flags & JSON_CTX_FLG_OOM)
          {
@@ -2733,27 +3674,27 @@ static bool playlist_read_file(playlist_t *playlist)
 
             /* path */
             if (!string_is_empty(line_buf[0]))
-               entry->path      = strdup(line_buf[0]);
+               entry->path      = playlist_strdup(playlist, line_buf[0]);
 
             /* label */
             if (!string_is_empty(line_buf[1]))
-               entry->label     = strdup(line_buf[1]);
+               entry->label     = playlist_strdup(playlist, line_buf[1]);
 
             /* core_path */
             if (!string_is_empty(line_buf[2]))
-               entry->core_path = strdup(line_buf[2]);
+               entry->core_path = playlist_strdup(playlist, line_buf[2]);
 
             /* core_name */
             if (!string_is_empty(line_buf[3]))
-               entry->core_name = strdup(line_buf[3]);
+               entry->core_name = playlist_strdup(playlist, line_buf[3]);
 
             /* crc32 */
             if (!string_is_empty(line_buf[4]))
-               entry->crc32     = strdup(line_buf[4]);
+               entry->crc32     = playlist_strdup(playlist, line_buf[4]);
 
             /* db_name */
             if (!string_is_empty(line_buf[5]))
-               entry->db_name   = strdup(line_buf[5]);
+               entry->db_name   = playlist_strdup(playlist, line_buf[5]);
          }
          /* If fewer than 'PLAYLIST_ENTRIES' lines were
           * read, then this is metadata */
@@ -2879,6 +3820,12 @@ static bool playlist_read_file(playlist_t *playlist)
 end:
    intfstream_close(file);
    free(file);
+
+   /* Excess entries were dropped, so the file is going to be
+    * rewritten anyway */
+   if (parsed && !(playlist->flags & CNT_PLAYLIST_FLG_MOD))
+      playlist_cache_write(playlist);
+
    return res;
 }
 
@@ -2939,6 +3886,10 @@ playlist_t *playlist_init(const playlist_config_t *config)
    playlist->default_core_path              = NULL;
    playlist->base_content_directory         = NULL;
    playlist->entries                        = NULL;
+   playlist->str_blocks                     = NULL;
+   playlist->str_dead                       = 0;
+   playlist->index_buckets                  = NULL;
+   playlist->index_links                    = NULL;
    playlist->label_display_mode             = LABEL_DISPLAY_MODE_DEFAULT;
    playlist->right_thumbnail_mode           = PLAYLIST_THUMBNAIL_MODE_DEFAULT;
    playlist->left_thumbnail_mode            = PLAYLIST_THUMBNAIL_MODE_DEFAULT;
@@ -2948,6 +3899,7 @@ playlist_t *playlist_init(const playlist_config_t *config)
    playlist->scan_record.search_recursively = false;
    playlist->scan_record.search_archives    = false;
    playlist->scan_record.filter_dat_content = false;
+   playlist->scan_record.overwrite_playlist = false;
    playlist->scan_record.content_dir        = NULL;
    playlist->scan_record.file_exts          = NULL;
    playlist->scan_record.dat_file_path      = NULL;
@@ -2985,8 +3937,7 @@ playlist_t *playlist_init(const playlist_config_t *config)
                   playlist->base_content_directory, playlist->config.base_content_directory,
                   sizeof(tmp_entry_path));
 
-            free(entry->path);
-            entry->path = strdup(tmp_entry_path);
+            entry->path = playlist_strdup(playlist, tmp_entry_path);
 
             /* Fix subsystem roms paths*/
             if (     (entry->subsystem_roms)
@@ -3161,6 +4112,7 @@ void playlist_qsort(playlist_t *playlist)
    qsort(playlist->entries, RBUF_LEN(playlist->entries),
          sizeof(struct playlist_entry),
          (int (*)(const void *, const void *))playlist_qsort_func);
+   playlist->flags &= ~CNT_PLAYLIST_FLG_INDEXED;
 }
 
 void command_playlist_push_write(
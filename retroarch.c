@@ -3773,6 +3773,7 @@ bool command_event(enum event_command cmd, void *data)
          {
             bool rewind_enable        = settings->bools.rewind_enable;
             size_t rewind_buf_size    = settings->sizes.rewind_buffer_size;
+            bool rewind_threaded      = settings->bools.rewind_threaded;
             bool core_type_is_dummy   = runloop_st->current_core_type == CORE_TYPE_DUMMY;
 
             if (core_type_is_dummy)
@@ -3795,7 +3796,7 @@ bool command_event(enum event_command cmd, void *data)
 #endif
                {
                   state_manager_event_init(&runloop_st->rewind_st,
-                        (unsigned)rewind_buf_size);
+                        (unsigned)rewind_buf_size, rewind_threaded);
                }
             }
          }
@@ -7816,6 +7817,9 @@ void retroarch_init_task_queue(void)
 #endif
 
    task_queue_deinit();
+#ifdef HAVE_THREADS
+   task_queue_set_workers(settings->uints.threaded_data_runloop_workers);
+#endif
    task_queue_init(threaded_enable, runloop_task_msg_queue_push);
 }
 
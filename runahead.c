@@ -37,6 +37,15 @@
 #include "runloop.h"
 #include "verbosity.h"
 
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+#include <link.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_RUNAHEAD_THREAD
+#include <rthreads/rthreads.h>
+#endif
+
 static int16_t input_state_get_last(unsigned port,
       unsigned device, unsigned index, unsigned id)
 {
@@ -177,9 +186,372 @@ static void strcat_alloc(char **dst, const char *s)
    strcpy_literal(src + len1, s);
 }
 
+/* RUNAHEAD - SECONDARY CORE THREAD */
+#ifdef HAVE_RUNAHEAD_THREAD
+typedef struct runahead_thread_input
+{
+   int16_t *state;
+   unsigned port;
+   unsigned device;
+   unsigned index;
+   unsigned state_size;
+   unsigned state_capacity;
+} runahead_thread_input_t;
+
+/* The worker runs the secondary core's presented frame
+ * for the next frame while the main thread runs the
+ * primary core. It only ever touches the secondary
+ * core and the copies below, which the main thread
+ * hands over before the job and reads back after it. */
+struct runahead_thread
+{
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+   runahead_thread_input_t *inputs;
+   uint8_t *frame_data;
+   size_t frame_capacity;
+   size_t frame_pitch;
+   uint64_t frame_count;   /* Frame the speculated output is for */
+   unsigned num_inputs;
+   unsigned inputs_capacity;
+   unsigned frame_width;
+   unsigned frame_height;
+   bool frame_dupe;
+   bool frame_sent;
+   bool frame_ready;
+   bool job_pending;
+   bool quit;
+};
+
+static int16_t runahead_thread_input_state(unsigned port,
+      unsigned device, unsigned index, unsigned id)
+{
+   unsigned i;
+   runahead_thread_t *rt = runloop_state_get_ptr()->runahead_thread;
+
+   for (i = 0; i < rt->num_inputs; i++)
+   {
+      runahead_thread_input_t *input = &rt->inputs[i];
+
+      if (     (input->port   == port)
+            && (input->device == device)
+            && (input->index  == index))
+      {
+         if (id < input->state_size)
+            return input->state[id];
+         break;
+      }
+   }
+
+   return 0;
+}
+
+static void runahead_thread_input_poll(void) { }
+
+static void runahead_thread_video_refresh(const void *data,
+      unsigned width, unsigned height, size_t pitch)
+{
+   runahead_thread_t *rt = runloop_state_get_ptr()->runahead_thread;
+   size_t size           = pitch * height;
+
+   rt->frame_width       = width;
+   rt->frame_height      = height;
+   rt->frame_pitch       = pitch;
+   rt->frame_dupe        = true;
+   rt->frame_sent        = true;
+
+   if (!data)
+      return;
+
+   if (size > rt->frame_capacity)
+   {
+      uint8_t *frame_data = (uint8_t*)realloc(rt->frame_data, size);
+      if (!frame_data)
+         return;
+      rt->frame_data      = frame_data;
+      rt->frame_capacity  = size;
+   }
+
+   memcpy(rt->frame_data, data, size);
+   rt->frame_dupe        = false;
+}
+
+static void runahead_thread_audio_sample(int16_t left, int16_t right) { }
+
+static size_t runahead_thread_audio_sample_batch(
+      const int16_t *data, size_t frames)
+{
+   return frames;
+}
+
+/* Environment calls made by the secondary core on the
+ * worker. The primary core makes the same requests on
+ * the main thread, so anything that changes frontend
+ * state is refused here. */
+static bool runahead_thread_environment(unsigned cmd, void *data)
+{
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+         /* Picked up on the next resync, which
+          * runs on the main thread */
+         if (data)
+            *(bool*)data = false;
+         return true;
+      case RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE:
+         /* Same as for the presented frame when
+          * running on the main thread */
+         if (data)
+            *(enum retro_av_enable_flags*)data = (enum retro_av_enable_flags)
+               (RETRO_AV_ENABLE_VIDEO | RETRO_AV_ENABLE_HARD_DISABLE_AUDIO);
+         return true;
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+         {
+            /* Lookup only; the regular handler also
+             * consumes the 'updated' state, which
+             * belongs to the main thread */
+            size_t opt_idx;
+            struct retro_variable *var  = (struct retro_variable*)data;
+            runloop_state_t *runloop_st = runloop_state_get_ptr();
+
+            if (!var)
+               return true;
+
+            var->value = NULL;
+            if (     runloop_st->core_options
+                  && core_option_manager_get_idx(runloop_st->core_options,
+                     var->key, &opt_idx))
+               var->value = core_option_manager_get_val(
+                     runloop_st->core_options, opt_idx);
+         }
+         return true;
+      case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+      case RETRO_ENVIRONMENT_GET_PERF_INTERFACE:
+      case RETRO_ENVIRONMENT_GET_CAN_DUPE:
+      case RETRO_ENVIRONMENT_GET_INPUT_BITMASKS:
+      case RETRO_ENVIRONMENT_GET_LANGUAGE:
+      case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+      case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
+         return runloop_environment_cb(cmd, data);
+      default:
+         break;
+   }
+
+   return false;
+}
+
+static void runahead_thread_run_secondary(runloop_state_t *runloop_st)
+{
+   struct retro_core_t *core   = &runloop_st->secondary_core;
+   struct retro_callbacks *cbs = &runloop_st->secondary_callbacks;
+
+   core->retro_set_video_refresh(runahead_thread_video_refresh);
+   core->retro_set_audio_sample(runahead_thread_audio_sample);
+   core->retro_set_audio_sample_batch(runahead_thread_audio_sample_batch);
+   core->retro_set_input_poll(runahead_thread_input_poll);
+   core->retro_set_input_state(runahead_thread_input_state);
+
+   core->retro_run();
+
+   core->retro_set_video_refresh(cbs->frame_cb);
+   core->retro_set_audio_sample(cbs->sample_cb);
+   core->retro_set_audio_sample_batch(cbs->sample_batch_cb);
+   core->retro_set_input_poll(cbs->poll_cb);
+   core->retro_set_input_state(cbs->state_cb);
+}
+
+static void runahead_thread_loop(void *data)
+{
+   runloop_state_t *runloop_st = (runloop_state_t*)data;
+   runahead_thread_t *rt       = runloop_st->runahead_thread;
+
+   slock_lock(rt->lock);
+   for (;;)
+   {
+      while (!rt->job_pending && !rt->quit)
+         scond_wait(rt->cond, rt->lock);
+
+      if (rt->quit)
+         break;
+
+      slock_unlock(rt->lock);
+      runahead_thread_run_secondary(runloop_st);
+      slock_lock(rt->lock);
+
+      rt->job_pending = false;
+      rt->frame_ready = true;
+      scond_signal(rt->cond);
+   }
+   slock_unlock(rt->lock);
+}
+
+/* Waits for a pending job. Safe to call whether or
+ * not the thread exists; every access to the secondary
+ * core from the main thread must be preceded by this. */
+void runahead_secondary_core_sync(void *data)
+{
+   runloop_state_t *runloop_st = (runloop_state_t*)data;
+   runahead_thread_t *rt       = runloop_st->runahead_thread;
+
+   if (!rt)
+      return;
+
+   slock_lock(rt->lock);
+   while (rt->job_pending)
+      scond_wait(rt->cond, rt->lock);
+   slock_unlock(rt->lock);
+}
+
+static void runahead_thread_free(runloop_state_t *runloop_st)
+{
+   unsigned i;
+   runahead_thread_t *rt = runloop_st->runahead_thread;
+
+   if (!rt)
+      return;
+
+   if (rt->thread)
+   {
+      slock_lock(rt->lock);
+      rt->quit = true;
+      scond_signal(rt->cond);
+      slock_unlock(rt->lock);
+      sthread_join(rt->thread);
+   }
+
+   for (i = 0; i < rt->inputs_capacity; i++)
+      free(rt->inputs[i].state);
+   free(rt->inputs);
+   free(rt->frame_data);
+   scond_free(rt->cond);
+   slock_free(rt->lock);
+   free(rt);
+
+   runloop_st->runahead_thread = NULL;
+}
+
+static bool runahead_thread_init(runloop_state_t *runloop_st)
+{
+   runahead_thread_t *rt;
+
+   if (runloop_st->runahead_thread)
+      return true;
+
+   if (!(rt = (runahead_thread_t*)calloc(1, sizeof(*rt))))
+      return false;
+
+   runloop_st->runahead_thread = rt;
+   rt->lock                    = slock_new();
+   rt->cond                    = scond_new();
+
+   if (     !rt->lock
+         || !rt->cond
+         || !(rt->thread = sthread_create(runahead_thread_loop, runloop_st)))
+   {
+      runahead_thread_free(runloop_st);
+      return false;
+   }
+
+   return true;
+}
+
+/* Copies the logged input so the worker never reads
+ * the list the primary core is appending to */
+static bool runahead_thread_copy_input(runloop_state_t *runloop_st,
+      runahead_thread_t *rt)
+{
+   int i;
+   my_list *list  = runloop_st->input_state_list;
+   unsigned count = list ? (unsigned)list->size : 0;
+
+   if (count > rt->inputs_capacity)
+   {
+      runahead_thread_input_t *inputs = (runahead_thread_input_t*)
+         realloc(rt->inputs, count * sizeof(*inputs));
+      if (!inputs)
+         return false;
+      memset(inputs + rt->inputs_capacity, 0,
+            (count - rt->inputs_capacity) * sizeof(*inputs));
+      rt->inputs          = inputs;
+      rt->inputs_capacity = count;
+   }
+
+   for (i = 0; i < (int)count; i++)
+   {
+      input_list_element *element    = (input_list_element*)list->data[i];
+      runahead_thread_input_t *input = &rt->inputs[i];
+
+      if (element->state_size > input->state_capacity)
+      {
+         int16_t *state = (int16_t*)realloc(input->state,
+               element->state_size * sizeof(int16_t));
+         if (!state)
+            return false;
+         input->state          = state;
+         input->state_capacity = element->state_size;
+      }
+
+      memcpy(input->state, element->state,
+            element->state_size * sizeof(int16_t));
+      input->port       = element->port;
+      input->device     = element->device;
+      input->index      = element->index;
+      input->state_size = element->state_size;
+   }
+
+   rt->num_inputs = count;
+   return true;
+}
+
+/* Starts speculating the secondary core's presented
+ * frame for 'frame_count', assuming the input will
+ * not change. */
+static void runahead_thread_submit(runloop_state_t *runloop_st,
+      uint64_t frame_count)
+{
+   runahead_thread_t *rt = runloop_st->runahead_thread;
+
+   if (!runahead_thread_copy_input(runloop_st, rt))
+      return;
+
+   slock_lock(rt->lock);
+   rt->frame_count = frame_count;
+   rt->frame_sent  = false;
+   rt->frame_ready = false;
+   rt->job_pending = true;
+   scond_signal(rt->cond);
+   slock_unlock(rt->lock);
+}
+
+/* Waits for the speculated frame and returns true if
+ * it was made for 'frame_count'. The result can only
+ * be collected once. */
+static bool runahead_thread_collect(runloop_state_t *runloop_st,
+      uint64_t frame_count)
+{
+   bool ready;
+   runahead_thread_t *rt = runloop_st->runahead_thread;
+
+   if (!rt)
+      return false;
+
+   runahead_secondary_core_sync(runloop_st);
+
+   ready           = rt->frame_ready && rt->frame_count == frame_count;
+   rt->frame_ready = false;
+   return ready;
+}
+#else
+void runahead_secondary_core_sync(void *data) { }
+#endif
+
 void runahead_secondary_core_destroy(void *data)
 {
    runloop_state_t *runloop_st      = (runloop_state_t*)data;
+#ifdef HAVE_RUNAHEAD_THREAD
+   runahead_thread_free(runloop_st);
+#endif
    if (!runloop_st->secondary_lib_handle)
       return;
 
@@ -392,8 +764,16 @@ end:
 static bool runloop_environment_secondary_core_hook(
       unsigned cmd, void *data)
 {
+   bool result;
    runloop_state_t *runloop_st    = runloop_state_get_ptr();
-   bool result                    = runloop_environment_cb(cmd, data);
+
+#ifdef HAVE_RUNAHEAD_THREAD
+   if (     runloop_st->runahead_thread
+         && sthread_isself(runloop_st->runahead_thread->thread))
+      return runahead_thread_environment(cmd, data);
+#endif
+
+   result                         = runloop_environment_cb(cmd, data);
 
    if (runloop_st->flags & RUNLOOP_FLAG_HAS_VARIABLE_UPDATE)
    {
@@ -552,6 +932,7 @@ static bool secondary_core_deserialize(runloop_state_t *runloop_st,
 
    if (secondary_core_ensure_exists(runloop_st, settings))
    {
+      runahead_secondary_core_sync(runloop_st);
       runloop_st->flags |=  RUNLOOP_FLAG_REQUEST_SPECIAL_SAVESTATE;
       ret                = runloop_st->secondary_core.retro_unserialize(data, size);
       runloop_st->flags &= ~RUNLOOP_FLAG_REQUEST_SPECIAL_SAVESTATE;
@@ -576,6 +957,8 @@ static bool secondary_core_run_use_last_input(runloop_state_t *runloop_st)
       return false;
    }
 
+   runahead_secondary_core_sync(runloop_st);
+
    old_poll_function                        = runloop_st->secondary_callbacks.poll_cb;
    old_input_function                       = runloop_st->secondary_callbacks.state_cb;
 
@@ -607,11 +990,15 @@ void runahead_remember_controller_port_device(void *data,
       runloop_st->port_map[port] = (int)device;
    if (     runloop_st->secondary_lib_handle
          && runloop_st->secondary_core.retro_set_controller_port_device)
+   {
+      runahead_secondary_core_sync(runloop_st);
       runloop_st->secondary_core.retro_set_controller_port_device((unsigned)port, (unsigned)device);
+   }
 }
 
 #else
 void runahead_secondary_core_destroy(void *data) { }
+void runahead_secondary_core_sync(void *data) { }
 #endif
 
 static void mylist_resize(my_list *list,
@@ -1012,11 +1399,326 @@ static void runahead_add_hooks(runloop_state_t *runloop_st)
    runahead_add_input_state_hook(runloop_st);
 }
 
+/* RUNAHEAD - SNAPSHOT */
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+#define RUNAHEAD_SNAPSHOT_MAX_REGIONS   8
+/* Frames after enabling during which every snapshot
+ * rollback is checked against a regular savestate */
+#define RUNAHEAD_SNAPSHOT_WARMUP_FRAMES 300
+/* Frames between checks of a snapshot rollback
+ * against a regular savestate after the warm-up */
+#define RUNAHEAD_SNAPSHOT_VERIFY_FRAMES 600
+
+typedef struct runahead_snapshot_region
+{
+   uint8_t *addr;
+   uint8_t *copy;
+   size_t size;
+} runahead_snapshot_region_t;
+
+struct runahead_snapshot
+{
+   runahead_snapshot_region_t regions[RUNAHEAD_SNAPSHOT_MAX_REGIONS];
+   void *verify_data;
+   size_t verify_size;
+   size_t page_size;
+   unsigned num_regions;     /* 0 if the core can't be snapshotted */
+   unsigned warmup_countdown;
+   unsigned verify_countdown;
+   bool verify_pending;
+};
+
+typedef struct runahead_snapshot_search
+{
+   runahead_snapshot_t *snapshot;
+   uintptr_t symbol;
+   bool found;
+} runahead_snapshot_search_t;
+
+static void runahead_snapshot_add_region(runahead_snapshot_t *snapshot,
+      uintptr_t start, uintptr_t end)
+{
+   uintptr_t page_mask = (uintptr_t)snapshot->page_size - 1;
+
+   /* The dynamic linker only write-protects whole pages
+    * of the RELRO area, so rounding the start down never
+    * reaches into read-only memory */
+   start &= ~page_mask;
+   end    = (end + page_mask) & ~page_mask;
+
+   if (     end <= start
+         || snapshot->num_regions >= RUNAHEAD_SNAPSHOT_MAX_REGIONS)
+      return;
+
+   snapshot->regions[snapshot->num_regions].addr = (uint8_t*)start;
+   snapshot->regions[snapshot->num_regions].size = end - start;
+   snapshot->num_regions++;
+}
+
+static int runahead_snapshot_find_core(struct dl_phdr_info *info,
+      size_t size, void *data)
+{
+   int i;
+   runahead_snapshot_search_t *search = (runahead_snapshot_search_t*)data;
+   uintptr_t relro_start              = 0;
+   uintptr_t relro_end                = 0;
+   bool contains_symbol               = false;
+
+   for (i = 0; i < info->dlpi_phnum; i++)
+   {
+      const ElfW(Phdr) *phdr = &info->dlpi_phdr[i];
+      uintptr_t start        = info->dlpi_addr + phdr->p_vaddr;
+
+      if (phdr->p_type == PT_LOAD)
+      {
+         if (     search->symbol >= start
+               && search->symbol <  start + phdr->p_memsz)
+            contains_symbol = true;
+      }
+      else if (phdr->p_type == PT_GNU_RELRO)
+      {
+         relro_start = start;
+         relro_end   = start + phdr->p_memsz;
+      }
+   }
+
+   if (!contains_symbol)
+      return 0;
+
+   /* A core linked into the executable shares its
+    * writable segments with the frontend */
+   if (string_is_empty(info->dlpi_name))
+      return 1;
+
+   for (i = 0; i < info->dlpi_phnum; i++)
+   {
+      const ElfW(Phdr) *phdr = &info->dlpi_phdr[i];
+      uintptr_t start        = info->dlpi_addr + phdr->p_vaddr;
+      uintptr_t end          = start + phdr->p_memsz;
+
+      if (phdr->p_type != PT_LOAD || !(phdr->p_flags & PF_W))
+         continue;
+
+      if (relro_start <= start && relro_end > start)
+         start = relro_end;
+      else if (relro_start < end && relro_end >= end)
+         end   = relro_start;
+
+      runahead_snapshot_add_region(search->snapshot, start, end);
+   }
+
+   search->found = search->snapshot->num_regions > 0;
+   return 1;
+}
+
+static void runahead_snapshot_free(runahead_snapshot_t *snapshot)
+{
+   unsigned i;
+
+   if (!snapshot)
+      return;
+
+   for (i = 0; i < snapshot->num_regions; i++)
+      free(snapshot->regions[i].copy);
+   free(snapshot->verify_data);
+   free(snapshot);
+}
+
+static void runahead_snapshot_disable(runahead_snapshot_t *snapshot)
+{
+   unsigned i;
+
+   for (i = 0; i < snapshot->num_regions; i++)
+   {
+      free(snapshot->regions[i].copy);
+      snapshot->regions[i].copy = NULL;
+   }
+   free(snapshot->verify_data);
+   snapshot->verify_data    = NULL;
+   snapshot->num_regions    = 0;
+   snapshot->verify_pending = false;
+}
+
+/* Locates the writable segments of the loaded core.
+ * Always returns a snapshot object so that an
+ * unsupported core is only probed once; num_regions
+ * is left at 0 in that case.
+ * Heap memory is not part of the snapshot, so a core
+ * that allocates while running would be rolled back
+ * to pointers into freed blocks. Only cores whose info
+ * file sets 'runahead_snapshot' are used. */
+static runahead_snapshot_t *runahead_snapshot_new(
+      runloop_state_t *runloop_st)
+{
+   unsigned i;
+   runahead_snapshot_search_t search;
+   size_t total                  = 0;
+   long page_size                = sysconf(_SC_PAGESIZE);
+   runahead_snapshot_t *snapshot = (runahead_snapshot_t*)
+      calloc(1, sizeof(*snapshot));
+
+   if (!snapshot)
+      return NULL;
+
+   if (!core_info_current_supports_runahead_snapshot())
+   {
+      RARCH_LOG("[Run-Ahead]: Core does not support memory snapshots, using savestates.\n");
+      return snapshot;
+   }
+
+   if (     (runloop_st->current_core_type != CORE_TYPE_PLAIN)
+         || !runloop_st->current_core.retro_run
+         || (page_size <= 0))
+      goto unsupported;
+
+   snapshot->page_size = (size_t)page_size;
+   search.snapshot     = snapshot;
+   search.symbol       = (uintptr_t)runloop_st->current_core.retro_run;
+   search.found        = false;
+
+   dl_iterate_phdr(runahead_snapshot_find_core, &search);
+
+   if (!search.found)
+      goto unsupported;
+
+   for (i = 0; i < snapshot->num_regions; i++)
+   {
+      runahead_snapshot_region_t *region = &snapshot->regions[i];
+      if (!(region->copy = (uint8_t*)malloc(region->size)))
+         goto unsupported;
+      memcpy(region->copy, region->addr, region->size);
+      total += region->size;
+   }
+
+   snapshot->verify_size      = runloop_st->runahead_save_state_size;
+   if (!(snapshot->verify_data = malloc(snapshot->verify_size)))
+      goto unsupported;
+   snapshot->warmup_countdown = RUNAHEAD_SNAPSHOT_WARMUP_FRAMES;
+
+   RARCH_LOG("[Run-Ahead]: Snapshotting %u KB of core memory in %u regions.\n",
+         (unsigned)(total >> 10), snapshot->num_regions);
+   return snapshot;
+
+unsupported:
+   RARCH_WARN("[Run-Ahead]: Core memory cannot be snapshotted, using savestates.\n");
+   runahead_snapshot_disable(snapshot);
+   return snapshot;
+}
+
+/* Copies every page that differs between the core
+ * and its snapshot, in the requested direction. Only
+ * pages dirtied since the last save or restore are
+ * written. */
+static void runahead_snapshot_sync(runahead_snapshot_t *snapshot,
+      bool restore)
+{
+   unsigned i;
+   size_t page_size = snapshot->page_size;
+
+   for (i = 0; i < snapshot->num_regions; i++)
+   {
+      size_t offset;
+      runahead_snapshot_region_t *region = &snapshot->regions[i];
+
+      for (offset = 0; offset < region->size; offset += page_size)
+      {
+         uint8_t *live = region->addr + offset;
+         uint8_t *copy = region->copy + offset;
+
+         if (memcmp(live, copy, page_size))
+         {
+            if (restore)
+               memcpy(live, copy, page_size);
+            else
+               memcpy(copy, live, page_size);
+         }
+      }
+   }
+}
+
+static void runahead_snapshot_update(runloop_state_t *runloop_st,
+      bool enable)
+{
+   if (!enable)
+   {
+      runahead_snapshot_free(runloop_st->runahead_snapshot);
+      runloop_st->runahead_snapshot = NULL;
+   }
+   else if (!runloop_st->runahead_snapshot)
+      runloop_st->runahead_snapshot = runahead_snapshot_new(runloop_st);
+}
+
+/* Returns true if the snapshot fully replaces the
+ * savestate for this frame. A regular savestate is
+ * still requested on every frame of the warm-up and
+ * periodically after it, so that the rollback can be
+ * verified against it. */
+static bool runahead_snapshot_save(runahead_snapshot_t *snapshot)
+{
+   if (!snapshot || !snapshot->num_regions)
+      return false;
+
+   runahead_snapshot_sync(snapshot, false);
+
+   if (snapshot->warmup_countdown > 0)
+   {
+      snapshot->warmup_countdown--;
+      snapshot->verify_pending = true;
+      return false;
+   }
+
+   if (snapshot->verify_countdown > 0)
+   {
+      snapshot->verify_countdown--;
+      return true;
+   }
+
+   snapshot->verify_countdown = RUNAHEAD_SNAPSHOT_VERIFY_FRAMES;
+   snapshot->verify_pending   = true;
+   return false;
+}
+
+/* Returns true if the core was rolled back from the
+ * snapshot. On a verification mismatch the snapshot
+ * is disabled and the caller loads the savestate. */
+static bool runahead_snapshot_load(runahead_snapshot_t *snapshot,
+      const retro_ctx_serialize_info_t *serialize_info)
+{
+   retro_ctx_serialize_info_t verify_info;
+
+   if (!snapshot || !snapshot->num_regions)
+      return false;
+
+   runahead_snapshot_sync(snapshot, true);
+
+   if (!snapshot->verify_pending)
+      return true;
+
+   snapshot->verify_pending = false;
+   verify_info.data         = snapshot->verify_data;
+   verify_info.data_const   = snapshot->verify_data;
+   verify_info.size         = snapshot->verify_size;
+
+   if (     (serialize_info->size == verify_info.size)
+         && core_serialize_special(&verify_info)
+         && !memcmp(verify_info.data, serialize_info->data_const,
+            verify_info.size))
+      return true;
+
+   RARCH_WARN("[Run-Ahead]: Core keeps state outside of its memory snapshot, using savestates.\n");
+   runahead_snapshot_disable(snapshot);
+   return false;
+}
+#endif
+
 /* Runahead Code */
 
 static void runahead_error(runloop_state_t *runloop_st)
 {
    runloop_st->flags &= ~RUNLOOP_FLAG_RUNAHEAD_AVAILABLE;
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+   runahead_snapshot_update(runloop_st, false);
+#endif
    mylist_destroy(&runloop_st->runahead_save_state_list);
    runahead_remove_hooks(runloop_st);
    runloop_st->runahead_save_state_size       = 0;
@@ -1059,6 +1761,11 @@ static bool runahead_save_state(runloop_state_t *runloop_st)
    serialize_info                  =
       (retro_ctx_serialize_info_t*)runloop_st->runahead_save_state_list->data[0];
 
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+   if (runahead_snapshot_save(runloop_st->runahead_snapshot))
+      return true;
+#endif
+
    if (core_serialize_special(serialize_info))
       return true;
 
@@ -1068,11 +1775,18 @@ static bool runahead_save_state(runloop_state_t *runloop_st)
 
 static bool runahead_load_state(runloop_state_t *runloop_st)
 {
+   bool ret;
    retro_ctx_serialize_info_t *serialize_info =
       (retro_ctx_serialize_info_t*)
       runloop_st->runahead_save_state_list->data[0];
    bool last_dirty                            = (runloop_st->flags & RUNLOOP_FLAG_INPUT_IS_DIRTY) ? true : false;
-   bool ret                                   = core_unserialize_special(serialize_info);
+
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+   if (runahead_snapshot_load(runloop_st->runahead_snapshot, serialize_info))
+      return true;
+#endif
+
+   ret                                        = core_unserialize_special(serialize_info);
    if (last_dirty)
       runloop_st->flags                      |=  RUNLOOP_FLAG_INPUT_IS_DIRTY;
    else
@@ -1134,6 +1848,10 @@ void runahead_run(void *data,
    int frame_number        = 0;
    bool last_frame         = false;
    bool suspended_frame    = false;
+#ifdef HAVE_RUNAHEAD_THREAD
+   bool threaded           = false;
+   bool speculated         = false;
+#endif
 #if defined(HAVE_DYNAMIC) || defined(HAVE_DYLIB)
    const bool have_dynamic = true;
    settings_t *settings    = config_get_ptr();
@@ -1194,6 +1912,9 @@ void runahead_run(void *data,
          || !have_dynamic
          || !(runloop_st->flags & RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE))
    {
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+      runahead_snapshot_update(runloop_st, settings->bools.run_ahead_snapshot);
+#endif
       /* TODO: multiple savestates for higher performance
        * when not using secondary core */
       for (frame_number = 0; frame_number <= runahead_count; frame_number++)
@@ -1249,6 +1970,11 @@ void runahead_run(void *data,
    }
    else
    {
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+      /* Secondary core syncs from a savestate of the
+       * primary, which the snapshot must not replace */
+      runahead_snapshot_update(runloop_st, false);
+#endif
 #if HAVE_DYNAMIC
       if (!secondary_core_ensure_exists(runloop_st, config_get_ptr()))
       {
@@ -1269,10 +1995,26 @@ void runahead_run(void *data,
       else
          video_st->flags &= ~VIDEO_FLAG_ACTIVE;
 
+#ifdef HAVE_RUNAHEAD_THREAD
+      /* Hardware rendered frames can't leave the
+       * thread that owns the context */
+      threaded = settings->bools.run_ahead_secondary_thread
+         && video_st->hw_render.context_type == RETRO_HW_CONTEXT_NONE;
+      if (threaded)
+         threaded   = runahead_thread_init(runloop_st);
+      else
+         runahead_thread_free(runloop_st);
+      speculated    = runahead_thread_collect(runloop_st, frame_count);
+#endif
+
       if (     (runloop_st->flags & RUNLOOP_FLAG_INPUT_IS_DIRTY)
             || (runloop_st->flags & RUNLOOP_FLAG_RUNAHEAD_FORCE_INPUT_DIRTY))
       {
          runloop_st->flags &= ~RUNLOOP_FLAG_INPUT_IS_DIRTY;
+#ifdef HAVE_RUNAHEAD_THREAD
+         /* The speculated frame assumed unchanged input */
+         speculated         = false;
+#endif
 
          if (!runahead_save_state(runloop_st))
          {
@@ -1309,14 +2051,37 @@ void runahead_run(void *data,
                video_st->flags          &= ~VIDEO_FLAG_ACTIVE;
          }
       }
-      audio_st->flags                   |= AUDIO_FLAG_SUSPENDED
-                                         | AUDIO_FLAG_HARD_DISABLE;
-      if (secondary_core_run_use_last_input(runloop_st))
-         runloop_st->flags              |=  RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE;
+#ifdef HAVE_RUNAHEAD_THREAD
+      if (speculated)
+      {
+         runahead_thread_t *rt           = runloop_st->runahead_thread;
+         if (rt->frame_sent)
+            runloop_st->secondary_callbacks.frame_cb(
+                  rt->frame_dupe ? NULL : rt->frame_data,
+                  rt->frame_width, rt->frame_height, rt->frame_pitch);
+      }
       else
-         runloop_st->flags              &= ~RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE;
-      audio_st->flags                   &= ~(AUDIO_FLAG_SUSPENDED
+#endif
+      {
+         audio_st->flags                |= AUDIO_FLAG_SUSPENDED
+                                         | AUDIO_FLAG_HARD_DISABLE;
+         if (secondary_core_run_use_last_input(runloop_st))
+            runloop_st->flags           |=  RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE;
+         else
+            runloop_st->flags           &= ~RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE;
+         audio_st->flags                &= ~(AUDIO_FLAG_SUSPENDED
                                          | AUDIO_FLAG_HARD_DISABLE);
+      }
+
+#ifdef HAVE_RUNAHEAD_THREAD
+      /* Run the secondary core's next frame while the
+       * main thread presents this one and runs the
+       * primary core */
+      if (     threaded
+            && runloop_st->secondary_lib_handle
+            && (runloop_st->flags & RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE))
+         runahead_thread_submit(runloop_st, frame_count + 1);
+#endif
 #endif
    }
    runloop_st->flags &= ~RUNLOOP_FLAG_RUNAHEAD_FORCE_INPUT_DIRTY;
@@ -1329,6 +2094,12 @@ force_input_dirty:
 
 /* Preemptive Frames */
 
+/* Replays run, and analog changes absorbed
+ * without one. Static as they stay registered
+ * with the frontend once created */
+static struct retro_perf_counter preempt_replay_perf;
+static struct retro_perf_counter preempt_skip_perf;
+
 static int16_t preempt_input_state(unsigned port,
       unsigned device, unsigned index, unsigned id)
 {
@@ -1463,6 +2234,9 @@ bool preempt_init(void *data)
                settings->uints.run_ahead_frames)))
       goto error;
 
+   performance_counter_init(preempt_replay_perf, "preempt_replay");
+   performance_counter_init(preempt_skip_perf, "preempt_skip");
+
    /* Only poll in preempt_run() */
    runloop_st->current_core.retro_set_input_poll(retro_input_poll_null);
    /* Track requested analog states and pointing device types */
@@ -1482,8 +2256,95 @@ error:
    return false;
 }
 
+/**
+ * preempt_analog_threshold:
+ *
+ * Adds this frame's analog changes to the port's
+ * histogram and returns the replay threshold: just
+ * above the jitter of the stick, so that noise is
+ * absorbed while real movement is not, and never
+ * above the user limit.
+ **/
+static int preempt_analog_threshold(preempt_t *preempt,
+      const int16_t *state, unsigned port, int max_threshold)
+{
+   uint8_t i;
+   unsigned sum;
+   unsigned total;
+   uint16_t *hist = preempt->analog_hist[port];
+
+   for (i = 0; i < 20; i++)
+   {
+      unsigned delta = (unsigned)abs(state[i] - preempt->analog_last[port][i]);
+      uint8_t bucket = 0;
+
+      if (!delta)
+         continue;
+
+      while (delta >>= 1)
+         bucket++;
+      hist[bucket]++;
+
+      /* Decay, so the histogram follows the
+       * controller currently in use */
+      if (++preempt->analog_hist_total[port] >= 1024)
+      {
+         uint8_t j;
+         preempt->analog_hist_total[port] = 0;
+         for (j = 0; j < PREEMPT_ANALOG_HIST_SIZE; j++)
+         {
+            hist[j] >>= 1;
+            preempt->analog_hist_total[port] += hist[j];
+         }
+      }
+   }
+
+   memcpy(preempt->analog_last[port], state,
+         sizeof(preempt->analog_last[port]));
+
+   if (!(total = preempt->analog_hist_total[port]))
+      return 0;
+
+   /* Bucket holding the 95th percentile change.
+    * Changes are measured against the last replayed
+    * state, so allow twice the top of that bucket */
+   for (i = 0, sum = 0; i < PREEMPT_ANALOG_HIST_SIZE - 1; i++)
+   {
+      sum += hist[i];
+      if (sum * 20 >= total * 19)
+         break;
+   }
+
+   return MIN(4 << i, max_threshold);
+}
+
+static bool preempt_analog_change_significant(preempt_t *preempt,
+      const int16_t *state, unsigned port, int threshold)
+{
+   uint8_t i;
+
+   for (i = 0; i < 20; i++)
+   {
+      int16_t old = preempt->analog_state[port][i];
+
+      if (abs(state[i] - old) > threshold)
+         return true;
+
+      /* A digital input mapped to an axis jumps between
+       * rest and full deflection, which always counts even
+       * with the threshold at its maximum. An analog stick
+       * settling around rest is jitter like any other. */
+      if (     (!state[i] != !old)
+            && (abs(state[i]) >= 0x7fff || abs(old) >= 0x7fff))
+         return true;
+   }
+
+   return false;
+}
+
 static INLINE bool preempt_analog_input_dirty(preempt_t *preempt,
-      retro_input_state_t state_cb, unsigned port)
+      retro_input_state_t state_cb, unsigned port,
+      unsigned threshold_percent)
 {
    int16_t state[20] = {0};
    uint8_t base, i;
@@ -1509,7 +2370,23 @@ static INLINE bool preempt_analog_input_dirty(preempt_t *preempt,
       }
    }
 
-   if (memcmp(preempt->analog_state[port], state, sizeof(state)) == 0)
+   if (threshold_percent)
+   {
+      int threshold = preempt_analog_threshold(preempt, state, port,
+            (int)(threshold_percent * 0x7fff / 100));
+
+      /* Keep the last replayed state as reference, so
+       * that slow drift still replays once it adds up */
+      if (!preempt_analog_change_significant(preempt, state, port,
+               threshold))
+      {
+         if (     runloop_state_get_ptr()->perfcnt_enable
+               && memcmp(preempt->analog_state[port], state, sizeof(state)))
+            preempt_skip_perf.call_cnt++;
+         return false;
+      }
+   }
+   else if (memcmp(preempt->analog_state[port], state, sizeof(state)) == 0)
       return false;
 
    memcpy(preempt->analog_state[port], state, sizeof(state));
@@ -1567,6 +2444,7 @@ static INLINE void preempt_input_poll(preempt_t *preempt,
    int16_t joypad_state;
    retro_input_state_t state_cb = input_driver_state_wrapper;
    unsigned max_users           = settings->uints.input_max_users;
+   unsigned analog_threshold    = settings->uints.preemptive_frames_analog_threshold;
 
    input_driver_poll();
 
@@ -1584,7 +2462,8 @@ static INLINE void preempt_input_poll(preempt_t *preempt,
 
       /* Check requested analogs */
       if (     preempt->analog_mask[p]
-            && preempt_analog_input_dirty(preempt, state_cb, (unsigned)p))
+            && preempt_analog_input_dirty(preempt, state_cb, (unsigned)p,
+               analog_threshold))
       {
          runloop_st->flags |= RUNLOOP_FLAG_INPUT_IS_DIRTY;
          preempt->analog_mask[p] = 0;
@@ -1629,6 +2508,9 @@ void preempt_run(preempt_t *preempt, void *data)
    if ((runloop_st->flags & RUNLOOP_FLAG_INPUT_IS_DIRTY)
          && preempt->frame_count >= preempt->frames)
    {
+      performance_counter_start_plus(runloop_st->perfcnt_enable,
+            preempt_replay_perf);
+
       /* Suspend A/V and run preemptive frames */
       audio_st->flags |=  AUDIO_FLAG_SUSPENDED;
       video_st->flags &= ~VIDEO_FLAG_ACTIVE;
@@ -1658,6 +2540,9 @@ void preempt_run(preempt_t *preempt, void *data)
 
       audio_st->flags &= ~AUDIO_FLAG_SUSPENDED;
       video_st->flags |=  VIDEO_FLAG_ACTIVE;
+
+      performance_counter_stop_plus(runloop_st->perfcnt_enable,
+            preempt_replay_perf);
    }
 
    /* Save current state and set start_ptr to oldest state */
@@ -1694,6 +2579,10 @@ void runahead_clear_variables(void *data)
 {
    runloop_state_t *runloop_st            = (runloop_state_t*)data;
    video_driver_state_t *video_st         = video_state_get_ptr();
+#ifdef HAVE_RUNAHEAD_SNAPSHOT
+   runahead_snapshot_free(runloop_st->runahead_snapshot);
+   runloop_st->runahead_snapshot          = NULL;
+#endif
    runloop_st->runahead_save_state_size   = 0;
    runloop_st->flags                     &= ~RUNLOOP_FLAG_RUNAHEAD_SAVE_STATE_SIZE_KNOWN;
    video_st->flags                       |= VIDEO_FLAG_RUNAHEAD_IS_ACTIVE;
@@ -26,6 +26,23 @@
 
 #define MAX_RUNAHEAD_FRAMES 12
 
+/* log2 buckets of analog input changes */
+#define PREEMPT_ANALOG_HIST_SIZE 16
+
+/* Single instance runahead can roll back by restoring
+ * the pages of the core's own writable segments,
+ * which requires a dynamically loaded core and
+ * dl_iterate_phdr() */
+#if defined(__linux__) && defined(HAVE_DYNAMIC)
+#define HAVE_RUNAHEAD_SNAPSHOT
+#endif
+
+/* Second instance runahead can run the secondary
+ * core on its own thread */
+#if defined(HAVE_THREADS) && defined(HAVE_DYNAMIC)
+#define HAVE_RUNAHEAD_THREAD
+#endif
+
 typedef void *(*constructor_t)(void);
 typedef void  (*destructor_t )(void*);
 
@@ -55,6 +72,14 @@ typedef struct preemptive_frames_data
    int16_t analog_state[MAX_USERS][20];
    int16_t ptrdev_state[MAX_USERS][4];
 
+   /* Analog states of the previous frame, and a decaying
+    * histogram of their frame to frame changes. Used to
+    * pick a per-port threshold below which analog
+    * changes don't trigger a replay */
+   int16_t analog_last[MAX_USERS][20];
+   uint16_t analog_hist[MAX_USERS][PREEMPT_ANALOG_HIST_SIZE];
+   uint16_t analog_hist_total[MAX_USERS];
+
    /* Pointing device requested */
    uint8_t ptr_dev_needed[MAX_USERS];
    /* Device ID of ptrdev_state */
@@ -66,6 +91,9 @@ typedef struct preemptive_frames_data
    uint8_t frames;
 } preempt_t;
 
+typedef struct runahead_snapshot runahead_snapshot_t;
+typedef struct runahead_thread runahead_thread_t;
+
 RETRO_BEGIN_DECLS
 
 typedef bool(*runahead_load_state_function)(const void*, size_t);
@@ -87,6 +115,7 @@ void runahead_set_load_content_info(
       const retro_ctx_load_content_info_t *ctx);
 
 void runahead_secondary_core_destroy(void *data);
+void runahead_secondary_core_sync(void *data);
 
 bool preempt_init(void *data);
 void preempt_deinit(void *data);
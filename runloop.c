@@ -7558,8 +7558,11 @@ bool core_set_cheat(retro_ctx_cheat_info_t *info)
          && (runloop_st->flags & RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE)
          && (secondary_core_ensure_exists(runloop_st, settings))
          && (runloop_st->secondary_core.retro_cheat_set))
+   {
+      runahead_secondary_core_sync(runloop_st);
       runloop_st->secondary_core.retro_cheat_set(
             info->index, info->enabled, info->code);
+   }
 #endif
 
    return true;
@@ -7598,7 +7601,10 @@ bool core_reset_cheat(void)
        && (runloop_st->flags & RUNLOOP_FLAG_RUNAHEAD_SECONDARY_CORE_AVAILABLE)
        && (secondary_core_ensure_exists(runloop_st, settings))
        && (runloop_st->secondary_core.retro_cheat_reset))
+   {
+      runahead_secondary_core_sync(runloop_st);
       runloop_st->secondary_core.retro_cheat_reset();
+   }
 #endif
 
    return true;
@@ -186,6 +186,8 @@ struct runloop
    my_list *runahead_save_state_list;
    my_list *input_state_list;
    preempt_t *preempt_data;
+   runahead_snapshot_t *runahead_snapshot;
+   runahead_thread_t *runahead_thread;
 #endif
 
 #ifdef HAVE_REWIND
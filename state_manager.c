@@ -26,6 +26,7 @@
 #include <retro_inline.h>
 #include <compat/strl.h>
 #include <compat/intrinsics.h>
+#include <features/features_cpu.h>
 
 #include "state_manager.h"
 #include "msg_hash.h"
@@ -65,6 +66,31 @@
 #include <emmintrin.h>
 #endif
 
+/* AVX2 kernels are built with a per-function target
+ * attribute and only selected at runtime, so the rest
+ * of the file does not need to be compiled with -mavx2. */
+#if defined(CPU_X86)
+#if defined(__AVX2__)
+#define STATE_MANAGER_HAVE_AVX2
+#define STATE_MANAGER_AVX2_TARGET
+#elif defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define STATE_MANAGER_HAVE_AVX2
+#define STATE_MANAGER_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1700
+#define STATE_MANAGER_HAVE_AVX2
+#define STATE_MANAGER_AVX2_TARGET
+#endif
+#endif
+
+#ifdef STATE_MANAGER_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(HAVE_NEON)
+#define STATE_MANAGER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
 /* Format per frame (pseudocode): */
 #if 0
 size nextstart;
@@ -87,7 +113,7 @@ size thisstart;
 
 /* There's no equivalent in libc, you'd think so ...
  * std::mismatch exists, but it's not optimized at all. */
-static size_t find_change(const uint16_t *a, const uint16_t *b)
+static size_t find_change_generic(const uint16_t *a, const uint16_t *b)
 {
 #if __SSE2__
    const __m128i *a128 = (const __m128i*)a;
@@ -145,7 +171,7 @@ static size_t find_change(const uint16_t *a, const uint16_t *b)
 #endif
 }
 
-static size_t find_same(const uint16_t *a, const uint16_t *b)
+static size_t find_same_generic(const uint16_t *a, const uint16_t *b)
 {
    const uint16_t *a_org = a;
 #ifdef NO_UNALIGNED_MEM
@@ -185,6 +211,192 @@ static size_t find_same(const uint16_t *a, const uint16_t *b)
    return a - a_org;
 }
 
+/* The vectorized kernels below follow the same rules as
+ * the generic ones, which on x86 makes every kernel produce
+ * byte-identical patches. On other arches the generic code
+ * aligns its scan first, so patches may be split differently,
+ * but they always decompress to the same state.
+ *
+ * find_change() reports the first differing byte,
+ * converted to a uint16 offset.
+ *
+ * find_same() looks for the first identical uint32 at
+ * even uint16 offsets from 'a', then backs off by one
+ * uint16 if the word before it matches as well. */
+
+#ifdef STATE_MANAGER_HAVE_AVX2
+static STATE_MANAGER_AVX2_TARGET size_t find_change_avx2(
+      const uint16_t *a, const uint16_t *b)
+{
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+   size_t offset     = 0;
+
+   for (;;)
+   {
+      __m256i c0     = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(a8 + offset)),
+            _mm256_loadu_si256((const __m256i*)(b8 + offset)));
+      __m256i c1     = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(a8 + offset + 32)),
+            _mm256_loadu_si256((const __m256i*)(b8 + offset + 32)));
+      uint32_t mask0 = (uint32_t)_mm256_movemask_epi8(c0);
+      uint32_t mask1 = (uint32_t)_mm256_movemask_epi8(c1);
+
+      if ((mask0 & mask1) != 0xffffffff)
+      {
+         if (mask0 != 0xffffffff)
+            return (offset + compat_ctz(~mask0)) >> 1;
+         return (offset + 32 + compat_ctz(~mask1)) >> 1;
+      }
+
+      offset        += 64;
+   }
+}
+
+static STATE_MANAGER_AVX2_TARGET size_t find_same_avx2(
+      const uint16_t *a, const uint16_t *b)
+{
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+   size_t offset     = 0;
+   size_t ret;
+
+   for (;;)
+   {
+      __m256i c     = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i*)(a8 + offset)),
+            _mm256_loadu_si256((const __m256i*)(b8 + offset)));
+      uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c));
+
+      if (mask)
+      {
+         ret        = (offset + compat_ctz(mask) * sizeof(uint32_t)) >> 1;
+         break;
+      }
+
+      offset       += 32;
+   }
+
+   if (ret && a[ret - 1] == b[ret - 1])
+      ret--;
+   return ret;
+}
+#endif
+
+#ifdef STATE_MANAGER_HAVE_NEON
+/* NEON has no movemask; fold each 16-byte compare
+ * result into two 64-bit lanes and only go looking for
+ * the exact position once something has been found.
+ * Lane order matches memory order on little endian. */
+static size_t find_change_neon(const uint16_t *a, const uint16_t *b)
+{
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+   size_t offset     = 0;
+
+   for (;;)
+   {
+      uint64x2_t c0 = vreinterpretq_u64_u8(vceqq_u8(
+               vld1q_u8(a8 + offset),      vld1q_u8(b8 + offset)));
+      uint64x2_t c1 = vreinterpretq_u64_u8(vceqq_u8(
+               vld1q_u8(a8 + offset + 16), vld1q_u8(b8 + offset + 16)));
+      uint64x2_t c  = vandq_u64(c0, c1);
+
+      if ((vgetq_lane_u64(c, 0) & vgetq_lane_u64(c, 1)) != UINT64_MAX)
+      {
+         unsigned i;
+         uint64_t lanes[4];
+
+         lanes[0] = vgetq_lane_u64(c0, 0);
+         lanes[1] = vgetq_lane_u64(c0, 1);
+         lanes[2] = vgetq_lane_u64(c1, 0);
+         lanes[3] = vgetq_lane_u64(c1, 1);
+
+         for (i = 0; lanes[i] == UINT64_MAX; i++)
+            offset += 8;
+
+         if (((uint32_t)lanes[i]) == 0xffffffff)
+            return (offset + 4 + compat_ctz(~(uint32_t)(lanes[i] >> 32)) / 8) >> 1;
+         return (offset + compat_ctz(~(uint32_t)lanes[i]) / 8) >> 1;
+      }
+
+      offset       += 32;
+   }
+}
+
+static size_t find_same_neon(const uint16_t *a, const uint16_t *b)
+{
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+   size_t offset     = 0;
+   size_t ret;
+
+   for (;;)
+   {
+      uint32x4_t c = vceqq_u32(
+            vreinterpretq_u32_u8(vld1q_u8(a8 + offset)),
+            vreinterpretq_u32_u8(vld1q_u8(b8 + offset)));
+      uint64x2_t c64 = vreinterpretq_u64_u32(c);
+      uint64_t lo    = vgetq_lane_u64(c64, 0);
+      uint64_t hi    = vgetq_lane_u64(c64, 1);
+
+      if (lo | hi)
+      {
+         unsigned i;
+         uint32_t lanes[4];
+
+         lanes[0] = (uint32_t)lo;
+         lanes[1] = (uint32_t)(lo >> 32);
+         lanes[2] = (uint32_t)hi;
+         lanes[3] = (uint32_t)(hi >> 32);
+
+         for (i = 0; !lanes[i]; i++);
+
+         ret      = (offset + i * sizeof(uint32_t)) >> 1;
+         break;
+      }
+
+      offset      += 16;
+   }
+
+   if (ret && a[ret - 1] == b[ret - 1])
+      ret--;
+   return ret;
+}
+#endif
+
+static size_t (*find_change)(const uint16_t *a, const uint16_t *b) =
+   find_change_generic;
+static size_t (*find_same)(const uint16_t *a, const uint16_t *b) =
+   find_same_generic;
+
+/* Picks the fastest find_change()/find_same() pair the
+ * host CPU supports. */
+static void state_manager_init_simd(void)
+{
+   uint64_t cpu = cpu_features_get();
+
+   find_change  = find_change_generic;
+   find_same    = find_same_generic;
+
+#ifdef STATE_MANAGER_HAVE_AVX2
+   if (cpu & RETRO_SIMD_AVX2)
+   {
+      find_change = find_change_avx2;
+      find_same   = find_same_avx2;
+   }
+#endif
+#ifdef STATE_MANAGER_HAVE_NEON
+   if (cpu & RETRO_SIMD_NEON)
+   {
+      find_change = find_change_neon;
+      find_same   = find_same_neon;
+   }
+#endif
+   (void)cpu;
+}
+
 /* Returns the maximum compressed size of a savestate.
  * It is very likely to compress to far less. */
 static size_t state_manager_raw_maxsize(size_t uncomp)
@@ -206,7 +418,7 @@ static size_t state_manager_raw_maxsize(size_t uncomp)
 static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
 {
    size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 16, 1);
+   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 64, 1);
 
    if (!ret)
       return NULL;
@@ -219,8 +431,9 @@ static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
     *
     * There is also some padding at the end. This is so we don't
     * read outside the buffer end if we're reading in large blocks;
+    * the widest kernel reads 64 bytes per iteration.
     *
-    * It doesn't make any difference to us, but sacrificing 16 bytes to get
+    * It doesn't make any difference to us, but sacrificing 64 bytes to get
     * Valgrind happy is worth it. */
    ret[len16/sizeof(uint16_t) + 3] = uniq;
 
@@ -375,11 +588,49 @@ static INLINE size_t read_size_t(const void *ptr)
    return ret;
 }
 
+#ifdef HAVE_THREADS
+/* Blocks until the compression worker has finished its
+ * current job. The ring buffer, entry count and all
+ * scratch blocks may only be touched by the main thread
+ * after calling this. */
+static void state_manager_sync(state_manager_t *state)
+{
+   if (!state->thread)
+      return;
+
+   slock_lock(state->lock);
+   while (state->job_pending)
+      scond_wait(state->cond, state->lock);
+   slock_unlock(state->lock);
+}
+#endif
+
 static void state_manager_free(state_manager_t *state)
 {
    if (!state)
       return;
 
+#ifdef HAVE_THREADS
+   if (state->thread)
+   {
+      slock_lock(state->lock);
+      state->thread_quit = true;
+      scond_broadcast(state->cond);
+      slock_unlock(state->lock);
+      sthread_join(state->thread);
+   }
+   if (state->lock)
+      slock_free(state->lock);
+   if (state->cond)
+      scond_free(state->cond);
+   if (state->spareblock)
+      free(state->spareblock);
+   state->thread     = NULL;
+   state->lock       = NULL;
+   state->cond       = NULL;
+   state->spareblock = NULL;
+#endif
+
    if (state->data)
       free(state->data);
    if (state->thisblock)
@@ -396,8 +647,82 @@ static void state_manager_free(state_manager_t *state)
    state->nextblock  = NULL;
 }
 
+/* Compresses 'newb' against 'oldb' into the ring buffer,
+ * discarding the oldest entries if there is not enough room. */
+static void state_manager_push_compress(state_manager_t *state,
+      const uint8_t *oldb, const uint8_t *newb)
+{
+   uint8_t *compressed;
+   size_t headpos, tailpos, remaining;
+
+recheckcapacity:;
+   headpos   = state->head - state->data;
+   tailpos   = state->tail - state->data;
+   remaining = (tailpos + state->capacity -
+         sizeof(size_t) - headpos - 1) % state->capacity + 1;
+
+   if (remaining <= state->maxcompsize)
+   {
+      state->tail = state->data + read_size_t(state->tail);
+      state->entries--;
+      goto recheckcapacity;
+   }
+
+   compressed        = state->head + sizeof(size_t);
+
+   compressed       += state_manager_raw_compress(oldb, newb,
+         state->blocksize, compressed);
+
+   if (compressed - state->data + state->maxcompsize > state->capacity)
+   {
+      compressed     = state->data;
+      if (state->tail == state->data + sizeof(size_t))
+         state->tail = state->data + read_size_t(state->tail);
+   }
+   write_size_t(compressed, state->head-state->data);
+   compressed       += sizeof(size_t);
+   write_size_t(state->head, compressed-state->data);
+   state->head       = compressed;
+}
+
+#ifdef HAVE_THREADS
+/**
+ * state_manager_thread:
+ * @data            : pointer to state manager object
+ *
+ * Compression worker for threaded rewind. Waits for
+ * state_manager_push_do() to hand over a pair of
+ * serialized states and writes the delta between them
+ * into the ring buffer.
+ **/
+static void state_manager_thread(void *data)
+{
+   state_manager_t *state = (state_manager_t*)data;
+
+   slock_lock(state->lock);
+
+   for (;;)
+   {
+      while (!state->job_pending && !state->thread_quit)
+         scond_wait(state->cond, state->lock);
+
+      if (state->thread_quit)
+         break;
+
+      slock_unlock(state->lock);
+      state_manager_push_compress(state, state->job_oldb, state->job_newb);
+      slock_lock(state->lock);
+
+      state->job_pending = false;
+      scond_broadcast(state->cond);
+   }
+
+   slock_unlock(state->lock);
+}
+#endif
+
 static state_manager_t *state_manager_new(
-      size_t state_size, size_t buffer_size)
+      size_t state_size, size_t buffer_size, bool threaded)
 {
    size_t max_comp_size, block_size;
    uint8_t *next_block    = NULL;
@@ -408,6 +733,8 @@ static state_manager_t *state_manager_new(
    if (!state)
       return NULL;
 
+   state_manager_init_simd();
+
    block_size         = (state_size + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
    /* the compressed data is surrounded by pointers to the other side */
    max_comp_size      = state_manager_raw_maxsize(state_size) + sizeof(size_t) * 2;
@@ -437,6 +764,30 @@ static state_manager_t *state_manager_new(
    state->debugblock  = (uint8_t*)malloc(state_size);
 #endif
 
+#ifdef HAVE_THREADS
+   /* The worker compresses the previous pair of states
+    * while the core serializes into a third block, so
+    * every block needs a distinct end marker. */
+   if (threaded)
+   {
+      state->spareblock  = (uint8_t*)state_manager_raw_alloc(state_size, 2);
+      state->lock        = slock_new();
+      state->cond        = scond_new();
+
+      if (   state->spareblock
+          && state->lock
+          && state->cond)
+         state->thread   = sthread_create(state_manager_thread, state);
+
+      if (!state->thread)
+      {
+         state_manager_free(state);
+         free(state);
+         return NULL;
+      }
+   }
+#endif
+
    return state;
 
 error:
@@ -456,6 +807,10 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
 
    *data                        = NULL;
 
+#ifdef HAVE_THREADS
+   state_manager_sync(state);
+#endif
+
    if (state->thisblock_valid)
    {
       state->thisblock_valid    = false;
@@ -510,46 +865,42 @@ static void state_manager_push_do(state_manager_t *state)
    memcpy(state->nextblock, state->debugblock, state->debugsize);
 #endif
 
+#ifdef HAVE_THREADS
+   state_manager_sync(state);
+#endif
+
    if (state->thisblock_valid)
    {
-      const uint8_t *oldb, *newb;
-      uint8_t *compressed;
-      size_t headpos, tailpos, remaining;
       if (state->capacity < sizeof(size_t) + state->maxcompsize) {
          RARCH_ERR("State capacity insufficient\n");
          return;
       }
 
-recheckcapacity:;
-      headpos   = state->head - state->data;
-      tailpos   = state->tail - state->data;
-      remaining = (tailpos + state->capacity -
-            sizeof(size_t) - headpos - 1) % state->capacity + 1;
-
-      if (remaining <= state->maxcompsize)
+#ifdef HAVE_THREADS
+      if (state->thread)
       {
-         state->tail = state->data + read_size_t(state->tail);
-         state->entries--;
-         goto recheckcapacity;
-      }
-
-      oldb              = state->thisblock;
-      newb              = state->nextblock;
-      compressed        = state->head + sizeof(size_t);
-
-      compressed       += state_manager_raw_compress(oldb, newb,
-            state->blocksize, compressed);
+         /* The worker keeps reading the old block, so it
+          * is parked as the spare until the next sync; the
+          * core serializes into the previous spare instead. */
+         state->entries++;
 
-      if (compressed - state->data + state->maxcompsize > state->capacity)
-      {
-         compressed     = state->data;
-         if (state->tail == state->data + sizeof(size_t))
-            state->tail = state->data + read_size_t(state->tail);
+         slock_lock(state->lock);
+         state->job_oldb      = state->thisblock;
+         state->job_newb      = state->nextblock;
+         state->job_pending   = true;
+         scond_broadcast(state->cond);
+         slock_unlock(state->lock);
+
+         swap                 = state->thisblock;
+         state->thisblock     = state->nextblock;
+         state->nextblock     = state->spareblock;
+         state->spareblock    = swap;
+         return;
       }
-      write_size_t(compressed, state->head-state->data);
-      compressed       += sizeof(size_t);
-      write_size_t(state->head, compressed-state->data);
-      state->head       = compressed;
+#endif
+
+      state_manager_push_compress(state,
+            state->thisblock, state->nextblock);
    }
    else
       state->thisblock_valid = true;
@@ -579,9 +930,56 @@ static void state_manager_capacity(state_manager_t *state,
 }
 #endif
 
+/* Serializes the core into a state slot handed out by
+ * state_manager_push_where(). */
+static bool state_manager_serialize(
+      struct state_manager_rewind_state *rewind_st, void *data)
+{
+   /* Every slot already holds a complete state, so for
+    * cores with a fixed layout only their data is rewritten,
+    * straight into the slot. */
+   if (rewind_st->core_size)
+   {
+      retro_ctx_serialize_info_t serial_info;
+
+      if (content_serialized_core_block_rewind_is_current())
+      {
+         serial_info.data = (uint8_t*)data + rewind_st->core_offset;
+         serial_info.size = rewind_st->core_size;
+         return core_serialize(&serial_info);
+      }
+
+      /* Something else joined the state since the slots
+       * were primed, write whole states from now on */
+      rewind_st->core_offset = 0;
+      rewind_st->core_size   = 0;
+   }
+
+   return content_serialize_state_rewind(data, rewind_st->size);
+}
+
+/* Copies a complete state into every other slot, so the
+ * headers around the core data never need rewriting. */
+static void state_manager_prime_slots(state_manager_t *state,
+      const void *data, size_t size)
+{
+   if (state->thisblock != data)
+      memcpy(state->thisblock, data, size);
+   if (state->nextblock != data)
+      memcpy(state->nextblock, data, size);
+#ifdef HAVE_THREADS
+   if (state->spareblock && state->spareblock != data)
+      memcpy(state->spareblock, data, size);
+#endif
+#if STRICT_BUF_SIZE
+   if (state->debugblock != data)
+      memcpy(state->debugblock, data, size);
+#endif
+}
+
 void state_manager_event_init(
       struct state_manager_rewind_state *rewind_st,
-      unsigned rewind_buffer_size)
+      unsigned rewind_buffer_size, bool threaded)
 {
    core_info_t *core_info = NULL;
    void *state            = NULL;
@@ -592,6 +990,8 @@ void state_manager_event_init(
       return;
 
    rewind_st->size               = 0;
+   rewind_st->core_offset        = 0;
+   rewind_st->core_size          = 0;
    rewind_st->flags             &= ~(
                                    STATE_MGR_REWIND_ST_FLAG_FRAME_IS_REVERSED
                                  | STATE_MGR_REWIND_ST_FLAG_HOTKEY_WAS_CHECKED
@@ -634,14 +1034,26 @@ void state_manager_event_init(
          (unsigned)(rewind_buffer_size / 1000000));
 
    rewind_st->state = state_manager_new(rewind_st->size,
-         rewind_buffer_size);
+         rewind_buffer_size, threaded);
 
    if (!rewind_st->state)
+   {
       RARCH_WARN("%s.\n", msg_hash_to_str(MSG_REWIND_INIT_FAILED));
+      return;
+   }
 
    state_manager_push_where(rewind_st->state, &state);
 
-   content_serialize_state_rewind(state, rewind_st->size);
+   if (content_serialize_state_rewind(state, rewind_st->size))
+   {
+      size_t core_offset, core_size;
+      if (content_get_serialized_core_block_rewind(&core_offset, &core_size))
+      {
+         state_manager_prime_slots(rewind_st->state, state, rewind_st->size);
+         rewind_st->core_offset = core_offset;
+         rewind_st->core_size   = core_size;
+      }
+   }
 
    state_manager_push_do(rewind_st->state);
 }
@@ -668,6 +1080,8 @@ void state_manager_event_deinit(
 
    rewind_st->state              = NULL;
    rewind_st->size               = 0;
+   rewind_st->core_offset        = 0;
+   rewind_st->core_size          = 0;
    rewind_st->flags             &= ~(
                                    STATE_MGR_REWIND_ST_FLAG_FRAME_IS_REVERSED
                                  | STATE_MGR_REWIND_ST_FLAG_HOTKEY_WAS_CHECKED
@@ -806,7 +1220,7 @@ bool state_manager_check_rewind(
          void *state = NULL;
          state_manager_push_where(rewind_st->state, &state);
 
-         content_serialize_state_rewind(state, rewind_st->size);
+         state_manager_serialize(rewind_st, state);
 
          state_manager_push_do(rewind_st->state);
       }
@@ -24,6 +24,10 @@
 #include <boolean.h>
 #include <retro_common_api.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
 #include "dynamic.h"
 
 RETRO_BEGIN_DECLS
@@ -46,6 +50,17 @@ struct state_manager
 
    uint8_t *thisblock;
    uint8_t *nextblock;
+#ifdef HAVE_THREADS
+   /* Only allocated in threaded mode; holds the
+    * state the worker is still compressing against. */
+   uint8_t *spareblock;
+   /* Pending job for the compression worker. */
+   const uint8_t *job_oldb;
+   const uint8_t *job_newb;
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+#endif
 #if STRICT_BUF_SIZE
    uint8_t *debugblock;
    size_t debugsize;
@@ -61,6 +76,10 @@ struct state_manager
 
    unsigned entries;
    bool thisblock_valid;
+#ifdef HAVE_THREADS
+   bool job_pending;
+   bool thread_quit;
+#endif
 };
 
 typedef struct state_manager state_manager_t;
@@ -70,6 +89,10 @@ struct state_manager_rewind_state
    /* Rewind support. */
    state_manager_t *state;
    size_t size;
+   /* Location of the core data in every state slot when
+    * the rest of the state never changes; 0 otherwise. */
+   size_t core_offset;
+   size_t core_size;
    uint8_t flags;
 };
 
@@ -79,8 +102,16 @@ void state_manager_event_deinit(
       struct state_manager_rewind_state *rewind_st,
       struct retro_core_t *current_core);
 
+/**
+ * state_manager_event_init:
+ * @rewind_buffer_size   : size of the rewind ring buffer, in bytes.
+ * @threaded             : compress states on a background worker
+ *                         instead of the main thread.
+ *
+ * Initializes the rewind state manager for the current core.
+ **/
 void state_manager_event_init(struct state_manager_rewind_state *rewind_st,
-      unsigned rewind_buffer_size);
+      unsigned rewind_buffer_size, bool threaded);
 
 /**
  * check_rewind:
@@ -1140,6 +1140,7 @@ void *task_push_core_updater_download(
          sizeof(task_title) - _len);
 
    task->handler          = task_core_updater_download_handler;
+   task->priority         = TASK_PRIORITY_BACKGROUND;
    task->state            = download_handle;
    task->title            = strdup(task_title);
    task->progress         = 0;
@@ -1669,6 +1670,7 @@ void task_push_update_installed_cores(
 
    /* Configure task */
    task->handler          = task_update_installed_cores_handler;
+   task->priority         = TASK_PRIORITY_BACKGROUND;
    task->state            = update_installed_handle;
    task->title            = strdup(msg_hash_to_str(MSG_FETCHING_CORE_LIST));
    task->progress         = 0;
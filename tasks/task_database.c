@@ -20,6 +20,7 @@
 #include <compat/strl.h>
 #include <retro_miscellaneous.h>
 #include <retro_endianness.h>
+#include <array/rbuf.h>
 #include <string/stdstring.h>
 #include <lists/dir_list.h>
 #include <file/file_path.h>
@@ -27,6 +28,10 @@
 #include <streams/file_stream.h>
 #include <streams/chd_stream.h>
 #include <streams/interface_stream.h>
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
+#endif
 #include "tasks_internal.h"
 
 #include "../core_info.h"
@@ -43,12 +48,64 @@
 #include "../retroarch.h"
 #include "../verbosity.h"
 #include "task_database_cue.h"
+#include "task_database_cache.h"
+
+#ifdef HAVE_THREADS
+/* Content files are identified (read, hashed, probed for a serial)
+ * by a small worker pool running ahead of the task thread, which
+ * only matches the results against the databases and writes the
+ * playlists, in list order. */
+#define DATABASE_SCAN_WORKERS_MAX 4
+#define DATABASE_SCAN_READ_AHEAD  8
+
+enum database_scan_job_state
+{
+   DATABASE_SCAN_JOB_EMPTY = 0,
+   DATABASE_SCAN_JOB_QUEUED,
+   DATABASE_SCAN_JOB_RUNNING,
+   DATABASE_SCAN_JOB_DONE
+};
+
+typedef struct database_scan_job
+{
+   char *path;
+   size_t list_ptr;
+   int64_t size;
+   int64_t mtime;
+   uint32_t crc;
+   uint32_t archive_crc;
+   int ret;
+   enum database_type type;
+   enum database_scan_job_state state;
+   char serial[4096];
+} database_scan_job_t;
+
+typedef struct database_scan_pool
+{
+   sthread_t *threads[DATABASE_SCAN_WORKERS_MAX];
+   slock_t *lock;
+   scond_t *cond_work;
+   scond_t *cond_done;
+   /* Indexed by list position modulo DATABASE_SCAN_READ_AHEAD */
+   database_scan_job_t jobs[DATABASE_SCAN_READ_AHEAD];
+   size_t dispatched;
+   unsigned num_threads;
+   bool quit;
+} database_scan_pool_t;
+#endif
 
 typedef struct database_state_handle
 {
    database_info_list_t *info;
+   database_info_index_t *index;
+#ifdef HAVE_THREADS
+   database_scan_pool_t *pool;
+#endif
+   database_scan_cache_t *cache;
    struct string_list *list;
    uint8_t *buf;
+   int64_t content_size;  /* of the file being identified */
+   int64_t content_mtime; /* -1 if it is not to be cached */
    size_t list_index;
    size_t entry_index;
    uint32_t crc;
@@ -71,6 +128,7 @@ typedef struct db_handle
    char *content_database_path;
    char *fullpath;
    database_info_handle_t *handle;
+   playlist_t *playlist;
    database_state_handle_t state;
    playlist_config_t playlist_config; /* size_t alignment */
    unsigned status;
@@ -613,41 +671,44 @@ static enum msg_file_type extension_to_file_type(const char *ext)
    return FILE_TYPE_NONE;
 }
 
-static int task_database_iterate_playlist(
-      database_state_handle_t *db_state,
-      database_info_handle_t *db, const char *name)
+/* Works out how a content file is looked up and computes its
+ * serial and/or CRC. Only reads the file, so it is safe to run
+ * on the scan workers. Returns 0 if the file should be skipped. */
+static int task_database_identify(const char *name,
+      enum database_type *type, uint32_t *crc, uint32_t *archive_crc,
+      char *serial, size_t serial_len)
 {
+   *type        = DATABASE_TYPE_NONE;
+   *crc         = 0;
+   *archive_crc = 0;
+   serial[0]    = '\0';
+
    switch (extension_to_file_type(path_get_extension(name)))
    {
       case FILE_TYPE_COMPRESSED:
 #ifdef HAVE_COMPRESSION
-         db->type = DATABASE_TYPE_CRC_LOOKUP;
+         *type = DATABASE_TYPE_CRC_LOOKUP;
          /* first check crc of archive itself */
-         return intfstream_file_get_crc(name,
-               0, SIZE_MAX, &db_state->archive_crc);
+         return intfstream_file_get_crc(name, 0, SIZE_MAX, archive_crc);
 #else
          break;
 #endif
       case FILE_TYPE_CUE:
-         task_database_cue_prune(db, name);
-         db_state->serial[0] = '\0';
-         if (task_database_cue_get_serial(name, db_state->serial, sizeof(db_state->serial)))
-            db->type = DATABASE_TYPE_SERIAL_LOOKUP;
+         if (task_database_cue_get_serial(name, serial, serial_len))
+            *type = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
-            db->type = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_cue_get_crc(name, &db_state->crc);
+            *type = DATABASE_TYPE_CRC_LOOKUP;
+            return task_database_cue_get_crc(name, crc);
          }
          break;
       case FILE_TYPE_GDI:
-         gdi_prune(db, name);
-         db_state->serial[0] = '\0';
-         if (task_database_gdi_get_serial(name, db_state->serial, sizeof(db_state->serial)))
-            db->type = DATABASE_TYPE_SERIAL_LOOKUP;
+         if (task_database_gdi_get_serial(name, serial, serial_len))
+            *type = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
-            db->type = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_gdi_get_crc(name, &db_state->crc);
+            *type = DATABASE_TYPE_CRC_LOOKUP;
+            return task_database_gdi_get_crc(name, crc);
          }
          break;
       /* Consider WBFS, RVZ and WIA files similar to ISO files. */
@@ -655,32 +716,366 @@ static int task_database_iterate_playlist(
       case FILE_TYPE_RVZ:
       case FILE_TYPE_WIA:
       case FILE_TYPE_ISO:
-         db_state->serial[0] = '\0';
-         intfstream_file_get_serial(name, 0, SIZE_MAX, db_state->serial, sizeof(db_state->serial));
-         db->type            =  DATABASE_TYPE_SERIAL_LOOKUP;
+         intfstream_file_get_serial(name, 0, SIZE_MAX, serial, serial_len);
+         *type = DATABASE_TYPE_SERIAL_LOOKUP;
          break;
       case FILE_TYPE_CHD:
-         db_state->serial[0] = '\0';
-         if (task_database_chd_get_serial(name, db_state->serial, sizeof(db_state->serial)))
-            db->type         = DATABASE_TYPE_SERIAL_LOOKUP;
+         if (task_database_chd_get_serial(name, serial, serial_len))
+            *type = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
-            db->type         = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_chd_get_crc(name, &db_state->crc);
+            *type = DATABASE_TYPE_CRC_LOOKUP;
+            return task_database_chd_get_crc(name, crc);
          }
          break;
       case FILE_TYPE_LUTRO:
-         db->type            = DATABASE_TYPE_ITERATE_LUTRO;
+         *type = DATABASE_TYPE_ITERATE_LUTRO;
          break;
       default:
-         db_state->serial[0] = '\0';
-         db->type            = DATABASE_TYPE_CRC_LOOKUP;
-         return intfstream_file_get_crc(name, 0, SIZE_MAX, &db_state->crc);
+         *type = DATABASE_TYPE_CRC_LOOKUP;
+         return intfstream_file_get_crc(name, 0, SIZE_MAX, crc);
    }
 
    return 1;
 }
 
+/* Looks up a content file in the scan cache. The file's size and
+ * modification time are returned either way, for storing a fresh
+ * identification; 'mtime' is -1 if the file must not be cached. */
+static const database_scan_cache_entry_t *task_database_cache_find(
+      database_scan_cache_t *cache, const char *name,
+      int64_t *size, int64_t *mtime)
+{
+   *size  = 0;
+   *mtime = -1;
+
+   if (!cache)
+      return NULL;
+
+   /* A cue/gdi sheet is identified through the tracks it references,
+    * whose changes do not show in its own size or time */
+   switch (extension_to_file_type(path_get_extension(name)))
+   {
+      case FILE_TYPE_CUE:
+      case FILE_TYPE_GDI:
+         return NULL;
+      default:
+         break;
+   }
+
+   *mtime = path_get_mtime(name, size);
+   return database_scan_cache_find(cache, name, *size, *mtime);
+}
+
+#ifdef HAVE_THREADS
+static void database_scan_worker(void *data)
+{
+   database_scan_pool_t *pool = (database_scan_pool_t*)data;
+
+   slock_lock(pool->lock);
+
+   while (!pool->quit)
+   {
+      size_t i;
+      database_scan_job_t *job = NULL;
+
+      /* Oldest queued file first; the task thread waits on it */
+      for (i = 0; i < DATABASE_SCAN_READ_AHEAD; i++)
+      {
+         database_scan_job_t *cur = &pool->jobs[i];
+         if (     cur->state == DATABASE_SCAN_JOB_QUEUED
+               && (!job || cur->list_ptr < job->list_ptr))
+            job = cur;
+      }
+
+      if (!job)
+      {
+         scond_wait(pool->cond_work, pool->lock);
+         continue;
+      }
+
+      /* A running job belongs to this worker until it is done */
+      job->state = DATABASE_SCAN_JOB_RUNNING;
+      slock_unlock(pool->lock);
+
+      job->ret   = task_database_identify(job->path, &job->type,
+            &job->crc, &job->archive_crc,
+            job->serial, sizeof(job->serial));
+
+      slock_lock(pool->lock);
+      job->state = DATABASE_SCAN_JOB_DONE;
+      scond_broadcast(pool->cond_done);
+   }
+
+   slock_unlock(pool->lock);
+}
+
+static void database_scan_pool_free(database_scan_pool_t *pool)
+{
+   unsigned i;
+
+   if (!pool)
+      return;
+
+   if (pool->lock)
+   {
+      slock_lock(pool->lock);
+      pool->quit = true;
+      if (pool->cond_work)
+         scond_broadcast(pool->cond_work);
+      slock_unlock(pool->lock);
+   }
+
+   for (i = 0; i < pool->num_threads; i++)
+      sthread_join(pool->threads[i]);
+
+   for (i = 0; i < DATABASE_SCAN_READ_AHEAD; i++)
+      free(pool->jobs[i].path);
+
+   if (pool->cond_work)
+      scond_free(pool->cond_work);
+   if (pool->cond_done)
+      scond_free(pool->cond_done);
+   if (pool->lock)
+      slock_free(pool->lock);
+   free(pool);
+}
+
+static database_scan_pool_t *database_scan_pool_new(void)
+{
+   unsigned i;
+   unsigned num_threads       = cpu_features_get_core_amount();
+   database_scan_pool_t *pool = (database_scan_pool_t*)
+      calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+   if (num_threads > DATABASE_SCAN_WORKERS_MAX)
+      num_threads = DATABASE_SCAN_WORKERS_MAX;
+   /* Even a single worker overlaps file I/O with matching */
+   if (num_threads < 1)
+      num_threads = 1;
+
+   if (     !(pool->lock      = slock_new())
+         || !(pool->cond_work = scond_new())
+         || !(pool->cond_done = scond_new()))
+      goto error;
+
+   for (i = 0; i < num_threads; i++)
+   {
+      if (!(pool->threads[i] = sthread_create(database_scan_worker, pool)))
+         break;
+      pool->num_threads++;
+   }
+
+   if (!pool->num_threads)
+      goto error;
+
+   return pool;
+
+error:
+   database_scan_pool_free(pool);
+   return NULL;
+}
+
+/* Queues the files following 'list_ptr' for identification.
+ * Paths are copied, since cue/gdi pruning frees list entries
+ * and archive expansion may reallocate the list. Files that are
+ * unchanged since the last scan are completed from 'cache'.
+ * Workers ignore empty jobs, so the slots being filled are
+ * claimed under the lock and set up (stat, cache lookup)
+ * outside of it. */
+static void database_scan_pool_fill(database_scan_pool_t *pool,
+      const struct string_list *list, size_t list_ptr,
+      database_scan_cache_t *cache)
+{
+   size_t i, first, last;
+   enum database_scan_job_state next[DATABASE_SCAN_READ_AHEAD];
+   bool queued = false;
+
+   slock_lock(pool->lock);
+
+   /* Drop queued files that have been pruned meanwhile */
+   for (i = 0; i < DATABASE_SCAN_READ_AHEAD; i++)
+   {
+      database_scan_job_t *job = &pool->jobs[i];
+      if (     job->state == DATABASE_SCAN_JOB_QUEUED
+            && !list->elems[job->list_ptr].data)
+      {
+         free(job->path);
+         job->path  = NULL;
+         job->state = DATABASE_SCAN_JOB_EMPTY;
+      }
+   }
+
+   if (pool->dispatched < list_ptr)
+      pool->dispatched = list_ptr;
+
+   for (i = first = pool->dispatched;
+         i < list_ptr + DATABASE_SCAN_READ_AHEAD && i < list->size; i++)
+   {
+      database_scan_job_t *job = &pool->jobs[i % DATABASE_SCAN_READ_AHEAD];
+
+      /* Still busy with a file that was skipped; retry later */
+      if (job->state == DATABASE_SCAN_JOB_RUNNING)
+         break;
+
+      free(job->path);
+      job->path  = NULL;
+      job->state = DATABASE_SCAN_JOB_EMPTY;
+   }
+
+   pool->dispatched = last = i;
+
+   slock_unlock(pool->lock);
+
+   for (i = first; i < last; i++)
+   {
+      size_t slot              = i % DATABASE_SCAN_READ_AHEAD;
+      database_scan_job_t *job = &pool->jobs[slot];
+      const char *path         = list->elems[i].data;
+      const database_scan_cache_entry_t *entry = NULL;
+
+      next[slot] = DATABASE_SCAN_JOB_EMPTY;
+
+      /* Archive members are looked up through the archive */
+      if (     string_is_empty(path)
+            || path_contains_compressed_file(path))
+         continue;
+
+      job->path     = strdup(path);
+      job->list_ptr = i;
+
+      if ((entry = task_database_cache_find(cache, path,
+                  &job->size, &job->mtime)))
+      {
+         job->type        = (enum database_type)entry->type;
+         job->crc         = entry->crc;
+         job->archive_crc = entry->archive_crc;
+         job->ret         = entry->ret;
+         strlcpy(job->serial, entry->serial ? entry->serial : "",
+               sizeof(job->serial));
+         next[slot]       = DATABASE_SCAN_JOB_DONE;
+         continue;
+      }
+
+      next[slot]    = DATABASE_SCAN_JOB_QUEUED;
+      queued        = true;
+   }
+
+   slock_lock(pool->lock);
+
+   for (i = first; i < last; i++)
+   {
+      size_t slot = i % DATABASE_SCAN_READ_AHEAD;
+      pool->jobs[slot].state = next[slot];
+   }
+
+   if (queued)
+      scond_broadcast(pool->cond_work);
+
+   slock_unlock(pool->lock);
+}
+
+/* Collects the identification of list entry 'list_ptr', waiting
+ * for a worker that is still on it. Returns false if no worker
+ * has picked it up, in which case the caller identifies it. */
+static bool database_scan_pool_take(database_scan_pool_t *pool,
+      size_t list_ptr, const char *name,
+      database_state_handle_t *db_state, database_info_handle_t *db,
+      int *ret)
+{
+   bool taken               = false;
+   database_scan_job_t *job = &pool->jobs[list_ptr % DATABASE_SCAN_READ_AHEAD];
+
+   slock_lock(pool->lock);
+
+   if (     job->state != DATABASE_SCAN_JOB_EMPTY
+         && job->list_ptr == list_ptr
+         && string_is_equal(job->path, name))
+   {
+      if (job->state != DATABASE_SCAN_JOB_QUEUED)
+      {
+         while (job->state == DATABASE_SCAN_JOB_RUNNING)
+            scond_wait(pool->cond_done, pool->lock);
+
+         db->type                = job->type;
+         db_state->crc           = job->crc;
+         db_state->archive_crc   = job->archive_crc;
+         db_state->content_size  = job->size;
+         db_state->content_mtime = job->mtime;
+         strlcpy(db_state->serial, job->serial, sizeof(db_state->serial));
+         *ret                    = job->ret;
+         taken                   = true;
+      }
+
+      free(job->path);
+      job->path  = NULL;
+      job->state = DATABASE_SCAN_JOB_EMPTY;
+   }
+
+   slock_unlock(pool->lock);
+
+   return taken;
+}
+#endif
+
+static int task_database_iterate_playlist(
+      database_state_handle_t *db_state,
+      database_info_handle_t *db, const char *name)
+{
+   int ret;
+   bool taken = false;
+
+   /* Pruning edits the file list, so it stays on the task thread */
+   switch (extension_to_file_type(path_get_extension(name)))
+   {
+      case FILE_TYPE_CUE:
+         task_database_cue_prune(db, name);
+         break;
+      case FILE_TYPE_GDI:
+         gdi_prune(db, name);
+         break;
+      default:
+         break;
+   }
+
+#ifdef HAVE_THREADS
+   if (db_state->pool)
+      taken = database_scan_pool_take(db_state->pool, db->list_ptr,
+            name, db_state, db, &ret);
+#endif
+
+   if (!taken)
+   {
+      const database_scan_cache_entry_t *entry = task_database_cache_find(
+            db_state->cache, name,
+            &db_state->content_size, &db_state->content_mtime);
+
+      if (entry)
+      {
+         db->type              = (enum database_type)entry->type;
+         db_state->crc         = entry->crc;
+         db_state->archive_crc = entry->archive_crc;
+         strlcpy(db_state->serial, entry->serial ? entry->serial : "",
+               sizeof(db_state->serial));
+         ret                   = entry->ret;
+      }
+      else
+         ret = task_database_identify(name, &db->type,
+               &db_state->crc, &db_state->archive_crc,
+               db_state->serial, sizeof(db_state->serial));
+   }
+
+   database_scan_cache_update(db_state->cache, name,
+         db_state->content_size, db_state->content_mtime,
+         (uint8_t)db->type, ret, db_state->crc, db_state->archive_crc,
+         db_state->serial);
+
+   return ret;
+}
+
 static int database_info_list_iterate_end_no_match(
       database_info_handle_t *db,
       database_state_handle_t *db_state,
@@ -759,6 +1154,170 @@ static int database_info_list_iterate_new(database_state_handle_t *db_state,
    return 0;
 }
 
+/* Same as database_info_list_iterate_new(), but answered from the
+ * scan-session index. Returns false when the current database is
+ * not indexed, in which case the caller falls back to a query. */
+static bool database_info_list_iterate_index(
+      database_state_handle_t *db_state, bool by_serial)
+{
+   database_info_list_t *info = NULL;
+   const char *new_database   = database_info_get_current_name(db_state);
+   /* Set when the index was created; survives the
+    * reordering done by database_info_list_iterate_found_match() */
+   size_t db_id               = (size_t)
+      db_state->list->elems[db_state->list_index].attr.i;
+
+   if (!db_state->index)
+      return false;
+
+   if (by_serial)
+      info = database_info_index_find_serial(db_state->index,
+            db_id, new_database, db_state->serial);
+   else
+      info = database_info_index_find_crc(db_state->index,
+            db_id, new_database, db_state->crc, db_state->archive_crc);
+
+   if (!info)
+      return false;
+
+   if (db_state->info)
+   {
+      database_info_list_free(db_state->info);
+      free(db_state->info);
+   }
+   db_state->info = info;
+   return true;
+}
+
+/* Matches arrive in scan order and usually cluster per system,
+ * so the current playlist stays open and is only written out once
+ * the scan moves on to another one (or finishes). */
+static void task_database_flush_playlist(db_handle_t *_db)
+{
+   if (!_db->playlist)
+      return;
+   playlist_write_file(_db->playlist);
+   playlist_free(_db->playlist);
+   _db->playlist = NULL;
+}
+
+static playlist_t *task_database_get_playlist(db_handle_t *_db,
+      const char *path)
+{
+   if (_db->playlist)
+   {
+      if (string_is_equal(playlist_get_conf_path(_db->playlist), path))
+         return _db->playlist;
+      task_database_flush_playlist(_db);
+   }
+
+   playlist_config_set_path(&_db->playlist_config, path);
+   _db->playlist = playlist_init(&_db->playlist_config);
+   return _db->playlist;
+}
+
+/* Removes the entry a since deleted file was given in a playlist */
+static void task_database_cache_prune_cb(const char *playlist_name,
+      const char *entry_path, void *userdata)
+{
+   char playlist_path[PATH_MAX_LENGTH];
+   db_handle_t *_db = (db_handle_t*)userdata;
+
+   fill_pathname_join_special(playlist_path, _db->playlist_directory,
+         playlist_name, sizeof(playlist_path));
+
+   /* Never create a playlist just to remove something from it */
+   if (     !(_db->playlist && string_is_equal(
+               playlist_get_conf_path(_db->playlist), playlist_path))
+         && !path_is_valid(playlist_path))
+      return;
+
+   playlist_delete_by_path(task_database_get_playlist(_db, playlist_path),
+         entry_path);
+}
+
+/* The push function reads the entry as const,
+ * so the casts are safe */
+static void task_database_playlist_push(playlist_t *playlist,
+      const char *path, const char *label, const char *db_name,
+      const char *crc32)
+{
+   struct playlist_entry entry;
+
+   entry.path              = (char*)path;
+   entry.label             = (char*)label;
+   entry.core_path         = (char*)"DETECT";
+   entry.core_name         = (char*)"DETECT";
+   entry.db_name           = (char*)db_name;
+   entry.crc32             = (char*)crc32;
+   entry.subsystem_ident   = NULL;
+   entry.subsystem_name    = NULL;
+   entry.subsystem_roms    = NULL;
+   entry.entry_slot        = 0;
+   entry.runtime_hours     = 0;
+   entry.runtime_minutes   = 0;
+   entry.runtime_seconds   = 0;
+   entry.last_played_year  = 0;
+   entry.last_played_month = 0;
+   entry.last_played_day   = 0;
+   entry.last_played_hour  = 0;
+   entry.last_played_minute= 0;
+   entry.last_played_second= 0;
+
+   playlist_push(playlist, &entry);
+}
+
+/* Adds the playlist entries a file matched in an earlier scan,
+ * instead of searching the databases for it again */
+static void task_database_replay_match(db_handle_t *_db,
+      const database_scan_cache_entry_t *cached)
+{
+   size_t i;
+   char playlist_path[PATH_MAX_LENGTH];
+
+   for (i = 0; i < RBUF_LEN(cached->items); i++)
+   {
+      playlist_t *playlist                   = NULL;
+      const database_scan_cache_item_t *item = &cached->items[i];
+
+      playlist_path[0] = '\0';
+      if (!string_is_empty(_db->playlist_directory))
+         fill_pathname_join_special(playlist_path,
+               _db->playlist_directory, item->playlist,
+               sizeof(playlist_path));
+
+      playlist = task_database_get_playlist(_db, playlist_path);
+
+      if (!playlist_entry_exists(playlist, item->entry_path))
+      {
+         task_database_playlist_push(playlist, item->entry_path,
+               item->label, item->playlist, item->crc32);
+         RARCH_LOG("[Scanner]: Add \"%s\" to \"%s\"\n",
+               item->label, item->playlist);
+      }
+   }
+}
+
+/* Returns true if the file just identified matched in an earlier
+ * scan and is unchanged, in which case its playlist entries are
+ * restored and the database search is skipped. Archives are left
+ * out, since a miss expands them into their members. */
+static bool task_database_iterate_cached(db_handle_t *_db,
+      database_state_handle_t *db_state, const char *name)
+{
+   const database_scan_cache_entry_t *cached = database_scan_cache_find(
+         db_state->cache, name,
+         db_state->content_size, db_state->content_mtime);
+
+   if (     !cached
+         || !(cached->flags & DATABASE_SCAN_CACHE_FLAG_MATCHED)
+         || path_is_compressed_file(name))
+      return false;
+
+   task_database_replay_match(_db, cached);
+   return true;
+}
+
 static int database_info_list_iterate_found_match(
       db_handle_t *_db,
       database_state_handle_t *db_state,
@@ -799,8 +1358,7 @@ static int database_info_list_iterate_found_match(
       fill_pathname_join_special(db_playlist_path, _db->playlist_directory,
             db_playlist_base_str, str_len);
 
-   playlist_config_set_path(&_db->playlist_config, db_playlist_path);
-   playlist = playlist_init(&_db->playlist_config);
+   playlist = task_database_get_playlist(_db, db_playlist_path);
 
    if (!string_is_empty(db_state->serial))
    {
@@ -841,6 +1399,9 @@ static int database_info_list_iterate_found_match(
        (hash = strchr(entry_path_str, '#')))
        *hash = '\0';
 
+   database_scan_cache_add_playlist(db_state->cache, entry_path,
+         db_playlist_base_str, entry_path_str, entry_lbl, db_crc);
+
 #if !defined(RARCH_INTERNAL)
    fprintf(stderr, "Found match in database !\n");
 
@@ -855,41 +1416,15 @@ static int database_info_list_iterate_found_match(
 
    if (!playlist_entry_exists(playlist, entry_path_str))
    {
-      struct playlist_entry entry;
-
-      /* the push function reads our entry as const,
-       * so these casts are safe */
-      entry.path              = entry_path_str;
-      entry.label             = entry_lbl;
-      entry.core_path         = (char*)"DETECT";
-      entry.core_name         = (char*)"DETECT";
-      entry.db_name           = db_playlist_base_str;
-      entry.crc32             = db_crc;
-      entry.subsystem_ident   = NULL;
-      entry.subsystem_name    = NULL;
-      entry.subsystem_roms    = NULL;
-      entry.entry_slot        = 0;
-      entry.runtime_hours     = 0;
-      entry.runtime_minutes   = 0;
-      entry.runtime_seconds   = 0;
-      entry.last_played_year  = 0;
-      entry.last_played_month = 0;
-      entry.last_played_day   = 0;
-      entry.last_played_hour  = 0;
-      entry.last_played_minute= 0;
-      entry.last_played_second= 0;
-
-      playlist_push(playlist, &entry);
-      RARCH_LOG("[Scanner]: Add \"%s\" to \"%s\"\n", entry_lbl, entry.db_name);
+      task_database_playlist_push(playlist, entry_path_str, entry_lbl,
+            db_playlist_base_str, db_crc);
+      RARCH_LOG("[Scanner]: Add \"%s\" to \"%s\"\n", entry_lbl, db_playlist_base_str);
       if (retroarch_override_setting_is_set(RARCH_OVERRIDE_SETTING_DATABASE_SCAN, NULL))
          task_database_scan_console_output(entry_lbl, path_remove_extension(db_playlist_base_str), true);
    }
    else if (retroarch_override_setting_is_set(RARCH_OVERRIDE_SETTING_DATABASE_SCAN, NULL))
       task_database_scan_console_output(entry_lbl, path_remove_extension(db_playlist_base_str), false);
 
-   playlist_write_file(playlist);
-   playlist_free(playlist);
-
    database_info_list_free(db_state->info);
    free(db_state->info);
 
@@ -978,11 +1513,15 @@ static int task_database_iterate_crc_lookup(
          }
       }
 
-      snprintf(query, sizeof(query),
-            "{crc:or(b\"%08lX\",b\"%08lX\")}",
-            (unsigned long)db_state->crc, (unsigned long)db_state->archive_crc);
+      if (!database_info_list_iterate_index(db_state, false))
+      {
+         snprintf(query, sizeof(query),
+               "{crc:or(b\"%08lX\",b\"%08lX\")}",
+               (unsigned long)db_state->crc,
+               (unsigned long)db_state->archive_crc);
 
-      database_info_list_iterate_new(db_state, query);
+         database_info_list_iterate_new(db_state, query);
+      }
    }
 
    if (db_state->info)
@@ -1030,6 +1569,7 @@ static int task_database_iterate_playlist_lutro(
       database_info_handle_t *db,
       const char *path)
 {
+   char game_title[NAME_MAX_LENGTH];
    char db_playlist_path[PATH_MAX_LENGTH];
    playlist_t   *playlist  = NULL;
 
@@ -1040,44 +1580,18 @@ static int task_database_iterate_playlist_lutro(
             _db->playlist_directory,
             "Lutro.lpl", sizeof(db_playlist_path));
 
-   playlist_config_set_path(&_db->playlist_config, db_playlist_path);
-   playlist = playlist_init(&_db->playlist_config);
+   playlist = task_database_get_playlist(_db, db_playlist_path);
 
-   if (!playlist_entry_exists(playlist, path))
-   {
-      struct playlist_entry entry;
-      char game_title[NAME_MAX_LENGTH];
-      fill_pathname(game_title,
-            path_basename(path), "", sizeof(game_title));
-      path_remove_extension(game_title);
-
-      /* the push function reads our entry as const,
-       * so these casts are safe */
-      entry.path                  = (char*)path;
-      entry.label                 = game_title;
-      entry.core_path             = (char*)"DETECT";
-      entry.core_name             = (char*)"DETECT";
-      entry.db_name               = (char*)"Lutro.lpl";
-      entry.crc32                 = (char*)"DETECT";
-      entry.subsystem_ident       = NULL;
-      entry.subsystem_name        = NULL;
-      entry.subsystem_roms        = NULL;
-      entry.entry_slot            = 0;
-      entry.runtime_hours         = 0;
-      entry.runtime_minutes       = 0;
-      entry.runtime_seconds       = 0;
-      entry.last_played_year      = 0;
-      entry.last_played_month     = 0;
-      entry.last_played_day       = 0;
-      entry.last_played_hour      = 0;
-      entry.last_played_minute    = 0;
-      entry.last_played_second    = 0;
-
-      playlist_push(playlist, &entry);
-   }
+   fill_pathname(game_title,
+         path_basename(path), "", sizeof(game_title));
+   path_remove_extension(game_title);
+
+   database_scan_cache_add_playlist(db_state->cache, path,
+         "Lutro.lpl", path, game_title, "DETECT");
 
-   playlist_write_file(playlist);
-   playlist_free(playlist);
+   if (!playlist_entry_exists(playlist, path))
+      task_database_playlist_push(playlist, path, game_title,
+            "Lutro.lpl", "DETECT");
 
    return 0;
 }
@@ -1115,7 +1629,8 @@ static int task_database_iterate_serial_lookup(
       return database_info_list_iterate_end_no_match(db, db_state, name,
             path_contains_compressed_file);
 
-   if (db_state->entry_index == 0)
+   if (db_state->entry_index == 0
+         && !database_info_list_iterate_index(db_state, true))
    {
       size_t _len;
       char query[50];
@@ -1188,7 +1703,12 @@ static int task_database_iterate(
    switch (db->type)
    {
       case DATABASE_TYPE_ITERATE:
-         return task_database_iterate_playlist(db_state, db, name);
+         {
+            int ret = task_database_iterate_playlist(db_state, db, name);
+            if (task_database_iterate_cached(_db, db_state, name))
+               return 0;
+            return ret;
+         }
       case DATABASE_TYPE_ITERATE_ARCHIVE:
 #ifdef HAVE_COMPRESSION
          return task_database_iterate_crc_lookup(
@@ -1224,6 +1744,41 @@ static void task_database_cleanup_state(
    db_state->buf = NULL;
 }
 
+/* Hash of what a match depends on besides the file itself:
+ * the databases it is searched in and the scan options */
+static uint32_t task_database_scan_context(db_handle_t *_db,
+      const struct string_list *list)
+{
+   size_t i;
+   uint8_t options[2];
+   uint32_t context = 0;
+#ifdef RARCH_INTERNAL
+   settings_t *settings = config_get_ptr();
+   options[1]           = settings->bools.scan_serial_and_crc ? 1 : 0;
+#else
+   options[1]           = 0;
+#endif
+   options[0]           = (_db->flags
+         & DB_HANDLE_FLAG_SCAN_WITHOUT_CORE_MATCH) ? 1 : 0;
+   context              = encoding_crc32(context, options, sizeof(options));
+
+   for (i = 0; list && i < list->size; i++)
+   {
+      uint8_t stamp[16];
+      int64_t size  = 0;
+      int64_t mtime = path_get_mtime(list->elems[i].data, &size);
+
+      retro_set_unaligned_64le(stamp,     (uint64_t)size);
+      retro_set_unaligned_64le(stamp + 8, (uint64_t)mtime);
+      context = encoding_crc32(context,
+            (const uint8_t*)list->elems[i].data,
+            strlen(list->elems[i].data) + 1);
+      context = encoding_crc32(context, stamp, sizeof(stamp));
+   }
+
+   return context;
+}
+
 static void task_database_handler(retro_task_t *task)
 {
    uint8_t flg;
@@ -1332,6 +1887,36 @@ static void task_database_handler(retro_task_t *task)
                   }
                }
             }
+
+            if (dbstate->list)
+            {
+               size_t i;
+
+               /* Tag each database with its position in the index,
+                * since matched databases get moved to the front
+                * of the list as the scan goes on. */
+               for (i = 0; i < dbstate->list->size; i++)
+                  dbstate->list->elems[i].attr.i = (int)i;
+
+               dbstate->index = database_info_index_new(
+                     dbstate->list->size);
+            }
+
+            if (!string_is_empty(db->playlist_directory))
+            {
+               char cache_path[PATH_MAX_LENGTH];
+               fill_pathname_join_special(cache_path,
+                     db->playlist_directory,
+                     FILE_PATH_CONTENT_SCAN_CACHE, sizeof(cache_path));
+               dbstate->cache = database_scan_cache_load(cache_path);
+               database_scan_cache_set_context(dbstate->cache,
+                     task_database_scan_context(db, dbstate->list));
+            }
+
+#ifdef HAVE_THREADS
+            if (dbinfo->list->size > 1)
+               dbstate->pool = database_scan_pool_new();
+#endif
          }
          dbinfo->status = DATABASE_STATUS_ITERATE_START;
          break;
@@ -1340,6 +1925,11 @@ static void task_database_handler(retro_task_t *task)
          task_database_cleanup_state(dbstate);
          dbstate->list_index  = 0;
          dbstate->entry_index = 0;
+#ifdef HAVE_THREADS
+         if (dbstate->pool)
+            database_scan_pool_fill(dbstate->pool,
+                  dbinfo->list, dbinfo->list_ptr, dbstate->cache);
+#endif
          task_database_iterate_start(task, dbinfo, name);
          break;
       case DATABASE_STATUS_ITERATE:
@@ -1378,6 +1968,11 @@ static void task_database_handler(retro_task_t *task)
                msg = msg_hash_to_str(MSG_SCANNING_OF_DIRECTORY_FINISHED);
             else
                msg = msg_hash_to_str(MSG_SCANNING_OF_FILE_FINISHED);
+            /* Only a completed scan knows which files are gone */
+            database_scan_cache_prune(dbstate->cache, db->fullpath,
+                  (db->flags & DB_HANDLE_FLAG_IS_DIRECTORY) > 0,
+                  task_database_cache_prune_cb, db);
+            task_database_flush_playlist(db);
 #ifdef RARCH_INTERNAL
             task_free_title(task);
             task_set_title(task, strdup(msg));
@@ -1406,12 +2001,22 @@ task_finished:
 
    if (dbstate)
    {
+#ifdef HAVE_THREADS
+      database_scan_pool_free(dbstate->pool);
+      dbstate->pool = NULL;
+#endif
       if (dbstate->list)
          dir_list_free(dbstate->list);
+      database_info_index_free(dbstate->index);
+      dbstate->index = NULL;
+      database_scan_cache_save(dbstate->cache);
+      database_scan_cache_free(dbstate->cache);
+      dbstate->cache = NULL;
    }
 
    if (db)
    {
+      task_database_flush_playlist(db);
       if (!string_is_empty(db->playlist_directory))
          free(db->playlist_directory);
       if (!string_is_empty(db->content_database_path))
@@ -1457,6 +2062,7 @@ bool task_push_dbscan(
       goto error;
 
    t->handler                              = task_database_handler;
+   t->priority                             = TASK_PRIORITY_BACKGROUND;
    t->state                                = db;
    t->callback                             = cb;
    t->title                                = strdup(msg_hash_to_str(
@@ -0,0 +1,559 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_endianness.h>
+#include <array/rbuf.h>
+#include <array/rhmap.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <string/stdstring.h>
+
+#include "task_database_cache.h"
+
+#include "../database_info.h"
+#include "../verbosity.h"
+
+/* File layout, all integers little endian:
+ *
+ *   "RARCHSCC" version:u32 context:u32 count:u32
+ *   count x { path size:i64 mtime:i64 crc:u32 archive_crc:u32
+ *             ret:i32 type:u8 matched:u8 serial items:u32
+ *             items x { playlist entry_path label crc32 } }
+ *
+ * where each string is len:u32 followed by len bytes. */
+#define DATABASE_SCAN_CACHE_MAGIC   "RARCHSCC"
+#define DATABASE_SCAN_CACHE_VERSION 2
+
+struct database_scan_cache
+{
+   char *path;
+   database_scan_cache_entry_t **entries; /* RHMAP, keyed by path */
+   uint32_t context;
+};
+
+static void database_scan_cache_entry_free(database_scan_cache_entry_t *entry)
+{
+   size_t i;
+
+   if (!entry)
+      return;
+
+   for (i = 0; i < RBUF_LEN(entry->items); i++)
+   {
+      free(entry->items[i].playlist);
+      free(entry->items[i].entry_path);
+      free(entry->items[i].label);
+      free(entry->items[i].crc32);
+   }
+   RBUF_FREE(entry->items);
+   free(entry->serial);
+   free(entry);
+}
+
+/* Returns the entry for 'path', creating an empty one if needed */
+static database_scan_cache_entry_t *database_scan_cache_get(
+      database_scan_cache_t *cache, const char *path)
+{
+   database_scan_cache_entry_t *entry = RHMAP_GET_STR(cache->entries, path);
+
+   if (entry)
+      return entry;
+
+   if (!(entry = (database_scan_cache_entry_t*)calloc(1, sizeof(*entry))))
+      return NULL;
+
+   entry->mtime = -1;
+   RHMAP_SET_STR(cache->entries, path, entry);
+   return entry;
+}
+
+/* Reading */
+
+typedef struct
+{
+   const uint8_t *data;
+   size_t len;
+   size_t pos;
+} database_scan_cache_reader_t;
+
+static bool database_scan_cache_read_u8(database_scan_cache_reader_t *r,
+      uint8_t *val)
+{
+   if (r->len - r->pos < 1)
+      return false;
+   *val = r->data[r->pos++];
+   return true;
+}
+
+static bool database_scan_cache_read_u32(database_scan_cache_reader_t *r,
+      uint32_t *val)
+{
+   uint32_t tmp;
+   if (r->len - r->pos < sizeof(tmp))
+      return false;
+   memcpy(&tmp, r->data + r->pos, sizeof(tmp));
+   r->pos += sizeof(tmp);
+   *val    = retro_le_to_cpu32(tmp);
+   return true;
+}
+
+static bool database_scan_cache_read_u64(database_scan_cache_reader_t *r,
+      uint64_t *val)
+{
+   uint64_t tmp;
+   if (r->len - r->pos < sizeof(tmp))
+      return false;
+   memcpy(&tmp, r->data + r->pos, sizeof(tmp));
+   r->pos += sizeof(tmp);
+   *val    = retro_le_to_cpu64(tmp);
+   return true;
+}
+
+static char *database_scan_cache_read_str(database_scan_cache_reader_t *r)
+{
+   uint32_t len;
+   char *str;
+
+   if (     !database_scan_cache_read_u32(r, &len)
+         || r->len - r->pos < len
+         || !(str = (char*)malloc(len + 1)))
+      return NULL;
+
+   memcpy(str, r->data + r->pos, len);
+   str[len] = '\0';
+   r->pos  += len;
+   return str;
+}
+
+static bool database_scan_cache_read_entry(database_scan_cache_t *cache,
+      database_scan_cache_reader_t *r)
+{
+   uint32_t i;
+   uint64_t size, mtime;
+   uint32_t crc, archive_crc, ret, num_items;
+   uint8_t type, matched;
+   database_scan_cache_entry_t *entry = NULL;
+   char *path                         = database_scan_cache_read_str(r);
+
+   if (!path)
+      return false;
+
+   if (     !database_scan_cache_read_u64(r, &size)
+         || !database_scan_cache_read_u64(r, &mtime)
+         || !database_scan_cache_read_u32(r, &crc)
+         || !database_scan_cache_read_u32(r, &archive_crc)
+         || !database_scan_cache_read_u32(r, &ret)
+         || !database_scan_cache_read_u8(r, &type)
+         || !database_scan_cache_read_u8(r, &matched)
+         || type > DATABASE_TYPE_CRC_LOOKUP
+         || !(entry = (database_scan_cache_entry_t*)
+            calloc(1, sizeof(*entry))))
+      goto error;
+
+   entry->size        = (int64_t)size;
+   entry->mtime       = (int64_t)mtime;
+   entry->crc         = crc;
+   entry->archive_crc = archive_crc;
+   entry->ret         = (int32_t)ret;
+   entry->type        = type;
+   entry->flags       = matched ? DATABASE_SCAN_CACHE_FLAG_MATCHED : 0;
+
+   if (!(entry->serial = database_scan_cache_read_str(r)))
+      goto error;
+   if (!*entry->serial)
+   {
+      free(entry->serial);
+      entry->serial = NULL;
+   }
+
+   if (!database_scan_cache_read_u32(r, &num_items))
+      goto error;
+
+   for (i = 0; i < num_items; i++)
+   {
+      database_scan_cache_item_t item;
+
+      item.playlist   = database_scan_cache_read_str(r);
+      item.entry_path = database_scan_cache_read_str(r);
+      item.label      = database_scan_cache_read_str(r);
+      item.crc32      = database_scan_cache_read_str(r);
+
+      if (!item.playlist || !item.entry_path || !item.label || !item.crc32)
+      {
+         free(item.playlist);
+         free(item.entry_path);
+         free(item.label);
+         free(item.crc32);
+         goto error;
+      }
+
+      RBUF_PUSH(entry->items, item);
+   }
+
+   /* Last one wins if a path was written twice */
+   database_scan_cache_entry_free(RHMAP_GET_STR(cache->entries, path));
+   RHMAP_SET_STR(cache->entries, path, entry);
+   free(path);
+   return true;
+
+error:
+   database_scan_cache_entry_free(entry);
+   free(path);
+   return false;
+}
+
+database_scan_cache_t *database_scan_cache_load(const char *path)
+{
+   uint32_t i, version, count;
+   database_scan_cache_reader_t r;
+   void *buf                    = NULL;
+   int64_t len                  = 0;
+   database_scan_cache_t *cache = (database_scan_cache_t*)
+      calloc(1, sizeof(*cache));
+
+   if (!cache)
+      return NULL;
+
+   cache->path = strdup(path);
+
+   if (     !path_is_valid(path)
+         || !filestream_read_file(path, &buf, &len))
+      return cache;
+
+   r.data = (const uint8_t*)buf;
+   r.len  = (size_t)len;
+   r.pos  = STRLEN_CONST(DATABASE_SCAN_CACHE_MAGIC);
+
+   if (     r.len < r.pos
+         || memcmp(r.data, DATABASE_SCAN_CACHE_MAGIC, r.pos)
+         || !database_scan_cache_read_u32(&r, &version)
+         || version != DATABASE_SCAN_CACHE_VERSION
+         || !database_scan_cache_read_u32(&r, &cache->context)
+         || !database_scan_cache_read_u32(&r, &count))
+      goto error;
+
+   for (i = 0; i < count; i++)
+      if (!database_scan_cache_read_entry(cache, &r))
+         goto error;
+
+   free(buf);
+   return cache;
+
+error:
+   /* Start over rather than trust a partial read */
+   RARCH_WARN("[Scanner]: Ignoring invalid scan cache \"%s\".\n", path);
+   for (i = 0; i < RHMAP_CAP(cache->entries); i++)
+      if (RHMAP_KEY(cache->entries, i))
+         database_scan_cache_entry_free(cache->entries[i]);
+   RHMAP_FREE(cache->entries);
+   free(buf);
+   return cache;
+}
+
+/* Writing */
+
+static void database_scan_cache_write(uint8_t **buf,
+      const void *data, size_t len)
+{
+   size_t pos = RBUF_LEN(*buf);
+   RBUF_RESIZE(*buf, pos + len);
+   memcpy(*buf + pos, data, len);
+}
+
+static void database_scan_cache_write_u32(uint8_t **buf, uint32_t val)
+{
+   val = retro_cpu_to_le32(val);
+   database_scan_cache_write(buf, &val, sizeof(val));
+}
+
+static void database_scan_cache_write_u64(uint8_t **buf, uint64_t val)
+{
+   val = retro_cpu_to_le64(val);
+   database_scan_cache_write(buf, &val, sizeof(val));
+}
+
+static void database_scan_cache_write_str(uint8_t **buf, const char *str)
+{
+   size_t len = str ? strlen(str) : 0;
+   database_scan_cache_write_u32(buf, (uint32_t)len);
+   database_scan_cache_write(buf, str, len);
+}
+
+bool database_scan_cache_save(database_scan_cache_t *cache)
+{
+   size_t i, j;
+   bool ret       = false;
+   uint32_t count = 0;
+   uint8_t *buf   = NULL;
+
+   if (!cache || string_is_empty(cache->path))
+      return false;
+
+   database_scan_cache_write(&buf, DATABASE_SCAN_CACHE_MAGIC,
+         STRLEN_CONST(DATABASE_SCAN_CACHE_MAGIC));
+   database_scan_cache_write_u32(&buf, DATABASE_SCAN_CACHE_VERSION);
+   database_scan_cache_write_u32(&buf, cache->context);
+   /* Patched once the live entries are known */
+   database_scan_cache_write_u32(&buf, 0);
+
+   for (i = 0; i < RHMAP_CAP(cache->entries); i++)
+   {
+      database_scan_cache_entry_t *entry;
+      uint8_t matched;
+
+      if (!RHMAP_KEY(cache->entries, i))
+         continue;
+
+      entry = cache->entries[i];
+      if (entry->flags & DATABASE_SCAN_CACHE_FLAG_DEAD)
+         continue;
+
+      matched = (entry->flags & DATABASE_SCAN_CACHE_FLAG_MATCHED) ? 1 : 0;
+
+      database_scan_cache_write_str(&buf, RHMAP_KEY_STR(cache->entries, i));
+      database_scan_cache_write_u64(&buf, (uint64_t)entry->size);
+      database_scan_cache_write_u64(&buf, (uint64_t)entry->mtime);
+      database_scan_cache_write_u32(&buf, entry->crc);
+      database_scan_cache_write_u32(&buf, entry->archive_crc);
+      database_scan_cache_write_u32(&buf, (uint32_t)entry->ret);
+      database_scan_cache_write(&buf, &entry->type, 1);
+      database_scan_cache_write(&buf, &matched, 1);
+      database_scan_cache_write_str(&buf, entry->serial);
+      database_scan_cache_write_u32(&buf, (uint32_t)RBUF_LEN(entry->items));
+      for (j = 0; j < RBUF_LEN(entry->items); j++)
+      {
+         database_scan_cache_write_str(&buf, entry->items[j].playlist);
+         database_scan_cache_write_str(&buf, entry->items[j].entry_path);
+         database_scan_cache_write_str(&buf, entry->items[j].label);
+         database_scan_cache_write_str(&buf, entry->items[j].crc32);
+      }
+      count++;
+   }
+
+   count = retro_cpu_to_le32(count);
+   memcpy(buf + STRLEN_CONST(DATABASE_SCAN_CACHE_MAGIC)
+         + 2 * sizeof(uint32_t), &count, sizeof(count));
+
+   ret = filestream_write_file(cache->path, buf, (int64_t)RBUF_LEN(buf));
+   if (!ret)
+      RARCH_WARN("[Scanner]: Failed to write scan cache \"%s\".\n",
+            cache->path);
+
+   RBUF_FREE(buf);
+   return ret;
+}
+
+void database_scan_cache_set_context(database_scan_cache_t *cache,
+      uint32_t context)
+{
+   size_t i;
+
+   if (!cache || cache->context == context)
+      return;
+
+   for (i = 0; i < RHMAP_CAP(cache->entries); i++)
+      if (RHMAP_KEY(cache->entries, i))
+         cache->entries[i]->flags &= ~DATABASE_SCAN_CACHE_FLAG_MATCHED;
+   cache->context = context;
+}
+
+void database_scan_cache_free(database_scan_cache_t *cache)
+{
+   size_t i;
+
+   if (!cache)
+      return;
+
+   for (i = 0; i < RHMAP_CAP(cache->entries); i++)
+      if (RHMAP_KEY(cache->entries, i))
+         database_scan_cache_entry_free(cache->entries[i]);
+   RHMAP_FREE(cache->entries);
+   free(cache->path);
+   free(cache);
+}
+
+const database_scan_cache_entry_t *database_scan_cache_find(
+      database_scan_cache_t *cache, const char *path,
+      int64_t size, int64_t mtime)
+{
+   database_scan_cache_entry_t *entry;
+
+   if (!cache || mtime < 0)
+      return NULL;
+
+   entry = RHMAP_GET_STR(cache->entries, path);
+   if (     !entry
+         || (entry->flags & DATABASE_SCAN_CACHE_FLAG_DEAD)
+         || entry->size  != size
+         || entry->mtime != mtime)
+      return NULL;
+
+   return entry;
+}
+
+void database_scan_cache_update(database_scan_cache_t *cache,
+      const char *path, int64_t size, int64_t mtime,
+      uint8_t type, int32_t ret, uint32_t crc, uint32_t archive_crc,
+      const char *serial)
+{
+   database_scan_cache_entry_t *entry;
+   uint8_t matched;
+
+   if (     !cache
+         || mtime < 0
+         || !(entry = database_scan_cache_get(cache, path)))
+      return;
+
+   matched = entry->flags & DATABASE_SCAN_CACHE_FLAG_MATCHED;
+
+   if (!string_is_equal(entry->serial ? entry->serial : "",
+            serial ? serial : ""))
+   {
+      free(entry->serial);
+      entry->serial = string_is_empty(serial) ? NULL : strdup(serial);
+      matched       = 0;
+   }
+
+   if (     entry->size        != size
+         || entry->mtime       != mtime
+         || entry->crc         != crc
+         || entry->archive_crc != archive_crc
+         || entry->type        != type)
+      matched = 0;
+
+   entry->size        = size;
+   entry->mtime       = mtime;
+   entry->crc         = crc;
+   entry->archive_crc = archive_crc;
+   entry->ret         = ret;
+   entry->type        = type;
+   entry->flags       = DATABASE_SCAN_CACHE_FLAG_SEEN | matched;
+}
+
+void database_scan_cache_add_playlist(database_scan_cache_t *cache,
+      const char *path, const char *playlist_name,
+      const char *entry_path, const char *label, const char *crc32)
+{
+   size_t i;
+   char *delim;
+   char *key;
+   database_scan_cache_item_t item;
+   database_scan_cache_entry_t *entry;
+
+   if (     !cache
+         || string_is_empty(path)
+         || string_is_empty(playlist_name)
+         || string_is_empty(entry_path)
+         || !(key = strdup(path)))
+      return;
+
+   if ((delim = strchr(key, '#')))
+      *delim = '\0';
+
+   /* Only files the scan has identified are tracked */
+   entry = RHMAP_GET_STR(cache->entries, key);
+   free(key);
+   if (!entry)
+      return;
+
+   entry->flags |= DATABASE_SCAN_CACHE_FLAG_MATCHED;
+
+   for (i = 0; i < RBUF_LEN(entry->items); i++)
+   {
+      database_scan_cache_item_t *cur = &entry->items[i];
+
+      if (     !string_is_equal(cur->playlist, playlist_name)
+            || !string_is_equal(cur->entry_path, entry_path))
+         continue;
+
+      /* Same entry, the databases may have renamed it */
+      if (!string_is_equal(cur->label, label ? label : ""))
+      {
+         free(cur->label);
+         cur->label = strdup(label ? label : "");
+      }
+      if (!string_is_equal(cur->crc32, crc32 ? crc32 : ""))
+      {
+         free(cur->crc32);
+         cur->crc32 = strdup(crc32 ? crc32 : "");
+      }
+      return;
+   }
+
+   item.playlist   = strdup(playlist_name);
+   item.entry_path = strdup(entry_path);
+   item.label      = strdup(label ? label : "");
+   item.crc32      = strdup(crc32 ? crc32 : "");
+   RBUF_PUSH(entry->items, item);
+}
+
+void database_scan_cache_prune(database_scan_cache_t *cache,
+      const char *root, bool directory,
+      void (*cb)(const char *playlist_name, const char *entry_path,
+         void *userdata),
+      void *userdata)
+{
+   size_t i, j;
+   size_t root_len;
+
+   if (!cache || string_is_empty(root))
+      return;
+
+   root_len = strlen(root);
+
+   for (i = 0; i < RHMAP_CAP(cache->entries); i++)
+   {
+      database_scan_cache_entry_t *entry;
+      const char *path;
+
+      if (!RHMAP_KEY(cache->entries, i))
+         continue;
+
+      entry = cache->entries[i];
+      path  = RHMAP_KEY_STR(cache->entries, i);
+
+      if (entry->flags & (DATABASE_SCAN_CACHE_FLAG_SEEN
+               | DATABASE_SCAN_CACHE_FLAG_DEAD))
+         continue;
+
+      if (directory)
+      {
+         if (     strncmp(path, root, root_len)
+               || (     path[root_len] != '/'
+                     && path[root_len] != '\\'
+                     && root[root_len - 1] != '/'
+                     && root[root_len - 1] != '\\'))
+            continue;
+      }
+      else if (!string_is_equal(path, root))
+         continue;
+
+      /* Outside the scan's filters, but still there */
+      if (path_is_valid(path))
+         continue;
+
+      RARCH_LOG("[Scanner]: Removing deleted content \"%s\".\n", path);
+
+      if (cb)
+         for (j = 0; j < RBUF_LEN(entry->items); j++)
+            cb(entry->items[j].playlist, entry->items[j].entry_path,
+                  userdata);
+
+      /* Deleting while iterating would reshuffle the map */
+      entry->flags |= DATABASE_SCAN_CACHE_FLAG_DEAD;
+   }
+}
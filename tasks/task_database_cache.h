@@ -0,0 +1,146 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TASK_DATABASE_CACHE
+#define TASK_DATABASE_CACHE
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Persistent record of what the database scanner found out about
+ * each content file, keyed by path and validated by size and
+ * modification time.  A rescan only has to identify files that
+ * are new or changed, can re-add the playlist entries of files
+ * that matched without searching the databases again, and can
+ * remove deleted files from the playlists they were added to. */
+
+typedef struct database_scan_cache database_scan_cache_t;
+
+enum database_scan_cache_flags
+{
+   DATABASE_SCAN_CACHE_FLAG_SEEN    = (1 << 0),
+   DATABASE_SCAN_CACHE_FLAG_DEAD    = (1 << 1),
+   /* 'items' is the complete match result for the current
+    * context, see database_scan_cache_set_context() */
+   DATABASE_SCAN_CACHE_FLAG_MATCHED = (1 << 2)
+};
+
+typedef struct database_scan_cache_item
+{
+   char *playlist;                /* playlist file name */
+   char *entry_path;              /* path of the playlist entry */
+   char *label;                   /* label of the playlist entry */
+   char *crc32;                   /* "<crc>|crc" or "<serial>|serial" */
+} database_scan_cache_item_t;
+
+typedef struct database_scan_cache_entry
+{
+   char *serial;                  /* NULL if none */
+   database_scan_cache_item_t *items; /* RBUF */
+   int64_t size;
+   int64_t mtime;
+   uint32_t crc;
+   uint32_t archive_crc;
+   int32_t ret;
+   uint8_t type;                  /* enum database_type */
+   uint8_t flags;
+} database_scan_cache_entry_t;
+
+/**
+ * database_scan_cache_load:
+ * @path                : Cache file.
+ *
+ * Loads the cache stored at @path.  A missing or unreadable file
+ * gives an empty cache, which database_scan_cache_save() writes
+ * back to @path.
+ *
+ * Returns: cache handle, or NULL on allocation failure.
+ **/
+database_scan_cache_t *database_scan_cache_load(const char *path);
+
+bool database_scan_cache_save(database_scan_cache_t *cache);
+
+/**
+ * database_scan_cache_set_context:
+ * @context             : Hash of everything besides the file itself
+ *                        that decides what it matches, i.e. the
+ *                        databases and the scan options.
+ *
+ * Cached match results from a different context are dropped.
+ **/
+void database_scan_cache_set_context(database_scan_cache_t *cache,
+      uint32_t context);
+
+void database_scan_cache_free(database_scan_cache_t *cache);
+
+/**
+ * database_scan_cache_find:
+ *
+ * Returns: the cached entry for @path if its @size and @mtime
+ * still match, otherwise NULL.
+ **/
+const database_scan_cache_entry_t *database_scan_cache_find(
+      database_scan_cache_t *cache, const char *path,
+      int64_t size, int64_t mtime);
+
+/**
+ * database_scan_cache_update:
+ *
+ * Stores the identification of @path and marks it as seen by the
+ * current scan.  Playlist entries recorded for @path are kept, but
+ * only remain the match result if the identification is unchanged.
+ **/
+void database_scan_cache_update(database_scan_cache_t *cache,
+      const char *path, int64_t size, int64_t mtime,
+      uint8_t type, int32_t ret, uint32_t crc, uint32_t archive_crc,
+      const char *serial);
+
+/**
+ * database_scan_cache_add_playlist:
+ * @path                : Content path; an archive member is
+ *                        recorded against its archive.
+ * @playlist_name       : Playlist file name, without directory.
+ * @entry_path          : Path the playlist entry was added with.
+ * @label               : Label the playlist entry was added with.
+ * @crc32               : CRC field the playlist entry was added with.
+ *
+ * Records a match for @path and marks its match result complete.
+ **/
+void database_scan_cache_add_playlist(database_scan_cache_t *cache,
+      const char *path, const char *playlist_name,
+      const char *entry_path, const char *label, const char *crc32);
+
+/**
+ * database_scan_cache_prune:
+ * @root                : Scanned directory, or scanned file.
+ * @directory           : Whether @root is a directory.
+ * @cb                  : Called for every playlist entry that was
+ *                        added for a deleted file.
+ *
+ * Drops files below @root that the current scan has not seen and
+ * that no longer exist.
+ **/
+void database_scan_cache_prune(database_scan_cache_t *cache,
+      const char *root, bool directory,
+      void (*cb)(const char *playlist_name, const char *entry_path,
+         void *userdata),
+      void *userdata);
+
+RETRO_END_DECLS
+
+#endif
@@ -611,6 +611,7 @@ bool task_push_manual_content_scan(
 
    /* > Configure task */
    task->handler                 = task_manual_content_scan_handler;
+   task->priority                = TASK_PRIORITY_BACKGROUND;
    task->state                   = manual_scan;
    task->title                   = strdup(task_title);
    task->progress                = 0;
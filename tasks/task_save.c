@@ -72,6 +72,10 @@
 #define RASTATE_CHEEVOS_BLOCK "ACHV"
 #define RASTATE_REPLAY_BLOCK "RPLY"
 #define RASTATE_END_BLOCK "END "
+/* "RASTATE" followed by the version byte */
+#define RASTATE_ID_SIZE 8
+/* Block marker followed by the 32-bit block size */
+#define RASTATE_BLOCK_HEADER_SIZE 8
 
 struct save_state_buf
 {
@@ -345,20 +349,23 @@ static size_t content_get_rastate_size(rastate_size_info_t* size, bool rewind)
    if (!info_size)
       return 0;
    size->coremem_size = info_size;
-   /* 8-byte identifier, 8-byte block header, content, 8-byte terminator */
-   size->total_size   = 8 + 8 + CONTENT_ALIGN_SIZE(info_size) + 8;
+   /* Identifier, block header, content, terminator block header */
+   size->total_size   = RASTATE_ID_SIZE + RASTATE_BLOCK_HEADER_SIZE
+      + CONTENT_ALIGN_SIZE(info_size) + RASTATE_BLOCK_HEADER_SIZE;
 #ifdef HAVE_CHEEVOS
-   /* 8-byte block header + content */
+   /* Block header + content */
    if ((size->cheevos_size = rcheevos_get_serialize_size()) > 0)
-      size->total_size += 8 + CONTENT_ALIGN_SIZE(size->cheevos_size);
+      size->total_size += RASTATE_BLOCK_HEADER_SIZE
+         + CONTENT_ALIGN_SIZE(size->cheevos_size);
 #endif
 #ifdef HAVE_BSV_MOVIE
-   /* 8-byte block header + content */
+   /* Block header + content */
    if(!rewind)
    {
       size->replay_size = replay_get_serialize_size();
       if(size->replay_size > 0)
-         size->total_size += 8 + CONTENT_ALIGN_SIZE(size->replay_size);
+         size->total_size += RASTATE_BLOCK_HEADER_SIZE
+            + CONTENT_ALIGN_SIZE(size->replay_size);
    }
    else
       size->replay_size = 0;
@@ -396,7 +403,7 @@ static bool content_write_serialized_state(void* buffer,
    /* 8-byte identifier "RASTATE1" where 1 is the version */
    memcpy(output, "RASTATE", 7);
    output[7] = RASTATE_VERSION;
-   output   += 8;
+   output   += RASTATE_ID_SIZE;
   /* Replay block---this has to come before the mem block since its
      contents may prevent the state from loading (e.g., if it's
      incompatible with the current recording). */
@@ -414,15 +421,15 @@ static bool content_write_serialized_state(void* buffer,
        {
           content_write_block_header(output,
              RASTATE_REPLAY_BLOCK, size->replay_size);
-          if (replay_get_serialized_data(output + 8))
-            output += CONTENT_ALIGN_SIZE(size->replay_size) + 8;
+          if (replay_get_serialized_data(output + RASTATE_BLOCK_HEADER_SIZE))
+            output += CONTENT_ALIGN_SIZE(size->replay_size) + RASTATE_BLOCK_HEADER_SIZE;
        }
     }
 #endif
 
    /* important - write the unaligned size - some cores fail if they aren't passed the exact right size. */
    content_write_block_header(output, RASTATE_MEM_BLOCK, size->coremem_size);
-   output += 8;
+   output += RASTATE_BLOCK_HEADER_SIZE;
 
    /* important - pass the unaligned size to the core. some fail if it isn't exactly what they're expecting. */
    serial_info.size = size->coremem_size;
@@ -437,8 +444,8 @@ static bool content_write_serialized_state(void* buffer,
    {
       content_write_block_header(output,
             RASTATE_CHEEVOS_BLOCK, size->cheevos_size);
-      if (rcheevos_get_serialized_data(output + 8))
-         output += CONTENT_ALIGN_SIZE(size->cheevos_size) + 8;
+      if (rcheevos_get_serialized_data(output + RASTATE_BLOCK_HEADER_SIZE))
+         output += CONTENT_ALIGN_SIZE(size->cheevos_size) + RASTATE_BLOCK_HEADER_SIZE;
    }
 #endif
 
@@ -468,6 +475,35 @@ bool content_serialize_state_rewind(void* buffer, size_t buffer_size)
    return content_write_serialized_state(buffer, &size, true);
 }
 
+bool content_get_serialized_core_block_rewind(size_t *offset, size_t *size)
+{
+   rastate_size_info_t info;
+
+   if (core_serialization_quirks() & RETRO_SERIALIZATION_QUIRK_CORE_VARIABLE_SIZE)
+      return false;
+   if (content_get_rastate_size(&info, true) == 0)
+      return false;
+   if (!content_serialized_core_block_rewind_is_current())
+      return false;
+
+   /* Rewind states have no replay block, so the memory block
+    * directly follows the identifier,
+    * see content_write_serialized_state() */
+   *offset = RASTATE_ID_SIZE + RASTATE_BLOCK_HEADER_SIZE;
+   *size   = info.coremem_size;
+   return true;
+}
+
+bool content_serialized_core_block_rewind_is_current(void)
+{
+#ifdef HAVE_CHEEVOS
+   /* The achievement block is not part of the core data */
+   if (rcheevos_get_serialize_size())
+      return false;
+#endif
+   return true;
+}
+
 static void *content_get_serialized_data(size_t* serial_size)
 {
    size_t len;
@@ -638,6 +674,7 @@ static bool task_push_undo_save_state(const char *path, void *data, size_t size)
       state->flags              |= SAVE_TASK_FLAG_MUTE;
 
    task->type                    = TASK_TYPE_BLOCKING;
+   task->priority                = TASK_PRIORITY_INTERACTIVE;
    task->state                   = state;
    task->handler                 = task_save_handler;
    task->callback                = undo_save_state_cb;
@@ -1196,6 +1233,7 @@ static void task_push_save_state(const char *path, void *data, size_t size, bool
       state->flags              |= SAVE_TASK_FLAG_MUTE;
 
    task->type                    = TASK_TYPE_BLOCKING;
+   task->priority                = TASK_PRIORITY_INTERACTIVE;
    task->state                   = state;
    task->handler                 = task_save_handler;
    task->callback                = save_state_cb;
@@ -1307,6 +1345,7 @@ static void task_push_load_and_save_state(const char *path, void *data,
 
    task->state                   = state;
    task->type                    = TASK_TYPE_BLOCKING;
+   task->priority                = TASK_PRIORITY_INTERACTIVE;
    task->handler                 = task_load_handler;
    task->callback                = content_load_and_save_state_cb;
    task->title                   = strdup(msg_hash_to_str(MSG_LOADING_STATE));
@@ -1595,6 +1634,7 @@ bool content_load_state(const char *path,
       state->flags             |= SAVE_TASK_FLAG_MUTE;
 
    task->type                   = TASK_TYPE_BLOCKING;
+   task->priority               = TASK_PRIORITY_INTERACTIVE;
    task->state                  = state;
    task->handler                = task_load_handler;
    task->callback               = content_load_state_cb;
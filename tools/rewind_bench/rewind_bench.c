@@ -0,0 +1,287 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Replays a sequence of savestates through the rewind
+ * delta encoder with every find_change()/find_same()
+ * kernel the host supports, and reports throughput. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Pull in the encoder with all its static helpers. */
+#include "../../state_manager.c"
+
+/* state_manager.c is built as part of RetroArch; stub out
+ * the frontend functions it references outside the
+ * encoder, none of which are reached from here. */
+const char *msg_hash_to_str(enum msg_hash_enums msg) { return ""; }
+bool core_info_get_current_core(core_info_t **core_info) { return false; }
+bool core_info_current_supports_rewind(void) { return false; }
+bool audio_driver_has_callback(void) { return false; }
+size_t content_get_serialized_size_rewind(void) { return 0; }
+bool content_serialize_state_rewind(void *buffer, size_t size) { return false; }
+bool content_deserialize_state(const void *buffer, size_t size) { return false; }
+bool content_get_serialized_core_block_rewind(size_t *offset, size_t *size) { return false; }
+bool content_serialized_core_block_rewind_is_current(void) { return false; }
+bool core_serialize(retro_ctx_serialize_info_t *info) { return false; }
+void audio_driver_frame_is_reverse(void) { }
+void audio_driver_setup_rewind(void) { }
+void audio_driver_sample(int16_t left, int16_t right) { }
+size_t audio_driver_sample_batch(const int16_t *data, size_t frames) { return 0; }
+void audio_driver_sample_rewind(int16_t left, int16_t right) { }
+size_t audio_driver_sample_batch_rewind(const int16_t *data, size_t frames) { return 0; }
+bool retroarch_ctl(enum rarch_ctl_state state, void *data) { return false; }
+void runloop_msg_queue_push(const char *msg, unsigned prio, unsigned duration,
+      bool flush, char *title, enum message_queue_icon icon,
+      enum message_queue_category category) { }
+void RARCH_LOG(const char *fmt, ...) { }
+void RARCH_WARN(const char *fmt, ...) { }
+void RARCH_ERR(const char *fmt, ...) { }
+#ifdef HAVE_NETWORKING
+bool netplay_driver_ctl(enum rarch_netplay_ctl_state state, void *data) { return false; }
+#endif
+#ifdef HAVE_BSV_MOVIE
+void bsv_movie_frame_rewind(void) { }
+#endif
+
+struct bench_kernel
+{
+   const char *name;
+   size_t (*find_change)(const uint16_t *a, const uint16_t *b);
+   size_t (*find_same)(const uint16_t *a, const uint16_t *b);
+   uint64_t simd;
+};
+
+static const struct bench_kernel bench_kernels[] = {
+   { "generic", find_change_generic, find_same_generic, 0 },
+#ifdef STATE_MANAGER_HAVE_AVX2
+   { "avx2",    find_change_avx2,    find_same_avx2,    RETRO_SIMD_AVX2 },
+#endif
+#ifdef STATE_MANAGER_HAVE_NEON
+   { "neon",    find_change_neon,    find_same_neon,    RETRO_SIMD_NEON },
+#endif
+};
+
+static uint8_t *bench_read_file(const char *path, size_t *len)
+{
+   long size;
+   uint8_t *buf = NULL;
+   FILE *fp     = fopen(path, "rb");
+
+   if (!fp)
+      return NULL;
+
+   fseek(fp, 0, SEEK_END);
+   size = ftell(fp);
+   fseek(fp, 0, SEEK_SET);
+
+   if (size > 0 && (buf = (uint8_t*)malloc(size)))
+   {
+      if (fread(buf, 1, size, fp) != (size_t)size)
+      {
+         free(buf);
+         buf = NULL;
+      }
+   }
+
+   fclose(fp);
+   *len = (size_t)size;
+   return buf;
+}
+
+/* Synthetic frames: a mostly static state where a few
+ * scattered pages and some 'hot' variables change. */
+static void bench_synth_state(uint8_t *data, size_t len, unsigned frame)
+{
+   size_t i;
+   unsigned seed = 1;
+
+   for (i = 0; i < len; i++)
+   {
+      seed    = seed * 1103515245 + 12345;
+      data[i] = (uint8_t)(seed >> 16);
+   }
+
+   for (i = 0; i < 8; i++)
+   {
+      size_t page = ((frame * 7 + i * 131) * 4096) % len;
+      size_t j;
+      for (j = page; j < page + 512 && j < len; j++)
+         data[j] ^= (uint8_t)(frame + j);
+   }
+
+   for (i = 0; i < len; i += 997)
+      data[i] = (uint8_t)frame;
+}
+
+static void bench_usage(const char *argv0)
+{
+   fprintf(stderr,
+         "Usage: %s [-n iterations] [-s synthetic_size] [state ...]\n"
+         "\n"
+         "Consecutive states are compressed against each other as\n"
+         "rewind would. States must not be compressed on disk.\n"
+         "Without any states, %s synthetic 4 MiB states are used.\n",
+         argv0, "60");
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned k, iter;
+   size_t len          = 0;
+   size_t synth_len    = 4 << 20;
+   unsigned iterations = 10;
+   unsigned num_states = 0;
+   uint8_t **states    = NULL;
+   uint8_t *patch      = NULL;
+   uint8_t *check      = NULL;
+   size_t *ref_sizes   = NULL;
+   uint64_t cpu        = cpu_features_get();
+   const char **files  = (const char**)calloc(argc, sizeof(*files));
+   unsigned num_files  = 0;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc)
+         iterations = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+         synth_len  = (size_t)strtoul(argv[++i], NULL, 0);
+      else if (argv[i][0] == '-')
+      {
+         bench_usage(argv[0]);
+         return 1;
+      }
+      else
+         files[num_files++] = argv[i];
+   }
+
+   if (num_files == 1)
+   {
+      bench_usage(argv[0]);
+      return 1;
+   }
+
+   num_states = num_files ? num_files : 60;
+   states     = (uint8_t**)calloc(num_states, sizeof(*states));
+
+   if (num_files)
+   {
+      /* Every state is padded to the largest one, like
+       * a core reporting a fixed serialize size. */
+      uint8_t **raw = (uint8_t**)calloc(num_files, sizeof(*raw));
+      size_t *lens  = (size_t*)calloc(num_files, sizeof(*lens));
+
+      for (k = 0; k < num_files; k++)
+      {
+         if (!(raw[k] = bench_read_file(files[k], &lens[k])))
+         {
+            fprintf(stderr, "Failed to read \"%s\".\n", files[k]);
+            return 1;
+         }
+         if (lens[k] > len)
+            len = lens[k];
+      }
+
+      for (k = 0; k < num_files; k++)
+      {
+         states[k] = (uint8_t*)state_manager_raw_alloc(len, k & 1);
+         memcpy(states[k], raw[k], lens[k]);
+         free(raw[k]);
+      }
+
+      free(raw);
+      free(lens);
+   }
+   else
+   {
+      len = synth_len;
+      for (k = 0; k < num_states; k++)
+      {
+         states[k] = (uint8_t*)state_manager_raw_alloc(len, k & 1);
+         bench_synth_state(states[k], len, k);
+      }
+   }
+
+   patch     = (uint8_t*)malloc(state_manager_raw_maxsize(len));
+   check     = (uint8_t*)state_manager_raw_alloc(len, 0);
+   ref_sizes = (size_t*)calloc(num_states, sizeof(*ref_sizes));
+
+   printf("%u states of %u bytes, %u iterations\n",
+         num_states, (unsigned)len, iterations);
+
+   for (k = 0; k < ARRAY_SIZE(bench_kernels); k++)
+   {
+      unsigned s;
+      retro_time_t start, elapsed;
+      size_t total_patch = 0;
+      bool valid         = true;
+      bool identical     = true;
+      const struct bench_kernel *kernel = &bench_kernels[k];
+
+      if (kernel->simd && !(cpu & kernel->simd))
+      {
+         printf("%-8s unsupported by this CPU\n", kernel->name);
+         continue;
+      }
+
+      find_change = kernel->find_change;
+      find_same   = kernel->find_same;
+
+      /* Verification pass */
+      for (s = 1; s < num_states; s++)
+      {
+         size_t patch_len = state_manager_raw_compress(
+               states[s - 1], states[s], len, patch);
+
+         memcpy(check, states[s], len);
+         state_manager_raw_decompress(patch, patch_len, check, len);
+         if (memcmp(check, states[s - 1], len))
+            valid = false;
+
+         if (k == 0)
+            ref_sizes[s] = patch_len;
+         else if (ref_sizes[s] != patch_len)
+            identical = false;
+
+         total_patch += patch_len;
+      }
+
+      start = cpu_features_get_time_usec();
+      for (iter = 0; iter < iterations; iter++)
+         for (s = 1; s < num_states; s++)
+            state_manager_raw_compress(states[s - 1], states[s], len, patch);
+      elapsed = cpu_features_get_time_usec() - start;
+
+      printf("%-8s %9.1f MB/s  %9.1f us/push  patches %u bytes%s%s\n",
+            kernel->name,
+            (double)len * (num_states - 1) * iterations
+            / (elapsed ? elapsed : 1),
+            (double)elapsed / ((num_states - 1) * iterations),
+            (unsigned)total_patch,
+            valid ? "" : "  [DECODE MISMATCH]",
+            identical ? "" : "  [size differs from generic]");
+   }
+
+   for (k = 0; k < num_states; k++)
+      free(states[k]);
+   free(states);
+   free(files);
+   free(patch);
+   free(check);
+   free(ref_sizes);
+
+   return 0;
+}
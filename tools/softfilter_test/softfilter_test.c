@@ -0,0 +1,340 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Renders test images through the CPU filters with their scalar
+ * code as the golden reference, checks that every SIMD kernel the
+ * host supports gives bit-exact output, and reports throughput.
+ *
+ * Usage: softfilter_test [frames] [filter]
+ *
+ * 'frames' is the number of 320x240 frames to time each kernel
+ * with (0 skips timing), 'filter' restricts the run to one filter,
+ * by its short name (e.g. 2xbr). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <features/features_cpu.h>
+
+#include "../../gfx/video_filters/softfilter.h"
+
+extern const struct softfilter_implementation *scale2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *epx_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *twoxsai_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *supertwoxsai_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *supereagle_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *twoxbr_get_implementation(softfilter_simd_mask_t simd);
+
+static const softfilter_get_implementation_t test_filters[] = {
+   scale2x_get_implementation,
+   epx_get_implementation,
+   twoxsai_get_implementation,
+   supertwoxsai_get_implementation,
+   supereagle_get_implementation,
+   twoxbr_get_implementation,
+};
+
+struct test_isa
+{
+   const char *name;
+   softfilter_simd_mask_t simd;
+};
+
+static const struct test_isa test_isas[] = {
+   { "sse2", SOFTFILTER_SIMD_SSE2 },
+   { "avx2", SOFTFILTER_SIMD_SSE2 | SOFTFILTER_SIMD_AVX2 },
+   { "neon", SOFTFILTER_SIMD_NEON },
+};
+
+/* Odd sizes exercise the scalar tails of the kernels.
+ * EPX needs at least two pixels per row. */
+static const unsigned test_widths[]  = { 2, 3, 5, 8, 9, 16, 17, 31, 33, 64, 67, 256, 319 };
+static const unsigned test_heights[] = { 1, 2, 3, 4, 7, 30 };
+static const unsigned test_threads[] = { 1, 3 };
+
+#define TEST_GUARD  8
+#define TEST_MAGIC  0xA5
+
+/* Every option keeps its default */
+static int test_get_float(void *userdata, const char *key,
+      float *value, float default_value)
+{
+   *value = default_value;
+   return 0;
+}
+
+static int test_get_int(void *userdata, const char *key,
+      int *value, int default_value)
+{
+   *value = default_value;
+   return 0;
+}
+
+static int test_get_hex(void *userdata, const char *key,
+      unsigned *value, unsigned default_value)
+{
+   *value = default_value;
+   return 0;
+}
+
+static int test_get_float_array(void *userdata, const char *key,
+      float **values, unsigned *out_num_values,
+      const float *default_values, unsigned num_default_values)
+{
+   *values         = NULL;
+   *out_num_values = 0;
+   return 0;
+}
+
+static int test_get_int_array(void *userdata, const char *key,
+      int **values, unsigned *out_num_values,
+      const int *default_values, unsigned num_default_values)
+{
+   *values         = NULL;
+   *out_num_values = 0;
+   return 0;
+}
+
+static int test_get_string(void *userdata, const char *key,
+      char **output, const char *default_output)
+{
+   *output = NULL;
+   return 0;
+}
+
+static const struct softfilter_config test_config = {
+   test_get_float,
+   test_get_int,
+   test_get_hex,
+   test_get_float_array,
+   test_get_int_array,
+   test_get_string,
+   free,
+};
+
+static uint32_t test_rand_state = 1;
+
+static uint32_t test_rand(void)
+{
+   test_rand_state = test_rand_state * 1103515245 + 12345;
+   return test_rand_state >> 8;
+}
+
+/* Pixel art: runs of a few colours, some noise and near-duplicate
+ * shades, so that every equality branch of the filters is taken. */
+static void test_fill(uint8_t *buf, size_t size, unsigned fmt)
+{
+   static const uint32_t palette[] = {
+      0x00000000, 0x00ffffff, 0x00ff0000, 0x0000ff00,
+      0x000000ff, 0x00808080, 0x00818080, 0x00fefefe,
+   };
+   size_t i;
+   uint32_t color = 0;
+
+   for (i = 0; i < size; i += (fmt == SOFTFILTER_FMT_RGB565) ? 2 : 4)
+   {
+      uint32_t r = test_rand();
+
+      if ((r & 7) == 0)
+         color = palette[(r >> 3) & 7];
+      else if ((r & 63) == 1)
+         color = test_rand();
+
+      if (fmt == SOFTFILTER_FMT_RGB565)
+      {
+         uint16_t c = (uint16_t)(((color >> 8) & 0xf800)
+               | ((color >> 5) & 0x07e0) | ((color >> 3) & 0x001f));
+         memcpy(buf + i, &c, sizeof(c));
+      }
+      else
+         memcpy(buf + i, &color, sizeof(color));
+   }
+}
+
+static double test_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Runs the packets of one frame, in order, on this thread */
+static void test_render(const struct softfilter_implementation *impl,
+      void *filt, unsigned threads, uint8_t *out, size_t out_pitch,
+      const uint8_t *in, unsigned width, unsigned height, size_t in_pitch)
+{
+   unsigned i;
+   struct softfilter_work_packet packets[16];
+
+   impl->get_work_packets(filt, packets, out, out_pitch,
+         in, width, height, in_pitch);
+   for (i = 0; i < threads; i++)
+      packets[i].work(filt, packets[i].thread_data);
+}
+
+/* Renders the frame with the scalar code and with 'simd', and
+ * compares the whole output buffers, padding included. */
+static int test_compare(softfilter_get_implementation_t get_impl,
+      const struct test_isa *isa, unsigned fmt,
+      unsigned width, unsigned height, unsigned threads)
+{
+   unsigned out_width, out_height, i;
+   int ret                               = 0;
+   unsigned bpp                          = (fmt == SOFTFILTER_FMT_RGB565) ? 2 : 4;
+   const struct softfilter_implementation *impl = get_impl(0);
+   void *ref_filt                        = impl->create(&test_config,
+         fmt, fmt, width, height, threads, 0, NULL);
+   void *simd_filt                       = get_impl(isa->simd)->create(
+         &test_config, fmt, fmt, width, height, threads, isa->simd, NULL);
+   size_t in_pitch                       = (width + 2 * TEST_GUARD) * bpp;
+   size_t in_size                        = in_pitch * height;
+   uint8_t *in                           = (uint8_t*)malloc(in_size);
+   size_t out_pitch, out_size;
+   uint8_t *ref, *out;
+
+   impl->query_output_size(ref_filt, &out_width, &out_height, width, height);
+   out_pitch = (out_width + TEST_GUARD) * bpp;
+   out_size  = out_pitch * out_height;
+   ref       = (uint8_t*)malloc(out_size);
+   out       = (uint8_t*)malloc(out_size);
+
+   threads   = impl->query_num_threads(ref_filt);
+   test_fill(in, in_size, fmt);
+   memset(ref, TEST_MAGIC, out_size);
+   memset(out, TEST_MAGIC, out_size);
+
+   test_render(impl, ref_filt, threads, ref, out_pitch,
+         in + TEST_GUARD * bpp, width, height, in_pitch);
+   test_render(impl, simd_filt, threads, out, out_pitch,
+         in + TEST_GUARD * bpp, width, height, in_pitch);
+
+   for (i = 0; i < out_size; i++)
+   {
+      if (ref[i] != out[i])
+      {
+         printf("%-12s %-4s %s %ux%u, %u thread(s): "
+               "MISMATCH at output row %u, byte %u\n",
+               impl->short_ident, isa->name,
+               (fmt == SOFTFILTER_FMT_RGB565) ? "RGB565  " : "XRGB8888",
+               width, height, threads,
+               (unsigned)(i / out_pitch), (unsigned)(i % out_pitch));
+         ret = 1;
+         break;
+      }
+   }
+
+   impl->destroy(ref_filt);
+   impl->destroy(simd_filt);
+   free(in);
+   free(ref);
+   free(out);
+   return ret;
+}
+
+/* Returns milliseconds per frame */
+static double test_bench(softfilter_get_implementation_t get_impl,
+      softfilter_simd_mask_t simd, unsigned fmt,
+      unsigned width, unsigned height, unsigned frames)
+{
+   unsigned out_width, out_height, threads, i;
+   double start;
+   unsigned bpp                          = (fmt == SOFTFILTER_FMT_RGB565) ? 2 : 4;
+   const struct softfilter_implementation *impl = get_impl(simd);
+   void *filt                            = impl->create(&test_config,
+         fmt, fmt, width, height, 1, simd, NULL);
+   size_t in_pitch                       = (width + 2 * TEST_GUARD) * bpp;
+   uint8_t *in                           = (uint8_t*)malloc(in_pitch * height);
+   size_t out_pitch;
+   uint8_t *out;
+
+   impl->query_output_size(filt, &out_width, &out_height, width, height);
+   out_pitch = (out_width + TEST_GUARD) * bpp;
+   out       = (uint8_t*)malloc(out_pitch * out_height);
+   threads   = impl->query_num_threads(filt);
+   test_fill(in, in_pitch * height, fmt);
+
+   start     = test_now();
+   for (i = 0; i < frames; i++)
+      test_render(impl, filt, threads, out, out_pitch,
+            in + TEST_GUARD * bpp, width, height, in_pitch);
+   start     = test_now() - start;
+
+   impl->destroy(filt);
+   free(in);
+   free(out);
+   return start * 1000.0 / frames;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned f, k, i, w, h, t;
+   int failed                    = 0;
+   unsigned frames               = (argc > 1) ? (unsigned)atoi(argv[1]) : 200;
+   const char *only              = (argc > 2) ? argv[2] : NULL;
+   softfilter_simd_mask_t host   = (softfilter_simd_mask_t)cpu_features_get();
+   static const unsigned fmts[]  = { SOFTFILTER_FMT_RGB565, SOFTFILTER_FMT_XRGB8888 };
+
+   for (f = 0; f < sizeof(test_filters) / sizeof(test_filters[0]); f++)
+   {
+      const struct softfilter_implementation *impl = test_filters[f](0);
+
+      if (only && strcmp(only, impl->short_ident))
+         continue;
+
+      for (k = 0; k < sizeof(fmts) / sizeof(fmts[0]); k++)
+      {
+         double base;
+
+         if (!(impl->query_input_formats() & fmts[k]))
+            continue;
+
+         for (i = 0; i < sizeof(test_isas) / sizeof(test_isas[0]); i++)
+         {
+            if ((host & test_isas[i].simd) != test_isas[i].simd)
+               continue;
+
+            for (w = 0; w < sizeof(test_widths) / sizeof(test_widths[0]); w++)
+               for (h = 0; h < sizeof(test_heights) / sizeof(test_heights[0]); h++)
+                  for (t = 0; t < sizeof(test_threads) / sizeof(test_threads[0]); t++)
+                     if (test_compare(test_filters[f], &test_isas[i], fmts[k],
+                              test_widths[w], test_heights[h], test_threads[t]))
+                        failed = 1;
+         }
+
+         if (!frames)
+            continue;
+
+         /* 240p content, single-threaded */
+         base = test_bench(test_filters[f], 0, fmts[k], 320, 240, frames);
+         printf("%-12s %s scalar %7.3f ms", impl->short_ident,
+               (fmts[k] == SOFTFILTER_FMT_RGB565) ? "RGB565  " : "XRGB8888",
+               base);
+         for (i = 0; i < sizeof(test_isas) / sizeof(test_isas[0]); i++)
+         {
+            double ms;
+            if ((host & test_isas[i].simd) != test_isas[i].simd)
+               continue;
+            ms = test_bench(test_filters[f], test_isas[i].simd,
+                  fmts[k], 320, 240, frames);
+            printf("  %s %7.3f ms (%.2fx)", test_isas[i].name, ms, base / ms);
+         }
+         printf("\n");
+      }
+   }
+
+   printf(failed ? "FAILED\n" : "All kernels match the scalar output\n");
+   return failed;
+}